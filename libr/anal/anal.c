@@ -111,6 +111,7 @@ R_API RAnal *r_anal_new(void) {
 	anal->threads = r_list_newf (free);
 	r_interval_tree_init (&anal->meta, r_meta_item_free);
 	anal->sdb_types = sdb_ns (anal->sdb, "types", 1);
+	anal->typedb = r_anal_typedb_new (anal->sdb_types);
 	anal->sdb_fmts = sdb_ns (anal->sdb, "spec", 1);
 	anal->sdb_cc = sdb_ns (anal->sdb, "cc", 1);
 	anal->sdb_zigns = sdb_ns (anal->sdb, "zigns", 1);
@@ -185,6 +186,7 @@ R_API void r_anal_free(RAnal *a) {
 	r_anal_xrefs_free (a);
 	r_list_free (a->threads);
 	r_list_free (a->leaddrs);
+	r_anal_typedb_free (a->typedb);
 	sdb_free (a->sdb);
 	a->esil->anal = NULL;
 	r_esil_free (a->esil);
@@ -294,6 +296,7 @@ R_API bool r_anal_set_os(RAnal *anal, const char *os) {
 		Sdb *gd = sdb_new0 ();
 		sdb_open_gperf (gd, gp);
 		sdb_reset (anal->sdb_types);
+		r_anal_typedb_invalidate (anal->typedb);
 		sdb_merge (anal->sdb_types, gd);
 		sdb_close (gd);
 		sdb_free (gd);
@@ -395,6 +398,7 @@ R_API void r_anal_purge(RAnal *anal) {
 	r_interval_tree_fini (&anal->meta);
 	r_interval_tree_init (&anal->meta, r_meta_item_free);
 	sdb_reset (anal->sdb_types);
+	r_anal_typedb_invalidate (anal->typedb);
 	sdb_reset (anal->sdb_zigns);
 	sdb_reset (anal->sdb_classes);
 	sdb_reset (anal->sdb_classes_attrs);
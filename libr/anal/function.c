@@ -155,6 +155,7 @@ R_API bool r_anal_add_function(RAnal *anal, RAnalFunction *fcn) {
 	r_list_append (anal->fcns, fcn);
 	ht_pp_insert (anal->ht_name_fun, fcn->name, fcn);
 	ht_up_insert (anal->ht_addr_fun, fcn->addr, fcn);
+	R_DIRTY (anal);
 	return true;
 }
 
@@ -195,6 +196,7 @@ R_API RAnalFunction *r_anal_create_function(RAnal *anal, const char *name, ut64
 
 R_API bool r_anal_function_delete(RAnalFunction *fcn) {
 	R_RETURN_VAL_IF_FAIL (fcn, false);
+	R_DIRTY (fcn->anal);
 	return r_list_delete_data (fcn->anal->fcns, fcn);
 }
 
@@ -219,6 +221,7 @@ R_API bool r_anal_function_relocate(RAnalFunction *fcn, ut64 addr) {
 	ht_up_delete (fcn->anal->ht_addr_fun, fcn->addr);
 	fcn->addr = addr;
 	ht_up_insert (fcn->anal->ht_addr_fun, addr, fcn);
+	R_DIRTY (fcn->anal);
 	return true;
 }
 
@@ -242,6 +245,7 @@ R_API bool r_anal_function_rename(RAnalFunction *fcn, const char *name) {
 			// only re-insert if it really was in the tree before
 			ht_pp_insert (anal->ht_name_fun, fcn->name, fcn);
 		}
+		R_DIRTY (anal);
 		return true;
 	}
 	return false;
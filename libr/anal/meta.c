@@ -174,6 +174,7 @@ static void del(RAnal *a, RAnalMetaType type, const RSpace *space, ut64 addr, ut
 
 R_API void r_meta_del(RAnal *a, RAnalMetaType type, ut64 addr, ut64 size) {
 	del (a, type, r_spaces_current (&a->meta_spaces), addr, size);
+	R_DIRTY (a);
 }
 
 R_API bool r_meta_set(RAnal *a, RAnalMetaType type, ut64 addr, ut64 size, const char *str) {
@@ -0,0 +1,322 @@
+/* radare - LGPL - Copyright 2024 - pancake */
+
+#include <r_anal.h>
+
+// The sdb records remain the source of truth, this is only a parsed index of
+// them so the analysis loops don't need to split strings on every lookup.
+// Any write to the types sdb marks it as dirty and the next query drops it.
+
+static void typedb_hook(Sdb *s, void *user, const char *k, const char *v) {
+	RAnalTypeDB *db = user;
+	db->dirty = true;
+}
+
+static void typeinfo_free(RAnalTypeInfo *ti) {
+	if (ti) {
+		r_vector_fini (&ti->members);
+		free (ti);
+	}
+}
+
+static void types_kv_free(HtPPKv *kv) {
+	if (kv) {
+		free (kv->key);
+		typeinfo_free (kv->value);
+	}
+}
+
+static bool typedb_tables_init(RAnalTypeDB *db) {
+	if (!r_str_constpool_init (&db->names)) {
+		return false;
+	}
+	db->types = ht_pp_new (NULL, types_kv_free, NULL);
+	db->sizes = ht_pu_new0 ();
+	r_pvector_init (&db->structs, NULL);
+	db->structs_loaded = false;
+	db->dirty = false;
+	if (!db->types || !db->sizes) {
+		ht_pp_free (db->types);
+		ht_pu_free (db->sizes);
+		r_str_constpool_fini (&db->names);
+		return false;
+	}
+	return true;
+}
+
+static void typedb_tables_fini(RAnalTypeDB *db) {
+	r_pvector_fini (&db->structs);
+	ht_pp_free (db->types);
+	ht_pu_free (db->sizes);
+	db->types = NULL;
+	db->sizes = NULL;
+	r_str_constpool_fini (&db->names);
+}
+
+R_API RAnalTypeDB *r_anal_typedb_new(Sdb *sdb) {
+	R_RETURN_VAL_IF_FAIL (sdb, NULL);
+	RAnalTypeDB *db = R_NEW0 (RAnalTypeDB);
+	if (!db) {
+		return NULL;
+	}
+	db->sdb = sdb;
+	if (!typedb_tables_init (db)) {
+		free (db);
+		return NULL;
+	}
+	sdb_hook (sdb, typedb_hook, db);
+	return db;
+}
+
+R_API void r_anal_typedb_free(RAnalTypeDB *db) {
+	if (db) {
+		sdb_unhook (db->sdb, typedb_hook);
+		typedb_tables_fini (db);
+		free (db);
+	}
+}
+
+// sdb_reset() doesn't go through the hooks, callers must invalidate by hand
+R_API void r_anal_typedb_invalidate(RAnalTypeDB *db) {
+	R_RETURN_IF_FAIL (db);
+	db->dirty = true;
+}
+
+static void typedb_sync(RAnalTypeDB *db) {
+	if (db->dirty) {
+		typedb_tables_fini (db);
+		typedb_tables_init (db);
+	}
+}
+
+static RTypeKind kind_from_string(const char *s) {
+	if (!strcmp (s, "struct")) {
+		return R_TYPE_STRUCT;
+	}
+	if (!strcmp (s, "union")) {
+		return R_TYPE_UNION;
+	}
+	if (!strcmp (s, "enum")) {
+		return R_TYPE_ENUM;
+	}
+	if (!strcmp (s, "type")) {
+		return R_TYPE_BASIC;
+	}
+	if (!strcmp (s, "typedef")) {
+		return R_TYPE_TYPEDEF;
+	}
+	return R_TYPE_INVALID;
+}
+
+// parses "struct.NAME.member=type,offset,elements"
+static bool load_member(RAnalTypeDB *db, const char *kind, const char *tname, const char *name, RAnalTypeMember *m) {
+	char *query = r_str_newf ("%s.%s.%s", kind, tname, name);
+	char *record = sdb_get (db->sdb, query, 0);
+	free (query);
+	if (!record) {
+		return false;
+	}
+	int fields = r_str_split (record, ',');
+	m->name = r_str_constpool_get (&db->names, name);
+	m->type = r_str_constpool_get (&db->names, r_str_word_get0 (record, 0));
+	m->fields = fields;
+	m->offset = 0;
+	m->elements = 0;
+	if (fields >= 3) {
+		m->offset = r_num_math (NULL, r_str_word_get0 (record, fields - 2));
+		m->elements = r_num_math (NULL, r_str_word_get0 (record, fields - 1));
+	}
+	free (record);
+	return m->name && m->type;
+}
+
+static RAnalTypeInfo *load_type(RAnalTypeDB *db, const char *name) {
+	const char *kind = sdb_const_get (db->sdb, name, 0);
+	if (!kind) {
+		return NULL;
+	}
+	RAnalTypeInfo *ti = R_NEW0 (RAnalTypeInfo);
+	if (!ti) {
+		return NULL;
+	}
+	ti->name = r_str_constpool_get (&db->names, name);
+	ti->kind = kind_from_string (kind);
+	r_vector_init (&ti->members, sizeof (RAnalTypeMember), NULL, NULL);
+	if (ti->kind == R_TYPE_BASIC) {
+		char *query = r_str_newf ("type.%s.size", name);
+		ti->bitsize = sdb_num_get (db->sdb, query, 0);
+		free (query);
+	} else if (ti->kind == R_TYPE_STRUCT || ti->kind == R_TYPE_UNION) {
+		char *query = r_str_newf ("%s.%s", kind, name);
+		char *members = sdb_get (db->sdb, query, 0);
+		free (query);
+		if (members) {
+			int i, n = r_str_split (members, ',');
+			for (i = 0; i < n; i++) {
+				const char *mname = r_str_word_get0 (members, i);
+				RAnalTypeMember m = {0};
+				if (R_STR_ISEMPTY (mname) || !load_member (db, kind, name, mname, &m)) {
+					break;
+				}
+				r_vector_push (&ti->members, &m);
+			}
+			free (members);
+		}
+	}
+	return ti;
+}
+
+R_API const RAnalTypeInfo *r_anal_typedb_get(RAnalTypeDB *db, const char *name) {
+	R_RETURN_VAL_IF_FAIL (db && name, NULL);
+	typedb_sync (db);
+	bool found = false;
+	RAnalTypeInfo *ti = ht_pp_find (db->types, name, &found);
+	if (!found) {
+		// unknown names are cached as well, they are asked for all the time
+		ti = load_type (db, name);
+		char *key = strdup (name);
+		if (!key || !ht_pp_insert (db->types, key, ti)) {
+			free (key);
+			typeinfo_free (ti);
+			return NULL;
+		}
+	}
+	return ti;
+}
+
+static ut64 typedb_bitsize(RAnalTypeDB *db, const char *type) {
+	bool found = false;
+	ut64 size = ht_pu_find (db->sizes, type, &found);
+	if (found) {
+		return size;
+	}
+	// recursive types resolve to 0 instead of looping forever
+	ht_pu_insert (db->sizes, type, 0);
+	const char *name = type;
+	if (r_str_startswith (type, "struct ")) {
+		name = type + 7;
+	} else if (r_str_startswith (type, "union ")) {
+		name = type + 6;
+	}
+	if ((strstr (type, "*(") || strstr (type, " *")) && strncmp (type, "char *", 7)) {
+		size = 32;
+	} else {
+		const RAnalTypeInfo *ti = r_anal_typedb_get (db, name);
+		if (!ti) {
+			// XXX: Need a proper way to determine size of enum
+			size = r_str_startswith (name, "enum ")? 32: 0;
+		} else if (ti->kind == R_TYPE_BASIC) {
+			size = ti->bitsize;
+		} else if (ti->kind == R_TYPE_STRUCT || ti->kind == R_TYPE_UNION) {
+			RAnalTypeMember *m;
+			r_vector_foreach (&ti->members, m) {
+				if (m->fields < 2) {
+					continue;
+				}
+				ut64 sz = typedb_bitsize (db, m->type) * (m->elements? m->elements: 1);
+				if (ti->kind == R_TYPE_STRUCT) {
+					size += sz;
+				} else if (sz > size) {
+					size = sz;
+				}
+			}
+		}
+	}
+	ht_pu_update (db->sizes, type, size);
+	return size;
+}
+
+// same as r_type_get_bitsize() but memoized
+R_API ut64 r_anal_typedb_bitsize(RAnalTypeDB *db, const char *type) {
+	R_RETURN_VAL_IF_FAIL (db && type, 0);
+	typedb_sync (db);
+	return typedb_bitsize (db, type);
+}
+
+// same as r_type_get_struct_memb(), returns "type.member" or "type.member.field"
+R_API char *r_anal_typedb_member_at(RAnalTypeDB *db, const char *type, int offset) {
+	R_RETURN_VAL_IF_FAIL (db && type, NULL);
+	if (offset < 0) {
+		return NULL;
+	}
+	typedb_sync (db);
+	const RAnalTypeInfo *ti = r_anal_typedb_get (db, type);
+	if (!ti || ti->kind != R_TYPE_STRUCT) {
+		return NULL;
+	}
+	int next_offset = 0;
+	RAnalTypeMember *m;
+	r_vector_foreach (&ti->members, m) {
+		if (m->fields < 3) {
+			break;
+		}
+		int cur_offset = m->offset;
+		if (cur_offset > 0 && cur_offset < next_offset) {
+			break;
+		}
+		if (!cur_offset) {
+			cur_offset = next_offset;
+		}
+		if (cur_offset == offset) {
+			return r_str_newf ("%s.%s", type, m->name);
+		}
+		const int arrsz = m->elements? m->elements: 1;
+		const int fsize = (typedb_bitsize (db, m->type) * arrsz) / 8;
+		if (!fsize) {
+			break;
+		}
+		next_offset = cur_offset + fsize;
+		if (offset > cur_offset && offset < next_offset) {
+			if (r_str_startswith (m->type, "struct ") && !r_str_endswith (m->type, " *")) {
+				const char *nested = r_str_trim_head_ro (m->type + 7);
+				char *res = r_anal_typedb_member_at (db, nested, offset - cur_offset);
+				if (res) {
+					const char *leaf = r_str_rchr (res, NULL, '.');
+					char *full = r_str_newf ("%s.%s.%s", type, m->name, leaf? leaf + 1: res);
+					free (res);
+					return full;
+				}
+			}
+		}
+	}
+	return NULL;
+}
+
+static void typedb_load_structs(RAnalTypeDB *db) {
+	SdbList *ls = sdb_foreach_list (db->sdb, true);
+	SdbListIter *lsi;
+	SdbKv *kv;
+	ls_foreach (ls, lsi, kv) {
+		// TODO: Add unions support
+		const char *k = sdbkv_key (kv);
+		if (r_str_startswith (sdbkv_value (kv), "struct") && !r_str_startswith (k, "struct.")) {
+			const RAnalTypeInfo *ti = r_anal_typedb_get (db, k);
+			if (ti) {
+				r_pvector_push (&db->structs, (void *)ti);
+			}
+		}
+	}
+	ls_free (ls);
+	db->structs_loaded = true;
+}
+
+// same as r_type_get_by_offset() without walking the whole sdb every time
+R_API RList *r_anal_typedb_by_offset(RAnalTypeDB *db, ut64 offset) {
+	R_RETURN_VAL_IF_FAIL (db, NULL);
+	typedb_sync (db);
+	if (!db->structs_loaded) {
+		typedb_load_structs (db);
+	}
+	RList *offtypes = r_list_newf (free);
+	if (offset > ST32_MAX) {
+		return offtypes;
+	}
+	void **it;
+	r_pvector_foreach (&db->structs, it) {
+		const RAnalTypeInfo *ti = *it;
+		char *res = r_anal_typedb_member_at (db, ti->name, (int)offset);
+		if (res) {
+			r_list_append (offtypes, res);
+		}
+	}
+	return offtypes;
+}
@@ -65,3 +65,192 @@ R_API int r_arch_session_info(RArchSession *s, int query) {
 	}
 	return -1;
 }
+
+// Decoder contexts (capstone handles, etc) are created by the plugin for
+// every combination of bits, syntax, endianness and cpu used in each thread,
+// so switching between modes is a lookup instead of reopening the decoder,
+// and threads decoding with the same session don't share any state. The
+// lock only protects the table, the last context used is kept per thread.
+// Worker threads release their contexts before exiting, otherwise they are
+// kept until the session ends.
+
+R_VEC_TYPE (RVecDecoderKey, ut64);
+
+static R_TH_LOCAL RArchDecoders *last_decoders = NULL;
+static R_TH_LOCAL ut32 last_id = 0;
+static R_TH_LOCAL RArchDecoder *last_decoder = NULL;
+static RThreadLock decoders_id_lock = {0}; // static locks are initialized on the first use
+static ut32 decoders_id = 0;
+
+static inline ut64 decoder_tid(void) {
+#if R2__WINDOWS__ && !HAVE_PTHREAD
+	// GetCurrentThread returns the same pseudo handle in every thread
+	return (ut64)GetCurrentThreadId ();
+#else
+	return (ut64)(size_t)r_th_self ();
+#endif
+}
+
+static void decoder_free(RArchDecoders *ds, RArchDecoder *d) {
+	while (d) {
+		RArchDecoder *next = d->next;
+		if (d->ctx && ds->dfree) {
+			ds->dfree (d->ctx);
+		}
+		free (d->cpu);
+		free (d);
+		d = next;
+	}
+}
+
+static bool decoder_free_cb(void *user, const ut64 key, const void *value) {
+	decoder_free (user, (RArchDecoder *)value);
+	return true;
+}
+
+static ut64 decoder_key(ut64 tid, RArchConfig *cfg) {
+	ut64 k = cfg->cpu? r_str_hash64 (cfg->cpu): 0;
+	k = (k * 31) ^ tid;
+	k = (k * 31) ^ (ut64)cfg->bits;
+	k = (k * 31) ^ (ut64)cfg->syntax;
+	return (k * 31) ^ (ut64)R_ARCH_CONFIG_IS_BIG_ENDIAN (cfg);
+}
+
+static inline bool decoder_match(RArchDecoder *d, ut64 tid, RArchConfig *cfg) {
+	return d->tid == tid && d->bits == cfg->bits && d->syntax == cfg->syntax
+		&& d->bigendian == R_ARCH_CONFIG_IS_BIG_ENDIAN (cfg)
+		&& !strcmp (r_str_get (d->cpu), r_str_get (cfg->cpu));
+}
+
+/* Used by the plugins in init to create the decoder contexts on demand with
+ * dnew for the current config, dfree is called when the session is done */
+R_API bool r_arch_session_decoders_init(RArchSession *as, RArchDecoderNew dnew, RArchDecoderFree dfree) {
+	R_RETURN_VAL_IF_FAIL (as && dnew && !as->decoders, false);
+	RArchDecoders *ds = R_NEW0 (RArchDecoders);
+	if (!ds) {
+		return false;
+	}
+	ds->ht = ht_up_new0 ();
+	ds->lock = r_th_lock_new (false);
+	if (!ds->ht || !ds->lock) {
+		ht_up_free (ds->ht);
+		r_th_lock_free (ds->lock);
+		free (ds);
+		return false;
+	}
+	r_th_lock_enter (&decoders_id_lock);
+	ds->id = ++decoders_id;
+	r_th_lock_leave (&decoders_id_lock);
+	ds->dnew = dnew;
+	ds->dfree = dfree;
+	as->decoders = ds;
+	return true;
+}
+
+R_API void r_arch_session_decoders_fini(RArchSession *as) {
+	R_RETURN_IF_FAIL (as);
+	RArchDecoders *ds = as->decoders;
+	if (!ds) {
+		return;
+	}
+	if (last_decoders == ds) {
+		last_decoders = NULL;
+		last_decoder = NULL;
+	}
+	ht_up_foreach (ds->ht, decoder_free_cb, ds);
+	ht_up_free (ds->ht);
+	r_th_lock_free (ds->lock);
+	free (ds);
+	as->decoders = NULL;
+}
+
+/* Returns the decoder context for the current config in the calling thread,
+ * it's created the first time and can be used without taking any lock */
+R_API void *r_arch_session_decoder(RArchSession *as) {
+	R_RETURN_VAL_IF_FAIL (as && as->config, NULL);
+	RArchDecoders *ds = as->decoders;
+	if (!ds) {
+		return NULL;
+	}
+	RArchConfig *cfg = as->config;
+	const ut64 tid = decoder_tid ();
+	if (last_decoders == ds && last_id == ds->id && decoder_match (last_decoder, tid, cfg)) {
+		return last_decoder->ctx;
+	}
+	const ut64 key = decoder_key (tid, cfg);
+	r_th_lock_enter (ds->lock);
+	RArchDecoder *head = ht_up_find (ds->ht, key, NULL);
+	RArchDecoder *d = head;
+	while (d && !decoder_match (d, tid, cfg)) {
+		d = d->next;
+	}
+	r_th_lock_leave (ds->lock);
+	if (!d) {
+		d = R_NEW0 (RArchDecoder);
+		if (!d) {
+			return NULL;
+		}
+		d->tid = tid;
+		d->bits = cfg->bits;
+		d->syntax = cfg->syntax;
+		d->bigendian = R_ARCH_CONFIG_IS_BIG_ENDIAN (cfg);
+		d->cpu = cfg->cpu? strdup (cfg->cpu): NULL;
+		// failures are kept too, to not retry on every instruction
+		d->ctx = ds->dnew (as);
+		r_th_lock_enter (ds->lock);
+		d->next = ht_up_find (ds->ht, key, NULL);
+		ht_up_update (ds->ht, key, d);
+		r_th_lock_leave (ds->lock);
+	}
+	last_decoders = ds;
+	last_id = ds->id;
+	last_decoder = d;
+	return d->ctx;
+}
+
+static bool decoder_key_cb(void *user, const ut64 key, const void *value) {
+	RVecDecoderKey_push_back ((RVecDecoderKey *)user, &key);
+	return true;
+}
+
+/* Frees the decoder contexts created by the calling thread, which must not
+ * use them anymore. Worker threads call it before exiting */
+R_API void r_arch_session_decoder_release(RArchSession *as) {
+	RArchDecoders *ds = as? as->decoders: NULL;
+	if (!ds) {
+		return;
+	}
+	const ut64 tid = decoder_tid ();
+	if (last_decoders == ds) {
+		last_decoders = NULL;
+		last_decoder = NULL;
+	}
+	RArchDecoder *released = NULL;
+	RVecDecoderKey keys;
+	RVecDecoderKey_init (&keys);
+	r_th_lock_enter (ds->lock);
+	ht_up_foreach (ds->ht, decoder_key_cb, &keys);
+	ut64 *key;
+	R_VEC_FOREACH (&keys, key) {
+		RArchDecoder *head = ht_up_find (ds->ht, *key, NULL);
+		RArchDecoder **pd = &head;
+		while (*pd) {
+			RArchDecoder *d = *pd;
+			if (d->tid == tid) {
+				*pd = d->next;
+				d->next = released;
+				released = d;
+			} else {
+				pd = &d->next;
+			}
+		}
+		if (head) {
+			ht_up_update (ds->ht, *key, head);
+		} else {
+			ht_up_delete (ds->ht, *key);
+		}
+	}
+	r_th_lock_leave (ds->lock);
+	RVecDecoderKey_fini (&keys);
+	decoder_free (ds, released);
+}
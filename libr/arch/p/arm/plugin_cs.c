@@ -14,31 +14,31 @@
 
 typedef char RStringShort[32];
 
-typedef struct plugin_data_t {
-	bool bigendian;
-	int bits;
-	char *cpu;
+// pooled by the session for each mode, cpu, syntax and thread
+typedef struct arm_decoder_t {
 	csh cs_handle;
 	HtUU *ht_itblock;
 	HtUU *ht_it;
-} PluginData;
+} ArmDecoder;
+
+static inline ArmDecoder *decoder_for_session(RArchSession *as) {
+	R_RETURN_VAL_IF_FAIL (as && as->decoders, NULL);
+	return r_arch_session_decoder (as);
+}
 
 static inline csh *cs_handle_for_session(RArchSession *as) {
-	R_RETURN_VAL_IF_FAIL (as && as->data, NULL);
-	PluginData *pd = (PluginData*) as->data;
-	return &(pd->cs_handle);
+	ArmDecoder *ad = decoder_for_session (as);
+	return ad? &ad->cs_handle: NULL;
 }
 
 static inline HtUU *ht_itblock_for_session (RArchSession *as) {
-	R_RETURN_VAL_IF_FAIL (as && as->data, NULL);
-	PluginData *pd = (PluginData*) as->data;
-	return pd->ht_itblock;
+	ArmDecoder *ad = decoder_for_session (as);
+	return ad? ad->ht_itblock: NULL;
 }
 
 static inline HtUU *ht_it_for_session (RArchSession *as) {
-	R_RETURN_VAL_IF_FAIL (as && as->data, NULL);
-	PluginData *pd = (PluginData*) as->data;
-	return pd->ht_it;
+	ArmDecoder *ad = decoder_for_session (as);
+	return ad? ad->ht_it: NULL;
 }
 
 /* arm64 */
@@ -4685,8 +4685,11 @@ static inline bool is_valid_mnemonic(const char *m) {
 }
 
 static int analop(RArchSession *as, RAnalOp *op, ut64 addr, const ut8 *buf, int len, RAnalOpMask mask) {
-	R_CRITICAL_ENTER (as);
 	csh *cs_handle = cs_handle_for_session (as);
+	if (!cs_handle) {
+		return -1;
+	}
+	R_CRITICAL_ENTER (as);
 	cs_insn *insn = NULL;
 	op->size = (as->config->bits == 16)? 2: 4;
 	op->addr = addr;
@@ -4756,34 +4759,7 @@ static int analop(RArchSession *as, RAnalOp *op, ut64 addr, const ut8 *buf, int
 	return true;
 }
 
-static bool plugin_changed(RArchSession *as) {
-	PluginData *pd = as->data;
-	if (as->config->bits != pd->bits) {
-		return true;
-	}
-	if (R_ARCH_CONFIG_IS_BIG_ENDIAN (as->config) != pd->bigendian) {
-		return true;
-	}
-	if (pd->cpu && as->config->cpu && strcmp (pd->cpu, as->config->cpu)) {
-		return true;
-	}
-	return false;
-}
-
-static bool init(RArchSession *as);
-static bool fini(RArchSession *as);
-
 static bool decode(RArchSession *as, RAnalOp *op, RAnalOpMask mask) {
-	if (plugin_changed (as)) {
-		fini (as);
-		init (as);
-	}
-	csh *handle = cs_handle_for_session (as);
-	if (as->config->syntax == R_ARCH_SYNTAX_REGNUM) {
-		cs_option (*handle, CS_OPT_SYNTAX, CS_OPT_SYNTAX_NOREGNAME);
-	} else {
-		cs_option (*handle, CS_OPT_SYNTAX, CS_OPT_SYNTAX_DEFAULT);
-	}
 	return analop (as, op, op->addr, op->bytes, op->size, mask) >= 1;
 }
 
@@ -4987,6 +4963,9 @@ extern char *r_arm64_cs_mnemonics(RArchSession *as, csh *cs_handle, int id, bool
 
 static char *arm_mnemonics(RArchSession *as, int id, bool json) {
 	csh *cs_handle = cs_handle_for_session (as);
+	if (!cs_handle) {
+		return NULL;
+	}
 	if (as->config->bits == 64) {
 		return r_arm64_cs_mnemonics (as, cs_handle, id, json);
 	}
@@ -5003,38 +4982,49 @@ static inline bool cs_init(RArchSession *as, csh *cs_handle) {
 	return r_arm_arch_cs_init (as, cs_handle);
 }
 
+static void decoder_free(void *ctx) {
+	ArmDecoder *ad = ctx;
+	if (ad) {
+		ht_uu_free (ad->ht_itblock);
+		ht_uu_free (ad->ht_it);
+		if (ad->cs_handle) {
+			cs_close (&ad->cs_handle);
+		}
+		free (ad);
+	}
+}
+
+static void *decoder_new(RArchSession *as) {
+	ArmDecoder *ad = R_NEW0 (ArmDecoder);
+	if (!ad) {
+		return NULL;
+	}
+	ad->ht_it = ht_uu_new0 ();
+	ad->ht_itblock = ht_uu_new0 ();
+	if (!ad->ht_it || !ad->ht_itblock || !cs_init (as, &ad->cs_handle) || !ad->cs_handle) {
+		decoder_free (ad);
+		return NULL;
+	}
+	if (as->config->syntax == R_ARCH_SYNTAX_REGNUM) {
+		cs_option (ad->cs_handle, CS_OPT_SYNTAX, CS_OPT_SYNTAX_NOREGNAME);
+	} else {
+		cs_option (ad->cs_handle, CS_OPT_SYNTAX, CS_OPT_SYNTAX_DEFAULT);
+	}
+	return ad;
+}
+
 static bool init(RArchSession* as) {
 	R_RETURN_VAL_IF_FAIL (as, false);
-	if (as->data) {
+	if (as->decoders) {
 		R_LOG_WARN ("Already initialized");
 		return false;
 	}
-	as->data = R_NEW0 (PluginData);
-	csh *cs_handle = cs_handle_for_session (as);
-	if (!cs_init (as, cs_handle)) {
-		R_LOG_ERROR ("Cannot initialize capstone");
-		R_FREE (as->data);
+	if (!r_arch_session_decoders_init (as, decoder_new, decoder_free)) {
 		return false;
 	}
-
-	PluginData *pd = as->data;
-	pd->bits = as->config->bits;
-	pd->bigendian = R_ARCH_CONFIG_IS_BIG_ENDIAN (as->config);
-	pd->cpu = as->config->cpu? strdup (as->config->cpu): NULL;
-	pd->ht_it = ht_uu_new0 ();
-	if (!pd->ht_it) {
-		R_LOG_ERROR ("Cannot initialize 'ht_it'");
-		cs_close (&(pd->cs_handle));
-		R_FREE (as->data);
-		return false;
-	}
-
-	pd->ht_itblock = ht_uu_new0 ();
-	if (!pd->ht_itblock) {
-		R_LOG_ERROR ("Cannot initialize 'ht_itblock'");
-		ht_uu_free (pd->ht_it);
-		cs_close (&(pd->cs_handle));
-		R_FREE (as->data);
+	if (!decoder_for_session (as)) {
+		R_LOG_ERROR ("Cannot initialize capstone");
+		r_arch_session_decoders_fini (as);
 		return false;
 	}
 	return true;
@@ -5042,13 +5032,7 @@ static bool init(RArchSession* as) {
 
 static bool fini(RArchSession *as) {
 	R_RETURN_VAL_IF_FAIL (as, false);
-
-	PluginData *pd = (PluginData*) as->data;
-	ht_uu_free (pd->ht_itblock);
-	ht_uu_free (pd->ht_it);
-	free (pd->cpu);
-	cs_close (&(pd->cs_handle));
-	R_FREE (as->data);
+	r_arch_session_decoders_fini (as);
 	return true;
 }
 
@@ -41,48 +41,48 @@ call = 4
 	(as->config->bits == 16)? CS_MODE_16: 0
 #include "../capstone.inc.c"
 
-typedef struct plugin_data_t {
-	CapstonePluginData cpd;
-	int bits;
-	int syntax;
-	int omode; // XXX unused?
-// 	char *cpu;
-} PluginData;
+// capstone handles are pooled per mode, syntax and thread by the session
+static void *cs_new(RArchSession *as) {
+	csh *handle = R_NEW0 (csh);
+	if (handle && (!r_arch_cs_init (as, handle) || !*handle)) {
+		R_FREE (handle);
+	}
+	return handle;
+}
+
+static void cs_fini(void *ctx) {
+	csh *handle = ctx;
+	cs_close (handle);
+	free (handle);
+}
 
 static bool init(RArchSession *as) {
 	R_RETURN_VAL_IF_FAIL (as, false);
-	if (as->data) {
+	if (as->decoders) {
 		R_LOG_WARN ("Already initialized");
 		return false;
 	}
-	PluginData *pd = R_NEW0 (PluginData);
-	if (!pd) {
+	if (!r_arch_session_decoders_init (as, cs_new, cs_fini)) {
 		return false;
 	}
-	// pd->cpu = as->config->cpu? strdup (as->config->cpu): NULL;
-	if (!r_arch_cs_init (as, &pd->cpd.cs_handle)) {
+	if (!r_arch_session_decoder (as)) {
 		R_LOG_ERROR ("Cannot initialize capstone");
-		R_FREE (as->data);
+		r_arch_session_decoders_fini (as);
 		return false;
 	}
-	pd->bits = as->config->bits;
-	pd->syntax = as->config->syntax;
-	as->data = pd;
 	return true;
 }
 
 static bool fini(RArchSession *as) {
 	R_RETURN_VAL_IF_FAIL (as, false);
-	PluginData *pd = as->data;
-	cs_close (&pd->cpd.cs_handle);
-	R_FREE (as->data);
+	r_arch_session_decoders_fini (as);
 	return true;
 }
 
 static csh cs_handle_for_session(RArchSession *as) {
-	R_RETURN_VAL_IF_FAIL (as && as->data, 0);
-	CapstonePluginData *pd = as->data;
-	return pd->cs_handle;
+	R_RETURN_VAL_IF_FAIL (as && as->decoders, 0);
+	csh *handle = r_arch_session_decoder (as);
+	return handle? *handle: 0;
 }
 
 
@@ -3832,17 +3832,6 @@ static int cs_len_prefix_opcode(uint8_t *item) {
 	return len;
 }
 
-static bool plugin_changed(RArchSession *as) {
-	PluginData *cpd = as->data;
-	if (as->config->bits != cpd->bits) {
-		return true;
-	}
-	if (as->config->syntax != cpd->syntax) {
-		return true;
-	}
-	return false;
-}
-
 static bool decode(RArchSession *as, RAnalOp *op, RAnalOpMask mask) {
 	csh handle = cs_handle_for_session (as);
 	if (handle == 0) {
@@ -3854,11 +3843,6 @@ static bool decode(RArchSession *as, RAnalOp *op, RAnalOpMask mask) {
 	case 32: mode = CS_MODE_32; break;
 	case 64: mode = CS_MODE_64; break;
 	}
-	if (plugin_changed (as)) {
-		fini (as);
-		init (as);
-		handle = cs_handle_for_session (as);
-	}
 
 	cs_insn *insn = NULL;
 	int n;
@@ -4440,9 +4424,8 @@ static RList *anal_preludes(RArchSession *as) {
 }
 
 static char *mnemonics(RArchSession *as, int id, bool json) {
-	R_RETURN_VAL_IF_FAIL (as && as->data, NULL);
-	CapstonePluginData *cpd = as->data;
-	return r_arch_cs_mnemonics (as, cpd->cs_handle, id, json);
+	R_RETURN_VAL_IF_FAIL (as && as->decoders, NULL);
+	return r_arch_cs_mnemonics (as, cs_handle_for_session (as), id, json);
 }
 #include <r_core.h>
 
@@ -433,16 +433,10 @@ static bool is_invalid(RAnalOp *op) {
 	return (text && !strcmp (text, "invalid"));
 }
 
-R_API int r_asm_disassemble(RAsm *a, RAnalOp *op, const ut8 *buf, int len) {
-	R_RETURN_VAL_IF_FAIL (a && buf && op, -1);
-	r_asm_op_init (op);
-	if (len < 1) {
-		return 0;
-	}
-
+// decodes the instruction at a->pc with the given mask, op must be initialized
+static int asm_decode(RAsm *a, RAnalOp *op, const ut8 *buf, int len, RAnalOpMask mask) {
 	int ret = 0;
 	op->size = 4;
-	r_anal_op_set_mnemonic (op, op->addr, "");
 	if (a->config->codealign) {
 		const int mod = a->pc % a->config->codealign;
 		if (mod) {
@@ -452,8 +446,10 @@ R_API int r_asm_disassemble(RAsm *a, RAnalOp *op, const ut8 *buf, int len) {
 		}
 	}
 	if (a->analb.anal) {
-		ret = a->analb.decode (a->analb.anal, op, a->pc,buf, len,
-				R_ARCH_OP_MASK_ESIL | R_ARCH_OP_MASK_DISASM);
+		// the decoder initializes the op, nothing can be allocated before
+		ret = a->analb.decode (a->analb.anal, op, a->pc, buf, len, mask);
+	} else {
+		r_anal_op_set_mnemonic (op, op->addr, "");
 	}
 	if (ret < 0) {
 		ret = 0;
@@ -487,10 +483,23 @@ R_API int r_asm_disassemble(RAsm *a, RAnalOp *op, const ut8 *buf, int len) {
 	if (a->pseudo) {
 		char *newtext = r_asm_parse_pseudo (a, op->mnemonic);
 		if (newtext) {
-			r_anal_op_set_mnemonic (op, op->addr, newtext);
-			free (newtext);
+			free (op->mnemonic);
+			op->mnemonic = newtext;
 		}
 	}
+	return ret;
+}
+
+R_API int r_asm_disassemble(RAsm *a, RAnalOp *op, const ut8 *buf, int len) {
+	R_RETURN_VAL_IF_FAIL (a && buf && op, -1);
+	r_asm_op_init (op);
+	if (len < 1) {
+		return 0;
+	}
+	int ret = asm_decode (a, op, buf, len, R_ARCH_OP_MASK_ESIL | R_ARCH_OP_MASK_DISASM);
+	if (ret < 0) {
+		return ret;
+	}
 	int opsz = (op->size > 0)? R_MAX (0, R_MIN (len, op->size)): 1;
 	r_anal_op_set_bytes (op, op->addr, buf, opsz);
 	return ret;
@@ -584,48 +593,167 @@ static int r_asm_assemble(RAsm *a, RAnalOp *op, const char *buf) {
 	return ret;
 }
 
-R_API RAsmCode* r_asm_mdisassemble(RAsm *a, const ut8 *buf, int len) {
-	R_RETURN_VAL_IF_FAIL (a && buf && len >= 0, NULL);
+// XXX move from io to archconfig!! and remove the dependency on core!
+static size_t asm_addrbytes(RAsm *a) {
+	return a->user? ((RCore *)a->user)->io->addrbytes: 1;
+}
+
+R_API RAsmBatch *r_asm_batch_new(RAsm *a) {
+	R_RETURN_VAL_IF_FAIL (a, NULL);
+	RAsmBatch *b = R_NEW0 (RAsmBatch);
+	if (!b) {
+		return NULL;
+	}
+	b->a = a;
+	r_vector_init (&b->insns, sizeof (RAsmInsn), NULL, NULL);
+	r_pvector_init (&b->mnems, free);
+	b->mnemids = ht_pu_new0 ();
+	if (!b->mnemids) {
+		r_asm_batch_free (b);
+		return NULL;
+	}
+	return b;
+}
+
+R_API void r_asm_batch_free(RAsmBatch *b) {
+	if (b) {
+		r_vector_fini (&b->insns);
+		r_pvector_fini (&b->mnems);
+		ht_pu_free (b->mnemids);
+		free (b->arena);
+		free (b);
+	}
+}
+
+// drops the instructions, the mnemonic ids stay valid
+R_API void r_asm_batch_reset(RAsmBatch *b) {
+	R_RETURN_IF_FAIL (b);
+	r_vector_clear (&b->insns);
+	b->arenalen = 0;
+}
+
+static ut32 batch_mnemonic_id(RAsmBatch *b, const char *mnem) {
+	bool found = false;
+	ut64 id = ht_pu_find (b->mnemids, mnem, &found);
+	if (found) {
+		return (ut32)id;
+	}
+	char *s = strdup (mnem);
+	if (!s || !r_pvector_push (&b->mnems, s)) {
+		free (s);
+		return UT32_MAX;
+	}
+	id = r_pvector_length (&b->mnems) - 1;
+	ht_pu_insert (b->mnemids, mnem, id);
+	return (ut32)id;
+}
+
+// copies the text into the arena and splits it in mnemonic and operands
+R_API bool r_asm_batch_set_text(RAsmBatch *b, RAsmInsn *insn, const char *text) {
+	R_RETURN_VAL_IF_FAIL (b && insn && text, false);
+	const size_t len = R_MIN (strlen (text), UT16_MAX);
+	if (b->arenalen + len + 1 > b->arenasize) {
+		size_t size = R_MAX (b->arenasize * 2, 4096);
+		while (size < b->arenalen + len + 1) {
+			size *= 2;
+		}
+		if (size > UT32_MAX) {
+			return false;
+		}
+		char *arena = realloc (b->arena, size);
+		if (!arena) {
+			return false;
+		}
+		b->arena = arena;
+		b->arenasize = size;
+	}
+	char *s = b->arena + b->arenalen;
+	memcpy (s, text, len);
+	s[len] = 0;
+	insn->text = b->arenalen;
+	insn->textlen = len;
+	b->arenalen += len + 1;
+	size_t mlen = 0;
+	while (mlen < len && s[mlen] != ' ') {
+		mlen++;
+	}
+	size_t ops = mlen;
+	while (ops < len && s[ops] == ' ') {
+		ops++;
+	}
+	insn->ops = ops;
+	insn->opslen = len - ops;
+	s[mlen] = 0;
+	insn->mnem = batch_mnemonic_id (b, s);
+	if (mlen < len) {
+		s[mlen] = ' ';
+	}
+	return true;
+}
 
-	ut64 pc = a->pc;
-	ut64 idx;
-	int ret;
-	// XXX move from io to archconfig!! and remove the dependency on core!
-	const size_t addrbytes = a->user? ((RCore *)a->user)->io->addrbytes: 1;
-	int mininstrsize = 1; // TODO: use r_arch_info();
+/* Decodes up to count instructions (all if count is 0) of the buffer at
+ * addr and appends them to the batch, returns how many were decoded. The
+ * esil is not generated and the op is reused, so the only allocations are
+ * the ones done by the arch plugin */
+R_API int r_asm_batch_disassemble(RAsmBatch *b, ut64 addr, const ut8 *buf, int len, int count) {
+	R_RETURN_VAL_IF_FAIL (b && buf && len >= 0, -1);
+	RAsm *a = b->a;
+	RAnalOp *op = &b->op;
+	const size_t addrbytes = asm_addrbytes (a);
+	int idx, n = 0;
+	for (idx = 0; idx + addrbytes <= len && (count < 1 || n < count); n++) {
+		RAsmInsn insn = {0};
+		r_asm_set_pc (a, addr + idx);
+		asm_decode (a, op, buf + idx, len - idx, R_ARCH_OP_MASK_DISASM);
+		const int size = R_MAX (op->size, 1);
+		insn.addr = addr + idx;
+		insn.size = R_MIN (size, UT16_MAX);
+		bool ok = r_asm_batch_set_text (b, &insn, r_str_get (op->mnemonic));
+		r_anal_op_fini (op);
+		if (!ok || !r_vector_push (&b->insns, &insn)) {
+			break;
+		}
+		idx += addrbytes * size;
+	}
+	return n;
+}
+
+R_API const char *r_asm_batch_text(RAsmBatch *b, const RAsmInsn *insn) {
+	R_RETURN_VAL_IF_FAIL (b && insn, NULL);
+	return b->arena + insn->text;
+}
 
+R_API const char *r_asm_batch_mnemonic(RAsmBatch *b, ut32 id) {
+	R_RETURN_VAL_IF_FAIL (b, NULL);
+	return (id < r_pvector_length (&b->mnems))? r_pvector_at (&b->mnems, id): NULL;
+}
+
+R_API RAsmCode* r_asm_mdisassemble(RAsm *a, const ut8 *buf, int len) {
+	R_RETURN_VAL_IF_FAIL (a && buf && len >= 0, NULL);
 	RAsmCode *acode = r_asm_code_new ();
 	if (!acode) {
 		return NULL;
 	}
-	RStrBuf *sb = r_strbuf_new (NULL);
+	RAsmBatch *b = r_asm_batch_new (a);
+	if (!b) {
+		r_asm_code_free (acode);
+		return NULL;
+	}
+	const ut64 pc = a->pc;
 	acode->bytes = r_mem_dup (buf, len);
-
-	for (idx = 0; idx + addrbytes <= len; idx += (addrbytes * ret)) {
-		RAnalOp op = {0};
-		r_anal_op_init (&op);
-		r_asm_set_pc (a, pc + idx);
-		// we can change this to return RAnalOp* instead of passing it as arg here
-		ret = r_asm_disassemble (a, &op, buf + idx, len - idx);
-		if (ret < 1) {
-			ret = mininstrsize;
-		}
-		ret = op.size;
-		if (a->pseudo) {
-			char *newtext = r_asm_parse_pseudo (a, op.mnemonic);
-			if (newtext) {
-				free (op.mnemonic);
-				op.mnemonic = newtext;
-			}
-		}
-		if (op.mnemonic) {
-			r_strbuf_append (sb, op.mnemonic);
-			r_strbuf_append (sb, "\n");
+	r_asm_batch_disassemble (b, pc, buf, len, 0);
+	RStrBuf *sb = r_strbuf_new (NULL);
+	r_strbuf_reserve (sb, b->arenalen + 1);
+	RAsmInsn *insn;
+	r_vector_foreach (&b->insns, insn) {
+		if (insn->textlen) {
+			r_strbuf_append_n (sb, r_asm_batch_text (b, insn), insn->textlen);
+			r_strbuf_append_n (sb, "\n", 1);
 		}
-		r_anal_op_fini (&op);
+		acode->len = insn->addr + insn->size * asm_addrbytes (a) - pc;
 	}
 	acode->assembly = r_strbuf_drain (sb);
-	acode->len = idx;
+	r_asm_batch_free (b);
 	return acode;
 }
 
@@ -835,11 +963,329 @@ static inline char *next_token(const char *tok) {
 	return NULL;
 }
 
+// The assembler splits the input in statements once and encodes them in
+// passes until the addresses of the labels are stable. After the first pass
+// only the instructions referencing a label that moved, or whose encoding
+// depends on their own address, are assembled again. Encodings are cached by
+// the text of the instruction and the output is written in a single buffer.
+
+#define ASM_MAXPASSES 16
+// distance used to find the encodings that depend on the address
+#define ASM_PCDELTA 0x1000
+
+typedef struct {
+	char *name;
+	ut64 addr;
+	ut64 fwd; // value used by the references found before the label in a pass
+	bool defined;
+	bool fwdused;
+	bool fwdbad;
+} AsmLabel;
+
+typedef struct {
+	char *text; // instruction or directive, NULL for labels alone
+	int label; // index of the label defined in this line or -1
+	int line;
+	bool directive;
+	bool refs; // references labels or equs
+	char *enc; // text of the last encoding, after replacing labels and equs
+	ut64 addr; // address of the last encoding
+	bool pcdep;
+	int size;
+	ut8 *bytes;
+} AsmStmt;
+
+typedef struct {
+	int size;
+	bool pcdep; // the bytes change with the address
+	ut8 bytes[];
+} AsmEnc;
+
+typedef struct {
+	RAsm *a;
+	RAsmCode *acode;
+	RVector stmts;
+	RVector labels;
+	HtPU *labelids;
+	HtPP *cache;
+	RStrBuf sb;
+	bool unstable;
+	// config of the cached encodings
+	char *arch;
+	char *cpu;
+	int bits;
+	int syntax;
+	int endian;
+} AsmBulk;
+
+static void bulk_fini(AsmBulk *ab) {
+	AsmStmt *st;
+	r_vector_foreach (&ab->stmts, st) {
+		if (st->enc != st->text) {
+			free (st->enc);
+		}
+		free (st->bytes);
+	}
+	r_vector_fini (&ab->stmts);
+	AsmLabel *l;
+	r_vector_foreach (&ab->labels, l) {
+		free (l->name);
+	}
+	r_vector_fini (&ab->labels);
+	ht_pu_free (ab->labelids);
+	ht_pp_free (ab->cache);
+	r_strbuf_fini (&ab->sb);
+	free (ab->arch);
+	free (ab->cpu);
+}
+
+static int bulk_label(AsmBulk *ab, const char *name, bool add) {
+	bool found = false;
+	ut64 id = ht_pu_find (ab->labelids, name, &found);
+	if (found) {
+		return (int)id;
+	}
+	if (!add) {
+		return -1;
+	}
+	AsmLabel l = { .name = strdup (name), .addr = UT64_MAX };
+	if (!l.name || !r_vector_push (&ab->labels, &l)) {
+		free (l.name);
+		return -1;
+	}
+	id = r_vector_length (&ab->labels) - 1;
+	ht_pu_insert (ab->labelids, name, id);
+	return (int)id;
+}
+
+// forward references take the address of the previous pass or the current one
+static ut64 bulk_label_value(AsmBulk *ab, AsmLabel *l, ut64 pc) {
+	if (l->defined) {
+		return l->addr;
+	}
+	const ut64 v = (l->addr != UT64_MAX)? l->addr: pc;
+	if (l->fwdused && l->fwd != v) {
+		l->fwdbad = true;
+	}
+	l->fwd = v;
+	l->fwdused = true;
+	return v;
+}
+
+static void bulk_label_define(AsmBulk *ab, AsmLabel *l, ut64 addr) {
+	if (l->defined) {
+		return;
+	}
+	if (l->fwdused && (l->fwdbad || l->fwd != addr)) {
+		ab->unstable = true;
+	}
+	l->addr = addr;
+	l->defined = true;
+}
+
+static inline bool is_ident(char c) {
+	return isalnum ((ut8)c) || c == '_' || c == '.' || c == '$';
+}
+
+// replaces the labels and equs, returns the same text if there are none
+static const char *bulk_subst(AsmBulk *ab, AsmStmt *st, ut64 pc) {
+	HtPP *equs = ab->acode->equs;
+	const char *text = st->text;
+	const char *last = text;
+	const char *p = text;
+	bool replaced = false;
+	char name[256];
+	char num[32];
+	while (*p) {
+		if (!is_ident (*p)) {
+			p++;
+			continue;
+		}
+		const char *s = p;
+		while (is_ident (*p)) {
+			p++;
+		}
+		const size_t n = p - s;
+		if (isdigit ((ut8)*s) || n >= sizeof (name)) {
+			continue;
+		}
+		memcpy (name, s, n);
+		name[n] = 0;
+		const char *val = NULL;
+		const int id = bulk_label (ab, name, false);
+		if (id >= 0) {
+			ut64 v = bulk_label_value (ab, r_vector_at (&ab->labels, id), pc);
+			snprintf (num, sizeof (num), "0x%"PFMT64x, v);
+			val = num;
+		} else if (equs) {
+			val = ht_pp_find (equs, name, NULL);
+		}
+		if (val) {
+			if (!replaced) {
+				r_strbuf_set (&ab->sb, "");
+				replaced = true;
+			}
+			r_strbuf_append_n (&ab->sb, last, s - last);
+			r_strbuf_append (&ab->sb, val);
+			last = p;
+		}
+	}
+	st->refs |= replaced;
+	if (!replaced) {
+		return text;
+	}
+	r_strbuf_append (&ab->sb, last);
+	return r_strbuf_get (&ab->sb);
+}
+
+static void stmt_set(AsmStmt *st, int size, const ut8 *bytes, int blen) {
+	st->size = size;
+	if (size < 1) {
+		return;
+	}
+	ut8 *b = realloc (st->bytes, size);
+	if (!b) {
+		st->size = -1;
+		return;
+	}
+	st->bytes = b;
+	const int n = bytes? R_MIN (R_MAX (blen, 0), size): 0;
+	if (n > 0) {
+		memcpy (b, bytes, n);
+	}
+	memset (b + n, 0, size - n);
+}
+
+// drops the cached encodings when a directive changed the arch config
+static void bulk_check_config(AsmBulk *ab) {
+	RArchConfig *cfg = ab->a->config;
+	if (ab->bits == cfg->bits && ab->syntax == cfg->syntax && ab->endian == cfg->endian
+			&& !strcmp (r_str_get (ab->arch), r_str_get (cfg->arch))
+			&& !strcmp (r_str_get (ab->cpu), r_str_get (cfg->cpu))) {
+		return;
+	}
+	if (ab->cache) {
+		ht_pp_free (ab->cache);
+	}
+	ab->cache = ht_pp_new (NULL, htpp_freekv, NULL);
+	free (ab->arch);
+	free (ab->cpu);
+	ab->arch = cfg->arch? strdup (cfg->arch): NULL;
+	ab->cpu = cfg->cpu? strdup (cfg->cpu): NULL;
+	ab->bits = cfg->bits;
+	ab->syntax = cfg->syntax;
+	ab->endian = cfg->endian;
+}
+
+static void bulk_encode(AsmBulk *ab, AsmStmt *st, RAnalOp *op, const char *text) {
+	RAsm *a = ab->a;
+	AsmEnc *enc = ab->cache? ht_pp_find (ab->cache, text, NULL): NULL;
+	if (enc && !enc->pcdep) {
+		stmt_set (st, enc->size, enc->bytes, enc->size);
+		st->pcdep = false;
+		return;
+	}
+	const ut64 pc = a->pc;
+	int size = r_asm_assemble (a, op, text);
+	stmt_set (st, size, (size > 0)? op->bytes: NULL, op->size);
+	if (enc) {
+		st->pcdep = true;
+		return;
+	}
+	bool pcdep = false;
+	// texts without numbers can't refer to addresses
+	if (strpbrk (text, "0123456789")) {
+		r_asm_set_pc (a, pc + ASM_PCDELTA);
+		int size2 = r_asm_assemble (a, op, text);
+		r_asm_set_pc (a, pc);
+		pcdep = size2 != size || (size > 0 && (op->size < size || memcmp (op->bytes, st->bytes, size)));
+	}
+	st->pcdep = pcdep;
+	if (ab->cache && (enc = malloc (sizeof (AsmEnc) + R_MAX (size, 0)))) {
+		enc->size = size;
+		enc->pcdep = pcdep;
+		if (size > 0) {
+			memcpy (enc->bytes, st->bytes, size);
+		}
+		if (!ht_pp_insert (ab->cache, text, enc)) {
+			free (enc);
+		}
+	}
+}
+
+// runs the statements once, returns false on errors
+static bool bulk_pass(AsmBulk *ab, RAnalOp *op, ut64 pc, bool first) {
+	RAsm *a = ab->a;
+	RAsmCode *acode = ab->acode;
+	AsmLabel *l;
+	r_vector_foreach (&ab->labels, l) {
+		l->defined = l->fwdused = l->fwdbad = false;
+	}
+	ab->unstable = false;
+	r_asm_set_pc (a, pc);
+	bool failed = false;
+	AsmStmt *st;
+	r_vector_foreach (&ab->stmts, st) {
+		ut64 off = a->pc;
+		if (st->label >= 0) {
+			if (acode->code_align) {
+				off += (acode->code_align - (off % acode->code_align));
+			}
+			bulk_label_define (ab, r_vector_at (&ab->labels, st->label), off);
+		}
+		if (!st->text) {
+			continue;
+		}
+		if (st->directive) {
+			char *s = strdup (st->text);
+			if (!s) {
+				return false;
+			}
+			r_asm_op_fini (op);
+			r_asm_op_init (op);
+			int ret = parse_asm_directive (a, op, acode, s, &off);
+			free (s);
+			if (ret < 0) {
+				return false;
+			}
+			if (ret == 0) {
+				st->size = 0;
+				bulk_check_config (ab);
+				continue;
+			}
+			stmt_set (st, ret, op->bytes, op->size);
+		} else {
+			const bool subst = acode->equs || (r_vector_length (&ab->labels) > 0 && (first || st->refs));
+			const char *text = subst? bulk_subst (ab, st, a->pc): st->text;
+			const bool same = st->enc && !strcmp (st->enc, text) && (!st->pcdep || st->addr == a->pc);
+			if (!same) {
+				bulk_encode (ab, st, op, text);
+				if (st->enc != st->text) {
+					free (st->enc);
+				}
+				st->enc = (text == st->text)? st->text: strdup (text);
+				st->addr = a->pc;
+			}
+			if (st->size < 1) {
+				failed = true;
+				continue;
+			}
+		}
+		r_asm_set_pc (a, a->pc + st->size);
+	}
+	// equs defined after their use are only replaced in the next pass
+	if (failed && first && acode->equs) {
+		ab->unstable = true;
+	}
+	return true;
+}
+
 R_API RAsmCode *r_asm_massemble(RAsm *a, const char *assembly) {
-	int num, stage, ret, idx, ctr, i, linenum = 0;
+	int num, ctr, i, linenum = 0;
 	char *ptr = NULL, *ptr_start = NULL;
 	RAnalOp op = {0};
-	ut64 off, pc;
+	AsmBulk ab = {0};
+	ut64 pc;
 
 	char *buf_token = NULL;
 	size_t tokens_size = 32;
@@ -931,172 +1377,155 @@ R_API RAsmCode *r_asm_massemble(RAsm *a, const char *assembly) {
 		(x) == ',' || (x) == ';' || (x) == '[' || (x) == ']'|| \
 		(x) == '(' || (x) == ')' || (x) == '{' || (x) == '}')
 
-	/* Stage 0-2: Parse labels*/
-	/* Stage 3: Assemble */
-// XXX: stages must be dynamic. until all equs have been resolved
-#define STAGES 5
-	pc = a->pc;
+	ab.a = a;
+	ab.acode = acode;
+	r_vector_init (&ab.stmts, sizeof (AsmStmt), NULL, NULL);
+	r_vector_init (&ab.labels, sizeof (AsmLabel), NULL, NULL);
+	r_strbuf_init (&ab.sb);
+	ab.labelids = ht_pu_new0 ();
+	if (!ab.labelids) {
+		goto fail;
+	}
+	bulk_check_config (&ab);
+
+	/* Split the lines in statements */
+	// XXX TODO remove arch-specific hacks
+	const char *cur_arch = R_UNWRAP3 (a, config, arch);
+	const bool avr = cur_arch && r_str_startswith (cur_arch, "avr");
 	bool inComment = false;
-	for (stage = 0; stage < STAGES; stage++) {
-		if (stage < 2 && !labels) {
+	for (i = 0; i <= ctr; i++) {
+		buf_token = tokens[i];
+		if (inComment) {
+			if (strstr (buf_token, "*/")) {
+				inComment = false;
+			}
 			continue;
 		}
-		inComment = false;
-		r_asm_set_pc (a, pc);
-		linenum = 0;
-		for (idx = ret = i = 0, off = a->pc; i <= ctr; i++, idx += ret) {
-			buf_token = tokens[i];
-			if (!buf_token) {
-				continue;
-			}
-			if (inComment) {
-				if (r_str_startswith (ptr_start, "*/")) {
-					inComment = false;
-				}
-				continue;
-			}
-			// XXX TODO remove arch-specific hacks
-			const char *cur_arch = R_UNWRAP3 (a, config, arch);
-			if (cur_arch && r_str_startswith (cur_arch, "avr")) {
-				for (ptr_start = buf_token; *ptr_start && isavrseparator (*ptr_start); ptr_start++);
-			} else {
-				for (ptr_start = buf_token; *ptr_start && IS_SEPARATOR (*ptr_start); ptr_start++);
-			}
-			if (r_str_startswith (ptr_start, "/*")) {
-				if (!strstr (ptr_start + 2, "*/")) {
-					inComment = true;
-				}
-				continue;
-			}
-			/* Comments */
-			{
-				bool likely_comment = true;
-				char* cptr = strchr (ptr_start, ',');
-				ptr = strchr (ptr_start, '#');
-				// a comma is probably not followed by a comment
-				// 8051 often uses #symbol notation as 2nd arg
-				if (cptr && ptr && cptr < ptr) {
-					likely_comment = false;
-					for (cptr += 1; cptr < ptr ; cptr += 1) {
-						if (! isspace ((int) *cptr)) {
-							likely_comment = true;
-							break;
-						}
-					}
-				}
-				// # followed by number literal also
-				// isn't likely to be a comment
-				likely_comment = likely_comment && ptr
-					&& !R_BETWEEN ('0', ptr[1], '9')
-					&& ptr[1] != '-' ;
-				if (likely_comment) {
-					*ptr = '\0';
-				}
-			}
-			r_asm_set_pc (a, a->pc + ret);
-			off = a->pc;
-			ret = 0;
-			if (!*ptr_start) {
-				continue;
+		if (avr) {
+			for (ptr_start = buf_token; *ptr_start && isavrseparator (*ptr_start); ptr_start++);
+		} else {
+			for (ptr_start = buf_token; *ptr_start && IS_SEPARATOR (*ptr_start); ptr_start++);
+		}
+		if (r_str_startswith (ptr_start, "/*")) {
+			if (!strstr (ptr_start + 2, "*/")) {
+				inComment = true;
 			}
-			linenum++;
-			/* labels */
-			if (labels && (ptr = strchr (ptr_start, ':'))) {
-				bool is_a_label = true;
-				char *q = ptr_start;
-				while (*q) {
-					if (*q == ' ') {
-						is_a_label = false;
+			continue;
+		}
+		/* Comments */
+		{
+			bool likely_comment = true;
+			char* cptr = strchr (ptr_start, ',');
+			ptr = strchr (ptr_start, '#');
+			// a comma is probably not followed by a comment
+			// 8051 often uses #symbol notation as 2nd arg
+			if (cptr && ptr && cptr < ptr) {
+				likely_comment = false;
+				for (cptr += 1; cptr < ptr ; cptr += 1) {
+					if (! isspace ((int) *cptr)) {
+						likely_comment = true;
 						break;
 					}
-					q++;
-				}
-				if (is_a_label) {
-					//if (stage != 2) {
-					if (ptr_start[1] && ptr_start[1] != ' ') {
-						*ptr = 0;
-						char *p = strdup (ptr_start);
-						*ptr = ':';
-						if (acode->code_align) {
-							off += (acode->code_align - (off % acode->code_align));
-						}
-						char *food = r_str_newf ("0x%"PFMT64x, off);
-						if (food) {
-							ht_pp_insert (a->flags, ptr_start, food);
-							r_asm_code_set_equ (acode, p, food);
-							free (food);
-						}
-						free (p);
-					}
-					//}
-					ptr_start = ptr + 1;
 				}
-				ptr = ptr_start;
 			}
-			if (!*ptr_start) {
-				ret = 0;
-				continue;
+			// # followed by number literal also
+			// isn't likely to be a comment
+			likely_comment = likely_comment && ptr
+				&& !R_BETWEEN ('0', ptr[1], '9')
+				&& ptr[1] != '-' ;
+			if (likely_comment) {
+				*ptr = '\0';
 			}
-			if (*ptr_start == '.') { /* pseudo */
-				ret = parse_asm_directive (a, &op, acode, ptr_start, &off);
-				if (ret < 0) {
-					goto fail;
-				} else if (ret == 0) {
-					continue;
-				}
-			} else { /* Instruction */
-				char *str = ptr_start;
-				r_str_trim (str);
-				if (acode->equs) {
-					if (!*ptr_start) {
-						continue;
-					}
-					str = r_asm_code_equ_replace (acode, strdup (ptr_start));
-					ret = r_asm_assemble (a, &op, str);
-					free (str);
-				} else {
-					if (!*ptr_start) {
-						continue;
-					}
-					char *arg = strdup (ptr_start);
-					ret = r_asm_assemble (a, &op, arg);
-					free (arg);
-				}
+		}
+		if (!*ptr_start) {
+			continue;
+		}
+		linenum++;
+		AsmStmt st = { .label = -1, .line = linenum };
+		/* labels */
+		if (labels && (ptr = strchr (ptr_start, ':')) && !strchr (ptr_start, ' ')) {
+			if (ptr_start[1] && ptr_start[1] != ' ') {
+				*ptr = 0;
+				st.label = bulk_label (&ab, ptr_start, true);
 			}
-			if (stage == STAGES - 1) {
-				if (ret < 1) {
-					R_LOG_ERROR ("Cannot assemble '%s' at line %d", ptr_start, linenum);
-					goto fail;
-				}
-				acode->len = idx + ret;
-				char *newbuf = realloc (acode->bytes, (idx + ret) * 2);
-				if (!newbuf) {
-					goto fail;
-				}
-				acode->bytes = (ut8*)newbuf;
-				if (op.size > 0) {
-					memcpy (acode->bytes + idx, op.bytes, op.size);
-				}
-				memset (acode->bytes + idx + ret, 0, idx + ret);
-#if 0
-				if (op.buf_inc && r_buf_size (op.buf_inc) > 1) {
-					char *inc = r_buf_tostring (op.buf_inc);
-					r_buf_free (op.buf_inc);
-					op.buf_inc = NULL;
-					if (inc) {
-						ret += r_hex_str2bin (inc, acode->bytes + idx + ret);
-						free (inc);
-					}
-				}
-#endif
+			ptr_start = ptr + 1;
+		}
+		r_str_trim (ptr_start);
+		if (*ptr_start) {
+			st.text = ptr_start;
+			st.directive = *ptr_start == '.';
+		} else if (st.label < 0) {
+			continue;
+		}
+		if (!r_vector_push (&ab.stmts, &st)) {
+			goto fail;
+		}
+	}
+
+	/* Assemble until the labels don't move */
+	pc = a->pc;
+	int pass;
+	for (pass = 0; pass < ASM_MAXPASSES; pass++) {
+		if (!bulk_pass (&ab, &op, pc, pass == 0)) {
+			goto fail;
+		}
+		if (!ab.unstable) {
+			break;
+		}
+	}
+	if (pass == ASM_MAXPASSES) {
+		// the sizes still change, the bytes would encode stale label addresses
+		R_LOG_ERROR ("The label addresses did not converge after %d passes", pass);
+		goto fail;
+	}
+
+	/* Write the output */
+	size_t len = 0;
+	AsmStmt *st;
+	r_vector_foreach (&ab.stmts, st) {
+		if (st->text && !st->directive && st->size < 1) {
+			R_LOG_ERROR ("Cannot assemble '%s' at line %d", st->text, st->line);
+			goto fail;
+		}
+		if (st->size > 0) {
+			len += st->size;
+			if (len > ST32_MAX) {
+				R_LOG_ERROR ("Assembled code is too big");
+				goto fail;
+			}
+		}
+	}
+	ut8 *bytes = calloc (len + 1, 1);
+	if (!bytes) {
+		goto fail;
+	}
+	free (acode->bytes);
+	acode->bytes = bytes;
+	acode->len = (int)len;
+	r_vector_foreach (&ab.stmts, st) {
+		if (st->size > 0) {
+			memcpy (bytes, st->bytes, st->size);
+			bytes += st->size;
+		}
+	}
+	AsmLabel *l;
+	r_vector_foreach (&ab.labels, l) {
+		if (l->defined) {
+			char *food = r_str_newf ("0x%"PFMT64x, l->addr);
+			if (food) {
+				ht_pp_insert (a->flags, l->name, food);
+				r_asm_code_set_equ (acode, l->name, food);
+				free (food);
 			}
 		}
 	}
+	bulk_fini (&ab);
 	free (lbuf);
 	free (tokens);
 	r_asm_op_fini (&op);
 	return acode;
 fail:
+	bulk_fini (&ab);
 	free (lbuf);
 	free (tokens);
 	r_asm_op_fini (&op);
@@ -604,3 +604,93 @@ R_API char *r_asm_parse_filter(RAsm *a, ut64 addr, RFlag *f, RAnalHint *hint, co
 	}
 	return str;
 }
+
+typedef struct {
+	ut64 val;
+	ut32 insn;
+} FilterValue;
+
+static int filter_value_cmp(const void *a, const void *b) {
+	const FilterValue *va = a, *vb = b;
+	return (va->val > vb->val) - (va->val < vb->val);
+}
+
+// collects the numbers of the text that filter() looks up
+static void filter_values(RVector *vals, ut32 insn, const char *text, ut64 minval) {
+	char *ptr = (char *)text;
+	char *nptr;
+	while ((nptr = findNextNumber (ptr))) {
+		FilterValue v = { r_num_get (NULL, nptr), insn };
+		if (v.val >= minval) {
+			r_vector_push (vals, &v);
+		}
+		ptr = nptr + 1;
+		while (*ptr == 'x' || IS_HEXCHAR (*ptr)) {
+			ptr++;
+		}
+	}
+}
+
+/* Same as calling r_asm_parse_filter() on every instruction of the batch,
+ * without hints. The numbers of all the texts are sorted first, so each
+ * distinct value is resolved to a flag or function once, and only the texts
+ * referencing any of them are filtered */
+R_API void r_asm_batch_filter(RAsmBatch *b, RFlag *f) {
+	R_RETURN_IF_FAIL (b && f);
+	RAsm *a = b->a;
+	RParse *p = a->parse;
+	RAnal *anal = a->analb.anal;
+	if (!p || !anal || !p->flag_get || !a->analb.get_fcn_in) {
+		return;
+	}
+	const ut32 n = r_vector_length (&b->insns);
+	bool *todo = R_NEWS0 (bool, R_MAX (n, 1));
+	if (!todo) {
+		return;
+	}
+	ut32 i;
+	const char *pname = R_UNWRAP4 (a, cur, plugin, meta.name);
+	const bool x86seg = pname && r_str_startswith (pname, "x86") && anal->config->bits == 16;
+	RAsmPlugin *ap = R_UNWRAP3 (a, cur, plugin);
+	if (p->subreg || p->subtail || x86seg || (ap && ap->filter)) {
+		// the texts change even when there are no flags
+		memset (todo, 1, n);
+	} else {
+		RVector vals;
+		r_vector_init (&vals, sizeof (FilterValue), NULL, NULL);
+		for (i = 0; i < n; i++) {
+			RAsmInsn *insn = r_vector_at (&b->insns, i);
+			filter_values (&vals, i, r_asm_batch_text (b, insn), p->minval);
+		}
+		qsort (vals.a, vals.len, sizeof (FilterValue), filter_value_cmp);
+		const ut32 nvals = r_vector_length (&vals);
+		bool resolved = false;
+		for (i = 0; i < nvals; i++) {
+			FilterValue *v = r_vector_at (&vals, i);
+			if (!i || v->val != ((FilterValue *)r_vector_at (&vals, i - 1))->val) {
+				resolved = a->analb.get_fcn_in (anal, v->val, 0)
+					|| p->flag_get (f, false, v->val);
+			}
+			if (resolved) {
+				todo[v->insn] = true;
+			}
+		}
+		r_vector_fini (&vals);
+	}
+	// the address of the last disassembled instruction doesn't apply here
+	const ut64 subrel_addr = p->subrel_addr;
+	p->subrel_addr = 0;
+	for (i = 0; i < n; i++) {
+		if (!todo[i]) {
+			continue;
+		}
+		RAsmInsn *insn = r_vector_at (&b->insns, i);
+		char *res = r_asm_parse_filter (a, insn->addr, f, NULL, r_asm_batch_text (b, insn));
+		if (res && strcmp (res, r_asm_batch_text (b, insn))) {
+			r_asm_batch_set_text (b, insn, res);
+		}
+		free (res);
+	}
+	p->subrel_addr = subrel_addr;
+	free (todo);
+}
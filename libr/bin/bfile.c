@@ -822,6 +822,8 @@ R_API void r_bin_file_free(void /*RBinFile*/ *_bf) {
 		sdb_free (bf->sdb_addrinfo);
 		bf->sdb_addrinfo = NULL;
 	}
+	r_bin_dwarf_line_index_free (bf->addrinfo_priv);
+	bf->addrinfo_priv = NULL;
 	free (bf->file);
 	r_bin_object_free (bf->bo);
 	r_list_free (bf->xtr_data);
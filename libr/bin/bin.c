@@ -349,6 +349,9 @@ R_API bool r_bin_open_io(RBin *bin, RBinFileOptions *opt) {
 	if (is_debugger) {
 		buf = r_buf_new_file (fname, O_RDONLY, 0);
 		is_debugger = false;
+	} else if (bin->use_mmap && r_file_is_regular (fname)) {
+		// parsers can borrow tables straight from the mapping with r_buf_view
+		buf = r_buf_new_mmap (fname, R_PERM_R);
 	}
 	if (!buf) {
 		buf = r_buf_new_with_io (&bin->iob, opt->fd);
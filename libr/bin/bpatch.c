@@ -0,0 +1,189 @@
+/* radare - LGPL - Copyright 2024 - pancake */
+
+#include <r_bin.h>
+
+// patches closer than this are written in the same io operation
+#define PATCH_GAP 32
+// but never write more than this in one go
+#define PATCH_RUN_MAX 0x1000
+
+R_API void r_bin_patch_batch_init(RBinPatchBatch *pb, RIOBind *iob) {
+	R_RETURN_IF_FAIL (pb && iob);
+	pb->iob = iob;
+	r_vector_init (&pb->patches, sizeof (RBinPatch), NULL, NULL);
+	pb->last = ht_uu_new0 ();
+}
+
+R_API void r_bin_patch_batch_fini(RBinPatchBatch *pb) {
+	R_RETURN_IF_FAIL (pb);
+	r_vector_fini (&pb->patches);
+	ht_uu_free (pb->last);
+	pb->last = NULL;
+}
+
+// queue a write of up to 8 bytes, nothing reaches the io until flush
+R_API bool r_bin_patch_batch_add(RBinPatchBatch *pb, ut64 addr, const ut8 *data, int size) {
+	R_RETURN_VAL_IF_FAIL (pb && pb->last && data, false);
+	if (size < 1 || size > 8) {
+		return false;
+	}
+	RBinPatch p = {
+		.addr = addr,
+		.seq = (ut32)r_vector_length (&pb->patches),
+		.prev = UT32_MAX,
+		.size = size,
+	};
+	bool found = false;
+	ut64 last = ht_uu_find (pb->last, addr, &found);
+	if (found) {
+		p.prev = (ut32)last;
+	}
+	memcpy (p.data, data, size);
+	if (!r_vector_push (&pb->patches, &p)) {
+		return false;
+	}
+	ht_uu_update (pb->last, addr, p.seq);
+	return true;
+}
+
+static int patch_seq_cmp(const void *a, const void *b) {
+	const RBinPatch *pa = *(const RBinPatch **)a;
+	const RBinPatch *pb = *(const RBinPatch **)b;
+	return (pa->seq > pb->seq) - (pa->seq < pb->seq);
+}
+
+static void patch_apply(const RBinPatch *p, ut64 addr, ut8 *buf, int len) {
+	ut64 from = R_MAX (p->addr, addr);
+	ut64 to = R_MIN (p->addr + p->size, addr + len);
+	if (from < to) {
+		memcpy (buf + (from - addr), p->data + (from - p->addr), to - from);
+	}
+}
+
+// read through the io as if all the queued patches were already written
+R_API bool r_bin_patch_batch_read(RBinPatchBatch *pb, ut64 addr, ut8 *buf, int len) {
+	R_RETURN_VAL_IF_FAIL (pb && pb->last && buf, false);
+	if (len < 1) {
+		return false;
+	}
+	bool res = pb->iob->read_at (pb->iob->io, addr, buf, len);
+	if (r_vector_empty (&pb->patches)) {
+		return res;
+	}
+	RPVector hits;
+	r_pvector_init (&hits, NULL);
+	ut64 at = (addr > 7)? addr - 7: 0;
+	for (; at < addr + len; at++) {
+		bool found = false;
+		ut64 idx = ht_uu_find (pb->last, at, &found);
+		while (found && idx != UT32_MAX) {
+			RBinPatch *p = r_vector_index_ptr (&pb->patches, idx);
+			r_pvector_push (&hits, p);
+			idx = p->prev;
+		}
+	}
+	if (r_pvector_length (&hits) > 1) {
+		qsort (hits.v.a, r_pvector_length (&hits), sizeof (void *), patch_seq_cmp);
+	}
+	void **it;
+	r_pvector_foreach (&hits, it) {
+		patch_apply (*it, addr, buf, len);
+	}
+	r_pvector_fini (&hits);
+	return res;
+}
+
+static int patch_addr_cmp(const void *a, const void *b) {
+	const RBinPatch *pa = a;
+	const RBinPatch *pb = b;
+	if (pa->addr != pb->addr) {
+		return (pa->addr > pb->addr)? 1: -1;
+	}
+	return (pa->seq > pb->seq) - (pa->seq < pb->seq);
+}
+
+// writes the patches of a run, only the range that really changes is written
+static bool patch_run_write(RBinPatchBatch *pb, RBinPatch *run, size_t count, int *writes) {
+	const ut64 from = run[0].addr;
+	ut64 to = from;
+	size_t i;
+	for (i = 0; i < count; i++) {
+		to = R_MAX (to, run[i].addr + run[i].size);
+	}
+	const int len = (int)(to - from);
+	ut8 *orig = malloc (len);
+	ut8 *data = malloc (len);
+	if (!orig || !data) {
+		free (orig);
+		free (data);
+		return false;
+	}
+	pb->iob->read_at (pb->iob->io, from, orig, len);
+	memcpy (data, orig, len);
+	RBinPatch **byseq = R_NEWS (RBinPatch *, count);
+	if (!byseq) {
+		free (orig);
+		free (data);
+		return false;
+	}
+	for (i = 0; i < count; i++) {
+		byseq[i] = &run[i];
+	}
+	// overlapping patches must land in the order they were queued
+	qsort (byseq, count, sizeof (RBinPatch *), patch_seq_cmp);
+	for (i = 0; i < count; i++) {
+		patch_apply (byseq[i], from, data, len);
+	}
+	free (byseq);
+	int lo = 0, hi = len;
+	while (lo < hi && data[lo] == orig[lo]) {
+		lo++;
+	}
+	while (hi > lo && data[hi - 1] == orig[hi - 1]) {
+		hi--;
+	}
+	bool res = true;
+	if (lo < hi) {
+		res = pb->iob->overlay_write_at (pb->iob->io, from + lo, data + lo, hi - lo);
+		if (!res) {
+			R_LOG_WARN ("cannot write relocs at 0x%"PFMT64x, from + lo);
+		}
+		(*writes)++;
+	}
+	free (orig);
+	free (data);
+	return res;
+}
+
+// coalesce the queued patches into runs of nearby addresses and write each
+// run with a single io operation. returns the amount of writes performed
+R_API int r_bin_patch_batch_flush(RBinPatchBatch *pb) {
+	R_RETURN_VAL_IF_FAIL (pb && pb->last, 0);
+	const size_t count = r_vector_length (&pb->patches);
+	int writes = 0;
+	if (count > 0) {
+		RBinPatch *patches = pb->patches.a;
+		qsort (patches, count, sizeof (RBinPatch), patch_addr_cmp);
+		size_t i, start = 0;
+		ut64 end = patches[0].addr + patches[0].size;
+		for (i = 1; i <= count; i++) {
+			if (i < count) {
+				const RBinPatch *p = &patches[i];
+				const ut64 pend = R_MAX (end, p->addr + p->size);
+				if (p->addr <= end + PATCH_GAP && pend - patches[start].addr <= PATCH_RUN_MAX) {
+					end = pend;
+					continue;
+				}
+			}
+			patch_run_write (pb, patches + start, i - start, &writes);
+			if (i < count) {
+				start = i;
+				end = patches[i].addr + patches[i].size;
+			}
+		}
+	}
+	r_vector_clear (&pb->patches);
+	ht_uu_free (pb->last);
+	pb->last = ht_uu_new0 ();
+	return writes;
+}
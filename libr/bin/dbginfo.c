@@ -17,6 +17,18 @@ static void r_bin_dbgitem_free(RBinDbgItem *di) {
 
 // R2_600 - make this api public
 static RBinDbgItem *r_bin_dbgitem_at(RBin *bin, ut64 addr) {
+	RBinDwarfLineIndex *li = bin->cur->addrinfo_priv;
+	if (li) {
+		const RBinDwarfLineAddr *row = r_bin_dwarf_line_index_at (bin, li, addr);
+		if (row) {
+			RBinDbgItem *di = R_NEW0 (RBinDbgItem);
+			di->address = addr;
+			di->file = strdup (row->file);
+			di->line = row->line;
+			di->column = row->column;
+			return di;
+		}
+	}
 	r_strf_var (key, 64, "0x%"PFMT64x, addr); // TODO: use sdb_itoa because its faster
 	char *data = sdb_get (bin->cur->sdb_addrinfo, key, 0);
 	if (data) {
@@ -44,6 +56,15 @@ static RBinDbgItem *r_bin_dbgitem_at(RBin *bin, ut64 addr) {
 	return NULL;
 }
 
+// the lazy dwarf line index keeps the rows out of the addrinfo sdb, this
+// must be called before walking all the entries of bin->cur->sdb_addrinfo
+R_API void r_bin_addrinfo_load(RBin *bin) {
+	R_RETURN_IF_FAIL (bin);
+	if (bin->cur && bin->cur->addrinfo_priv) {
+		r_bin_dwarf_line_index_fill (bin, bin->cur->addrinfo_priv);
+	}
+}
+
 // XXX this is an useless wrapper
 static bool addr2line_from_sdb(RBin *bin, ut64 addr, char *file, int len, int *line, int *column) {
 	R_RETURN_VAL_IF_FAIL (bin, false);
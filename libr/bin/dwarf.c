@@ -1206,7 +1206,45 @@ static inline void add_sdb_addrline(Sdb *s, ut64 addr, const char *file, ut64 li
 	free (fileline);
 }
 
-static const ut8 *parse_ext_opcode(RBin *bin, const ut8 *obuf, size_t len, const RBinDwarfLineHeader *hdr, RBinDwarfSMRegisters *regs, int mode) {
+static void line_index_add(RBinDwarfLineIndex *li, ut64 addr, const char *file, ut64 line, ut64 column) {
+	if (R_STR_ISEMPTY (file)) {
+		return;
+	}
+	if (li->rows_count == li->rows_capacity) {
+		size_t cap = li->rows_capacity? li->rows_capacity * 2: 1024;
+		RBinDwarfLineAddr *rows = realloc (li->rows, cap * sizeof (RBinDwarfLineAddr));
+		if (!rows) {
+			return;
+		}
+		li->rows = rows;
+		li->rows_capacity = cap;
+	}
+	RBinDwarfLineAddr *row = &li->rows[li->rows_count++];
+	row->addr = addr;
+	row->file = r_str_constpool_get (&li->files, file);
+	row->line = (ut32)line;
+	row->column = (ut32)column;
+}
+
+// emit a row of the line number matrix, either into the lazy index or into the addrinfo sdb
+static void add_line_row(RBinFile *binfile, const RBinDwarfLineHeader *hdr, const RBinDwarfSMRegisters *regs, RBinDwarfLineIndex *li, int mode, PrintfCallback print) {
+	if (!binfile || !hdr->file_names) {
+		return;
+	}
+	int fnidx = regs->file;
+	if (fnidx < 0 || fnidx >= hdr->file_names_count) {
+		return;
+	}
+	const char *file = hdr->file_names[fnidx].name;
+	if (li) {
+		line_index_add (li, regs->address, file, regs->line, regs->column);
+	} else if (binfile->sdb_addrinfo) {
+		add_sdb_addrline (binfile->sdb_addrinfo, regs->address,
+			file, regs->line, regs->column, mode, print);
+	}
+}
+
+static const ut8 *parse_ext_opcode(RBin *bin, const ut8 *obuf, size_t len, const RBinDwarfLineHeader *hdr, RBinDwarfSMRegisters *regs, RBinDwarfLineIndex *li, int mode) {
 	R_RETURN_VAL_IF_FAIL (bin && bin->cur && obuf && hdr && regs, NULL);
 
 	const bool be = r_bin_is_big_endian (bin);
@@ -1234,14 +1272,9 @@ static const ut8 *parse_ext_opcode(RBin *bin, const ut8 *obuf, size_t len, const
 	switch (opcode) {
 	case DW_LNE_end_sequence:
 		regs->end_sequence = true;
-
-		if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
-			int fnidx = regs->file;
-			if (fnidx >= 0 && fnidx < hdr->file_names_count) {
-				add_sdb_addrline (binfile->sdb_addrinfo, regs->address,
-						hdr->file_names[fnidx].name,
-						regs->line, regs->column, mode, print);
-			}
+		// the end of sequence address is past the last instruction, dont index it
+		if (!li) {
+			add_line_row (binfile, hdr, regs, NULL, mode, print);
 		}
 
 		if (mode == R_MODE_PRINT) {
@@ -1303,7 +1336,7 @@ static const ut8 *parse_ext_opcode(RBin *bin, const ut8 *obuf, size_t len, const
 static const ut8 *parse_spec_opcode(
 	const RBin *bin, const ut8 *obuf, size_t len,
 	const RBinDwarfLineHeader *hdr,
-	RBinDwarfSMRegisters *regs,
+	RBinDwarfSMRegisters *regs, RBinDwarfLineIndex *li,
 	ut8 opcode, int mode) {
 
 	R_RETURN_VAL_IF_FAIL (bin && obuf && hdr && regs, NULL);
@@ -1328,14 +1361,7 @@ static const ut8 *parse_spec_opcode(
 		print ("advance Address by %"PFMT64d " to 0x%"PFMT64x" and Line by %d to %"PFMT64d"\n",
 			advance_adr, regs->address, line_increment, regs->line);
 	}
-	if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
-		int idx = regs->file;
-		if (idx >= 0 && idx < hdr->file_names_count) {
-			add_sdb_addrline (binfile->sdb_addrinfo, regs->address,
-					hdr->file_names[idx].name,
-					regs->line, regs->column, mode, print);
-		}
-	}
+	add_line_row (binfile, hdr, regs, li, mode, print);
 	regs->basic_block = false;
 	regs->prologue_end = false;
 	regs->epilogue_begin = false;
@@ -1344,7 +1370,7 @@ static const ut8 *parse_spec_opcode(
 	return buf;
 }
 
-static const ut8 *parse_std_opcode(RBin *bin, const ut8 *obuf, size_t len, const RBinDwarfLineHeader *hdr, RBinDwarfSMRegisters *regs, ut8 opcode, int mode) {
+static const ut8 *parse_std_opcode(RBin *bin, const ut8 *obuf, size_t len, const RBinDwarfLineHeader *hdr, RBinDwarfSMRegisters *regs, RBinDwarfLineIndex *li, ut8 opcode, int mode) {
 	R_RETURN_VAL_IF_FAIL (bin && bin->cur && obuf && hdr && regs, NULL);
 	bool be = r_bin_is_big_endian (bin);
 
@@ -1366,15 +1392,7 @@ static const ut8 *parse_std_opcode(RBin *bin, const ut8 *obuf, size_t len, const
 		if (mode == R_MODE_PRINT) {
 			print ("Copy\n");
 		}
-		if (binfile && binfile->sdb_addrinfo && hdr->file_names) {
-			int fnidx = regs->file;
-			if (fnidx >= 0 && fnidx < hdr->file_names_count) {
-				add_sdb_addrline (binfile->sdb_addrinfo,
-					regs->address,
-					hdr->file_names[fnidx].name,
-					regs->line, regs->column, mode, print);
-			}
-		}
+		add_line_row (binfile, hdr, regs, li, mode, print);
 		regs->basic_block = false;
 		break;
 	case DW_LNS_advance_pc:
@@ -1480,7 +1498,7 @@ static void set_regs_default(const RBinDwarfLineHeader *hdr, RBinDwarfSMRegister
 }
 
 // Passing bin should be unnecessary (after we stop printing inside bin_dwarf)
-static size_t parse_opcodes(RBin *bin, const ut8 *obuf, size_t len, const RBinDwarfLineHeader *hdr, RBinDwarfSMRegisters *regs, int mode) {
+static size_t parse_opcodes(RBin *bin, const ut8 *obuf, size_t len, const RBinDwarfLineHeader *hdr, RBinDwarfSMRegisters *regs, RBinDwarfLineIndex *li, int mode) {
 	R_RETURN_VAL_IF_FAIL (bin && obuf, 0);
 	ut8 opcode, ext_opcode;
 
@@ -1495,15 +1513,15 @@ static size_t parse_opcodes(RBin *bin, const ut8 *obuf, size_t len, const RBinDw
 		len--;
 		if (!opcode) {
 			ext_opcode = *buf;
-			buf = parse_ext_opcode (bin, buf, len, hdr, regs, mode);
+			buf = parse_ext_opcode (bin, buf, len, hdr, regs, li, mode);
 			if (!buf || ext_opcode == DW_LNE_end_sequence) {
 				set_regs_default (hdr, regs); // end_sequence should reset regs to default
 				break;
 			}
 		} else if (opcode >= hdr->opcode_base) {
-			buf = parse_spec_opcode (bin, buf, len, hdr, regs, opcode, mode);
+			buf = parse_spec_opcode (bin, buf, len, hdr, regs, li, opcode, mode);
 		} else {
-			buf = parse_std_opcode (bin, buf, len, hdr, regs, opcode, mode);
+			buf = parse_std_opcode (bin, buf, len, hdr, regs, li, opcode, mode);
 		}
 		len = (size_t)(buf_end - buf);
 	}
@@ -1575,7 +1593,7 @@ static bool parse_line_raw(RBin *a, const ut8 *obuf, ut64 len, int mode, bool be
 		// we read the whole compilation unit (that might be composed of more sequences)
 		do {
 			// reads one whole sequence
-			tmp_read = parse_opcodes (a, buf, buf_end - buf, &hdr, &regs, mode);
+			tmp_read = parse_opcodes (a, buf, buf_end - buf, &hdr, &regs, NULL, mode);
 			bytes_read += tmp_read;
 			buf += tmp_read; // Move in the buffer forward
 		} while (bytes_read < buf_size && tmp_read != 0); // if nothing is read -> error, exit
@@ -2845,6 +2863,394 @@ R_API RBinDwarfDebugAbbrev *r_bin_dwarf_parse_abbrev(RBin *bin, int mode) {
 	return abbrevs;
 }
 
+/* lazy line index */
+
+static int cu_range_cmp(const void *a, const void *b) {
+	const RBinDwarfCURange *x = a;
+	const RBinDwarfCURange *y = b;
+	if (x->offset != y->offset) {
+		return (x->offset < y->offset)? -1: 1;
+	}
+	return 0;
+}
+
+// known ranges sorted by their start, the units without a range go last
+static int cu_lo_cmp(const void *a, const void *b) {
+	const RBinDwarfCURange *x = a;
+	const RBinDwarfCURange *y = b;
+	const bool xknown = x->lo < x->hi;
+	const bool yknown = y->lo < y->hi;
+	if (xknown != yknown) {
+		return xknown? -1: 1;
+	}
+	if (xknown && x->lo != y->lo) {
+		return (x->lo < y->lo)? -1: 1;
+	}
+	if (x->offset != y->offset) {
+		return (x->offset < y->offset)? -1: 1;
+	}
+	return 0;
+}
+
+static int line_addr_cmp(const void *a, const void *b) {
+	const RBinDwarfLineAddr *x = a;
+	const RBinDwarfLineAddr *y = b;
+	if (x->addr != y->addr) {
+		return (x->addr < y->addr)? -1: 1;
+	}
+	if (x->line != y->line) {
+		return (x->line < y->line)? -1: 1;
+	}
+	return 0;
+}
+
+static inline ut64 rebase_addr(RBinObject *o, ut64 addr) {
+	if (o && o->baddr && o->baddr != UT64_MAX && addr < o->baddr) {
+		return addr + o->baddr;
+	}
+	return addr;
+}
+
+static void index_add_cu(RBinDwarfLineIndex *li, size_t *capacity, RBinDwarfCURange *cu) {
+	if (li->cus_count == *capacity) {
+		size_t cap = *capacity? *capacity * 2: 64;
+		RBinDwarfCURange *cus = realloc (li->cus, cap * sizeof (RBinDwarfCURange));
+		if (!cus) {
+			return;
+		}
+		li->cus = cus;
+		*capacity = cap;
+	}
+	li->cus[li->cus_count++] = *cu;
+}
+
+// reads only the unit DIE of every compilation unit to get its line program and address range
+static void index_comp_units(RBin *bin, RBinDwarfLineIndex *li, RBinDwarfDebugAbbrev *da) {
+	RBinSection *section = getsection (bin, DWARF_SN_INFO);
+	RBinFile *bf = bin->cur;
+	if (!section || !bf) {
+		return;
+	}
+	const bool be = r_bin_is_big_endian (bin);
+	size_t capacity = 0;
+	ut8 tmp[1024];
+	ut64 off = 0;
+	while (off + 11 < section->size) {
+		size_t toread = R_MIN (sizeof (tmp), section->size - off);
+		if (r_buf_read_at (bf->buf, section->paddr + off, tmp, toread) != toread) {
+			break;
+		}
+		const ut8 *buf_end = tmp + toread;
+		RBinDwarfCompUnitHdr hdr = {0};
+		hdr.unit_offset = off;
+		const ut8 *buf = info_comp_unit_read_hdr (tmp, buf_end, &hdr, be);
+		ut64 next = off + hdr.length + (hdr.is_64bit? 12: 4);
+		if (!hdr.length || next <= off || next > section->size) {
+			break;
+		}
+		RBinDwarfAbbrevDecl key = { .offset = hdr.abbrev_offset };
+		RBinDwarfAbbrevDecl *abbrev_start = bsearch (&key, da->decls, da->count, sizeof (key), abbrev_cmp);
+		ut64 abbr_code = 0;
+		const ut8 *nbuf = (abbrev_start && buf < buf_end)
+			? r_uleb128 (buf, buf_end - buf, &abbr_code, NULL): NULL;
+		size_t first_abbr_idx = abbrev_start? abbrev_start - da->decls: 0;
+		if (nbuf && abbr_code && first_abbr_idx + abbr_code <= da->count) {
+			RBinDwarfAbbrevDecl *abbrev = &da->decls[first_abbr_idx + abbr_code - 1];
+			RBinDwarfDie die = {0};
+			if (init_die (&die, abbr_code, abbrev->count)) {
+				parse_die (bin, nbuf, buf_end, abbrev, &hdr, &die, bf->sdb_addrinfo, be);
+				RBinDwarfCURange cu = { .offset = off, .stmt_list = UT64_MAX, .lo = UT64_MAX, .hi = 0 };
+				const RBinDwarfAttrValue *high = NULL;
+				ut64 low = UT64_MAX;
+				size_t i;
+				for (i = 0; i < die.count; i++) {
+					const RBinDwarfAttrValue *val = &die.attr_values[i];
+					switch (val->attr_name) {
+					case DW_AT_stmt_list:
+						cu.stmt_list = val->reference;
+						break;
+					case DW_AT_low_pc:
+						low = val->address;
+						break;
+					case DW_AT_high_pc:
+						high = val;
+						break;
+					}
+				}
+				if (low != UT64_MAX && high) {
+					ut64 hi = (high->kind == DW_AT_KIND_ADDRESS)? high->address: low + high->uconstant;
+					if (hi > low) {
+						cu.lo = rebase_addr (bf->bo, low);
+						cu.hi = rebase_addr (bf->bo, hi);
+					}
+				}
+				if (cu.stmt_list != UT64_MAX) {
+					index_add_cu (li, &capacity, &cu);
+				}
+				free_die (&die);
+			}
+		}
+		off = next;
+	}
+}
+
+// refine the unit ranges with .debug_aranges when available
+static void index_aranges(RBin *bin, RBinDwarfLineIndex *li) {
+	size_t len = 0;
+	ut8 *obuf = get_section_bytes (bin, DWARF_SN_ARANGES, &len);
+	if (!obuf) {
+		return;
+	}
+	RBinObject *o = R_UNWRAP3 (bin, cur, bo);
+	const bool be = r_bin_is_big_endian (bin);
+	const ut8 *buf = obuf;
+	const ut8 *buf_end = obuf + len;
+	while (buf + 16 <= buf_end) {
+		const ut8 *start = buf;
+		bool is_64bit = false;
+		ut64 unit_length = READ32 (buf);
+		if (unit_length == DWARF_INIT_LEN_64) {
+			unit_length = READ64 (buf);
+			is_64bit = true;
+		}
+		if (unit_length < 1 || unit_length > (ut64)(buf_end - buf)) {
+			break;
+		}
+		const ut8 *next = buf + unit_length;
+		buf += 2; // version
+		ut64 info_offset = dwarf_read_offset (is_64bit, &buf, buf_end, be);
+		ut8 address_size = READ8 (buf);
+		ut8 segment_size = READ8 (buf);
+		if (address_size != 4 && address_size != 8) {
+			buf = next;
+			continue;
+		}
+		// the first tuple is aligned to the tuple size
+		size_t tuple = 2 * address_size;
+		size_t hdrsz = buf - start;
+		buf += (tuple - (hdrsz % tuple)) % tuple;
+		RBinDwarfCURange key = { .offset = info_offset };
+		RBinDwarfCURange *cu = bsearch (&key, li->cus, li->cus_count, sizeof (key), cu_range_cmp);
+		while (buf + segment_size + tuple <= next) {
+			buf += segment_size;
+			ut64 addr = dwarf_read_address (address_size, &buf, buf_end, be);
+			ut64 size = dwarf_read_address (address_size, &buf, buf_end, be);
+			if (!addr && !size) {
+				break;
+			}
+			if (cu && size) {
+				addr = rebase_addr (o, addr);
+				cu->lo = R_MIN (cu->lo, addr);
+				cu->hi = R_MAX (cu->hi, addr + size);
+			}
+		}
+		buf = next;
+	}
+	free (obuf);
+}
+
+static void line_index_parse_unit(RBin *bin, RBinDwarfLineIndex *li, ut64 stmt_list) {
+	RBinSection *section = getsection (bin, DWARF_SN_LINE);
+	RBinFile *bf = bin->cur;
+	if (!section || !bf || stmt_list + 4 >= section->size) {
+		return;
+	}
+	const bool be = r_bin_is_big_endian (bin);
+	ut8 lbuf[12] = {0};
+	size_t toread = R_MIN (sizeof (lbuf), section->size - stmt_list);
+	if (r_buf_read_at (bf->buf, section->paddr + stmt_list, lbuf, toread) != toread) {
+		return;
+	}
+	ut64 size = r_read_ble32 (lbuf, be);
+	size = (size == DWARF_INIT_LEN_64)? r_read_ble64 (lbuf + 4, be) + 12: size + 4;
+	if (size > section->size - stmt_list || size > ST32_MAX) {
+		return;
+	}
+	ut8 *obuf = malloc (size);
+	if (!obuf) {
+		return;
+	}
+	if (r_buf_read_at (bf->buf, section->paddr + stmt_list, obuf, size) != size) {
+		free (obuf);
+		return;
+	}
+	const ut8 *buf_end = obuf + size;
+	RBinDwarfLineHeader hdr = {0};
+	const ut8 *buf = parse_line_header (bin, bf, obuf, buf_end, &hdr, R_MODE_SET, bin->cb_printf, (int)stmt_list, be);
+	if (buf) {
+		RBinDwarfSMRegisters regs;
+		set_regs_default (&hdr, &regs);
+		size_t n;
+		do {
+			n = parse_opcodes (bin, buf, buf_end - buf, &hdr, &regs, li, R_MODE_SET);
+			buf += n;
+		} while (n && buf < buf_end);
+	}
+	line_header_fini (&hdr);
+	free (obuf);
+}
+
+// sort the rows appended after `old` and merge them with the already sorted ones
+static void line_index_merge(RBinDwarfLineIndex *li, size_t old) {
+	RBinDwarfLineAddr *rows = li->rows;
+	const size_t count = li->rows_count;
+	if (count <= old) {
+		return;
+	}
+	qsort (rows + old, count - old, sizeof (RBinDwarfLineAddr), line_addr_cmp);
+	if (!old || line_addr_cmp (&rows[old - 1], &rows[old]) <= 0) {
+		return;
+	}
+	RBinDwarfLineAddr *res = malloc (count * sizeof (RBinDwarfLineAddr));
+	if (!res) {
+		qsort (rows, count, sizeof (RBinDwarfLineAddr), line_addr_cmp);
+		return;
+	}
+	size_t i = 0, j = old, k = 0;
+	while (i < old && j < count) {
+		res[k++] = (line_addr_cmp (&rows[j], &rows[i]) < 0)? rows[j++]: rows[i++];
+	}
+	while (i < old) {
+		res[k++] = rows[i++];
+	}
+	while (j < count) {
+		res[k++] = rows[j++];
+	}
+	free (li->rows);
+	li->rows = res;
+	li->rows_capacity = count;
+}
+
+/**
+ * @brief Builds a compilation unit range index without parsing the line programs
+ *
+ * Line programs are decoded on the first lookup of an address covered by their unit.
+ */
+R_API RBinDwarfLineIndex *r_bin_dwarf_index_lines(RBin *bin) {
+	R_RETURN_VAL_IF_FAIL (bin, NULL);
+	if (!bin->cur || !getsection (bin, DWARF_SN_LINE)) {
+		return NULL;
+	}
+	RBinDwarfDebugAbbrev *da = r_bin_dwarf_parse_abbrev (bin, R_MODE_SET);
+	if (!da) {
+		return NULL;
+	}
+	RBinDwarfLineIndex *li = R_NEW0 (RBinDwarfLineIndex);
+	if (!r_str_constpool_init (&li->files)) {
+		free (li);
+		r_bin_dwarf_free_debug_abbrev (da);
+		return NULL;
+	}
+	index_comp_units (bin, li, da);
+	r_bin_dwarf_free_debug_abbrev (da);
+	index_aranges (bin, li);
+	// the aranges are resolved by unit offset, from now on the units are searched by address
+	if (li->cus_count > 0) {
+		qsort (li->cus, li->cus_count, sizeof (RBinDwarfCURange), cu_lo_cmp);
+	}
+	ut64 hi_max = 0;
+	size_t i;
+	for (i = 0; i < li->cus_count && li->cus[i].lo < li->cus[i].hi; i++) {
+		hi_max = R_MAX (hi_max, li->cus[i].hi);
+		li->cus[i].hi_max = hi_max;
+	}
+	li->cus_known = i;
+	li->cus_pending = li->cus_count;
+	return li;
+}
+
+static void line_index_parse_cu(RBin *bin, RBinDwarfLineIndex *li, RBinDwarfCURange *cu) {
+	const size_t old = li->rows_count;
+	cu->parsed = true;
+	li->cus_pending--;
+	line_index_parse_unit (bin, li, cu->stmt_list);
+	line_index_merge (li, old);
+}
+
+static const RBinDwarfLineAddr *line_index_find(RBinDwarfLineIndex *li, ut64 addr) {
+	size_t lo = 0, hi = li->rows_count;
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		if (li->rows[mid].addr < addr) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+	return (lo < li->rows_count && li->rows[lo].addr == addr)? &li->rows[lo]: NULL;
+}
+
+R_API const RBinDwarfLineAddr *r_bin_dwarf_line_index_at(RBin *bin, RBinDwarfLineIndex *li, ut64 addr) {
+	R_RETURN_VAL_IF_FAIL (bin && li, NULL);
+	bool covered = false;
+	if (li->cus_pending) {
+		// after the last unit starting at addr, walk back while the ranges can still reach it
+		size_t lo = 0, hi = li->cus_known;
+		while (lo < hi) {
+			size_t mid = lo + (hi - lo) / 2;
+			if (li->cus[mid].lo <= addr) {
+				lo = mid + 1;
+			} else {
+				hi = mid;
+			}
+		}
+		while (lo > 0 && li->cus[lo - 1].hi_max > addr) {
+			RBinDwarfCURange *cu = &li->cus[--lo];
+			if (addr < cu->hi) {
+				covered = true;
+				if (!cu->parsed) {
+					line_index_parse_cu (bin, li, cu);
+				}
+			}
+		}
+	}
+	const RBinDwarfLineAddr *row = line_index_find (li, addr);
+	// units without a known range are parsed one by one only when no other unit covers addr
+	size_t i;
+	for (i = li->cus_known; !row && !covered && li->cus_pending && i < li->cus_count; i++) {
+		RBinDwarfCURange *cu = &li->cus[i];
+		if (!cu->parsed) {
+			line_index_parse_cu (bin, li, cu);
+			row = line_index_find (li, addr);
+		}
+	}
+	return row;
+}
+
+/**
+ * @brief Parses the pending units and copies every row into the addrinfo sdb
+ *
+ * The commands listing all the source lines walk the sdb, which the lazy index leaves empty.
+ */
+R_API void r_bin_dwarf_line_index_fill(RBin *bin, RBinDwarfLineIndex *li) {
+	R_RETURN_IF_FAIL (bin && li);
+	RBinFile *bf = bin->cur;
+	if (li->filled || !bf || !bf->sdb_addrinfo) {
+		return;
+	}
+	size_t i;
+	for (i = 0; li->cus_pending && i < li->cus_count; i++) {
+		if (!li->cus[i].parsed) {
+			line_index_parse_cu (bin, li, &li->cus[i]);
+		}
+	}
+	for (i = 0; i < li->rows_count; i++) {
+		const RBinDwarfLineAddr *row = &li->rows[i];
+		add_sdb_addrline (bf->sdb_addrinfo, row->addr, row->file,
+			row->line, row->column, R_MODE_SET, bin->cb_printf);
+	}
+	li->filled = true;
+}
+
+R_API void r_bin_dwarf_line_index_free(RBinDwarfLineIndex *li) {
+	if (li) {
+		r_str_constpool_fini (&li->files);
+		free (li->cus);
+		free (li->rows);
+		free (li);
+	}
+}
+
 static inline ut64 get_max_offset(size_t addr_size) {
 	switch (addr_size) {
 	case 1: return UT8_MAX;
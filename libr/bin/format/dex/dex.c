@@ -252,8 +252,21 @@ void r_bin_dex_free(RBinDexObj *dex) {
 	free (dex->protos);
 }
 
+// the id tables are decoded from a span, which must hold the whole table
+static bool dex_table(RBinDexObj *dex, ut64 offset, ut64 count, ut64 entsize, RBufferSpan *span) {
+	if (!r_buf_span (dex->b, offset, count * entsize, span)) {
+		return false;
+	}
+	if (span->len < count * entsize) {
+		r_buf_span_fini (span);
+		return false;
+	}
+	return true;
+}
+
 RBinDexObj *r_bin_dex_new_buf(RBuffer *buf, bool verbose) {
 	R_RETURN_VAL_IF_FAIL (buf, NULL);
+	RBufferSpan span;
 	int i;
 	RBinDexObj *dex = R_NEW0 (RBinDexObj);
 	if (!dex) {
@@ -331,23 +344,23 @@ RBinDexObj *r_bin_dex_new_buf(RBuffer *buf, bool verbose) {
 	dexhdr->class_size = classes_size / DEX_CLASS_SIZE;
 	dex->classes = (struct dex_class_t *) calloc (dexhdr->class_size + 1,
 		sizeof (struct dex_class_t));
-	for (i = 0; i < dexhdr->class_size; i++) {
-		ut64 offset = dexhdr->class_offset + i * DEX_CLASS_SIZE;
-		if (offset + 32 > dex->size) {
-			free (dex->strings);
-			free (dex->classes);
-			goto fail;
-		}
-		r_buf_seek (dex->b, offset, R_BUF_SET);
-		dex->classes[i].class_id = r_buf_read_le32 (dex->b);
-		dex->classes[i].access_flags = r_buf_read_le32 (dex->b);
-		dex->classes[i].super_class = r_buf_read_le32 (dex->b);
-		dex->classes[i].interfaces_offset = r_buf_read_le32 (dex->b);
-		dex->classes[i].source_file = r_buf_read_le32 (dex->b);
-		dex->classes[i].anotations_offset = r_buf_read_le32 (dex->b);
-		dex->classes[i].class_data_offset = r_buf_read_le32 (dex->b);
-		dex->classes[i].static_values_offset = r_buf_read_le32 (dex->b);
+	if (!dex_table (dex, dexhdr->class_offset, dexhdr->class_size, DEX_CLASS_SIZE, &span)) {
+		free (dex->strings);
+		free (dex->classes);
+		goto fail;
 	}
+	for (i = 0; i < dexhdr->class_size; i++) {
+		const ut8 *p = span.data + i * DEX_CLASS_SIZE;
+		dex->classes[i].class_id = r_read_le32 (p);
+		dex->classes[i].access_flags = r_read_le32 (p + 4);
+		dex->classes[i].super_class = r_read_le32 (p + 8);
+		dex->classes[i].interfaces_offset = r_read_le32 (p + 12);
+		dex->classes[i].source_file = r_read_le32 (p + 16);
+		dex->classes[i].anotations_offset = r_read_le32 (p + 20);
+		dex->classes[i].class_data_offset = r_read_le32 (p + 24);
+		dex->classes[i].static_values_offset = r_read_le32 (p + 28);
+	}
+	r_buf_span_fini (&span);
 
 	/* methods */
 	size_t methods_size = dexhdr->method_size * sizeof (struct dex_method_t);
@@ -360,19 +373,19 @@ RBinDexObj *r_bin_dex_new_buf(RBuffer *buf, bool verbose) {
 	}
 	dexhdr->method_size = methods_size / sizeof (struct dex_method_t);
 	dex->methods = (struct dex_method_t *) calloc (methods_size + 1, sizeof (struct dex_method_t));
+	if (!dex_table (dex, dexhdr->method_offset, dexhdr->method_size, sizeof (struct dex_method_t), &span)) {
+		free (dex->strings);
+		free (dex->classes);
+		free (dex->methods);
+		goto fail;
+	}
 	for (i = 0; i < dexhdr->method_size; i++) {
-		ut64 offset = dexhdr->method_offset + i * sizeof (struct dex_method_t);
-		if (offset + 8 > dex->size) {
-			free (dex->strings);
-			free (dex->classes);
-			free (dex->methods);
-			goto fail;
-		}
-		r_buf_seek (dex->b, offset, R_BUF_SET);
-		dex->methods[i].class_id = r_buf_read_le16 (dex->b);
-		dex->methods[i].proto_id = r_buf_read_le16 (dex->b);
-		dex->methods[i].name_id = r_buf_read_le32 (dex->b);
+		const ut8 *p = span.data + i * sizeof (struct dex_method_t);
+		dex->methods[i].class_id = r_read_le16 (p);
+		dex->methods[i].proto_id = r_read_le16 (p + 2);
+		dex->methods[i].name_id = r_read_le32 (p + 4);
 	}
+	r_buf_span_fini (&span);
 
 	/* types */
 	int types_size = dexhdr->types_size * sizeof (struct dex_type_t);
@@ -407,17 +420,17 @@ RBinDexObj *r_bin_dex_new_buf(RBuffer *buf, bool verbose) {
 	dexhdr->types_size = types_size / sizeof (struct dex_type_t);
 
 	dex->types = (struct dex_type_t *) calloc (types_size + 1, sizeof (struct dex_type_t));
+	if (!dex_table (dex, dexhdr->types_offset, dexhdr->types_size, sizeof (struct dex_type_t), &span)) {
+		free (dex->strings);
+		free (dex->classes);
+		free (dex->methods);
+		free (dex->types);
+		goto fail;
+	}
 	for (i = 0; i < dexhdr->types_size; i++) {
-		ut64 offset = dexhdr->types_offset + i * sizeof (struct dex_type_t);
-		if (offset + 4 > dex->size) {
-			free (dex->strings);
-			free (dex->classes);
-			free (dex->methods);
-			free (dex->types);
-			goto fail;
-		}
-		dex->types[i].descriptor_id = r_buf_read_le32_at (dex->b, offset);
+		dex->types[i].descriptor_id = r_read_le32 (span.data + i * sizeof (struct dex_type_t));
 	}
+	r_buf_span_fini (&span);
 
 	/* fields */
 	size_t fields_size = dexhdr->fields_size * sizeof (struct dex_field_t);
@@ -430,21 +443,21 @@ RBinDexObj *r_bin_dex_new_buf(RBuffer *buf, bool verbose) {
 	}
 	dexhdr->fields_size = fields_size / sizeof (struct dex_field_t);
 	dex->fields = (struct dex_field_t *) calloc (fields_size + 1, sizeof (struct dex_field_t));
+	if (!dex_table (dex, dexhdr->fields_offset, dexhdr->fields_size, sizeof (struct dex_field_t), &span)) {
+		free (dex->strings);
+		free (dex->classes);
+		free (dex->methods);
+		free (dex->types);
+		free (dex->fields);
+		goto fail;
+	}
 	for (i = 0; i < dexhdr->fields_size; i++) {
-		ut64 offset = dexhdr->fields_offset + i * sizeof (struct dex_field_t);
-		if (offset + 8 > dex->size) {
-			free (dex->strings);
-			free (dex->classes);
-			free (dex->methods);
-			free (dex->types);
-			free (dex->fields);
-			goto fail;
-		}
-		r_buf_seek (dex->b, offset, R_BUF_SET);
-		dex->fields[i].class_id = r_buf_read_le16 (dex->b);
-		dex->fields[i].type_id = r_buf_read_le16 (dex->b);
-		dex->fields[i].name_id = r_buf_read_le32 (dex->b);
+		const ut8 *p = span.data + i * sizeof (struct dex_field_t);
+		dex->fields[i].class_id = r_read_le16 (p);
+		dex->fields[i].type_id = r_read_le16 (p + 2);
+		dex->fields[i].name_id = r_read_le32 (p + 4);
 	}
+	r_buf_span_fini (&span);
 
 	/* proto */
 	size_t protos_size = dexhdr->prototypes_size * sizeof (struct dex_proto_t);
@@ -457,22 +470,22 @@ RBinDexObj *r_bin_dex_new_buf(RBuffer *buf, bool verbose) {
 	}
 	dexhdr->prototypes_size = protos_size / sizeof (struct dex_proto_t);
 	dex->protos = (struct dex_proto_t *) calloc (protos_size + 1, sizeof (struct dex_proto_t));
+	if (!dex_table (dex, dexhdr->prototypes_offset, dexhdr->prototypes_size, sizeof (struct dex_proto_t), &span)) {
+		free (dex->strings);
+		free (dex->classes);
+		free (dex->methods);
+		free (dex->types);
+		free (dex->fields);
+		free (dex->protos);
+		goto fail;
+	}
 	for (i = 0; i < dexhdr->prototypes_size; i++) {
-		ut64 offset = dexhdr->prototypes_offset + i * sizeof (struct dex_proto_t);
-		if (offset + 12 > dex->size) {
-			free (dex->strings);
-			free (dex->classes);
-			free (dex->methods);
-			free (dex->types);
-			free (dex->fields);
-			free (dex->protos);
-			goto fail;
-		}
-		r_buf_seek (dex->b, offset, R_BUF_SET);
-		dex->protos[i].shorty_id = r_buf_read_le32 (dex->b);
-		dex->protos[i].return_type_id = r_buf_read_le32 (dex->b);
-		dex->protos[i].parameters_off = r_buf_read_le32 (dex->b);
+		const ut8 *p = span.data + i * sizeof (struct dex_proto_t);
+		dex->protos[i].shorty_id = r_read_le32 (p);
+		dex->protos[i].return_type_id = r_read_le32 (p + 4);
+		dex->protos[i].parameters_off = r_read_le32 (p + 8);
 	}
+	r_buf_span_fini (&span);
 	bprintf ("Parse annotations\n");
 	for (i = 0; i < dexhdr->class_size; i++) {
 		ut64 at = dex->classes[i].anotations_offset;
@@ -259,16 +259,16 @@ static bool read_phdr(ELFOBJ *eo) {
 #else
 	const bool is_elf64 = false;
 #endif
+	RBufferSpan span;
+	const ut64 phdr_size = (ut64)phnum * sizeof (Elf_(Phdr));
+	if (!r_buf_span (eo->b, eo->ehdr.e_phoff, phdr_size, &span) || span.len != phdr_size) {
+		R_LOG_DEBUG ("read (phdr)");
+		r_buf_span_fini (&span);
+		return false;
+	}
 	int i;
 	for (i = 0; i < phnum; i++) {
-		ut8 phdr[sizeof (Elf_(Phdr))] = {0};
-		const size_t rsize = eo->ehdr.e_phoff + i * sizeof (Elf_(Phdr));
-		int len = r_buf_read_at (eo->b, rsize, phdr, sizeof (phdr));
-		if (len != sizeof (phdr)) {
-			R_LOG_DEBUG ("read (phdr)");
-			return false;
-		}
-
+		const ut8 *phdr = span.data + i * sizeof (Elf_(Phdr));
 		int j = 0;
 		eo->phdr[i].p_type = READ32 (phdr, j);
 		if (is_elf64) {
@@ -285,7 +285,7 @@ static bool read_phdr(ELFOBJ *eo) {
 		}
 		eo->phdr[i].p_align = R_BIN_ELF_READWORD (phdr, j);
 	}
-
+	r_buf_span_fini (&span);
 	return true;
 }
 
@@ -363,16 +363,17 @@ static int init_shdr(ELFOBJ *eo) {
 			"SHT_NOBITS=8,SHT_REL=9,SHT_SHLIB=10,SHT_DYNSYM=11,SHT_LOOS=0x60000000,"
 			"SHT_HIOS=0x6fffffff,SHT_LOPROC=0x70000000,SHT_HIPROC=0x7fffffff};", 0);
 
-	ut8 shdr[sizeof (Elf_(Shdr))] = {0};
+	RBufferSpan span;
+	if (!r_buf_span (eo->b, eo->ehdr.e_shoff, shdr_size, &span) || span.len != shdr_size) {
+		R_LOG_DEBUG ("read (shdr) at 0x%" PFMT64x, (ut64) eo->ehdr.e_shoff);
+		r_buf_span_fini (&span);
+		R_FREE (eo->shdr);
+		return false;
+	}
 	size_t i;
 	for (i = 0; i < eo->ehdr.e_shnum; i++) {
+		const ut8 *shdr = span.data + i * sizeof (Elf_(Shdr));
 		size_t j = 0;
-		size_t len = r_buf_read_at (eo->b, eo->ehdr.e_shoff + i * sizeof (Elf_(Shdr)), shdr, sizeof (Elf_(Shdr)));
-		if (len != sizeof (Elf_(Shdr))) {
-			R_LOG_DEBUG ("read (shdr) at 0x%" PFMT64x, (ut64) eo->ehdr.e_shoff);
-			R_FREE (eo->shdr);
-			return false;
-		}
 		eo->shdr[i].sh_name = READ32 (shdr, j);
 		eo->shdr[i].sh_type = READ32 (shdr, j);
 		eo->shdr[i].sh_flags = R_BIN_ELF_READWORD (shdr, j);
@@ -384,6 +385,7 @@ static int init_shdr(ELFOBJ *eo) {
 		eo->shdr[i].sh_addralign = R_BIN_ELF_READWORD (shdr, j);
 		eo->shdr[i].sh_entsize = R_BIN_ELF_READWORD (shdr, j);
 	}
+	r_buf_span_fini (&span);
 
 #if R_BIN_ELF64
 	sdb_set (eo->kv, "elf_s_flags_64.cparse", "enum elf_s_flags_64 {SF64_None=0,SF64_Exec=1,"
@@ -4028,6 +4030,24 @@ typedef struct {
 	Elf_(Addr) addr_sym_table;
 } ReadPhdrSymbolState;
 
+// names are borrowed from the string table when they are properly terminated,
+// otherwise a truncated copy is kept in the object constpool
+static const char *symbol_name(ELFOBJ *eo, const char *tab, size_t tabsz, size_t off) {
+	if (!tab || off >= tabsz) {
+		return "";
+	}
+	const char *name = tab + off;
+	const size_t left = tabsz - off;
+	const size_t maxlen = ELF_STRING_LENGTH - 2;
+	const size_t len = r_str_nlen (name, R_MIN (left, maxlen + 1));
+	if (len < left && len <= maxlen) {
+		return name;
+	}
+	char tmp[ELF_STRING_LENGTH];
+	r_str_ncpy (tmp, name, R_MIN (len, maxlen) + 1);
+	return r_str_constpool_get (&eo->symbol_names, tmp);
+}
+
 static bool _read_symbols_from_phdr(ELFOBJ *eo, ReadPhdrSymbolState *state) {
 	int type = state->type;
 	RVecRBinElfSymbol *ret = state->ret; // TODO: rename to elf_symbols_vec
@@ -4101,19 +4121,9 @@ static bool _read_symbols_from_phdr(ELFOBJ *eo, ReadPhdrSymbolState *state) {
 			break;
 		}
 
-		// R2_590 - getting symbol name requires a unified function to read outside strtab, current code is wrong
 		// get name before alocating it in the vector
-		int st_name = new_symbol.st_name;
-		const size_t rest = ELF_STRING_LENGTH - 1;
-		int maxsize = eo->size; //R_MIN (eo->size, eo->strtab_size);
-		int namelen = 0;
-		if (st_name < 0 || st_name >= maxsize) {
-			namelen = 0;
-		} else {
-			namelen = r_str_nlen (eo->strtab + st_name, rest) + 1;
-		}
 		const char *symname;
-		if (namelen < 1) {
+		if (!eo->strtab || new_symbol.st_name >= eo->strtab_size) {
 #if PERMIT_UNNAMED_SYMBOLS
 			symname = "unksym";
 #else
@@ -4121,7 +4131,7 @@ static bool _read_symbols_from_phdr(ELFOBJ *eo, ReadPhdrSymbolState *state) {
 			continue;
 #endif
 		} else {
-			symname = eo->strtab + st_name;
+			symname = symbol_name (eo, eo->strtab, eo->strtab_size, new_symbol.st_name);
 		}
 
 		RBinElfSymbol *psym = RVecRBinElfSymbol_emplace_back (ret);
@@ -4132,7 +4142,7 @@ static bool _read_symbols_from_phdr(ELFOBJ *eo, ReadPhdrSymbolState *state) {
 		memset (psym, 0, sizeof (RBinElfSymbol));
 		psym->offset = tmp_offset;
 		psym->size = tsize;
-		r_str_ncpy (psym->name, symname, R_MIN (rest, namelen));
+		psym->name = symname;
 
 		psym->ordinal = i;
 		psym->in_shdr = false;
@@ -4254,7 +4264,7 @@ static int Elf_(fix_symbols)(ELFOBJ *eo, int nsym, int type, RVecRBinElfSymbol *
 			if (d) {
 				symbol->in_shdr = true;
 				if (*symbol->name && *d->name == '$') {
-					strcpy (d->name, symbol->name);
+					d->name = symbol->name;
 				}
 			}
 		}
@@ -4436,6 +4446,11 @@ static RVecRBinElfSymbol *parse_gnu_debugdata(ELFOBJ *eo, size_t *ret_size) {
 			if (Elf_(load_symbols) (newobj)) {
 				symbols = newobj->g_symbols_vec;
 				newobj->g_symbols_vec = NULL;
+				// the names point into newobj, which is gone after this
+				RBinElfSymbol *symbol;
+				R_VEC_FOREACH (symbols, symbol) {
+					symbol->name = r_str_constpool_get (&eo->symbol_names, symbol->name);
+				}
 			}
 			Elf_(free)(newobj);
 		}
@@ -4579,24 +4594,24 @@ static bool _process_symbols_and_imports_in_section(ELFOBJ *eo, int type, Proces
 		return false;
 	}
 
-	// TODO don't calloc and copy from buf, read from buf directly
+	// symbol names are borrowed from the strtab, so it must outlive the symbols.
+	// it's always copied, a view of eo->b dangles when elf_write replaces it
 	char *strtab = calloc (1, 8 + strtab_section->sh_size);
 	if (!strtab) {
 		R_LOG_ERROR ("malloc (syms strtab)");
 		return false;
 	}
-
 	if (r_buf_read_at (eo->b, strtab_section->sh_offset, (ut8*)strtab, strtab_section->sh_size) == -1) {
 		R_LOG_ERROR ("read (syms strtab)");
 		free (strtab);
 		return false;
 	}
+	r_list_append (eo->symbol_strtabs, strtab);
 
 	// bounds check
 	int newsize = 1 + eo->shdr[i].sh_size;
 	if (newsize < 0 || newsize > eo->size) {
 		R_LOG_ERROR ("invalid shdr %d size", i);
-		free (strtab);
 		return false;
 	}
 
@@ -4604,7 +4619,6 @@ static bool _process_symbols_and_imports_in_section(ELFOBJ *eo, int type, Proces
 	const ut64 sh_end = sh_begin + eo->shdr[i].sh_size;
 	if (sh_begin > eo->size) {
 		R_LOG_ERROR ("invalid sh egin");
-		free (strtab);
 		return false;
 	}
 
@@ -4613,7 +4627,6 @@ static bool _process_symbols_and_imports_in_section(ELFOBJ *eo, int type, Proces
 		nsym = (int)(newshsize / sizeof (Elf_(Sym)));
 		if (nsym < 1) {
 			R_LOG_ERROR ("nsym < 1 again");
-			free (strtab);
 			return false;
 		}
 	}
@@ -4626,38 +4639,39 @@ static bool _process_symbols_and_imports_in_section(ELFOBJ *eo, int type, Proces
 	memory->sym = calloc (nsym, sizeof (Elf_(Sym)));
 	if (!memory->sym) {
 		R_LOG_ERROR ("calloc (syms)");
-		free (strtab);
 		return false;
 	}
 
 	ut32 size = 0;
 	if (!UT32_MUL (&size, nsym, sizeof (Elf_(Sym)))) {
 		R_LOG_ERROR ("mul overflow");
-		free (strtab);
 		return false;
 	}
 	if (size < 1 || size > eo->size) {
 		R_LOG_ERROR ("wrong size");
-		free (strtab);
 		return false;
 	}
 	if (eo->shdr[i].sh_offset > eo->size || eo->shdr[i].sh_offset + size > eo->size) {
 		R_LOG_ERROR ("inval");
-		free (strtab);
 		return false;
 	}
 
-	int j;
-	for (j = 0; j < nsym; j++) {
-		int k = 0;
-		ut8 s[sizeof (Elf_(Sym))] = {0};
-		ut64 sym_addr = eo->shdr[i].sh_offset + (j * sizeof (Elf_(Sym)));
-		int r = r_buf_read_at (eo->b, sym_addr, s, sizeof (Elf_(Sym)));
-		if (r < 1) {
+	// decode the whole table from memory instead of reading it symbol by symbol
+	const ut8 *symtab = r_buf_view (eo->b, eo->shdr[i].sh_offset, size);
+	ut8 *symtab_copy = NULL;
+	if (!symtab) {
+		symtab_copy = malloc (size);
+		if (!symtab_copy || r_buf_read_at (eo->b, eo->shdr[i].sh_offset, symtab_copy, size) < 1) {
 			R_LOG_ERROR ("read (sym)");
-			free (strtab);
+			free (symtab_copy);
 			return false;
 		}
+		symtab = symtab_copy;
+	}
+	int j;
+	for (j = 0; j < nsym; j++) {
+		int k = 0;
+		const ut8 *s = symtab + (j * sizeof (Elf_(Sym)));
 #if R_BIN_ELF64
 		memory->sym[j].st_name = READ32 (s, k);
 		memory->sym[j].st_info = READ8 (s, k);
@@ -4674,11 +4688,11 @@ static bool _process_symbols_and_imports_in_section(ELFOBJ *eo, int type, Proces
 		memory->sym[j].st_shndx = READ16 (s, k);
 #endif
 	}
+	free (symtab_copy);
 
 	if (!(*state->ret)) {
 		RVecRBinElfSymbol *ret = RVecRBinElfSymbol_new ();
 		if (!ret) {
-			free (strtab);
 			return false;
 		}
 		*state->ret = ret;
@@ -4690,7 +4704,6 @@ static bool _process_symbols_and_imports_in_section(ELFOBJ *eo, int type, Proces
 	ut64 len = RVecRBinElfSymbol_length (ret);
 	if (!RVecRBinElfSymbol_reserve (ret, increment + len)) {
 		R_LOG_ERROR ("Cannot allocate %d symbols", (int)(nsym + increment));
-		free (strtab);
 		return false;
 	}
 
@@ -4700,6 +4713,7 @@ static bool _process_symbols_and_imports_in_section(ELFOBJ *eo, int type, Proces
 		int tsize;
 		RBinElfSymbol *es = RVecRBinElfSymbol_emplace_back (ret); // r_vector_end (ret);
 		memset (es, 0, sizeof (RBinElfSymbol));
+		es->name = "";
 		bool is_sht_null = false;
 		bool is_vaddr = false;
 		bool is_imported = false;
@@ -4742,28 +4756,22 @@ static bool _process_symbols_and_imports_in_section(ELFOBJ *eo, int type, Proces
 		if (is_section_local_sym (eo, &memory->sym[k])) {
 			const size_t sym_section = memory->sym[k].st_shndx;
 			if (eo->shstrtab) {
-				size_t ss = eo->shstrtab_size;
 				size_t name_off = eo->shdr[sym_section].sh_name;
-				if (name_off > 0 && name_off < ss) {
-					const char *shname = eo->shstrtab + name_off;
-					size_t left = R_MIN (ELF_STRING_LENGTH - 1, ss - name_off);
-					r_str_ncpy (es->name, shname, left);
-				} else {
-					es->name[0] = 0;
+				if (name_off > 0) {
+					es->name = symbol_name (eo, eo->shstrtab, eo->shstrtab_size, name_off);
 				}
 			} else {
+				char name[ELF_STRING_LENGTH] = {0};
 				const ut64 at = strtab_section->sh_offset + eo->shdr[sym_section].sh_name;
-				r_buf_read_at (eo->b, at, (ut8*)es->name, sizeof (es->name));
+				r_buf_read_at (eo->b, at, (ut8*)name, sizeof (name) - 1);
+				es->name = r_str_constpool_get (&eo->symbol_names, name);
 			}
-		} else if (st_name <= 0 || st_name >= maxsize) {
-			es->name[0] = 0;
-		} else {
-			r_str_ncpy (es->name, &strtab[st_name], ELF_STRING_LENGTH - 1);
+		} else if (st_name > 0 && st_name < maxsize) {
+			es->name = symbol_name (eo, strtab, strtab_section->sh_size, st_name);
 			es->type = type2str (eo, es, &memory->sym[k]);
 		}
 
 		es->ordinal = k;
-		es->name[ELF_STRING_LENGTH - 1] = '\0';
 		fill_symbol_bind_and_type (eo, es, &memory->sym[k]);
 		es->is_sht_null = is_sht_null;
 		es->is_vaddr = is_vaddr;
@@ -4772,7 +4780,6 @@ static bool _process_symbols_and_imports_in_section(ELFOBJ *eo, int type, Proces
 			(*import_ret_ctr)++;
 		}
 	}
-	free (strtab);
 	return true;
 }
 
@@ -4940,6 +4947,8 @@ void Elf_(free)(ELFOBJ* eo) {
 	// RVecRBinElfSymbol_free (eo->phdr_imports_vec);
 	RVecRBinElfSymbol_free (eo->g_symbols_vec);
 	RVecRBinElfSymbol_free (eo->g_imports_vec);
+	r_str_constpool_fini (&eo->symbol_names);
+	r_list_free (eo->symbol_strtabs);
 #if 0
 	// R2_590
 	r_vector_free (eo->g_symbols);
@@ -4979,6 +4988,8 @@ ELFOBJ* Elf_(new_buf)(RBuffer *buf, ut64 baddr, bool verbose) {
 	ELFOBJ *eo = R_NEW0 (ELFOBJ);
 	if (eo) {
 		eo->kv = sdb_new0 ();
+		r_str_constpool_init (&eo->symbol_names);
+		eo->symbol_strtabs = r_list_newf (free);
 		eo->size = r_buf_size (buf);
 		eo->verbose = verbose;
 		eo->b = r_buf_ref (buf);
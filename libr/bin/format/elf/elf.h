@@ -55,8 +55,7 @@ typedef struct r_bin_elf_symbol_t {
 	ut32 ordinal;
 	const char *bind;
 	const char *type;
-	char name[ELF_STRING_LENGTH];
-	char libname[ELF_STRING_LENGTH];
+	const char *name; // borrowed from a string table or from ELFOBJ.symbol_names, never NULL
 	bool in_shdr;
 	bool is_sht_null;
 	bool is_vaddr; /* when true, offset is virtual address, otherwise it's physical */
@@ -154,6 +153,8 @@ struct Elf_(obj_t) {
 	RVecRBinElfSymbol *g_imports_vec;
 	RVecRBinElfSymbol *phdr_symbols_vec;
 	RVecRBinElfSymbol *phdr_imports_vec;
+	RStrConstPool symbol_names; // symbol names that cant be borrowed from a string table
+	RList *symbol_strtabs; // string tables the symbol names point into
 	RList *inits;
 	HtUU *rel_cache;
 	ut32 g_reloc_num;
@@ -491,7 +491,6 @@ static bool parse_symtab(struct MACH0_(obj_t) *mo, ut64 off) {
 	size_t i;
 	const char *error_message = "";
 	ut8 symt[sizeof (struct symtab_command)] = {0};
-	ut8 nlst[sizeof (struct MACH0_(nlist))] = {0};
 	const bool be = mo->big_endian;
 
 	if (off > (ut64)mo->size || off + sizeof (struct symtab_command) > (ut64)mo->size) {
@@ -537,12 +536,13 @@ static bool parse_symtab(struct MACH0_(obj_t) *mo, ut64 off) {
 		if (mo->nsymtab > max_nsymtab || !(mo->symtab = calloc (mo->nsymtab, sizeof (struct MACH0_(nlist))))) {
 			goto error;
 		}
+		RBufferSpan span;
+		if (!r_buf_span (mo->b, st.symoff, size_sym, &span) || span.len != size_sym) {
+			r_buf_span_fini (&span);
+			Error ("read (nlist)");
+		}
 		for (i = 0; i < mo->nsymtab; i++) {
-			ut64 at = st.symoff + (i * sizeof (struct MACH0_(nlist)));
-			len = r_buf_read_at (mo->b, at, nlst, sizeof (struct MACH0_(nlist)));
-			if (len != sizeof (struct MACH0_(nlist))) {
-				Error ("read (nlist)");
-			}
+			const ut8 *nlst = span.data + (i * sizeof (struct MACH0_(nlist)));
 			struct MACH0_(nlist) *sti = &mo->symtab[i];
 			//XXX not very safe what if is n_un.n_name instead?
 			sti->n_strx = r_read_ble32 (nlst, be);
@@ -555,6 +555,7 @@ static bool parse_symtab(struct MACH0_(obj_t) *mo, ut64 off) {
 			sti->n_value = r_read_ble32 (&nlst[8], be);
 #endif
 		}
+		r_buf_span_fini (&span);
 	}
 	return true;
 error:
@@ -582,7 +583,6 @@ static bool parse_dysymtab(struct MACH0_(obj_t) *mo, ut64 off) {
 	ut8 dysym[sizeof (struct dysymtab_command)] = {0};
 	ut8 dytoc[sizeof (struct dylib_table_of_contents)] = {0};
 	ut8 dymod[sizeof (struct MACH0_(dylib_module))] = {0};
-	ut8 idsyms[sizeof (ut32)] = {0};
 
 	if (off > mo->size || off + sizeof (struct dysymtab_command) >= mo->size) {
 		return false;
@@ -715,15 +715,17 @@ static bool parse_dysymtab(struct MACH0_(obj_t) *mo, ut64 off) {
 			R_FREE (mo->indirectsyms);
 			return false;
 		}
+		RBufferSpan span;
+		if (!r_buf_span (mo->b, mo->dysymtab.indirectsymoff, size_tab, &span) || span.len != size_tab) {
+			R_LOG_ERROR ("read (indirect syms)");
+			r_buf_span_fini (&span);
+			R_FREE (mo->indirectsyms);
+			return false;
+		}
 		for (i = 0; i < mo->nindirectsyms; i++) {
-			len = r_buf_read_at (mo->b, mo->dysymtab.indirectsymoff + i * sizeof (ut32), idsyms, 4);
-			if (len == -1) {
-				R_LOG_ERROR ("read (indirect syms)");
-				R_FREE (mo->indirectsyms);
-				return false;
-			}
-			mo->indirectsyms[i] = r_read_ble32 (&idsyms[0], mo->big_endian);
+			mo->indirectsyms[i] = r_read_ble32 (span.data + i * sizeof (ut32), mo->big_endian);
 		}
+		r_buf_span_fini (&span);
 	}
 	/* TODO extrefsyms, extrel, locrel */
 	return true;
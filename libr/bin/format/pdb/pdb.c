@@ -29,6 +29,23 @@ typedef struct {
 	free_func free;
 } SStreamParseFunc;
 
+// max amount of worker threads used to parse the streams listed in the dbi
+#define PDB_PARSE_THREADS 4
+
+typedef struct {
+	SStreamParseFunc *parse_func;
+	R_STREAM_FILE stream_file;
+	int indx;
+	ut64 elapsed;
+} SStreamParseJob;
+
+typedef struct {
+	SStreamParseJob *jobs;
+	int count;
+	int first;
+	int step;
+} SStreamParseWorker;
+
 ///////////////////////////////////////////////////////////////////////////////
 static void free_pdb_stream(void *stream) {
 	R_PDB_STREAM *pdb_stream = (R_PDB_STREAM *) stream;
@@ -342,6 +359,49 @@ static void find_indx_in_list(RList *l, int index, SStreamParseFunc **res) {
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+static void run_parse_job(SStreamParseJob *job) {
+	ut64 t0 = r_time_now_mono ();
+	job->parse_func->parse_stream (job->parse_func->stream, &job->stream_file);
+	job->elapsed = r_time_now_mono () - t0;
+}
+
+static RThreadFunctionRet parse_jobs_thread(RThread *th) {
+	SStreamParseWorker *w = (SStreamParseWorker *) th->user;
+	int i;
+	for (i = w->first; i < w->count; i += w->step) {
+		run_parse_job (&w->jobs[i]);
+	}
+	return R_TH_STOP;
+}
+
+// the streams of the jobs are in memory, so the parsers never touch pdb->buf
+static void parse_jobs(SStreamParseJob *jobs, int count) {
+	SStreamParseWorker workers[PDB_PARSE_THREADS];
+	RThread *threads[PDB_PARSE_THREADS] = {0};
+	int i, nthreads = R_MIN (count, PDB_PARSE_THREADS);
+	for (i = 1; i < nthreads; i++) {
+		workers[i] = (SStreamParseWorker){ jobs, count, i, nthreads };
+		threads[i] = r_th_new (parse_jobs_thread, &workers[i], 0);
+		if (threads[i]) {
+			r_th_start (threads[i]);
+		}
+	}
+	// the calling thread takes its share and any share a thread could not take
+	for (i = 0; i < count; i++) {
+		int owner = i % R_MAX (nthreads, 1);
+		if (!owner || !threads[owner]) {
+			run_parse_job (&jobs[i]);
+		}
+	}
+	for (i = 1; i < nthreads; i++) {
+		if (threads[i]) {
+			r_th_wait (threads[i]);
+			r_th_free (threads[i]);
+		}
+	}
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 static int pdb_read_root(RPdb *pdb) {
 	int i = 0;
@@ -354,7 +414,15 @@ static int pdb_read_root(RPdb *pdb) {
 	RListIter *it;
 	SPage *page = 0;
 	SStreamParseFunc *stream_parse_func = 0;
+	SStreamParseJob *jobs = NULL;
+	int jobs_count = 0;
+	int ret = 0;
+	ut64 t0;
 
+	jobs = R_NEWS0 (SStreamParseJob, r_list_length (root_stream->streams_list) + 1);
+	if (!jobs) {
+		return 0;
+	}
 	it = r_list_iterator (root_stream->streams_list);
 	while (r_list_iter_next (it)) {
 		page = (SPage *) r_list_iter_get (it);
@@ -368,13 +436,14 @@ static int pdb_read_root(RPdb *pdb) {
 			page->num_pages	/*root_stream->pdb_stream.pages_amount*/,
 			page->stream_size,
 			root_stream->pdb_stream.page_size);
+		t0 = r_time_now_mono ();
 		switch (i) {
 		// TODO: rewrite for style like for streams from dbg stream
 		// look default
 		case ePDB_STREAM_PDB:
 			pdb_info_stream = R_NEW0 (SPDBInfoStream);
 			if (!pdb_info_stream) {
-				return 0;
+				goto beach;
 			}
 			pdb_info_stream->free_ = free_info_stream;
 			parse_pdb_info_stream (pdb_info_stream, &stream_file);
@@ -383,38 +452,56 @@ static int pdb_read_root(RPdb *pdb) {
 		case ePDB_STREAM_TPI:
 			tpi_stream = R_NEW0 (STpiStream);
 			if (!tpi_stream) {
-				return 0;
+				goto beach;
 			}
 			init_tpi_stream (tpi_stream);
+			stream_file_load (&stream_file);
 			if (!parse_tpi_stream (tpi_stream, &stream_file)) {
+				stream_file_fini (&stream_file);
+				tpi_stream->free_ (tpi_stream);
 				free (tpi_stream);
-				return 0;
+				goto beach;
 			}
+			stream_file_fini (&stream_file);
 			r_list_append (pList, tpi_stream);
+			R_LOG_DEBUG ("pdb: tpi stream parsed in %"PFMT64d"us (%d types)",
+				r_time_now_mono () - t0, tpi_stream->index_count);
 			break;
 		case ePDB_STREAM_DBI:
 		{
 			SDbiStream *dbi_stream = R_NEW0 (SDbiStream);
 			if (!dbi_stream) {
-				return 0;
+				goto beach;
 			}
 			init_dbi_stream (dbi_stream);
+			stream_file_load (&stream_file);
 			parse_dbi_stream (dbi_stream, &stream_file);
+			stream_file_fini (&stream_file);
 			r_list_append (pList, dbi_stream);
 			pdb->pdb_streams2 = r_list_new ();
 			fill_list_for_stream_parsing (pdb->pdb_streams2, dbi_stream);
+			R_LOG_DEBUG ("pdb: dbi stream parsed in %"PFMT64d"us", r_time_now_mono () - t0);
 			break;
 		}
 		default:
 			find_indx_in_list (pdb->pdb_streams2, i, &stream_parse_func);
 			if (stream_parse_func && stream_parse_func->parse_stream) {
-				stream_parse_func->parse_stream (stream_parse_func->stream, &stream_file);
+				// defer the parsing, the dbg streams are independent from each other,
+				// but only the ones in memory can be parsed without reading pdb->buf
+				if (stream_file_load (&stream_file)) {
+					SStreamParseJob *job = &jobs[jobs_count++];
+					job->parse_func = stream_parse_func;
+					job->stream_file = stream_file;
+					job->indx = i;
+				} else {
+					stream_parse_func->parse_stream (stream_parse_func->stream, &stream_file);
+				}
 				break;
 			}
 
 			pdb_stream = R_NEW0 (R_PDB_STREAM);
 			if (!pdb_stream) {
-				return 0;
+				goto beach;
 			}
 			init_r_pdb_stream (pdb_stream, pdb->buf, (int *) page->stream_pages,
 				root_stream->pdb_stream.pages_amount, i,
@@ -423,11 +510,24 @@ static int pdb_read_root(RPdb *pdb) {
 			break;
 		}
 		if (stream_file.error) {
-			return 0;
+			goto beach;
 		}
 		i++;
 	}
-	return 1;
+	parse_jobs (jobs, jobs_count);
+	ret = 1;
+	for (i = 0; i < jobs_count; i++) {
+		R_LOG_DEBUG ("pdb: stream %d parsed in %"PFMT64d"us", jobs[i].indx, jobs[i].elapsed);
+		if (jobs[i].stream_file.error) {
+			ret = 0;
+		}
+	}
+beach:
+	for (i = 0; i < jobs_count; i++) {
+		stream_file_fini (&jobs[i].stream_file);
+	}
+	free (jobs);
+	return ret;
 }
 
 static bool pdb7_parse(RPdb *pdb) {
@@ -17,9 +17,45 @@ int init_r_stream_file(R_STREAM_FILE *stream_file, RBuffer *buf, int *pages, int
 		stream_file->end = size;
 	}
 	stream_file->pos = 0;
+	stream_file->data = NULL;
 	return 1;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// reads all the pages of the stream once into a contiguous buffer, later
+/// reads are served from memory and never touch the shared RBuffer
+////////////////////////////////////////////////////////////////////////////////
+bool stream_file_load(R_STREAM_FILE *stream_file) {
+	if (stream_file->data) {
+		return true;
+	}
+	if (stream_file->end < 1 || stream_file->page_size < 1) {
+		return false;
+	}
+	size_t pages = R_MIN ((size_t)stream_file->pages_amount,
+		((size_t)stream_file->end + stream_file->page_size - 1) / stream_file->page_size);
+	ut8 *data = calloc (pages + 1, stream_file->page_size);
+	if (!data) {
+		return false;
+	}
+	size_t i;
+	for (i = 0; i < pages; i++) {
+		ut64 page_offset = (ut64)stream_file->pages[i] * stream_file->page_size;
+		if (page_offset < 1) {
+			break;
+		}
+		r_buf_read_at (stream_file->buf, page_offset,
+			data + (i * stream_file->page_size), stream_file->page_size);
+	}
+	stream_file->data = data;
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void stream_file_fini(R_STREAM_FILE *stream_file) {
+	R_FREE (stream_file->data);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 static void stream_file_read_pages(R_STREAM_FILE *stream_file, int start_indx, int end_indx, char *res) {
 	int i, page_offset;
@@ -46,6 +82,19 @@ static void stream_file_read_pages(R_STREAM_FILE *stream_file, int start_indx, i
 ///////////////////////////////////////////////////////////////////////////////
 void stream_file_read(R_STREAM_FILE *stream_file, int size, char *res) {
 	size_t pn_start, off_start, pn_end, off_end;
+	if (stream_file->data) {
+		int pos = stream_file->pos;
+		if (size == -1) {
+			size = stream_file->end - pos;
+		}
+		int avail = R_MAX (0, R_MIN (size, stream_file->end - pos));
+		memcpy (res, stream_file->data + pos, avail);
+		if (avail < size) {
+			memset (res + avail, 0, size - avail);
+		}
+		stream_file->pos = R_MIN (pos + size, stream_file->end);
+		return;
+	}
 	if (size == -1) {
 		char *pdata = (char *) calloc(stream_file->pages_amount, stream_file->page_size);
 		if (pdata) {
@@ -10,6 +10,12 @@
 int init_r_stream_file(R_STREAM_FILE *stream_file, RBuffer *buf, int *pages,
 							  int pages_amount, int size, int page_size);
 
+///////////////////////////////////////////////////////////////////////////////
+bool stream_file_load(R_STREAM_FILE *stream_file);
+
+///////////////////////////////////////////////////////////////////////////////
+void stream_file_fini(R_STREAM_FILE *stream_file);
+
 // size by default = -1
 ///////////////////////////////////////////////////////////////////////////////
 void stream_file_read(R_STREAM_FILE *stream_file, int size, char *res);
@@ -5,7 +5,12 @@
 #include "stream_file.h"
 
 static R_TH_LOCAL unsigned int base_idx = 0;
-static R_TH_LOCAL RList *p_types_list;
+static R_TH_LOCAL SType **p_types_index = NULL;
+static R_TH_LOCAL ut32 p_types_count = 0;
+
+static SType *type_at(ut32 indx) {
+	return (p_types_index && indx < p_types_count)? p_types_index[indx]: NULL;
+}
 
 static bool is_simple_type(int idx) {
 	ut32 value = (ut32) idx;
@@ -820,7 +825,7 @@ static int get_array_element_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -846,7 +851,7 @@ static int get_array_index_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -873,7 +878,7 @@ static int get_bitfield_base_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -887,7 +892,7 @@ static int get_class_struct_derived(void *type, void **ret_type) {
 
 	if (curr_idx) {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	} else {
 		*ret_type = NULL;
 	}
@@ -902,7 +907,7 @@ static int get_class_struct_vshape(void *type, void **ret_type) {
 
 	if (curr_idx) {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	} else {
 		*ret_type = NULL;
 	}
@@ -929,7 +934,7 @@ static int get_mfunction_return_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -942,7 +947,7 @@ static int get_mfunction_class_type(void *type, void **ret_type) {
 
 	if (curr_idx) {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	} else {
 		*ret_type = NULL;
 	}
@@ -957,7 +962,7 @@ static int get_mfunction_this_type(void *type, void **ret_type) {
 
 	if (curr_idx) {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	} else {
 		*ret_type = NULL;
 	}
@@ -973,7 +978,7 @@ static int get_mfunction_arglist(void *type, void **ret_type) {
 
 	if (curr_idx) {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	} else {
 		*ret_type = NULL;
 	}
@@ -1001,7 +1006,7 @@ static int get_modifier_modified_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -1027,7 +1032,7 @@ static int get_pointer_utype(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -1052,7 +1057,7 @@ static int get_procedure_return_type(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -1077,7 +1082,7 @@ static int get_procedure_arglist(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -1102,7 +1107,7 @@ static int get_member_index(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -1127,7 +1132,7 @@ static int get_nesttype_index(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -1152,7 +1157,7 @@ static int get_onemethod_index(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -1177,7 +1182,7 @@ static int get_method_mlist(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -1202,7 +1207,7 @@ static int get_enum_utype(void *type, void **ret_type) {
 		return true; // check what are the return values used for
 	} else {
 		curr_idx -= base_idx;
-		*ret_type = r_list_get_n(p_types_list, curr_idx);
+		*ret_type = type_at (curr_idx);
 	}
 
 	return curr_idx;
@@ -1225,7 +1230,7 @@ static void get_union_members(void *type, RList **l) {
 	} else {
 		SType *tmp = 0;
 		indx = lf_union->field_list - base_idx;
-		tmp = (SType *)r_list_get_n(p_types_list, indx);
+		tmp = type_at (indx);
 		*l = tmp ? ((SLF_FIELDLIST *)tmp->type_data.type_info)->substructs : NULL;
 	}
 }
@@ -1240,7 +1245,7 @@ static void get_struct_class_members(void *type, RList **l) {
 	} else {
 		SType *tmp = 0;
 		indx = lf->field_list - base_idx;
-		tmp = (SType *)r_list_get_n(p_types_list, indx);
+		tmp = type_at (indx);
 		*l = tmp ? ((SLF_FIELDLIST *)tmp->type_data.type_info)->substructs : NULL;
 	}
 }
@@ -1255,7 +1260,7 @@ static void get_enum_members(void *type, RList **l) {
 	} else {
 		SType *tmp = 0;
 		indx = lf->field_list - base_idx;
-		tmp = (SType *)r_list_get_n(p_types_list, indx);
+		tmp = type_at (indx);
 		*l = tmp ? ((SLF_FIELDLIST *)tmp->type_data.type_info)->substructs : NULL;
 	}
 }
@@ -1663,6 +1668,11 @@ static void free_tpi_stream(void *stream) {
 		R_FREE (type);
 	}
 	r_list_free (tpi_stream->types);
+	if (p_types_index == tpi_stream->index) {
+		p_types_index = NULL;
+		p_types_count = 0;
+	}
+	R_FREE (tpi_stream->index);
 }
 
 static void get_array_print_type(void *type, char **name) {
@@ -2852,7 +2862,7 @@ static int parse_lf_vtshape(SLF_VTSHAPE *lf_vtshape, uint8_t *leaf_data, unsigne
 
 #define PARSE_LF(lf_type, lf_func) { \
 	lf_type *lf = (lf_type *) malloc(sizeof (lf_type)); \
-	if (!lf) { free (leaf_data); return 0; }\
+	if (!lf) { if (owned) { free (leaf_data); } return 0; }\
 	parse_##lf_func(lf, leaf_data + 2, &read_bytes, type->length); \
 	type->type_data.type_info = (void *) lf; \
 	init_stype_info(&type->type_data); \
@@ -2862,17 +2872,30 @@ static int parse_lf_vtshape(SLF_VTSHAPE *lf_vtshape, uint8_t *leaf_data, unsigne
 static int parse_tpi_stypes(R_STREAM_FILE *stream, SType *type) {
 	uint8_t *leaf_data;
 	unsigned int read_bytes = 0;
+	bool owned = true;
 
 	stream_file_read(stream, 2, (char *)&type->length);
 	if (type->length < 1) {
 		return 0;
 	}
-	leaf_data = (uint8_t *) malloc(type->length);
-	if (!leaf_data) {
-		return 0;
+	if (stream->data) {
+		// the stream is in memory, parse the leaf in place
+		if (type->length > stream->end - stream->pos) {
+			stream_file_seek (stream, 0, 2);
+			return 0;
+		}
+		leaf_data = stream->data + stream->pos;
+		stream_file_seek (stream, type->length, 1);
+		owned = false;
+	} else {
+		leaf_data = (uint8_t *) malloc(type->length);
+		if (!leaf_data) {
+			return 0;
+		}
+		stream_file_read (stream, type->length, (char *)leaf_data);
 	}
-	stream_file_read (stream, type->length, (char *)leaf_data);
-	type->type_data.leaf_type = *(uint16_t *)leaf_data;
+	// the leaves are not aligned in the stream
+	type->type_data.leaf_type = r_read_le16 (leaf_data);
 	read_bytes += 2;
 	switch (type->type_data.leaf_type) {
 	case eLF_FIELDLIST:
@@ -2892,7 +2915,9 @@ static int parse_tpi_stypes(R_STREAM_FILE *stream, SType *type) {
 	{
 		SLF_POINTER *lf = (SLF_POINTER *) malloc(sizeof (SLF_POINTER)); \
 		if (!lf) { \
-			free (leaf_data); \
+			if (owned) { \
+				free (leaf_data); \
+			} \
 			return 0; \
 		} \
 		parse_lf_pointer(lf, leaf_data + 2, &read_bytes, type->length); \
@@ -2933,33 +2958,48 @@ static int parse_tpi_stypes(R_STREAM_FILE *stream, SType *type) {
 		break;
 	}
 
-	free (leaf_data);
+	if (owned) {
+		free (leaf_data);
+	}
 	return read_bytes;
 }
 
 int parse_tpi_stream(void *parsed_pdb_stream, R_STREAM_FILE *stream) {
-	int i;
+	ut32 i;
 	SType *type = 0;
 	STpiStream *tpi_stream = (STpiStream *) parsed_pdb_stream;
 	tpi_stream->types = r_list_new ();
-	p_types_list = tpi_stream->types;
 
 	stream_file_read(stream, sizeof (STPIHeader), (char *)&tpi_stream->header);
 
 	base_idx = tpi_stream->header.idx_begin;
+	if (tpi_stream->header.idx_end > tpi_stream->header.idx_begin) {
+		// every record takes at least 4 bytes, do not trust bogus headers
+		ut32 count = tpi_stream->header.idx_end - tpi_stream->header.idx_begin;
+		count = R_MIN (count, (ut32)R_MAX (stream->end, 0) / 4);
+		tpi_stream->index = R_NEWS0 (SType *, count + 1);
+		if (!tpi_stream->index) {
+			return 0;
+		}
+		tpi_stream->index_count = count;
+	}
+	p_types_index = tpi_stream->index;
+	p_types_count = tpi_stream->index_count;
 
-	for (i = tpi_stream->header.idx_begin; i < tpi_stream->header.idx_end; i++) {
+	for (i = 0; i < tpi_stream->index_count; i++) {
 		type = (SType *) malloc (sizeof (SType));
 		if (!type) {
 			return 0;
 		}
-		type->tpi_idx = i;
+		type->tpi_idx = tpi_stream->header.idx_begin + i;
 		type->type_data.type_info = 0;
 		type->type_data.leaf_type = eLF_MAX;
 		init_stype_info(&type->type_data);
 		if (!parse_tpi_stypes(stream, type)) {
 			R_FREE (type);
 		}
+		// indices are resolved lazily by the getters through type_at
+		tpi_stream->index[i] = type;
 		r_list_append(tpi_stream->types, type);
 	}
 	return 1;
@@ -99,6 +99,7 @@ typedef struct R_STREAM_FILE_{
 	int end;
 	int pos;
 	int error;
+	ut8 *data; // stream contents, owned once loaded with stream_file_load
 } R_STREAM_FILE;
 
 typedef void (*free_func)(void *);
@@ -1150,6 +1151,8 @@ typedef struct {
 typedef struct {
 	STPIHeader header;
 	RList *types;
+	SType **index; // types by (tpi_idx - idx_begin), entries owned by types
+	ut32 index_count;
 
 	free_func free_;
 } STpiStream;
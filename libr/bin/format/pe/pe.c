@@ -3526,8 +3526,7 @@ struct r_bin_pe_export_t* PE_(r_bin_pe_get_exports)(RBinPEObj* pe) {
 	data_dir_export = &pe->data_directory[PE_IMAGE_DIRECTORY_ENTRY_EXPORT];
 	export_dir_rva = data_dir_export->VirtualAddress;
 	export_dir_size = data_dir_export->Size;
-	PE_VWord *func_rvas = NULL;
-	PE_Word *ordinals = NULL;
+	RBufferSpan ordinals = {0}, func_rvas = {0}, names = {0};
 	if (pe->export_directory) {
 		if (pe->export_directory->NumberOfFunctions + 1 <
 		pe->export_directory->NumberOfFunctions) {
@@ -3557,33 +3556,31 @@ struct r_bin_pe_export_t* PE_(r_bin_pe_get_exports)(RBinPEObj* pe) {
 
 		const size_t names_sz = pe->export_directory->NumberOfNames * sizeof (PE_Word);
 		const size_t funcs_sz = pe->export_directory->NumberOfFunctions * sizeof (PE_VWord);
-		ordinals = malloc (names_sz);
-		func_rvas = malloc (funcs_sz);
-		if (!ordinals || !func_rvas) {
+		if (!r_buf_span (pe->b, ordinals_paddr, names_sz, &ordinals) || ordinals.len != names_sz) {
 			goto beach;
 		}
-		int r = r_buf_read_at (pe->b, ordinals_paddr, (ut8 *)ordinals, names_sz);
-		if (r != names_sz) {
-			goto beach;
-		}
-		r = r_buf_read_at (pe->b, functions_paddr, (ut8 *)func_rvas, funcs_sz);
-		if (r != funcs_sz) {
+		if (!r_buf_span (pe->b, functions_paddr, funcs_sz, &func_rvas) || func_rvas.len != funcs_sz) {
 			goto beach;
 		}
+		// the names are only needed for the matching ordinals, so it can be short
+		(void)r_buf_span (pe->b, names_paddr, pe->export_directory->NumberOfNames * sizeof (PE_VWord), &names);
 		for (i = 0; i < pe->export_directory->NumberOfFunctions; i++) {
 			// get vaddr from AddressOfFunctions array
-			function_rva = r_read_at_ble32 ((ut8 *)func_rvas, i * sizeof (PE_VWord), pe->endian);
+			function_rva = r_read_at_ble32 (func_rvas.data, i * sizeof (PE_VWord), pe->endian);
 			// have exports by name?
 			if (pe->export_directory->NumberOfNames > 0) {
 				// search for value of i into AddressOfOrdinals
 				name_vaddr = 0;
 				for (n = 0; n < pe->export_directory->NumberOfNames; n++) {
-					PE_Word fo = r_read_at_ble16 ((ut8 *)ordinals, n * sizeof (PE_Word), pe->endian);
+					PE_Word fo = r_read_at_ble16 (ordinals.data, n * sizeof (PE_Word), pe->endian);
 					// if exist this index into AddressOfOrdinals
 					if (i == fo) {
 						function_ordinal = fo;
 						// get the VA of export name  from AddressOfNames
-						name_vaddr = r_buf_read_le32_at (pe->b, names_paddr + n * sizeof (PE_VWord));
+						const ut64 name_at = n * sizeof (PE_VWord);
+						name_vaddr = (name_at + sizeof (PE_VWord) <= names.len)
+							? r_read_le32 (names.data + name_at)
+							: r_buf_read_le32_at (pe->b, names_paddr + name_at);
 						break;
 					}
 				}
@@ -3594,7 +3591,7 @@ struct r_bin_pe_export_t* PE_(r_bin_pe_get_exports)(RBinPEObj* pe) {
 					if (r_buf_read_at (pe->b, name_paddr, (ut8*) function_name, PE_NAME_LENGTH) < 1) {
 						pe_printf ("Warning: read (function name)\n");
 						exports[i].last = 1;
-						return exports;
+						goto done;
 					}
 				} else { // No name export, get the ordinal
 					function_ordinal = i;
@@ -3608,7 +3605,7 @@ struct r_bin_pe_export_t* PE_(r_bin_pe_get_exports)(RBinPEObj* pe) {
 				// if forwarder, the VA point to Forwarded name
 				if (r_buf_read_at (pe->b, PE_(va2pa) (pe, function_rva), (ut8*) forwarder_name, PE_NAME_LENGTH) < 1) {
 					exports[i].last = 1;
-					return exports;
+					goto done;
 				}
 			} else { // no forwarder export
 				snprintf (forwarder_name, PE_NAME_LENGTH, "NONE");
@@ -3627,18 +3624,25 @@ struct r_bin_pe_export_t* PE_(r_bin_pe_get_exports)(RBinPEObj* pe) {
 			exports[i].last = 0;
 		}
 		exports[i].last = 1;
-		free (ordinals);
-		free (func_rvas);
+		r_buf_span_fini (&ordinals);
+		r_buf_span_fini (&func_rvas);
+		r_buf_span_fini (&names);
 	}
 	exp = parse_symbol_table (pe, exports, exports_sz - sizeof (struct r_bin_pe_export_t));
 	if (exp) {
 		exports = exp;
 	}
 	return exports;
+done:
+	r_buf_span_fini (&ordinals);
+	r_buf_span_fini (&func_rvas);
+	r_buf_span_fini (&names);
+	return exports;
 beach:
 	free (exports);
-	free (ordinals);
-	free (func_rvas);
+	r_buf_span_fini (&ordinals);
+	r_buf_span_fini (&func_rvas);
+	r_buf_span_fini (&names);
 	return NULL;
 }
 
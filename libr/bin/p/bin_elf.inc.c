@@ -773,7 +773,7 @@ static RList* relocs(RBinFile *bf) {
 	return ret;
 }
 
-static void _patch_reloc(ELFOBJ *bo, ut16 e_machine, RIOBind *iob, RBinElfReloc *rel, ut64 S, ut64 B, ut64 L) {
+static void _patch_reloc(ELFOBJ *bo, ut16 e_machine, RBinPatchBatch *pb, RBinElfReloc *rel, ut64 S, ut64 B, ut64 L) {
 	ut64 V = 0;
 	ut64 A = rel->addend;
 	ut64 P = rel->rva;
@@ -782,34 +782,34 @@ static void _patch_reloc(ELFOBJ *bo, ut16 e_machine, RIOBind *iob, RBinElfReloc
 	case EM_S390:
 		switch (rel->type) {
 		case R_390_GLOB_DAT: // globals
-			iob->overlay_write_at (iob->io, rel->rva, buf, 8);
+			r_bin_patch_batch_add (pb, rel->rva, buf, 8);
 			break;
 		case R_390_RELATIVE:
-			iob->overlay_write_at (iob->io, rel->rva, buf, 8);
+			r_bin_patch_batch_add (pb, rel->rva, buf, 8);
 			break;
 		}
 		break;
 	case EM_ARM:
 		if (!rel->sym && rel->mode == DT_REL) {
-			iob->read_at (iob->io, rel->rva, buf, 4);
+			r_bin_patch_batch_read (pb, rel->rva, buf, 4);
 		} else {
 			V = S + A;
 			r_write_ble32 (buf, V, bo->endian);
 		}
-		iob->overlay_write_at (iob->io, rel->rva, buf, 4);
+		r_bin_patch_batch_add (pb, rel->rva, buf, 4);
 		break;
 	case EM_AARCH64:
 		V = S + A;
 #if 0
 		r_write_le64 (buf, V);
-		iob->overlay_write_at (iob->io, rel->rva, buf, 8);
+		r_bin_patch_batch_add (pb, rel->rva, buf, 8);
 #else
-		iob->read_at (iob->io, rel->rva, buf, 8);
+		r_bin_patch_batch_read (pb, rel->rva, buf, 8);
 		// only patch the relocs that are initialized with zeroes
 		// if the destination contains a different value it's a constant useful for static analysis
 		ut64 addr = r_read_le64 (buf);
 		r_write_le64 (buf, addr? A: S);
-		iob->overlay_write_at (iob->io, rel->rva, buf, 8);
+		r_bin_patch_batch_add (pb, rel->rva, buf, 8);
 #endif
 		break;
 	case EM_PPC64: {
@@ -843,15 +843,15 @@ static void _patch_reloc(ELFOBJ *bo, ut16 e_machine, RIOBind *iob, RBinElfReloc
 			switch (low) {
 			case 14:
 				V &= (1 << 14) - 1;
-				iob->read_at (iob->io, rel->rva, buf, 2);
+				r_bin_patch_batch_read (pb, rel->rva, buf, 2);
 				r_write_le32 (buf, (r_read_le32 (buf) & ~((1<<16) - (1<<2))) | V << 2);
-				iob->overlay_write_at (iob->io, rel->rva, buf, 2);
+				r_bin_patch_batch_add (pb, rel->rva, buf, 2);
 				break;
 			case 24:
 				V &= (1 << 24) - 1;
-				iob->read_at (iob->io, rel->rva, buf, 4);
+				r_bin_patch_batch_read (pb, rel->rva, buf, 4);
 				r_write_le32 (buf, (r_read_le32 (buf) & ~((1<<26) - (1<<2))) | V << 2);
-				iob->overlay_write_at (iob->io, rel->rva, buf, 4);
+				r_bin_patch_batch_add (pb, rel->rva, buf, 4);
 				break;
 			}
 		} else if (word) {
@@ -859,11 +859,11 @@ static void _patch_reloc(ELFOBJ *bo, ut16 e_machine, RIOBind *iob, RBinElfReloc
 			switch (word) {
 			case 2:
 				r_write_le16 (buf, V);
-				iob->overlay_write_at (iob->io, rel->rva, buf, 2);
+				r_bin_patch_batch_add (pb, rel->rva, buf, 2);
 				break;
 			case 4:
 				r_write_le32 (buf, V);
-				iob->overlay_write_at (iob->io, rel->rva, buf, 4);
+				r_bin_patch_batch_add (pb, rel->rva, buf, 4);
 				break;
 			}
 		}
@@ -874,13 +874,13 @@ static void _patch_reloc(ELFOBJ *bo, ut16 e_machine, RIOBind *iob, RBinElfReloc
  		case R_386_32:
  		case R_386_PC32:
 			{
- 			r_io_read_at (iob->io, rel->rva, buf, 4);
+ 			r_bin_patch_batch_read (pb, rel->rva, buf, 4);
  			ut32 v = r_read_le32 (buf) + S + A;
  			if (rel->type == R_386_PC32) {
  				v -= P;
  			}
  			r_write_le32 (buf, v);
-			iob->overlay_write_at (iob->io, rel->rva, buf, 4);
+			r_bin_patch_batch_add (pb, rel->rva, buf, 4);
 			}
 			break;
  		default:
@@ -957,19 +957,19 @@ static void _patch_reloc(ELFOBJ *bo, ut16 e_machine, RIOBind *iob, RBinElfReloc
 			break;
 		case 1:
 			buf[0] = V;
-			iob->overlay_write_at (iob->io, rel->rva, buf, 1);
+			r_bin_patch_batch_add (pb, rel->rva, buf, 1);
 			break;
 		case 2:
 			r_write_le16 (buf, V);
-			iob->overlay_write_at (iob->io, rel->rva, buf, 2);
+			r_bin_patch_batch_add (pb, rel->rva, buf, 2);
 			break;
 		case 4:
 			r_write_le32 (buf, V);
-			iob->overlay_write_at (iob->io, rel->rva, buf, 4);
+			r_bin_patch_batch_add (pb, rel->rva, buf, 4);
 			break;
 		case 8:
 			r_write_le64 (buf, V);
-			iob->overlay_write_at (iob->io, rel->rva, buf, 8);
+			r_bin_patch_batch_add (pb, rel->rva, buf, 8);
 			break;
 		}
 		break;
@@ -1045,6 +1045,8 @@ static RList* patch_relocs(RBinFile *bf) {
 		r_list_free (ret);
 		return NULL;
 	}
+	RBinPatchBatch pb;
+	r_bin_patch_batch_init (&pb, &b->iob);
 	ut64 vaddr = n_vaddr;
 	RBinElfReloc *reloc;
 	r_vector_foreach (relocs, reloc) {
@@ -1065,7 +1067,7 @@ static RList* patch_relocs(RBinFile *bf) {
 		}
 		// ut64 raddr = sym_addr? sym_addr: vaddr;
 		ut64 raddr = (sym_addr && sym_addr != UT64_MAX)? sym_addr: vaddr;
-		_patch_reloc (eo, eo->ehdr.e_machine, &b->iob, reloc, raddr, 0, plt_entry_addr);
+		_patch_reloc (eo, eo->ehdr.e_machine, &pb, reloc, raddr, 0, plt_entry_addr);
 		ptr = reloc_convert (eo, reloc, n_vaddr);
 		if (!ptr) {
 			continue;
@@ -1080,6 +1082,9 @@ static RList* patch_relocs(RBinFile *bf) {
 		}
 		r_list_append (ret, ptr);
 	}
+	int writes = r_bin_patch_batch_flush (&pb);
+	R_LOG_DEBUG ("relocs patched with %d writes", writes);
+	r_bin_patch_batch_fini (&pb);
 	ht_uu_free (relocs_by_sym);
 	return ret;
 }
@@ -387,7 +387,7 @@ static RBinInfo *info(RBinFile *bf) {
 	return ret;
 }
 
-static bool _patch_reloc(struct MACH0_(obj_t) *mo, RIOBind *iob, struct reloc_t *reloc, ut64 symbol_at) {
+static bool _patch_reloc(struct MACH0_(obj_t) *mo, RBinPatchBatch *pb, struct reloc_t *reloc, ut64 symbol_at) {
 	ut64 pc = reloc->addr;
 	ut64 ins_len = 0;
 
@@ -426,7 +426,7 @@ static bool _patch_reloc(struct MACH0_(obj_t) *mo, RIOBind *iob, struct reloc_t
 		R_LOG_WARN ("invalid reloc size %d at 0x%08"PFMT64x, reloc->size, reloc->addr);
 		return false;
 	}
-	if (!iob->overlay_write_at (iob->io, reloc->addr, buf, reloc->size)) {
+	if (!r_bin_patch_batch_add (pb, reloc->addr, buf, reloc->size)) {
 		R_LOG_WARN ("cannot write reloc at 0x%"PFMT64x, reloc->addr);
 		return false;
 	}
@@ -459,6 +459,8 @@ static RList* patch_relocs(RBinFile *bf) {
 	}
 	RPVector ext_relocs;
 	r_pvector_init (&ext_relocs, NULL);
+	RBinPatchBatch pb;
+	r_bin_patch_batch_init (&pb, &b->iob);
 	RSkipListNode *it;
 	struct reloc_t *reloc;
 	r_skiplist_foreach (all_relocs, it, reloc) {
@@ -472,7 +474,7 @@ static RList* patch_relocs(RBinFile *bf) {
 		relocs_count = r_list_length (mo->reloc_fixups);
 	}
 	if (mo->reloc_fixups && relocs_count > 0) {
-		ut8 buf[8], obuf[8];
+		ut8 buf[8];
 		RBinReloc *r;
 		RListIter *iter2;
 
@@ -489,13 +491,11 @@ static RList* patch_relocs(RBinFile *bf) {
 			}
 			ut64 paddr = r->paddr + mo->baddr;
 			r_write_ble64 (buf, r->vaddr, false);
-			b->iob.read_at (b->iob.io, paddr, obuf, 8);
-			if (memcmp (buf, obuf, 8)) {
-				if (!b->iob.overlay_write_at (b->iob.io, paddr, buf, 8)) {
-					R_LOG_ERROR ("write error at 0x%"PFMT64x, paddr);
-				}
-			}
+			// the batch skips the bytes that already hold the right value
+			r_bin_patch_batch_add (&pb, paddr, buf, 8);
 		}
+		// fixups are written now, the external relocs below may land on them
+		r_bin_patch_batch_flush (&pb);
 	}
 	ut64 num_ext_relocs = r_pvector_length (&ext_relocs);
 	if (!num_ext_relocs) {
@@ -552,7 +552,7 @@ static RList* patch_relocs(RBinFile *bf) {
 			ht_uu_insert (relocs_by_sym, reloc->ord, vaddr);
 			vaddr += cdsz;
 		}
-		if (!_patch_reloc (mo, &b->iob, reloc, sym_addr)) {
+		if (!_patch_reloc (mo, &pb, reloc, sym_addr)) {
 			continue;
 		}
 		RBinReloc *ptr = R_NEW0 (RBinReloc);
@@ -569,15 +569,18 @@ static RList* patch_relocs(RBinFile *bf) {
 			}
 		}
 	}
+	r_bin_patch_batch_flush (&pb);
 	if (r_list_empty (ret)) {
 		goto beach;
 	}
+	r_bin_patch_batch_fini (&pb);
 	ht_uu_free (relocs_by_sym);
 	r_pvector_fini (&ext_relocs);
 	// XXX r_io_desc_free (gotr2desc);
 	return ret;
 
 beach:
+	r_bin_patch_batch_fini (&pb);
 	r_pvector_fini (&ext_relocs);
 	r_io_desc_free (gotr2desc);
 	r_list_free (ret);
@@ -64,6 +64,7 @@ R_API bool r_config_set_getter(RConfig *cfg, const char *key, RConfigCallback cb
 	RConfigNode *node = r_config_node_get (cfg, key);
 	if (node) {
 		node->getter = cb;
+		cfg->gen++;
 		return true;
 	}
 	return false;
@@ -359,25 +359,26 @@ R_API bool r_config_get_b(RConfig *cfg, const char *name) {
 	return r_config_get_i (cfg, name) != 0;
 }
 
+static ut64 node_get_i(RConfig *cfg, RConfigNode *node) {
+	if (node->getter) {
+		node->getter (cfg->user, node);
+	}
+	if (node->i_value) {
+		return node->i_value;
+	}
+	if (!strcmp (node->value, "false")) {
+		return 0;
+	}
+	if (!strcmp (node->value, "true")) {
+		return 1;
+	}
+	return (ut64) r_num_math (cfg->num, node->value);
+}
+
 R_API ut64 r_config_get_i(RConfig *cfg, const char *name) {
 	R_RETURN_VAL_IF_FAIL (cfg, 0ULL);
 	RConfigNode *node = r_config_node_get (cfg, name);
-	if (node) {
-		if (node->getter) {
-			node->getter (cfg->user, node);
-		}
-		if (node->i_value) {
-			return node->i_value;
-		}
-		if (!strcmp (node->value, "false")) {
-			return 0;
-		}
-		if (!strcmp (node->value, "true")) {
-			return 1;
-		}
-		return (ut64) r_num_math (cfg->num, node->value);
-	}
-	return 0ULL;
+	return node? node_get_i (cfg, node): 0ULL;
 }
 
 R_API const char* r_config_node_type(RConfigNode *node) {
@@ -436,6 +437,7 @@ R_API RConfigNode* r_config_set(RConfig *cfg, const char *name, const char *valu
 	ut64 oi;
 	R_RETURN_VAL_IF_FAIL (cfg && cfg->ht, NULL);
 	R_RETURN_VAL_IF_FAIL (!IS_NULLSTR (name), NULL);
+	cfg->gen++;
 	RConfigNode *node = r_config_node_get (cfg, name);
 	if (node) {
 		if (r_config_node_is_ro (node)) {
@@ -541,6 +543,7 @@ R_API bool r_config_rm(RConfig *cfg, const char *name) {
 	RConfigNode *node = r_config_node_get (cfg, name);
 	if (node) {
 		R_DIRTY (cfg);
+		cfg->gen++;
 		ht_pp_delete (cfg->ht, node->name);
 		r_list_delete_data (cfg->nodes, node);
 		return true;
@@ -576,6 +579,7 @@ R_API RConfigNode* r_config_set_b(RConfig *cfg, const char *name, bool b) {
 	if (!node) {
 		return NULL;
 	}
+	cfg->gen++;
 	node->flags = CN_RW | CN_BOOL;
 	node->i_value = b;
 	ht_pp_insert (cfg->ht, node->name, node);
@@ -590,6 +594,7 @@ R_API RConfigNode* r_config_set_i(RConfig *cfg, const char *name, const ut64 i)
 	R_RETURN_VAL_IF_FAIL (cfg && name, NULL);
 	RConfigNode *node = r_config_node_get (cfg, name);
 	R_DIRTY (cfg);
+	cfg->gen++;
 	if (node) {
 		if (r_config_node_is_ro (node)) {
 			node = NULL;
@@ -726,6 +731,7 @@ R_API RConfig* r_config_new(void *user) {
 	cfg->user = user;
 	cfg->num = NULL;
 	cfg->lock = false;
+	cfg->gen = 1;
 	cfg->cb_printf = (void *) printf;
 	R_DIRTY (cfg);
 	return cfg;
@@ -773,6 +779,110 @@ R_API void r_config_bump(RConfig *cfg, const char *key) {
 	}
 }
 
+R_API RConfigSnap *r_config_snap_new(RConfig *cfg, const RConfigSnapField *fields, size_t count) {
+	R_RETURN_VAL_IF_FAIL (cfg && fields && count > 0, NULL);
+	RConfigSnap *snap = R_NEW0 (RConfigSnap);
+	if (!snap) {
+		return NULL;
+	}
+	snap->values = R_NEWS0 (RConfigSnapValue, count);
+	if (!snap->values) {
+		free (snap);
+		return NULL;
+	}
+	snap->fields = fields;
+	snap->count = count;
+	r_config_snap_refresh (snap, cfg);
+	return snap;
+}
+
+R_API void r_config_snap_free(RConfigSnap *snap) {
+	if (snap) {
+		free (snap->values);
+		free (snap);
+	}
+}
+
+static void snap_read(RConfig *cfg, const RConfigSnapField *f, RConfigSnapValue *v) {
+	RConfigNode *node = v->node;
+	if (!node) {
+		v->i = 0;
+		v->s = NULL;
+		return;
+	}
+	if (f->type == R_CONFIG_SNAP_STR) {
+		if (node->getter) {
+			node->getter (cfg->user, node);
+		}
+		v->s = r_config_node_is_bool (node)
+			? r_str_bool (r_str_is_true (node->value))
+			: node->value;
+	} else {
+		v->i = node_get_i (cfg, node);
+	}
+}
+
+// resolve the nodes and their values again if the config changed after the last refresh
+R_API bool r_config_snap_refresh(RConfigSnap *snap, RConfig *cfg) {
+	R_RETURN_VAL_IF_FAIL (snap && cfg, false);
+	size_t i;
+	if (snap->cfg == cfg && snap->gen == cfg->gen) {
+		if (snap->dynamic > 0) {
+			for (i = 0; i < snap->count; i++) {
+				if (snap->values[i].dynamic) {
+					snap_read (cfg, &snap->fields[i], &snap->values[i]);
+				}
+			}
+		}
+		return false;
+	}
+	snap->dynamic = 0;
+	for (i = 0; i < snap->count; i++) {
+		const RConfigSnapField *f = &snap->fields[i];
+		RConfigSnapValue *v = &snap->values[i];
+		v->node = r_config_node_get (cfg, f->name);
+		if (!v->node) {
+			R_LOG_DEBUG ("Variable '%s' not found", f->name);
+		}
+		v->dynamic = v->node && v->node->getter;
+		if (v->dynamic) {
+			snap->dynamic++;
+		}
+		snap_read (cfg, f, v);
+	}
+	snap->cfg = cfg;
+	// getters may change the config while reading it
+	snap->gen = cfg->gen;
+	return true;
+}
+
+// refresh the snapshot if needed and store the typed values in the fields of dst
+R_API void r_config_snap_load(RConfigSnap *snap, RConfig *cfg, void *dst) {
+	R_RETURN_IF_FAIL (snap && cfg && dst);
+	r_config_snap_refresh (snap, cfg);
+	ut8 *base = dst;
+	size_t i;
+	for (i = 0; i < snap->count; i++) {
+		const RConfigSnapField *f = &snap->fields[i];
+		const RConfigSnapValue *v = &snap->values[i];
+		void *p = base + f->offset;
+		switch (f->type) {
+		case R_CONFIG_SNAP_BOOL:
+			*(bool *)p = v->i != 0;
+			break;
+		case R_CONFIG_SNAP_INT:
+			*(int *)p = (int)v->i;
+			break;
+		case R_CONFIG_SNAP_UT64:
+			*(ut64 *)p = v->i;
+			break;
+		case R_CONFIG_SNAP_STR:
+			*(const char **)p = v->s;
+			break;
+		}
+	}
+}
+
 R_API void r_config_serialize(R_NONNULL RConfig *config, R_NONNULL Sdb *db) {
 	RListIter *iter;
 	RConfigNode *node;
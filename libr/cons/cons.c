@@ -785,6 +785,7 @@ R_API RCons *r_cons_free(void) {
 	R_FREE (C->lastOutput);
 	C->lastLength = 0;
 	R_FREE (I->pager);
+	R_FREE (I->screen.rows);
 	RVecFdPairs_fini (&I->fds);
 	return NULL;
 }
@@ -1106,6 +1107,49 @@ R_API char *r_cons_drain(void) {
 	return s;
 }
 
+// length of the escape sequence at s and its final byte
+static int ansi_seqlen(const char *s, int len, char *fin) {
+	int i = 2;
+	*fin = 0;
+	if (len < 2) {
+		return len;
+	}
+	if (s[1] == '[') {
+		while (i < len && (s[i] < 0x40 || s[i] > 0x7e)) {
+			i++;
+		}
+		if (i < len) {
+			*fin = s[i++];
+		}
+		return i;
+	}
+	if (s[1] == ']') {
+		while (i < len && s[i] != 7 && s[i] != 0x1b) {
+			i++;
+		}
+		*fin = ']';
+		return (i < len && s[i] == 0x1b)? R_MIN (i + 2, len): R_MIN (i + 1, len);
+	}
+	*fin = s[1];
+	return 2;
+}
+
+// true if the buffer prints anything besides escape sequences
+static bool has_text(const char *s, int len) {
+	int i = 0;
+	while (i < len) {
+		if (s[i] == 0x1b) {
+			char fin;
+			i += ansi_seqlen (s + i, len - i, &fin);
+		} else if (IS_PRINTABLE (s[i]) || s[i] == '\n' || s[i] == '\t') {
+			return true;
+		} else {
+			i++;
+		}
+	}
+	return false;
+}
+
 R_API void r_cons_flush(void) {
 	if (!r_cons_instance) {
 		r_cons_instance = &g_cons_instance;
@@ -1200,6 +1244,10 @@ R_API void r_cons_flush(void) {
 		}
 	}
 	r_cons_highlight (I->highlight);
+	if (I->screen.valid && has_text (C->buffer, C->buffer_len)) {
+		// something was printed over the last visual frame
+		I->screen.valid = false;
+	}
 
 	if (r_cons_is_interactive () && !r_sandbox_enable (false)) {
 		if (I->linesleep > 0 && I->linesleep < 1000) {
@@ -1263,33 +1311,46 @@ R_API void r_cons_visual_flush(void) {
 	}
 }
 
+/* Prints the frames per second, the milliseconds since the key that caused
+ * the frame was read (or since the previous frame when it came without any
+ * key) and the rows written by the last frame when damage is enabled */
 R_API void r_cons_print_fps(int col) {
 	int fps = 0, w = r_cons_get_size (NULL);
-	fps = 0;
+	const ut64 now = r_time_now_mono ();
+	const ut64 since = R_MAX (prev, I->screen.input);
+	const int latency = (since && now > since)? (int)((now - since) / 1000): 0;
 	if (prev) {
-		ut64 now = r_time_now_mono ();
 		st64 diff = (st64)(now - prev);
 		if (diff <= 0) {
 			fps = 0;
 		} else {
 			fps = (diff < 1000000)? (int)(1000000.0 / diff): 0;
 		}
-		prev = now;
+	}
+	prev = now;
+	char msg[64];
+	if (I->damage) {
+		snprintf (msg, sizeof (msg), "[%d FPS %dms %d/%d]", fps, latency, I->screen.drawn, I->screen.nrows);
 	} else {
-		prev = r_time_now_mono ();
+		snprintf (msg, sizeof (msg), "[%d FPS %dms]", fps, latency);
 	}
 	if (col < 1) {
 		col = 12;
 	}
+	col = R_MAX (col, (int)strlen (msg) + 2);
+	if (I->screen.valid && I->screen.nrows > 0) {
+		// the counter is written over the first row
+		I->screen.rows[0] = 0;
+	}
 #ifdef R2__WINDOWS__
 	if (I->vtmode) {
-		eprintf ("\x1b[0;%dH[%d FPS] \n", w - col, fps);
+		eprintf ("\x1b[0;%dH%s \n", w - col, msg);
 	} else {
 		r_cons_w32_gotoxy (2, w - col, 0);
-		eprintf (" [%d FPS] \n", fps);
+		eprintf (" %s \n", msg);
 	}
 #else
-	eprintf ("\x1b[0;%dH[%d FPS] \n", w - col, fps);
+	eprintf ("\x1b[0;%dH%s \n", w - col, msg);
 #endif
 }
 
@@ -1303,6 +1364,163 @@ static int real_strlen(const char *ptr, int len) {
 	return ansilen - diff;
 }
 
+#define SCREEN_SGRMAX 128
+
+// attributes active at the start of a row, reset and set again before writing it
+typedef struct {
+	char sgr[SCREEN_SGRMAX];
+	int len;
+	bool top; // nothing was printed in the frame yet
+} ScreenState;
+
+static ut64 row_hash(ut64 h, const char *s, int len) {
+	int i;
+	for (i = 0; i < len; i++) {
+		h = (h ^ (ut8)s[i]) * 0x100000001b3ULL;
+	}
+	return h;
+}
+
+// tracks the attributes set in the row, false if it moves the cursor around
+static bool row_scan(ScreenState *st, const char *s, int len) {
+	int i = 0;
+	while (i < len) {
+		if (s[i] != 0x1b) {
+			st->top = false;
+			i++;
+			continue;
+		}
+		char fin;
+		const char *seq = s + i;
+		const int n = ansi_seqlen (seq, len - i, &fin);
+		i += n;
+		if (seq[1] == '[' && fin == 'm') {
+			// a zero or empty first parameter resets the attributes
+			const char p = seq[2];
+			if (p == 'm' || p == ';' || (isdigit (p) && !atoi (seq + 2))) {
+				st->len = 0;
+				if (strspn (seq + 2, "0;") == n - 3) {
+					continue;
+				}
+			}
+			if (st->len + n > SCREEN_SGRMAX) {
+				return false;
+			}
+			memcpy (st->sgr + st->len, seq, n);
+			st->len += n;
+		} else if (seq[1] == '[' && (fin == 'H' || fin == 'f')) {
+			// only the home at the beginning of the frame
+			if (!st->top || atoi (seq + 2) > 1) {
+				return false;
+			}
+			const char *semi = memchr (seq, ';', n);
+			if (semi && atoi (semi + 1) > 1) {
+				return false;
+			}
+		} else if (seq[1] == '[') {
+			if (fin && strchr ("ABCDEFGJSTdsuLMP@X`r", fin)) {
+				return false;
+			}
+		} else if (fin && strchr ("78DEMc", fin)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool screen_setup(RConsScreen *scr, int rows, int cols) {
+	if (rows != scr->nrows || cols != scr->ncols) {
+		ut64 *r = realloc (scr->rows, sizeof (ut64) * R_MAX (rows, 1));
+		if (!r) {
+			return false;
+		}
+		scr->rows = r;
+		scr->nrows = rows;
+		scr->ncols = cols;
+		scr->valid = false;
+	}
+	return true;
+}
+
+/* Writes only the rows that are different from the ones written by the
+ * previous frame, each one is positioned and starts with the attributes
+ * it would have in a full redraw. Returns false when the frame moves the
+ * cursor around, those must be written entirely */
+static bool visual_write_damage(char *buffer) {
+	RConsScreen *scr = &I->screen;
+	const int cols = I->columns;
+	const int rows = I->rows;
+	if (cols < 1 || rows < 1 || !screen_setup (scr, rows, cols)) {
+		return false;
+	}
+	ut64 *hashes = calloc (rows, sizeof (ut64));
+	RStrBuf *sb = r_strbuf_new (NULL);
+	if (!hashes || !sb) {
+		free (hashes);
+		r_strbuf_free (sb);
+		return false;
+	}
+	ScreenState st = { .len = 0, .top = true };
+	char *ptr = buffer;
+	int row, drawn = 0;
+	bool ok = true;
+	for (row = 0; row < rows && ok; row++) {
+		char *nl = ptr? strchr (ptr, '\n'): NULL;
+		const char *text = "";
+		int len = 0, alen = 0;
+		bool cut = false;
+		if (nl) {
+			*nl = 0;
+			alen = real_strlen (ptr, (int)(nl - ptr) + 1);
+			*nl = '\n';
+			text = ptr;
+			len = nl - ptr;
+			if (alen > cols) {
+				len = R_MIN (r_str_ansi_chrn (ptr, cols + 1) - ptr, len);
+				cut = true;
+			}
+			ptr = nl + 1;
+		} else {
+			ptr = NULL;
+		}
+		ut64 h = row_hash (0xcbf29ce484222325ULL, st.sgr, st.len);
+		h = row_hash (h, text, len);
+		hashes[row] = h;
+		if (!scr->valid || scr->rows[row] != h) {
+			r_strbuf_appendf (sb, "\x1b[%d;1H" Color_RESET, row + 1);
+			r_strbuf_append_n (sb, st.sgr, st.len);
+			r_strbuf_append_n (sb, text, len);
+			if (cut) {
+				r_strbuf_append (sb, Color_RESET);
+			} else if (alen < cols) {
+				if (I->blankline) {
+					r_strbuf_appendf (sb, "%*s", cols - alen, "");
+				} else {
+					r_strbuf_append (sb, "\x1b[K");
+				}
+			}
+			drawn++;
+		}
+		ok = row_scan (&st, text, len);
+		if (cut) {
+			st.len = 0;
+		}
+	}
+	if (ok) {
+		memcpy (scr->rows, hashes, rows * sizeof (ut64));
+		scr->valid = true;
+		scr->drawn = drawn;
+		__cons_write (r_strbuf_get (sb), r_strbuf_length (sb));
+	}
+	free (hashes);
+	r_strbuf_free (sb);
+	return ok;
+}
+
+R_API void r_cons_visual_invalidate(void) {
+	I->screen.valid = false;
+}
+
 R_API void r_cons_visual_write(char *buffer) {
 	char white[1024];
 	int cols = I->columns;
@@ -1314,6 +1532,11 @@ R_API void r_cons_visual_write(char *buffer) {
 	if (I->null) {
 		return;
 	}
+	if (I->damage && !break_lines && visual_write_damage (buffer)) {
+		return;
+	}
+	I->screen.valid = false;
+	I->screen.drawn = lines;
 	memset (&white, ' ', sizeof (white));
 	while ((nl = strchr (ptr, '\n'))) {
 		int len = ((int)(size_t)(nl - ptr)) + 1;
@@ -1,6 +1,7 @@
 /* radare - LGPL - Copyright 2009-2023 - pancake */
 
 #include <r_cons.h>
+#include <r_util.h>
 
 #define I r_cons_singleton ()
 
@@ -633,11 +634,14 @@ R_API int r_cons_readchar(void) {
 	}
 	r_cons_set_raw (true);
 #if R2__WINDOWS__
-	return __cons_readchar_w32 (0);
+	int ch = __cons_readchar_w32 (0);
+	I->screen.input = r_time_now_mono ();
+	return ch;
 #elif __wasi__
 	void *bed = r_cons_sleep_begin ();
 	int ret = read (STDIN_FILENO, buf, 1);
 	r_cons_sleep_end (bed);
+	I->screen.input = r_time_now_mono ();
 	if (ret < 1) {
 		return -1;
 	}
@@ -671,6 +675,7 @@ R_API int r_cons_readchar(void) {
 
 	ssize_t ret = read (STDIN_FILENO, buf, 1);
 	r_cons_sleep_end (bed);
+	I->screen.input = r_time_now_mono ();
 	if (ret != 1) {
 		return -1;
 	}
@@ -13,80 +13,48 @@ R_VEC_TYPE (RVecBuf, ut8);
 /// BEGIN /////////////////// esil trace helpers ///////////////////////
 
 static int etrace_index(REsilTrace *etrace) {
-	int len = RVecTraceOp_length (&etrace->db.ops);
+	int len = etrace->db.ops_first + RVecTraceOp_length (&etrace->db.ops);
 	etrace->cur_idx = len; //  > 0? len -1: 0;
 	return etrace->cur_idx; // RVecTraceOp_length (&etrace->db.ops);
 }
 
 static ut64 etrace_addrof(REsilTrace *etrace, ut32 idx) {
-	REsilTraceOp *op = RVecTraceOp_at (&etrace->db.ops, idx);
+	if ((int)idx < etrace->db.ops_first) {
+		return 0;
+	}
+	REsilTraceOp *op = RVecTraceOp_at (&etrace->db.ops, idx - etrace->db.ops_first);
 	return op? op->addr: 0;
 }
 
+// the trace ops keep a summary of their accesses, so these are constant time
+
 static ut64 etrace_memwrite_addr(REsilTrace *etrace, ut32 idx) {
-	REsilTraceOp *op = RVecTraceOp_at (&etrace->db.ops, idx);
 	D eprintf ("memwrite %d %d\n", etrace->idx, idx);
-	if (op && op->start != op->end) {
-		REsilTraceAccess *start = RVecAccess_at (&etrace->db.accesses, op->start);
-		REsilTraceAccess *end = RVecAccess_at (&etrace->db.accesses, op->end - 1);
-		while (start <= end) {
-			if (!start->is_reg && start->is_write) {
-				return start->mem.addr;
-			}
-			start++;
-		}
-	}
-	return 0;
+	ut64 addr = 0;
+	r_esil_trace_memwrite_addr (etrace, idx, &addr);
+	return addr;
 }
 
 static bool etrace_have_memread(REsilTrace *etrace, ut32 idx) {
-	REsilTraceOp *op = RVecTraceOp_at (&etrace->db.ops, idx);
 	D eprintf ("memread %d %d\n", etrace->idx, idx);
-	if (op && op->start != op->end) {
-		REsilTraceAccess *start = RVecAccess_at (&etrace->db.accesses, op->start);
-		REsilTraceAccess *end = RVecAccess_at (&etrace->db.accesses, op->end - 1);
-		while (start <= end) {
-			if (!start->is_reg && !start->is_write) {
-				return true;
-			}
-			start++;
-		}
-	}
-	return false;
+	return r_esil_trace_have_memread (etrace, idx);
 }
 
 static ut64 etrace_regread_value(REsilTrace *etrace, ut32 idx, const char *rname) {
 	D eprintf ("regread %d %d\n", etrace->idx, idx);
-	REsilTraceOp *op = RVecTraceOp_at (&etrace->db.ops, idx);
-	if (op && op->start != op->end) {
-		REsilTraceAccess *start = RVecAccess_at (&etrace->db.accesses, op->start);
-		REsilTraceAccess *end = RVecAccess_at (&etrace->db.accesses, op->end - 1);
-		while (start <= end) {
-			if (start->is_reg && !start->is_write) {
-				if (!strcmp (rname, start->reg.name)) {
-					return start->reg.value;
-				}
-			}
-			start++;
-		}
-	}
-	return 0;
+	ut64 value = 0;
+	r_esil_trace_regread_value (etrace, idx, rname, &value);
+	return value;
 }
 
 static const char *etrace_regwrite(REsilTrace *etrace, ut32 idx) {
 	DD eprintf ("regwrite %d %d\n", etrace->idx, idx);
-	REsilTraceOp *op = RVecTraceOp_at (&etrace->db.ops, idx);
-	if (op && op->start != op->end) {
-		REsilTraceAccess *start = RVecAccess_at (&etrace->db.accesses, op->start);
-		REsilTraceAccess *end = RVecAccess_at (&etrace->db.accesses, op->end - 1);
-		while (start <= end) {
-			if (start->is_reg && start->is_write) {
-				return start->reg.name;
-			}
-			start++;
-		}
-	}
-	return NULL;
+	return r_esil_trace_regwrite (etrace, idx);
+}
+
+static bool etrace_regwrite_contains(REsilTrace *etrace, ut32 idx, const char *rname) {
+	DD eprintf ("regwrite contains %d %s\n", idx, rname);
+	return r_esil_trace_regwrite_contains (etrace, idx, rname);
 }
 
 /// END ///////////////////// esil trace helpers ///////////////////////
@@ -118,25 +86,6 @@ static void anal_emul_restore(RCore *core, RConfigHold *hc, RDebugTrace *dt, REs
 	core->dbg->trace = dt;
 }
 
-static bool etrace_regwrite_contains(REsilTrace *etrace, ut32 idx, const char *rname) {
-	DD eprintf ("regwrite contains %d %s\n", idx, rname);
-	R_RETURN_VAL_IF_FAIL (etrace && rname, false);
-	REsilTraceOp *op = RVecTraceOp_at (&etrace->db.ops, idx); // AAA + 1);
-	if (op && op->start != op->end) {
-		REsilTraceAccess *start = RVecAccess_at (&etrace->db.accesses, op->start);
-		REsilTraceAccess *end = RVecAccess_at (&etrace->db.accesses, op->end - 1);
-		while (start <= end) {
-			if (start->is_reg && start->is_write) {
-				if (!strcmp (rname, start->reg.name)) {
-					return true;
-				}
-			}
-			start++;
-		}
-	}
-	return false;
-}
-
 static bool type_pos_hit(RAnal *anal, bool in_stack, int idx, int size, const char *place) {
 	DD eprintf ("TYpe pos hit %d %d %d %s\n", in_stack, idx, size, place);
 	REsilTrace *etrace = anal->esil->trace;
@@ -0,0 +1,246 @@
+/* radare - LGPL - Copyright 2024 - pancake */
+
+#include <r_core.h>
+
+// Instruction index for the searches that decode every offset of a range
+// (/ad, /ai, /r). Each searched range gets columnar arrays with one entry
+// per byte, filled the first time an offset is decoded, so repeating a
+// search only looks up what was already decoded. Mnemonics are interned and
+// referenced by id, which allows callers to memoize matches per mnemonic.
+// Any io write, map change or change in the asm config drops everything.
+
+// bytes available to decode a single instruction
+#define ASMIDX_OPSIZE 32
+
+static void seg_free(RCoreAsmIndexSeg *seg) {
+	if (seg) {
+		free (seg->state);
+		free (seg->len);
+		free (seg->mnem);
+		free (seg->op);
+		free (seg);
+	}
+}
+
+static RCoreAsmIndexSeg *seg_new(ut64 addr, ut64 size) {
+	RCoreAsmIndexSeg *seg = R_NEW0 (RCoreAsmIndexSeg);
+	if (!seg || size > SIZE_MAX / sizeof (ut32)) {
+		free (seg);
+		return NULL;
+	}
+	seg->addr = addr;
+	seg->size = size;
+	seg->state = calloc (size, 1);
+	seg->len = calloc (size, 1);
+	seg->mnem = malloc (size * sizeof (ut32));
+	seg->op = malloc (size * sizeof (ut32));
+	if (!seg->state || !seg->len || !seg->mnem || !seg->op) {
+		seg_free (seg);
+		return NULL;
+	}
+	return seg;
+}
+
+static bool asmidx_init(RCoreAsmIndex *ai) {
+	r_pvector_init (&ai->segs, (RPVectorFree)seg_free);
+	r_pvector_init (&ai->mnems, free);
+	r_vector_init (&ai->ops, sizeof (RCoreAsmIndexOp), NULL, NULL);
+	ai->mnemids = ht_pu_new0 ();
+	ai->bufaddr = UT64_MAX;
+	return ai->mnemids != NULL;
+}
+
+static void asmidx_fini(RCoreAsmIndex *ai) {
+	r_pvector_fini (&ai->segs);
+	r_pvector_fini (&ai->mnems);
+	r_vector_fini (&ai->ops);
+	ht_pu_free (ai->mnemids);
+	ai->mnemids = NULL;
+	R_FREE (ai->key);
+}
+
+R_API RCoreAsmIndex *r_core_asm_index_new(RCore *core) {
+	R_RETURN_VAL_IF_FAIL (core, NULL);
+	RCoreAsmIndex *ai = R_NEW0 (RCoreAsmIndex);
+	if (!ai) {
+		return NULL;
+	}
+	ai->core = core;
+	if (!asmidx_init (ai)) {
+		r_core_asm_index_free (ai);
+		return NULL;
+	}
+	return ai;
+}
+
+R_API void r_core_asm_index_free(RCoreAsmIndex *ai) {
+	if (ai) {
+		asmidx_fini (ai);
+		free (ai);
+	}
+}
+
+R_API void r_core_asm_index_reset(RCoreAsmIndex *ai) {
+	R_RETURN_IF_FAIL (ai);
+	asmidx_fini (ai);
+	asmidx_init (ai);
+}
+
+static char *asmidx_key(RCore *core) {
+	RConfig *cfg = core->config;
+	return r_str_newf ("%s.%s.%s.%d.%d.%d.%d", r_config_get (cfg, "asm.arch"),
+		r_config_get (cfg, "asm.cpu"), r_config_get (cfg, "asm.syntax"),
+		(int)r_config_get_i (cfg, "asm.bits"),
+		(int)r_config_get_b (cfg, "cfg.bigendian"),
+		(int)r_config_get_b (cfg, "asm.pseudo"),
+		(int)r_config_get_b (cfg, "io.va"));
+}
+
+static RCoreAsmIndexSeg *seg_at(RCoreAsmIndex *ai, ut64 addr) {
+	void **it;
+	r_pvector_foreach (&ai->segs, it) {
+		RCoreAsmIndexSeg *seg = *it;
+		if (addr >= seg->addr && addr - seg->addr < seg->size) {
+			return seg;
+		}
+	}
+	return NULL;
+}
+
+/* Returns the index for the range when search.index is enabled, the range
+ * is added to it when it's not covered yet */
+R_API RCoreAsmIndex *r_core_asm_index(RCore *core, ut64 from, ut64 to) {
+	R_RETURN_VAL_IF_FAIL (core, NULL);
+	if (!r_config_get_b (core->config, "search.index") || from >= to) {
+		return NULL;
+	}
+	if (!core->asmidx) {
+		core->asmidx = r_core_asm_index_new (core);
+		if (!core->asmidx) {
+			return NULL;
+		}
+	}
+	RCoreAsmIndex *ai = core->asmidx;
+	char *key = asmidx_key (core);
+	if (!key) {
+		return NULL;
+	}
+	// the io events don't cover the cache, overlay and map changes, but
+	// all of them bump the io generation or the map timestamps
+	RIO *io = core->io;
+	if (ai->key && (strcmp (ai->key, key) || ai->mts != io->mts || ai->iogen != R_DIRTY_GEN (io))) {
+		r_core_asm_index_reset (ai);
+	}
+	if (!ai->key) {
+		ai->key = key;
+		ai->mts = io->mts;
+		ai->iogen = R_DIRTY_GEN (io);
+	} else {
+		free (key);
+	}
+	RCoreAsmIndexSeg *seg = seg_at (ai, from);
+	if (seg && to - seg->addr <= seg->size) {
+		return ai;
+	}
+	// overlapping ranges are replaced by the new one
+	int i;
+	for (i = r_pvector_length (&ai->segs) - 1; i >= 0; i--) {
+		RCoreAsmIndexSeg *s = r_pvector_at (&ai->segs, i);
+		if (s->addr < to && from < s->addr + s->size) {
+			seg_free (r_pvector_remove_at (&ai->segs, i));
+		}
+	}
+	seg = seg_new (from, to - from);
+	if (!seg || !r_pvector_push (&ai->segs, seg)) {
+		seg_free (seg);
+		R_LOG_WARN ("Cannot index 0x%"PFMT64x"-0x%"PFMT64x, from, to);
+		return NULL;
+	}
+	return ai;
+}
+
+// bytes at addr, read in windows to not go through the io for every offset
+static const ut8 *asmidx_bytes(RCoreAsmIndex *ai, ut64 addr) {
+	if (ai->bufaddr == UT64_MAX || addr < ai->bufaddr || addr - ai->bufaddr >= R_CORE_ASM_INDEX_WINDOW) {
+		ai->bufaddr = addr;
+		memset (ai->buf, 0, sizeof (ai->buf));
+		(void)r_io_read_at (ai->core->io, addr, ai->buf, sizeof (ai->buf));
+	}
+	return ai->buf + (addr - ai->bufaddr);
+}
+
+static ut32 mnemonic_id(RCoreAsmIndex *ai, const char *mnemonic) {
+	bool found = false;
+	ut64 id = ht_pu_find (ai->mnemids, mnemonic, &found);
+	if (found) {
+		return (ut32)id;
+	}
+	char *s = strdup (mnemonic);
+	if (!s || !r_pvector_push (&ai->mnems, s)) {
+		free (s);
+		return UT32_MAX;
+	}
+	id = r_pvector_length (&ai->mnems) - 1;
+	ht_pu_insert (ai->mnemids, mnemonic, id);
+	return (ut32)id;
+}
+
+/* Same as r_asm_disassemble() at addr, returns the length of the
+ * instruction and the id of its mnemonic or UT32_MAX if there's none */
+R_API int r_core_asm_index_disasm(RCoreAsmIndex *ai, ut64 addr, ut32 *mnem) {
+	R_RETURN_VAL_IF_FAIL (ai && mnem, 0);
+	RCoreAsmIndexSeg *seg = seg_at (ai, addr);
+	if (!seg) {
+		*mnem = UT32_MAX;
+		return 0;
+	}
+	const ut64 off = addr - seg->addr;
+	if (!(seg->state[off] & R_CORE_ASM_INDEX_DISASM)) {
+		RCore *core = ai->core;
+		RAnalOp op;
+		r_asm_set_pc (core->rasm, addr);
+		int len = r_asm_disassemble (core->rasm, &op, asmidx_bytes (ai, addr), ASMIDX_OPSIZE);
+		seg->len[off] = R_MIN (R_MAX (len, 0), UT8_MAX);
+		seg->mnem[off] = op.mnemonic? mnemonic_id (ai, op.mnemonic): UT32_MAX;
+		seg->state[off] |= R_CORE_ASM_INDEX_DISASM;
+		r_asm_op_fini (&op);
+	}
+	*mnem = seg->mnem[off];
+	return seg->len[off];
+}
+
+R_API const char *r_core_asm_index_mnemonic(RCoreAsmIndex *ai, ut32 mnem) {
+	R_RETURN_VAL_IF_FAIL (ai, NULL);
+	return (mnem < r_pvector_length (&ai->mnems))? r_pvector_at (&ai->mnems, mnem): NULL;
+}
+
+// Same as r_anal_op() at addr with the basic mask
+R_API const RCoreAsmIndexOp *r_core_asm_index_op(RCoreAsmIndex *ai, ut64 addr) {
+	R_RETURN_VAL_IF_FAIL (ai, NULL);
+	RCoreAsmIndexSeg *seg = seg_at (ai, addr);
+	if (!seg) {
+		return NULL;
+	}
+	const ut64 off = addr - seg->addr;
+	if (!(seg->state[off] & R_CORE_ASM_INDEX_ANAL)) {
+		RCore *core = ai->core;
+		RAnalOp op;
+		r_anal_op_init (&op);
+		RCoreAsmIndexOp iop = {0};
+		iop.ret = r_anal_op (core->anal, &op, addr, asmidx_bytes (ai, addr), ASMIDX_OPSIZE, R_ARCH_OP_MASK_BASIC);
+		iop.size = op.size;
+		iop.type = op.type;
+		iop.direction = op.direction;
+		iop.jump = op.jump;
+		iop.ptr = op.ptr;
+		iop.val = op.val;
+		iop.disp = op.disp;
+		r_anal_op_fini (&op);
+		seg->op[off] = r_vector_length (&ai->ops);
+		if (!r_vector_push (&ai->ops, &iop)) {
+			return NULL;
+		}
+		seg->state[off] |= R_CORE_ASM_INDEX_ANAL;
+	}
+	return r_vector_index_ptr (&ai->ops, seg->op[off]);
+}
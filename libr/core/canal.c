@@ -4341,6 +4341,27 @@ static bool opiscall(RCore *core, RAnalOp *aop, ut64 addr, const ut8* buf, int l
 	return false;
 }
 
+// r_anal_op() with the basic mask, from the instruction index if enabled
+static int search_op(RCore *core, RCoreAsmIndex *ai, RAnalOp *op, ut64 addr, const ut8 *buf, int len) {
+	if (!ai) {
+		return r_anal_op (core->anal, op, addr, buf, len, R_ARCH_OP_MASK_BASIC);
+	}
+	const RCoreAsmIndexOp *iop = r_core_asm_index_op (ai, addr);
+	if (!iop) {
+		return r_anal_op (core->anal, op, addr, buf, len, R_ARCH_OP_MASK_BASIC);
+	}
+	r_anal_op_init (op);
+	op->addr = addr;
+	op->size = iop->size;
+	op->type = iop->type;
+	op->direction = iop->direction;
+	op->jump = iop->jump;
+	op->ptr = iop->ptr;
+	op->val = iop->val;
+	op->disp = iop->disp;
+	return iop->ret;
+}
+
 // TODO(maskray) RAddrInterval API
 #define OPSZ 8
 R_API int r_core_anal_search(RCore *core, ut64 from, ut64 to, ut64 ref, int mode) {
@@ -4371,6 +4392,7 @@ R_API int r_core_anal_search(RCore *core, ut64 from, ut64 to, ut64 ref, int mode
 	// ???
 	// XXX must read bytes correctly
 	do_bckwrd_srch = bckwrds = core->search->bckwrds;
+	RCoreAsmIndex *ai = (mode != 'c')? r_core_asm_index (core, from, to): NULL;
 	r_cons_break_push (NULL, NULL);
 	if (core->blocksize > OPSZ) {
 		if (bckwrds) {
@@ -4415,7 +4437,7 @@ R_API int r_core_anal_search(RCore *core, ut64 from, ut64 to, ut64 ref, int mode
 				case 'x':
 					{
 						r_anal_op_fini (&op);
-						r_anal_op (core->anal, &op, at + i, buf + i, core->blocksize - i, R_ARCH_OP_MASK_BASIC);
+						search_op (core, ai, &op, at + i, buf + i, core->blocksize - i);
 						int mask = (mode == 'r') ? 1 : mode == 'w' ? 2: mode == 'x' ? 4: 0;
 						if (op.direction == mask) {
 							i += op.size;
@@ -4426,7 +4448,7 @@ R_API int r_core_anal_search(RCore *core, ut64 from, ut64 to, ut64 ref, int mode
 					break;
 				default:
 					r_anal_op_fini (&op);
-					if (!r_anal_op (core->anal, &op, at + i, buf + i, core->blocksize - i, R_ARCH_OP_MASK_BASIC)) {
+					if (!search_op (core, ai, &op, at + i, buf + i, core->blocksize - i)) {
 						r_anal_op_fini (&op);
 						continue;
 					}
@@ -4465,7 +4487,7 @@ R_API int r_core_anal_search(RCore *core, ut64 from, ut64 to, ut64 ref, int mode
 				default:
 					{
 						r_anal_op_fini (&op);
-						if (!r_anal_op (core->anal, &op, at + i, buf + i, core->blocksize - i, R_ARCH_OP_MASK_BASIC)) {
+						if (!search_op (core, ai, &op, at + i, buf + i, core->blocksize - i)) {
 							r_anal_op_fini (&op);
 							continue;
 						}
@@ -123,6 +123,11 @@ R_API RList *r_core_asm_strsearch(RCore *core, const char *input, ut64 from, ut6
 		tokens[tokcount] = tok;
 	}
 	tokens[tokcount] = NULL;
+	// esil expressions are not indexed
+	RCoreAsmIndex *ai = (mode != 'e')? r_core_asm_index (core, from, to): NULL;
+	// regexp results by token and mnemonic id
+	HtUU *rxmemo = (ai && regexp)? ht_uu_new0 (): NULL;
+	ut32 mnem = UT32_MAX;
 	r_cons_break_push (NULL, NULL);
 	char *opst = NULL;
 	for (at = from; at < to; at += bs) {
@@ -148,7 +153,38 @@ R_API RList *r_core_asm_strsearch(RCore *core, const char *input, ut64 from, ut6
 				break;
 			}
 			r_asm_set_pc (core->rasm, addr);
-			if (mode == 'i') {
+			if (mode == 'i' && ai) {
+				const RCoreAsmIndexOp *iop = r_core_asm_index_op (ai, addr);
+				if (!iop || iop->ret < 1) {
+					idx ++; // TODO: honor mininstrsz
+					continue;
+				}
+				bool match = (iop->val != UT64_MAX && iop->val >= usrimm && iop->val <= usrimm2)
+					|| (iop->disp != UT64_MAX && iop->disp >= usrimm && iop->disp <= usrimm2)
+					|| (iop->ptr != UT64_MAX && iop->ptr >= usrimm && iop->ptr <= usrimm2);
+				if (match) {
+					RCoreAsmHit *hit = r_core_asm_hit_new ();
+					if (!hit) {
+						r_list_purge (hits);
+						R_FREE (hits);
+						goto beach;
+					}
+					hit->addr = addr;
+					hit->len = iop->size;
+					if (hit->len == -1) {
+						r_core_asm_hit_free (hit);
+						goto beach;
+					}
+					r_core_asm_index_disasm (ai, addr, &mnem);
+					hit->code = strdup (r_str_get (r_core_asm_index_mnemonic (ai, mnem)));
+					idx = (matchcount)? tidx + 1: idx + 1;
+					matchcount = 0;
+					r_list_append (hits, hit);
+					continue;
+				}
+				idx ++; // TODO: honor mininstrsz
+				continue;
+			} else if (mode == 'i') {
 				RAnalOp analop = {0};
 				ut64 len = R_MIN (15, bs - idx);
 				if (r_anal_op (core->anal, &analop, addr, buf + idx, len,
@@ -201,6 +237,19 @@ R_API RList *r_core_asm_strsearch(RCore *core, const char *input, ut64 from, ut6
 				// opsz = analop.size;
 				opst = strdup (r_strbuf_get (&analop.esil));
 				r_anal_op_fini (&analop);
+			} else if (ai) {
+				if (!(len = r_core_asm_index_disasm (ai, addr, &mnem))) {
+					idx = (matchcount)? tidx + 1: idx + 1;
+					R_LOG_ERROR ("Failed to disassemble instruction at 0x%08"PFMT64x, addr);
+					matchcount = 0;
+					continue;
+				}
+				const char *mn = r_core_asm_index_mnemonic (ai, mnem);
+				if (mn) {
+					opst = strdup (mn);
+				} else {
+					R_LOG_DEBUG ("Cannot disassemble at 0x%08"PFMT64x, addr);
+				}
 			} else {
 				RAnalOp op;
 				if (!(len = r_asm_disassemble (
@@ -236,9 +285,19 @@ R_API RList *r_core_asm_strsearch(RCore *core, const char *input, ut64 from, ut6
 						matches = !!strstr (opst, tokens[matchcount]);
 					}
 				} else {
-					rx = r_regex_new (tokens[matchcount], "es");
-					matches = r_regex_exec (rx, opst, 0, 0, 0) == 0;
-					r_regex_free (rx);
+					const ut64 k = ((ut64)matchcount << 32) | mnem;
+					bool found = false;
+					if (rxmemo && mnem != UT32_MAX) {
+						matches = ht_uu_find (rxmemo, k, &found);
+					}
+					if (!found) {
+						rx = r_regex_new (tokens[matchcount], "es");
+						matches = r_regex_exec (rx, opst, 0, 0, 0) == 0;
+						r_regex_free (rx);
+						if (rxmemo && mnem != UT32_MAX) {
+							ht_uu_insert (rxmemo, k, matches);
+						}
+					}
 				}
 			}
 			if (align && align > 1) {
@@ -302,6 +361,7 @@ R_API RList *r_core_asm_strsearch(RCore *core, const char *input, ut64 from, ut6
 	}
 beach:
 	r_asm_set_pc (core->rasm, toff);
+	ht_uu_free (rxmemo);
 	free (buf);
 	free (ptr);
 	free (code);
@@ -691,6 +691,7 @@ static void load_types_from(RCore *core, const char *fmt, ...) {
 		Sdb *gd = sdb_new0 ();
 		sdb_open_gperf (gd, gp);
 		sdb_reset (core->anal->sdb_types);
+		r_anal_typedb_invalidate (core->anal->typedb);
 		sdb_merge (core->anal->sdb_types, gd);
 		sdb_close (gd);
 		sdb_free (gd);
@@ -699,6 +700,7 @@ static void load_types_from(RCore *core, const char *fmt, ...) {
 		char *dbpath = r_str_newf ("%s/%s/%s.sdb", dir_prefix, R2_SDB_FCNSIGN, s);
 		if (r_file_exists (dbpath)) {
 			sdb_concat_by_path (core->anal->sdb_types, dbpath);
+			r_anal_typedb_invalidate (core->anal->typedb);
 		}
 		free (dbpath);
 	}
@@ -712,6 +714,7 @@ R_API void r_core_anal_type_init(RCore *core) {
 	Sdb *types = core->anal->sdb_types;
 	// make sure they are empty this is initializing
 	sdb_reset (types);
+	r_anal_typedb_invalidate (core->anal->typedb);
 	const char *anal_arch = r_config_get (core->config, "anal.arch");
 	const char *os = r_config_get (core->config, "asm.os");
 
@@ -1146,6 +1149,12 @@ static bool bin_dwarf(RCore *core, PJ *pj, int mode) {
 		// list is not cloned to improve speed. avoid use after free
 		list = plugin->lines (binfile);
 	} else if (core->bin) {
+		if (mode == R_MODE_SET && r_config_get_b (core->config, "bin.dbginfo.lazy")) {
+			// source lines are resolved on demand via r_bin_addr2line
+			r_bin_dwarf_line_index_free (binfile->addrinfo_priv);
+			binfile->addrinfo_priv = r_bin_dwarf_index_lines (core->bin);
+			return binfile->addrinfo_priv != NULL;
+		}
 		// TODO: complete and speed-up support for dwarf
 		RBinDwarfDebugAbbrev *da = r_bin_dwarf_parse_abbrev (core->bin, mode);
 		if (!da) {
@@ -1367,6 +1376,7 @@ static bool bin_source(RCore *r, PJ *pj, int mode) {
 	RListIter *iter2;
 	char* srcline;
 	SdbKv *kv;
+	r_bin_addrinfo_load (r->bin);
 	SdbList *ls = sdb_foreach_list (binfile->sdb_addrinfo, false);
 	ls_foreach (ls, iter, kv) {
 		char *v = sdbkv_value (kv);
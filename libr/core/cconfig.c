@@ -1888,6 +1888,15 @@ static bool cb_esilverbose(void *user, void *data) {
 	return true;
 }
 
+static bool cb_esiltracemaxmem(void *user, void *data) {
+	RCore *core = user;
+	RConfigNode *node = data;
+	if (core->anal->esil) {
+		core->anal->esil->trace_maxmem = node->i_value;
+	}
+	return true;
+}
+
 static bool cb_esilstackdepth(void *user, void *data) {
 	RConfigNode *node = data;
 	if (node->i_value < 3) {
@@ -2226,6 +2235,29 @@ static bool cb_cmd_esil_trap(void *user, void *data) {
 	return true;
 }
 
+static bool cb_fscache(void *user, void *data) {
+	RCore *core = (RCore *) user;
+	RConfigNode *node = (RConfigNode *) data;
+	if (!strcmp (node->name, "fs.cache.bsize") && (node->i_value < 512 || node->i_value > 0x100000)) {
+		R_LOG_ERROR ("fs.cache.bsize must be between 512 and 1M");
+		return false;
+	}
+	if (core->fs->cache) {
+		const bool enabled = r_config_get_b (core->config, "fs.cache");
+		const ut64 bsize = r_config_get_i (core->config, "fs.cache.bsize");
+		const ut64 size = r_config_get_i (core->config, "fs.cache.size");
+		r_fs_cache_setup (core->fs->cache, (ut32)bsize, enabled? size: 0);
+	}
+	return true;
+}
+
+static bool cb_fsthreads(void *user, void *data) {
+	RCore *core = (RCore *) user;
+	RConfigNode *node = (RConfigNode *) data;
+	core->fs->threads = (int)node->i_value;
+	return true;
+}
+
 static bool cb_fsview(void *user, void *data) {
 	int type = R_FS_VIEW_NORMAL;
 	RCore *core = (RCore *) user;
@@ -2857,6 +2889,13 @@ static bool cb_analverbose(void *user, void *data) {
 	return true;
 }
 
+static bool cb_binmmap(void *user, void *data) {
+	RCore *core = (RCore *) user;
+	RConfigNode *node = (RConfigNode *) data;
+	core->bin->use_mmap = node->i_value;
+	return true;
+}
+
 static bool cb_binverbose(void *user, void *data) {
 	RCore *core = (RCore *) user;
 	RConfigNode *node = (RConfigNode *) data;
@@ -3729,6 +3768,7 @@ R_API int r_core_config_init(RCore *core) {
 	SETI ("esil.addr.size", 64, "maximum address size in accessed by the ESIL VM");
 	SETBPREF ("esil.breakoninvalid", "false", "break esil execution when instruction is invalid");
 	SETI ("esil.timeout", 0, "a timeout (in seconds) for when we should give up emulating");
+	SETICB ("esil.trace.maxmem", 0, &cb_esiltracemaxmem, "memory budget in bytes to step back in the esil trace, older steps are forgotten (0 for unlimited)");
 	SETCB ("esil.traprevert", "false", &cb_esiltraprevert,
 		"Revert the entire expression, when esil traps, instead of just the pc");
 	SETCB ("cfg.debug", "false", &cb_cfgdebug, "debugger mode");
@@ -3940,6 +3980,7 @@ R_API int r_core_config_init(RCore *core) {
 	SETI ("bin.baddr", -1, "base address of the binary");
 	SETI ("bin.laddr", 0, "base address for loading library ('*.so')");
 	SETCB ("bin.dbginfo", "true", &cb_bindbginfo, "load debug information at startup if available");
+	SETBPREF ("bin.dbginfo.lazy", "false", "only index dwarf compilation units at load and parse line programs on demand");
 	SETBPREF ("bin.relocs", "true", "load relocs information at startup if available");
 	SETBPREF ("bin.relocs.apply", "false", "apply reloc information");
 	SETICB ("bin.maxsymlen", 0, &cb_binmaxsymlen, "maximum length for symbol names");
@@ -3955,6 +3996,7 @@ R_API int r_core_config_init(RCore *core) {
 	SETCB ("bin.str.debase64", "false", &cb_debase64, "try to debase64 all strings");
 	SETCB ("bin.classes", "true", &cb_bin_classes, "load classes from rbin on startup");
 	SETCB ("bin.verbose", "false", &cb_binverbose, "show RBin warnings when loading binaries");
+	SETCB ("bin.mmap", "false", &cb_binmmap, "mmap the file when loading bin info, avoids copying symbol and string tables");
 
 	/* prj */
 	SETCB ("prj.name", "", &cb_prjname, "name of current project");
@@ -4202,6 +4244,10 @@ R_API int r_core_config_init(RCore *core) {
 	SETDESC (n, "set visibility options for filesystems");
 	SETOPTIONS (n, "all", "normal", "deleted", "special", NULL);
 	n = SETPREF ("fs.cwd", "/", "current working directory (see 'ms' command)");
+	SETCB ("fs.cache", "true", &cb_fscache, "cache the disk blocks read by the mounted filesystems");
+	SETICB ("fs.cache.bsize", 4096, &cb_fscache, "block size of the filesystem cache");
+	SETICB ("fs.cache.size", 8 * 1024 * 1024, &cb_fscache, "size in bytes of the filesystem cache");
+	SETICB ("fs.threads", 4, &cb_fsthreads, "threads writing the files extracted from directories (see 'mg')");
 
 	/* hexdump */
 	SETCB ("hex.header", "true", &cb_hex_header, "show header in hexdump");
@@ -4397,6 +4443,7 @@ R_API int r_core_config_init(RCore *core) {
 	r_config_desc (cfg, "scr.fgets", "use fgets() instead of dietline for prompt input");
 	SETCB ("scr.echo", "false", &cb_screcho, "show rcons output in realtime to stderr and buffer");
 	SETPREF ("scr.loopnl", "false", "add a newline after every command executed in @@ loops");
+	SETBPREF ("scr.loopjson", "false", "join the output of json commands executed in @@ loops into a single array");
 	SETICB ("scr.linesleep", 0, &cb_scrlinesleep, "flush sleeping some ms in every line");
 	SETICB ("scr.maxtab", 4096, &cb_completion_maxtab, "change max number of auto completion suggestions");
 	SETICB ("scr.maxpage", 102400, &cb_scr_maxpage, "change max chars to print before prompting the user");
@@ -4434,6 +4481,8 @@ R_API int r_core_config_init(RCore *core) {
 	SETI ("scr.notch", 0, "force console row count (height) (duplicate?)");
 	SETICB ("scr.rows", 0, &cb_rows, "force console row count (height) (duplicate?)");
 	SETCB ("scr.fps", "false", &cb_fps, "show FPS in Visual");
+	SETBPREF ("scr.damage", "false", "only redraw the rows that changed in Visual");
+	SETI ("scr.vcache", 0, "reuse the last N rendered views in Visual while only moving around (0=disabled)");
 	SETICB ("scr.rows.fix", 0, &cb_fixrows, "Workaround for Linux TTY");
 	SETICB ("scr.cols.fix", 0, &cb_fixcolumns, "workaround for Prompt iOS SSH client");
 	SETCB ("scr.highlight", "", &cb_scrhighlight, "highlight that word at RCons level");
@@ -4506,6 +4555,7 @@ R_API int r_core_config_init(RCore *core) {
 	SETBPREF ("search.flags", "true", "all search results are flagged, otherwise only printed");
 	SETBPREF ("search.named", "false", "name flags with given string instead of search.prefix");
 	SETBPREF ("search.overlap", "false", "look for overlapped search hits");
+	SETBPREF ("search.index", "false", "keep the instructions decoded by /ad, /ai and /r to speed up the next searches");
 	SETI ("search.maxhits", 0, "maximum number of hits (0: no limit)");
 	SETI ("search.from", -1, "search start address");
 	n = NODECB ("search.in", "io.maps", &cb_searchin);
@@ -4525,6 +4575,7 @@ R_API int r_core_config_init(RCore *core) {
 	/* rop */
 	SETI ("rop.len", 5, "maximum ROP gadget length");
 	SETBPREF ("rop.sdb", "false", "cache results in sdb (experimental)");
+	SETBPREF ("rop.cache", "false", "save the gadgets found by /R in dir.cache, keyed by the hash of each map");
 	SETBPREF ("rop.db", "true", "categorize rop gadgets in sdb");
 	SETBPREF ("rop.subchains", "false", "display every length gadget from rop.len=X to 2 in /Rl");
 	SETBPREF ("rop.conditional", "false", "include conditional jump, calls and returns in ropsearch");
@@ -0,0 +1,151 @@
+/* radare - LGPL - Copyright 2024 - pancake */
+
+#include <r_core.h>
+
+// The rfs:// io plugin exposes a file inside a mounted filesystem as a
+// read only descriptor, so it can be analyzed in place. Contents are read
+// on demand through the filesystem plugin in small windows, the disk blocks
+// behind them are kept by the RFS cache. It lives in the core because the
+// io can't link against the fs, the RFS is reached through the core bind.
+
+#define RFSIO_WINDOW (64 * 1024)
+
+typedef struct {
+	RFS *fs;
+	RFSFile *file;
+	ut64 off;
+	ut64 bufaddr;
+	int buflen;
+	ut8 buf[RFSIO_WINDOW];
+} RIORfs;
+
+static bool __check(RIO *io, const char *pathname, bool many) {
+	return r_str_startswith (pathname, "rfs://");
+}
+
+static RIODesc *__open(RIO *io, const char *pathname, int rw, int mode) {
+	RCore *core = io->coreb.core;
+	if (!__check (io, pathname, false) || !core || !core->fs) {
+		return NULL;
+	}
+	RFSFile *file = r_fs_open (core->fs, pathname + 6, false);
+	if (!file) {
+		return NULL;
+	}
+	RIORfs *rf = R_NEW0 (RIORfs);
+	// the file must be detached if its root is unmounted before closing it
+	if (!rf || !r_fs_keep (core->fs, file)) {
+		r_fs_close (core->fs, file);
+		r_fs_file_free (file);
+		free (rf);
+		return NULL;
+	}
+	rf->fs = core->fs;
+	rf->file = file;
+	rf->bufaddr = UT64_MAX;
+	RIODesc *desc = r_io_desc_new (io, &r_io_plugin_rfs, pathname, R_PERM_R | (rw & R_PERM_X), mode, rf);
+	if (!desc) {
+		r_fs_close (core->fs, file);
+		r_fs_file_free (file);
+		free (rf);
+	}
+	return desc;
+}
+
+static bool __close(RIODesc *fd) {
+	RIORfs *rf = fd->data;
+	if (rf) {
+		r_fs_close (rf->fs, rf->file);
+		r_fs_file_free (rf->file);
+		free (rf);
+		fd->data = NULL;
+	}
+	return true;
+}
+
+// r_fs_umount detaches the kept file from its plugin
+static bool rfs_mounted(RIORfs *rf) {
+	return rf->file->p != NULL;
+}
+
+static bool rfs_fill(RIORfs *rf, ut64 addr) {
+	RFSFile *file = rf->file;
+	rf->bufaddr = addr - (addr % RFSIO_WINDOW);
+	rf->buflen = 0;
+	const int n = (int)R_MIN (RFSIO_WINDOW, file->size - rf->bufaddr);
+	const int res = r_fs_read (rf->fs, file, rf->bufaddr, n);
+	if (res < 1 || !file->data) {
+		rf->bufaddr = UT64_MAX;
+		return false;
+	}
+	rf->buflen = R_MIN (res, n);
+	memcpy (rf->buf, file->data, rf->buflen);
+	return true;
+}
+
+static int __read(RIO *io, RIODesc *fd, ut8 *buf, int count) {
+	R_RETURN_VAL_IF_FAIL (fd && fd->data && buf, -1);
+	RIORfs *rf = fd->data;
+	if (!rfs_mounted (rf)) {
+		R_LOG_ERROR ("%s is not mounted anymore", fd->uri);
+		return -1;
+	}
+	const ut64 size = rf->file->size;
+	int done = 0;
+	while (done < count && rf->off < size) {
+		if (rf->bufaddr == UT64_MAX || rf->off < rf->bufaddr || rf->off - rf->bufaddr >= rf->buflen) {
+			if (!rfs_fill (rf, rf->off)) {
+				break;
+			}
+			if (rf->off - rf->bufaddr >= rf->buflen) {
+				break;
+			}
+		}
+		const ut64 delta = rf->off - rf->bufaddr;
+		const int n = (int)R_MIN (count - done, rf->buflen - delta);
+		memcpy (buf + done, rf->buf + delta, n);
+		done += n;
+		rf->off += n;
+	}
+	return done? done: -1;
+}
+
+static int __write(RIO *io, RIODesc *fd, const ut8 *buf, int count) {
+	return -1;
+}
+
+static ut64 __lseek(RIO *io, RIODesc *fd, ut64 offset, int whence) {
+	RIORfs *rf = fd->data;
+	if (!rf) {
+		return offset;
+	}
+	const ut64 size = rf->file->size;
+	switch (whence) {
+	case SEEK_SET:
+		rf->off = R_MIN (offset, size);
+		break;
+	case SEEK_CUR:
+		rf->off = R_MIN (rf->off + offset, size);
+		break;
+	case SEEK_END:
+		rf->off = size;
+		break;
+	}
+	return rf->off;
+}
+
+RIOPlugin r_io_plugin_rfs = {
+	.meta = {
+		.name = "rfs",
+		.desc = "Read files inside the mounted filesystems",
+		.author = "pancake",
+		.license = "LGPL-3.0-only",
+	},
+	.uris = "rfs://",
+	.open = __open,
+	.close = __close,
+	.read = __read,
+	.seek = __lseek,
+	.write = __write,
+	.check = __check
+};
@@ -472,9 +472,110 @@ static bool duplicate_flag(RFlagItem *flag, void *u) {
 	return true;
 }
 
-static bool foreach_newline(RCore *core) {
-	bool nl = r_config_get_b (core->config, "scr.loopnl");
-	if (nl) {
+// inner command of a @@ loop, parsed once and executed on every iteration
+typedef struct {
+	const char *cmd;
+	bool direct; // plain command, dispatched to its handler without the parser
+	bool loopnl;
+	bool json; // join the output of every iteration in a single json array
+	bool opened;
+	int items;
+} CmdPlan;
+
+static bool cmd_is_plain(RCore *core, const char *cmd) {
+	if (!isalpha ((ut8)*cmd) || core->incomment || core->cmdremote || R_STR_ISNOTEMPTY (core->cmdfilter)) {
+		return false;
+	}
+	const char *p;
+	for (p = cmd; *p; p++) {
+		if (strchr (SPECIAL_CHARS "\\!\n\r", *p)) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// commands that print a single json value for the current seek
+static const char *loop_json_cmds[] = {
+	"afbj", "afij", "afj", "afvj", "aoj", "axfj", "axtj", "CLj", "fdj",
+	"pdfj", "pdj", "pfj", "pij", "psj", "pszj", "pvj", "pxj", NULL
+};
+
+static bool cmd_is_json(const char *cmd) {
+	const char *sp = strchr (cmd, ' ');
+	size_t len = sp? (size_t)(sp - cmd): strlen (cmd);
+	int i;
+	for (i = 0; loop_json_cmds[i]; i++) {
+		if (strlen (loop_json_cmds[i]) == len && !strncmp (cmd, loop_json_cmds[i], len)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static void cmd_plan_init(RCore *core, CmdPlan *plan, const char *cmd) {
+	memset (plan, 0, sizeof (CmdPlan));
+	plan->cmd = r_str_trim_head_ro (cmd);
+	plan->direct = cmd_is_plain (core, plan->cmd);
+	plan->loopnl = r_config_get_b (core->config, "scr.loopnl");
+	plan->json = r_config_get_b (core->config, "scr.loopjson") && cmd_is_json (plan->cmd);
+}
+
+// run the command at the current seek
+static int cmd_plan_run(RCore *core, CmdPlan *plan) {
+	int mark = 0;
+	if (plan->json) {
+		if (!plan->opened) {
+			r_cons_print ("[");
+			plan->opened = true;
+		}
+		mark = r_cons_get_buffer_len ();
+		if (plan->items > 0) {
+			r_cons_print (",");
+		}
+	}
+	int ret;
+	if (plan->direct) {
+		// same as r_core_cmd() does for a plain command
+		r_core_return_code (core, 0);
+		ret = r_cmd_call (core->rcmd, plan->cmd);
+		if (ret == -1) {
+			R_LOG_ERROR ("Invalid command '%s' (0x%02x)", plan->cmd, *plan->cmd);
+		} else if (ret == 1) {
+			r_core_return_value (core, ret);
+		}
+	} else {
+		ret = r_core_cmd (core, plan->cmd, 0);
+	}
+	if (plan->json) {
+		const int sep = (plan->items > 0)? 1: 0;
+		const char *buf = r_cons_get_buffer ();
+		int len = r_cons_get_buffer_len ();
+		int nl = 0;
+		while (len - nl > mark + sep && buf[len - nl - 1] == '\n') {
+			nl++;
+		}
+		r_cons_drop (nl);
+		len -= nl;
+		if (len > mark + sep) {
+			plan->items++;
+		} else if (sep && len == mark + sep) {
+			// nothing printed, drop the separator
+			r_cons_drop (sep);
+		}
+	}
+	return ret;
+}
+
+static void cmd_plan_fini(RCore *core, CmdPlan *plan) {
+	if (plan->opened) {
+		r_cons_println ("]");
+		plan->opened = false;
+	}
+}
+
+static bool foreach_newline(RCore *core, CmdPlan *plan) {
+	if (plan->loopnl) {
 		r_cons_newline ();
 	}
 	return !r_cons_is_breaked ();
@@ -5368,7 +5469,7 @@ static bool copy_into_flagitem_list(RFlagItem *item, void *u) {
 	return true;
 }
 
-static void foreach_pairs(RCore *core, const char *cmd, const char *each) {
+static void foreach_pairs(RCore *core, CmdPlan *plan, const char *each) {
 	const char *arg;
 	int pair = 0;
 	for (arg = each ; ; ) {
@@ -5384,7 +5485,7 @@ static void foreach_pairs(RCore *core, const char *cmd, const char *each) {
 			}
 			if (pair % 2) {
 				r_core_block_size (core, n);
-				r_core_cmd0 (core, cmd);
+				cmd_plan_run (core, plan);
 			} else {
 				r_core_seek (core, n, true);
 			}
@@ -5621,6 +5722,8 @@ static RList *foreach3list(RCore *core, char type, const char *glob) {
 R_API int r_core_cmd_foreach3(RCore *core, const char *cmd, char *each) { // "@@@"
 	ForeachListItem *item;
 	RListIter *iter;
+	CmdPlan _plan, *plan = &_plan;
+	cmd_plan_init (core, plan, cmd);
 	char ch = each[0];
 	if (r_str_startswith (each, "SS")) {
 		ch = 'G'; // @@@SS = @@@G
@@ -5633,7 +5736,7 @@ R_API int r_core_cmd_foreach3(RCore *core, const char *cmd, char *each) { // "@@
 
 	switch (ch) {
 	case '=': // "@@@="
-		foreach_pairs (core, cmd, each + 1);
+		foreach_pairs (core, plan, each + 1);
 		break;
 	case '?': // "@@@?"
 		r_core_cmd_help (core, help_msg_at_at_at);
@@ -5642,7 +5745,7 @@ R_API int r_core_cmd_foreach3(RCore *core, const char *cmd, char *each) { // "@@
 		if (glob) {
 			char *arg = r_core_cmd_str (core, glob);
 			if (arg) {
-				foreach_pairs (core, cmd, arg);
+				foreach_pairs (core, plan, arg);
 				free (arg);
 			}
 		} else {
@@ -5682,8 +5785,8 @@ R_API int r_core_cmd_foreach3(RCore *core, const char *cmd, char *each) { // "@@
 				if (item->size) {
 					r_core_block_size (core, item->size);
 				}
-				r_core_cmd0 (core, cmd);
-				if (!foreach_newline (core)) {
+				cmd_plan_run (core, plan);
+				if (!foreach_newline (core, plan)) {
 					break;
 				}
 			}
@@ -5700,8 +5803,8 @@ R_API int r_core_cmd_foreach3(RCore *core, const char *cmd, char *each) { // "@@
 				int curpid = (int) item->addr;
 				r_core_cmdf (core, "dp %d", curpid);
 				r_cons_printf ("# PID %d\n", curpid);
-				r_core_cmd0 (core, cmd);
-				if (!foreach_newline (core)) {
+				cmd_plan_run (core, plan);
+				if (!foreach_newline (core, plan)) {
 					break;
 				}
 			}
@@ -5718,13 +5821,14 @@ R_API int r_core_cmd_foreach3(RCore *core, const char *cmd, char *each) { // "@@
 		R_LOG_ERROR ("Invalid repeat type, Check @@@? for help");
 		break;
 	}
+	cmd_plan_fini (core, plan);
 	r_list_free (list);
 	free (glob);
 	return 0;
 }
 
-static void cmd_foreach_word(RCore *core, const char *_cmd, const char *each) {
-	char *cmd = strdup (_cmd);
+static void cmd_foreach_word(RCore *core, CmdPlan *plan, const char *each) {
+	char *cmd = strdup (plan->cmd);
 	char *nextLine = NULL;
 	/* foreach list of items */
 	while (each) {
@@ -5766,7 +5870,7 @@ static void cmd_foreach_word(RCore *core, const char *_cmd, const char *each) {
 			}
 			r_core_cmdf (core, "%s %s", cmd, curword);
 			R_FREE (curword);
-			if (!foreach_newline (core)) {
+			if (!foreach_newline (core, plan)) {
 				break;
 			}
 			r_cons_flush ();
@@ -5776,8 +5880,7 @@ static void cmd_foreach_word(RCore *core, const char *_cmd, const char *each) {
 	free (cmd);
 }
 
-static void cmd_foreach_offset(RCore *core, const char *_cmd, const char *each) {
-	char *cmd = strdup (_cmd);
+static void cmd_foreach_offset(RCore *core, CmdPlan *plan, const char *each) {
 	char *nextLine = NULL;
 	ut64 addr;
 	/* foreach list of items */
@@ -5828,16 +5931,18 @@ static void cmd_foreach_offset(RCore *core, const char *_cmd, const char *each)
 				each = NULL;
 			}
 			r_core_seek (core, addr, true);
-			r_core_cmd (core, cmd, 0);
-			if (!foreach_newline (core)) {
+			cmd_plan_run (core, plan);
+			const bool next = foreach_newline (core, plan);
+			if (!plan->json) {
+				// json output is flushed as a whole after the loop
 				r_cons_flush ();
+			}
+			if (!next) {
 				break;
 			}
-			r_cons_flush ();
 		}
 		each = nextLine;
 	}
-	free (cmd);
 }
 
 R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
@@ -5848,7 +5953,9 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 	RListIter *iter;
 	RFlagItem *flag;
 	ut64 oseek, addr;
+	CmdPlan _plan, *plan = &_plan;
 	cmd = r_str_trim_head_ro (cmd);
+	cmd_plan_init (core, plan, cmd);
 
 	oseek = core->offset;
 	ostr = str = strdup (each);
@@ -5881,8 +5988,8 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 				r_list_foreach (fcn->bbs, iter, bb) {
 					r_core_block_size (core, bb->size);
 					r_core_seek (core, bb->addr, true);
-					r_core_cmd (core, cmd, 0);
-					if (!foreach_newline (core)) {
+					cmd_plan_run (core, plan);
+					if (!foreach_newline (core, plan)) {
 						break;
 					}
 				}
@@ -5905,8 +6012,8 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 				ut64 step = r_num_math (core->num, r_str_word_get0 (str, 2));
 				for (cur = from; cur <= to; cur += step) {
 					(void) r_core_seek (core, cur, true);
-					r_core_cmd (core, cmd, 0);
-					if (!foreach_newline (core)) {
+					cmd_plan_run (core, plan);
+					if (!foreach_newline (core, plan)) {
 						break;
 					}
 				}
@@ -5927,7 +6034,7 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 				r_list_sort (fcn->bbs, bb_cmp);
 				r_list_foreach (fcn->bbs, iter, bb) {
 					r_core_seek (core, bb->addr, true);
-					r_core_cmd (core, cmd, 0);
+					cmd_plan_run (core, plan);
 					for (i = 0; i < bb->op_pos_size; i++) {
 						if (!bb->op_pos[i]) {
 							break;
@@ -5937,9 +6044,9 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 							continue;
 						}
 						r_core_seek (core, addr, true);
-						r_core_cmd (core, cmd, 0);
+						cmd_plan_run (core, plan);
 						set_u_add (set, addr);
-						if (!foreach_newline (core)) {
+						if (!foreach_newline (core, plan)) {
 							break;
 						}
 					}
@@ -5960,8 +6067,8 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 				r_list_foreach (core->anal->fcns, iter, fcn) {
 					if (each[2] && strstr (fcn->name, each + 2)) {
 						r_core_seek (core, fcn->addr, true);
-						r_core_cmd (core, cmd, 0);
-						if (!foreach_newline (core)) {
+						cmd_plan_run (core, plan);
+						if (!foreach_newline (core, plan)) {
 							break;
 						}
 					}
@@ -5978,7 +6085,7 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 					r_core_seek (core, fcn->addr, true);
 #if 0
 					r_cons_push ();
-					r_core_cmd (core, cmd, 0);
+					cmd_plan_run (core, plan);
 					char *buf = (char *)r_cons_get_buffer ();
 					if (buf) {
 						buf = strdup (buf);
@@ -5992,7 +6099,7 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 					r_strbuf_appendf (sb, "%s", buf);
 					free (buf);
 #endif
-					if (!foreach_newline (core)) {
+					if (!foreach_newline (core, plan)) {
 						break;
 					}
 				}
@@ -6016,8 +6123,8 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 				r_list_foreach (list, iter, p) {
 					r_cons_printf ("# PID %d\n", p->pid);
 					r_debug_select (core->dbg, p->pid, p->pid);
-					r_core_cmd (core, cmd, 0);
-					if (!foreach_newline (core)) {
+					cmd_plan_run (core, plan);
+					if (!foreach_newline (core, plan)) {
 						break;
 					}
 				}
@@ -6031,16 +6138,16 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 		if (each[1] == ':') {
 			char *arg = r_core_cmd_str (core, each + 2);
 			if (arg) {
-				cmd_foreach_offset (core, cmd, arg);
+				cmd_foreach_offset (core, plan, arg);
 				free (arg);
 			}
 		}
 		break;
 	case '=': // "@@="
 		if (each[1] == '=') {
-			cmd_foreach_word (core, cmd, r_str_trim_head_ro (str + 2));
+			cmd_foreach_word (core, plan, r_str_trim_head_ro (str + 2));
 		} else {
-			cmd_foreach_offset (core, cmd, r_str_trim_head_ro (str + 1));
+			cmd_foreach_offset (core, plan, r_str_trim_head_ro (str + 1));
 		}
 		break;
 	case 'd': // "@@d"
@@ -6064,8 +6171,8 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 					r_core_seek (core, frame->addr, true);
 					break;
 				}
-				r_core_cmd (core, cmd, 0);
-				if (!foreach_newline (core)) {
+				cmd_plan_run (core, plan);
+				if (!foreach_newline (core, plan)) {
 					break;
 				}
 				i++;
@@ -6100,11 +6207,13 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 				//eprintf ("; 0x%08"PFMT64x":\n", addr);
 				each = str + 1;
 				r_core_seek (core, addr, true);
-				r_core_cmd (core, cmd, 0);
-				if (!foreach_newline (core)) {
+				cmd_plan_run (core, plan);
+				if (!foreach_newline (core, plan)) {
 					break;
 				}
-				r_cons_flush ();
+				if (!plan->json) {
+					r_cons_flush ();
+				}
 			} while (str);
 			free (out);
 		}
@@ -6125,7 +6234,7 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 				addr = core->rcmd->macro._brk_value;
 				r_core_seek (core, addr, true);
 				r_core_cmdf (core, "%s @ 0x%08"PFMT64x, cmd, addr);
-				if (!foreach_newline (core)) {
+				if (!foreach_newline (core, plan)) {
 					break;
 				}
 				i++;
@@ -6142,7 +6251,7 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 					if (core->num->nc.errors == 0) {
 						r_core_cmd_call_at (core, addr, cmd);
 					}
-					if (!foreach_newline (core)) {
+					if (!foreach_newline (core, plan)) {
 						break;
 					}
 					core->rcmd->macro.counter++;
@@ -6201,7 +6310,7 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 					const char *tmp = NULL;
 					r_core_seek (core, flag->offset, true);
 					r_cons_push ();
-					r_core_cmd (core, cmd, 0);
+					cmd_plan_run (core, plan);
 					tmp = r_cons_get_buffer ();
 					buf = tmp? strdup (tmp): NULL;
 					r_cons_pop ();
@@ -6209,7 +6318,7 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 						r_cons_print (buf);
 						free (buf);
 					}
-					if (!foreach_newline (core)) {
+					if (!foreach_newline (core, plan)) {
 						break;
 					}
 					r_core_task_yield (&core->tasks);
@@ -6221,6 +6330,7 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 			}
 		}
 	}
+	cmd_plan_fini (core, plan);
 	r_cons_break_pop ();
 	// XXX: use r_core_seek here
 	core->offset = oseek;
@@ -6229,6 +6339,7 @@ R_API int r_core_cmd_foreach(RCore *core, const char *cmd, char *each) {
 	free (ostr);
 	return true;
 out_finish:
+	cmd_plan_fini (core, plan);
 	free (ostr);
 	r_cons_break_pop ();
 	return false;
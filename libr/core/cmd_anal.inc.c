@@ -2314,6 +2314,7 @@ static inline REsil *esil_new_setup(RCore *core) {
 		bool nonull = r_config_get_b (core->config, "esil.nonull");
 		r_esil_setup (esil, core->anal, romem, stats, nonull);
 		esil->verbose = r_config_get_i (core->config, "esil.verbose");
+		esil->trace_maxmem = r_config_get_i (core->config, "esil.trace.maxmem");
 		esil->cmd = r_core_esil_cmd;
 		const char *et = r_config_get (core->config, "cmd.esil.trap");
 		esil->cmd_trap = R_STR_ISNOTEMPTY (et)? strdup (et): NULL;
@@ -11274,7 +11275,7 @@ static void cmd_anal_hint(RCore *core, const char *input) {
 			r_str_trim (off);
 			int toff = r_num_math (NULL, off);
 			if (toff) {
-				RList *typeoffs = r_type_get_by_offset (core->anal->sdb_types, toff);
+				RList *typeoffs = r_anal_typedb_by_offset (core->anal->typedb, toff);
 				RListIter *iter;
 				char *ty;
 				r_list_foreach (typeoffs, iter, ty) {
@@ -11346,7 +11347,7 @@ static void cmd_anal_hint(RCore *core, const char *input) {
 						offimm += r_num_math (NULL, off);
 					}
 					// TODO: Allow to select from multiple choices
-					RList *otypes = r_type_get_by_offset (core->anal->sdb_types, offimm);
+					RList *otypes = r_anal_typedb_by_offset (core->anal->typedb, offimm);
 					RListIter *iter;
 					char *otype = NULL;
 					r_list_foreach (otypes, iter, otype) {
@@ -487,6 +487,7 @@ static RCoreHelpMessage help_msg_dt = {
 	"dt-", "", "reset traces (instruction/calls)",
 	"dt=", "", "show ascii-art color bars with the debug trace ranges",
 	"dta", " 0x804020 ...", "only trace given addresses",
+	"dtb", "[?] [file]", "trace basic blocks into a file, stepping only at branches",
 	"dtc", "[?][addr]|([from] [to] [addr])", "trace call/ret",
 	"dtd", "[qi] [nth-start]", "list all traced disassembled (quiet, instructions)",
 	"dte", "[?]", "show esil trace logs",
@@ -510,6 +511,14 @@ static RCoreHelpMessage help_msg_dte = {
 	NULL
 };
 
+static RCoreHelpMessage help_msg_dtb = {
+	"Usage: dtb", "", "Block trace, stops only at the branches of the analyzed basic blocks",
+	"dtb", " [file] ([until])", "trace until the given address, a breakpoint, the end of the process or ^C",
+	"dtbl", "[q] [file]", "list the instruction runs stored in the trace file",
+	"dtbr", " [file]", "expand the trace file into instructions (see dtd)",
+	NULL
+};
+
 static RCoreHelpMessage help_msg_dts = {
 	"Usage:", "dts[*]", "Trace sessions",
 	"dts+", "", "start trace session",
@@ -5380,6 +5389,41 @@ static ut8 *getFileData(RCore *core, const char *arg, int *sz) {
 	return out;
 }
 
+static void cmd_debug_btrace(RCore *core, const char *input) {
+	const char mode = *input;
+	if (mode == 'l' || mode == 'r') {
+		input++;
+	}
+	if (mode == 'l' && *input == 'q') {
+		input++;
+	}
+	char *file = r_str_trim_dup (input);
+	char *arg = strchr (file, ' ');
+	if (arg) {
+		*arg++ = 0;
+	}
+	if (mode == '?' || !*file) {
+		r_core_cmd_help (core, help_msg_dtb);
+	} else if (mode == 'l') { // "dtbl"
+		r_debug_btrace_list (core->dbg, file, input[-1]);
+	} else if (mode == 'r') { // "dtbr"
+		int n = r_debug_btrace_load (core->dbg, file);
+		if (n >= 0) {
+			R_LOG_INFO ("Loaded %d instructions", n);
+		}
+	} else if (r_debug_is_dead (core->dbg)) {
+		R_LOG_ERROR ("Cannot trace outside of debug mode, run ood?");
+	} else {
+		ut64 until = arg? r_num_math (core->num, arg): UT64_MAX;
+		int n = r_debug_btrace (core->dbg, file, until);
+		if (n >= 0) {
+			R_LOG_INFO ("Traced %d instruction runs", n);
+		}
+		r_core_cmd0 (core, ".dr*");
+	}
+	free (file);
+}
+
 R_VEC_TYPE(RVecDebugTracepoint, RDebugTracepoint);
 
 static int cmd_debug(void *data, const char *input) {
@@ -5455,6 +5499,9 @@ static int cmd_debug(void *data, const char *input) {
 				r_debug_trace_at (core->dbg, "$$");
 			}
 			break;
+		case 'b': // "dtb"
+			cmd_debug_btrace (core, input + 2);
+			break;
 		case 't': // "dtt"
 			if (input[2] == '.') {
 				r_cons_printf ("%d\n", core->dbg->trace->tag);
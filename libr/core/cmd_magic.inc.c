@@ -9,14 +9,94 @@ static R_TH_LOCAL char *ofile = NULL;
 
 #define MAX_MAGIC_DEPTH 64
 
+static bool magic_is_data(const char *str, bool v) {
+#if USE_LIB_MAGIC
+	return !v && (!strcmp (str, "data") || strstr (str, "ASCII") || strstr (str, "ISO") || strstr (str, "no line terminator"));
+#else
+	return !v && !strcmp (str, "data");
+#endif
+}
+
+static int r_core_magic_at(RCore *core, RSearchKeyword *kw, const char *file, ut64 addr, int depth, bool v, PJ *pj, int *hits);
+
+// report a magic result, flag it and follow the "@ addr" references in it
+static void magic_hit(RCore *core, RSearchKeyword *kw, const char *file, ut64 addr, int depth, const char *str, PJ *pj, int *hits) {
+	char *flag = NULL;
+	char *q, *p = strdup (str);
+	const char *fmt = p;
+	// processing newline
+	for (q = p; *q; q++) {
+		if (q[0] == '\\' && q[1] == 'n') {
+			*q = '\n';
+			strcpy (q + 1, q + ((q[2] == ' ')? 3: 2));
+		}
+	}
+	(*hits)++;
+	const char *cmdhit = r_config_get (core->config, "cmd.hit");
+	if (cmdhit && *cmdhit) {
+		r_core_cmd0 (core, cmdhit);
+	}
+
+	const char *searchprefix = r_config_get (core->config, "search.prefix");
+
+	// We do not flag for pm command.
+	if (kw) {
+		flag = r_str_newf ("%s%d_%d", searchprefix, kw->kwidx, kw->count);
+		kw->count++;
+		r_flag_set (core->flags, flag, addr, 1);
+	}
+	// TODO: This must be a callback .. move this into RSearch?
+	if (!pj) {
+		if (kw) {
+			r_cons_printf ("0x%08" PFMT64x " %d %s %s\n", addr, depth, flag, p);
+			R_FREE (flag);
+		} else {
+			r_cons_printf ("0x%08" PFMT64x " %d %s\n", addr, depth, p);
+		}
+	} else {
+		pj_o (pj);
+		pj_kN (pj, "offset", addr);
+		pj_ki (pj, "depth", depth);
+		pj_ks (pj, "info", p);
+		pj_end (pj);
+	}
+
+	if (!pj && r_config_get_b (core->config, "search.verbose") && r_config_get_b (core->config, "scr.interactive")) {
+		r_cons_clear_line (1);
+	}
+	//eprintf ("0x%08"PFMT64x" 0x%08"PFMT64x" %d %s\n", addr+adelta, addr+adelta, depth, p);
+	// walking children
+	for (q = p; *q; q++) {
+		switch (*q) {
+		case ' ':
+			fmt = q + 1;
+			break;
+		case '@':
+			{
+				ut64 addr = 0LL;
+				*q = 0;
+				if (r_str_startswith (q + 1, "0x")) {
+					sscanf (q + 3, "%"PFMT64x, &addr);
+				} else {
+					sscanf (q + 1, "%"PFMT64d, &addr);
+				}
+				if (R_STR_ISEMPTY (fmt)) {
+					fmt = file;
+				}
+				r_core_magic_at (core, kw, fmt, addr, depth + 1, true, pj, hits);
+				*q = '@';
+			}
+			break;
+		}
+	}
+	free (p);
+}
+
 static int r_core_magic_at(RCore *core, RSearchKeyword *kw, const char *file, ut64 addr, int depth, bool v, PJ *pj, int *hits) {
-	const char *fmt;
-	char *q, *p;
 	const char *str;
 	int delta = 0, adelta = 0, ret;
 	ut64 curoffset = core->offset;
 	int max_hits = r_config_get_i (core->config, "search.maxhits");
-	char *flag;
 
 	if (max_hits > 0 && *hits >= max_hits) {
 		return 0;
@@ -97,12 +177,7 @@ static int r_core_magic_at(RCore *core, RSearchKeyword *kw, const char *file, ut
 	}
 	str = r_magic_buffer (ck, core->block + delta, core->blocksize - delta);
 	if (str) {
-		const char *cmdhit;
-#if USE_LIB_MAGIC
-		if (!v && (!strcmp (str, "data") || strstr (str, "ASCII") || strstr (str, "ISO") || strstr (str, "no line terminator"))) {
-#else
-		if (!v && (!strcmp (str, "data"))) {
-#endif
+		if (magic_is_data (str, v)) {
 			int mod = core->search->align;
 			if (mod < 1) {
 				mod = 1;
@@ -113,74 +188,7 @@ static int r_core_magic_at(RCore *core, RSearchKeyword *kw, const char *file, ut
 			ret = mod + 1;
 			goto seek_exit;
 		}
-		p = strdup (str);
-		fmt = p;
-		// processing newline
-		for (q = p; *q; q++) {
-			if (q[0] == '\\' && q[1] == 'n') {
-				*q = '\n';
-				strcpy (q + 1, q + ((q[2] == ' ')? 3: 2));
-			}
-		}
-		(*hits)++;
-		cmdhit = r_config_get (core->config, "cmd.hit");
-		if (cmdhit && *cmdhit) {
-			r_core_cmd0 (core, cmdhit);
-		}
-
-		const char *searchprefix = r_config_get (core->config, "search.prefix");
-
-		// We do not flag for pm command.
-		if (kw) {
-			flag = r_str_newf ("%s%d_%d", searchprefix, kw->kwidx, kw->count);
-			kw->count++;
-			r_flag_set (core->flags, flag, addr + adelta, 1);
-		}
-		// TODO: This must be a callback .. move this into RSearch?
-		if (!pj) {
-			if (kw) {
-				r_cons_printf ("0x%08" PFMT64x " %d %s %s\n", addr + adelta, depth, flag, p);
-				R_FREE (flag);
-			} else {
-				r_cons_printf ("0x%08" PFMT64x " %d %s\n", addr + adelta, depth, p);
-			}
-		} else {
-			pj_o (pj);
-			pj_kN (pj, "offset", addr + adelta);
-			pj_ki (pj, "depth", depth);
-			pj_ks (pj, "info", p);
-			pj_end (pj);
-		}
-
-		if (must_report_progress) {
-			r_cons_clear_line (1);
-		}
-		//eprintf ("0x%08"PFMT64x" 0x%08"PFMT64x" %d %s\n", addr+adelta, addr+adelta, depth, p);
-		// walking children
-		for (q = p; *q; q++) {
-			switch (*q) {
-			case ' ':
-				fmt = q + 1;
-				break;
-			case '@':
-				{
-					ut64 addr = 0LL;
-					*q = 0;
-					if (r_str_startswith (q + 1, "0x")) {
-						sscanf (q + 3, "%"PFMT64x, &addr);
-					} else {
-						sscanf (q + 1, "%"PFMT64d, &addr);
-					}
-					if (R_STR_ISEMPTY (fmt)) {
-						fmt = file;
-					}
-					r_core_magic_at (core, kw, fmt, addr, depth + 1, true, pj, hits);
-					*q = '@';
-				}
-				break;
-			}
-		}
-		R_FREE (p);
+		magic_hit (core, kw, file, addr + adelta, depth, str, pj, hits);
 		r_magic_free (ck);
 		ck = NULL;
 	}
@@ -202,6 +210,94 @@ seek_exit:
 	return ret;
 }
 
+#define MAGIC_SCAN_CHUNK (1024 * 1024)
+
+// same results as calling r_core_magic_at() on every address of the range,
+// but reading it in big chunks instead of seeking around, and only running
+// the magic tests whose literal bytes are found at each address
+static int r_core_magic_scan(RCore *core, RSearchKeyword *kw, const char *file, ut64 from, ut64 to, PJ *pj, int *hits) {
+	const ut64 curoffset = core->offset;
+	const int bsize = core->blocksize;
+	const int align = core->search->align;
+	const int max_hits = r_config_get_i (core->config, "search.maxhits");
+	bool must_report_progress = !pj;
+	if (must_report_progress) {
+		must_report_progress = r_config_get_b (core->config, "search.verbose");
+		if (must_report_progress) {
+			must_report_progress = r_config_get_b (core->config, "scr.interactive");
+		}
+	}
+	if (file) {
+		file = r_str_trim_head_ro (file);
+		if (R_STR_ISEMPTY (file)) {
+			file = NULL;
+		}
+	}
+	const char *magicpath = file? file: r_config_get (core->config, "dir.magic");
+	RMagic *ms = r_magic_new (0);
+	if (!ms || !r_magic_load (ms, magicpath)) {
+		R_LOG_ERROR ("failed r_magic_load (\"%s\") %s", magicpath, r_magic_error (ms));
+		r_magic_free (ms);
+		return -1;
+	}
+	// NULL when using the system libmagic, every address is checked then
+	RMagicScan *sc = r_magic_scan_new (ms);
+	ut8 *buf = malloc (MAGIC_SCAN_CHUNK + bsize);
+	if (!buf) {
+		r_magic_scan_free (sc);
+		r_magic_free (ms);
+		return -1;
+	}
+	ut64 base = 0, end = 0;
+	ut64 addr = from;
+	while (addr < to && !r_cons_is_breaked ()) {
+		if (max_hits > 0 && *hits >= max_hits) {
+			break;
+		}
+		if (align) {
+			int mod = addr % align;
+			if (mod) {
+				R_LOG_WARN ("Unaligned search result at %d", mod);
+				addr += mod;
+				continue;
+			}
+		}
+		if (addr < base || addr >= end) {
+			base = addr;
+			end = R_MAX (addr + MAGIC_SCAN_CHUNK, addr);
+			r_io_read_at (core->io, base, buf, MAGIC_SCAN_CHUNK + bsize);
+		}
+		if (((addr & 7) == 0) && ((addr & (7 << 8)) == 0)) {
+			if (must_report_progress) {
+				eprintf ("0x%08" PFMT64x " [%d matches found]\r", addr, *hits);
+			}
+		}
+		// inside the current block only its tail is looked at
+		int len = bsize;
+		if (addr > curoffset && (addr + NAH) < (curoffset + bsize)) {
+			len = bsize - (addr - curoffset);
+		}
+		const ut8 *data = buf + (addr - base);
+		const char *str = sc? r_magic_scan_buffer (sc, data, len): r_magic_buffer (ms, data, len);
+		int step = align? align: 1;
+		if (str) {
+			if (magic_is_data (str, false)) {
+				step = R_MAX (align, 1) + 1;
+			} else {
+				magic_hit (core, kw, file, addr, 0, str, pj, hits);
+				if (core->offset != curoffset) {
+					r_core_seek (core, curoffset, true);
+				}
+			}
+		}
+		addr += step;
+	}
+	free (buf);
+	r_magic_scan_free (sc);
+	r_magic_free (ms);
+	return 0;
+}
+
 static void r_core_magic(RCore *core, const char *file, int v, PJ *pj) {
 	ut64 addr = core->offset;
 	int hits = 0;
@@ -416,6 +416,7 @@ retry:
 		if (remove) {
 			sdb_reset (core->bin->cur->sdb_addrinfo);
 		} else {
+			r_bin_addrinfo_load (core->bin);
 			sdb_foreach (core->bin->cur->sdb_addrinfo, print_addrinfo, &fs);
 		}
 		return 0;
@@ -463,6 +464,10 @@ retry:
 		fs.fscache = sdb_new0 ();
 		PJ *pj = NULL;
 		RBinFile *bf = r_bin_cur (core->bin);
+		if (offset == UT64_MAX) {
+			// single addresses are resolved through the lazy index by print_meta_offset
+			r_bin_addrinfo_load (core->bin);
+		}
 		if (use_json) {
 			pj = r_core_pj_new (core);
 			fs.pj = pj;
@@ -18,7 +18,7 @@ static RCoreHelpMessage help_msg_m = {
 	"mg", " /foo [offset size]", "get fs file/dir and dump to disk (support base64:)",
 	"mi", " /foo/bar", "get offset and size of given file",
 	"mj", "", "list mounted filesystems in JSON",
-	"mo", " /foo/bar", "open given file into a malloc://",
+	"mo", " /foo/bar", "open given file through rfs://",
 	"mp", " msdos 0", "show partitions in msdos format at offset 0",
 	"mp", "", "list all supported partition types",
 	"ms", " /mnt", "open filesystem shell at /mnt (or fs.cwd if not defined)",
@@ -218,6 +218,11 @@ static const char *t2s(const char ch) {
 	return "unknown";
 }
 
+static bool cat_cb(void *user, ut64 addr, const ut8 *buf, int len) {
+	r_cons_write ((const char *)buf, len);
+	return true;
+}
+
 static void cmd_mount_ls(RCore *core, const char *input) {
 	bool isJSON = *input == 'j';
 	RListIter *iter;
@@ -492,17 +497,12 @@ static int cmd_mount(void *data, const char *_input) {
 		if (*input == '?') { // "mo?"
 			r_core_cmd_help_match (core, help_msg_m, "mo");
 		} else {
-			file = r_fs_open (core->fs, input, false);
-			if (file) {
-				r_fs_read (core->fs, file, 0, file->size);
-				char *uri = r_str_newf ("malloc://%d", file->size);
-				RIODesc *fd = r_io_open (core->io, uri, R_PERM_RW, 0);
-				if (fd) {
-					r_io_desc_write (fd, file->data, file->size);
-				}
-			} else {
+			// the contents are read on demand by the rfs:// plugin
+			char *uri = r_str_newf ("rfs://%s", input);
+			if (!r_io_open (core->io, uri, R_PERM_RX, 0)) {
 				R_LOG_ERROR ("Cannot open file");
 			}
+			free (uri);
 		}
 		break;
 	case 'i':
@@ -512,8 +512,8 @@ static int cmd_mount(void *data, const char *_input) {
 			input = (char *)r_str_trim_head_ro (input + 1);
 			file = r_fs_open (core->fs, input, false);
 			if (file) {
-				// XXX: dump to file or just pipe?
-				r_fs_read (core->fs, file, 0, file->size);
+				// reading the first bytes is enough to find where the file is
+				r_fs_read (core->fs, file, 0, 1);
 				r_cons_printf ("f file %d 0x%08"PFMT64x"\n", file->size, file->off);
 				r_fs_close (core->fs, file);
 			} else {
@@ -534,8 +534,7 @@ static int cmd_mount(void *data, const char *_input) {
 			}
 			file = r_fs_open (core->fs, input, false);
 			if (file) {
-				r_fs_read (core->fs, file, 0, file->size);
-				r_cons_write ((const char *)file->data, file->size);
+				r_fs_read_cb (core->fs, file, 0, file->size, cat_cb, NULL);
 				r_fs_close (core->fs, file);
 				r_cons_write ("\n", 1);
 			} else if (!r_fs_dir_dump (core->fs, input, ptr)) {
@@ -588,23 +587,19 @@ static int cmd_mount(void *data, const char *_input) {
 			if (slash) {
 				memmove (localFile, slash + 1, strlen (slash));
 			}
-			size_t ptr = offset;
-			int total_bytes_read = 0;
-			int blocksize = file->size < core->blocksize ? file->size : core->blocksize;
 			size = size > 0 ? size : file->size;
-			if (r_file_exists (localFile) && !r_sys_truncate (localFile, 0)) {
+			int fd = r_sandbox_open (localFile, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+			if (fd == -1) {
 				R_LOG_ERROR ("Cannot create file %s", localFile);
+				r_fs_close (core->fs, file);
+				free (localFile);
+				free (hfilename);
 				break;
 			}
-			while (total_bytes_read < size && ptr < file->size) {
-				int left = (size - total_bytes_read < blocksize)? size - total_bytes_read: blocksize;
-				int bytes_read = r_fs_read (core->fs, file, ptr, left);
-				if (bytes_read > 0) {
-					r_file_dump (localFile, file->data, bytes_read, true);
-				}
-				ptr += bytes_read;
-				total_bytes_read += bytes_read;
+			if (!r_fs_read_fd (core->fs, file, offset, size, fd)) {
+				R_LOG_ERROR ("Cannot read the contents of %s", filename);
 			}
+			r_sandbox_close (fd);
 			r_fs_close (core->fs, file);
 			R_LOG_INFO ("File '%s' created. ", localFile);
 			if (offset) {
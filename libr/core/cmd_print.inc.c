@@ -13,6 +13,7 @@ static RCoreHelpMessage help_msg_pa = {
 	"paD", " [hexpairs]", "print assembly expression from hexpairs and show hexpairs",
 	"pad", " [hexpairs]", "print assembly expression from hexpairs (alias for pdx, pix)",
 	"pade", " [hexpairs]", "print ESIL expression from hexpairs",
+	"padj", " [hexpairs]", "disassemble hexpairs and print the instructions as json",
 	"pae", " [assembly]", "print ESIL expression of the given assembly expression",
 	NULL
 };
@@ -751,6 +752,39 @@ static void __cmd_pad(RCore *core, const char *arg) {
 	}
 }
 
+static void __cmd_padj(RCore *core, const char *arg) {
+	ut8 *buf = malloc (strlen (arg) + 1);
+	const int len = buf? r_hex_str2bin (arg, buf): 0;
+	RAsmBatch *b = (len > 0)? r_asm_batch_new (core->rasm): NULL;
+	if (!b) {
+		R_LOG_ERROR ("Invalid hexstr");
+		free (buf);
+		return;
+	}
+	r_asm_batch_disassemble (b, core->offset, buf, len, 0);
+	if (r_config_get_b (core->config, "asm.sub.names")) {
+		r_asm_batch_filter (b, core->flags);
+	}
+	PJ *pj = r_core_pj_new (core);
+	pj_a (pj);
+	RAsmInsn *insn;
+	r_vector_foreach (&b->insns, insn) {
+		const char *text = r_asm_batch_text (b, insn);
+		pj_o (pj);
+		pj_kn (pj, "addr", insn->addr);
+		pj_ki (pj, "size", insn->size);
+		pj_ks (pj, "mnemonic", r_str_get (r_asm_batch_mnemonic (b, insn->mnem)));
+		pj_ks (pj, "operands", text + insn->ops);
+		pj_ks (pj, "opcode", text);
+		pj_end (pj);
+	}
+	pj_end (pj);
+	r_cons_println (pj_string (pj));
+	pj_free (pj);
+	r_asm_batch_free (b);
+	free (buf);
+}
+
 static void first_flag_chars(const char *name, char *ch, char *ch2) {
 	name = r_name_filter_ro (name);
 	// name = "ab"; // r_name_filter_ro (name);
@@ -4706,6 +4740,63 @@ static ut8 *analBars(RCore *core, size_t type, size_t nblocks, size_t blocksize,
 	return ptr;
 }
 
+// the byte counting modes of p= are computed from the histogram of the block
+static bool statsCount(const ut8 *buf, ut64 len, int mode, ut64 *k) {
+	RHashStats st;
+	switch (mode) {
+	case '0':
+		r_hash_stats (buf, len, &st);
+		*k = st.zeros;
+		return true;
+	case 'f':
+	case 'F':
+		r_hash_stats (buf, len, &st);
+		*k = st.ffs;
+		return true;
+	case 'p':
+		r_hash_stats (buf, len, &st);
+		*k = st.printable;
+		return true;
+	}
+	return false;
+}
+
+static ut8 *entropyBars(RCore *core, size_t nblocks, ut64 blocksize, size_t skipblocks, ut64 from) {
+	if (blocksize < 1 || blocksize > ST32_MAX) {
+		return NULL;
+	}
+	const size_t nbatch = r_hash_batch_count (blocksize, nblocks);
+	ut8 *ptr = calloc (1, nblocks);
+	ut8 *p = malloc (nbatch * blocksize);
+	RHashBlock *blocks = R_NEWS0 (RHashBlock, nbatch);
+	if (!ptr || !p || !blocks) {
+		free (ptr);
+		free (p);
+		free (blocks);
+		return NULL;
+	}
+	const int nthreads = r_th_ncpus ();
+	const double maxent = log2 ((double)R_MIN (blocksize, 256));
+	size_t i, k;
+	for (i = 0; i < nblocks; i += nbatch) {
+		const size_t n = R_MIN (nbatch, nblocks - i);
+		const ut64 off = from + (blocksize * (i + skipblocks));
+		for (k = 0; k < n; k++) {
+			blocks[k].off = k * blocksize;
+			blocks[k].len = (int)blocksize;
+		}
+		r_io_read_at (core->io, off, p, n * blocksize);
+		r_hash_calculate_blocks (R_HASH_ENTROPY, p, blocks, n, nthreads);
+		for (k = 0; k < n; k++) {
+			// same as r_hash_entropy_fraction
+			ptr[i + k] = (ut8) (255 * (blocks[k].entropy / maxent));
+		}
+	}
+	free (p);
+	free (blocks);
+	return ptr;
+}
+
 static void cmd_print_bars(RCore *core, const char *input) {
 	if (r_str_endswith (input, "?")) {
 		r_core_cmd_help (core, help_msg_p_equal);
@@ -4847,6 +4938,10 @@ static void cmd_print_bars(RCore *core, const char *input) {
 				} else for (i = 0; i < nblocks; i++) {
 					ut64 off = from + blocksize * (i + skipblocks);
 					r_io_read_at (core->io, off, p, blocksize);
+					if (statsCount (p, blocksize, submode, &k)) {
+						ptr[i] = 256 * k / blocksize;
+						continue;
+					}
 					for (j = k = 0; j < blocksize; j++) {
 						switch (submode) {
 						case 'a':
@@ -4858,16 +4953,6 @@ static void cmd_print_bars(RCore *core, const char *input) {
 								}
 							}
 							break;
-						case '0':
-							if (!p[j]) {
-								k++;
-							}
-							break;
-						case 'f':
-							if (p[j] == 0xff) {
-								k++;
-							}
-							break;
 						case 'z':
 							if ((IS_PRINTABLE (p[j]))) {
 								if ((j + 1) < blocksize && p[j + 1] == 0) {
@@ -4881,11 +4966,6 @@ static void cmd_print_bars(RCore *core, const char *input) {
 								len = 0;
 							}
 							break;
-						case 'p':
-							if ((IS_PRINTABLE (p[j]))) {
-								k++;
-							}
-							break;
 						}
 					}
 					ptr[i] = 256 * k / blocksize;
@@ -4895,26 +4975,11 @@ static void cmd_print_bars(RCore *core, const char *input) {
 			}
 			break;
 		case 'e': // "p=e"
-		{
-			ut8 *p;
-			int i = 0;
-			ptr = calloc (1, nblocks);
+			ptr = entropyBars (core, nblocks, blocksize, skipblocks, from);
 			if (!ptr) {
 				goto beach;
 			}
-			p = malloc (blocksize);
-			if (!p) {
-				R_FREE (ptr);
-				goto beach;
-			}
-			for (i = 0; i < nblocks; i++) {
-				ut64 off = from + (blocksize * (i + skipblocks));
-				r_io_read_at (core->io, off, p, blocksize);
-				ptr[i] = (ut8) (255 * r_hash_entropy_fraction (p, blocksize));
-			}
-			free (p);
 			r_print_columns (core->print, ptr, nblocks, 14);
-		}
 			break;
 		default:
 			r_print_columns (core->print, core->block, core->blocksize, 14);
@@ -4994,27 +5059,10 @@ static void cmd_print_bars(RCore *core, const char *input) {
 	}
 		break;
 	case 'e': // "p=e" entropy
-	{
-		ut8 *p;
-		int i = 0;
-		ptr = calloc (1, nblocks);
-		if (!ptr) {
-			goto beach;
-		}
-		p = malloc (blocksize);
-		if (!p) {
-			R_FREE (ptr);
-			goto beach;
-		}
-		for (i = 0; i < nblocks; i++) {
-			ut64 off = from + (blocksize * (i + skipblocks));
-			r_io_read_at (core->io, off, p, blocksize);
-			ptr[i] = (ut8) (255 * r_hash_entropy_fraction (p, blocksize));
+		if ((ptr = entropyBars (core, nblocks, blocksize, skipblocks, from))) {
+			print_bars = true;
 		}
-		free (p);
-		print_bars = true;
-	}
-	break;
+		break;
 	case '0': // 0x00 bytes
 	case 'F': // 0xff bytes
 	case 'p': // printable chars
@@ -5035,18 +5083,12 @@ static void cmd_print_bars(RCore *core, const char *input) {
 		for (i = 0; i < nblocks; i++) {
 			ut64 off = from + blocksize * (i + skipblocks);
 			r_io_read_at (core->io, off, p, blocksize);
+			if (statsCount (p, blocksize, mode, &k)) {
+				ptr[i] = 256 * k / blocksize;
+				continue;
+			}
 			for (j = k = 0; j < blocksize; j++) {
 				switch (mode) {
-				case '0':
-					if (!p[j]) {
-						k++;
-					}
-					break;
-				case 'F':
-					if (p[j] == 0xff) {
-						k++;
-					}
-					break;
 				case 'z':
 					if ((IS_PRINTABLE (p[j]))) {
 						if ((j + 1) < blocksize && p[j + 1] == 0) {
@@ -5060,11 +5102,6 @@ static void cmd_print_bars(RCore *core, const char *input) {
 						len = 0;
 					}
 					break;
-				case 'p':
-					if ((IS_PRINTABLE (p[j]))) {
-						k++;
-					}
-					break;
 				}
 			}
 			ptr[i] = 256 * k / blocksize;
@@ -6766,6 +6803,9 @@ static int cmd_print(void *data, const char *input) {
 			case ' ': // "pad"
 				__cmd_pad (core, arg);
 				break;
+			case 'j': // "padj"
+				__cmd_padj (core, r_str_trim_head_ro (input + 3));
+				break;
 			case '?': // "pad?"
 				r_core_cmd_help_contains (core, help_msg_pa, "pad");
 				break;
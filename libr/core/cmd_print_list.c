@@ -49,6 +49,7 @@ static void tree_files(struct treestate *ts, int indent) {
 		R_LOG_WARN ("Unable to find current bin file");
 		return;
 	}
+	r_bin_addrinfo_load (ts->core->bin);
 	SdbList *ls = sdb_foreach_list (bf->sdb_addrinfo, false);
 	// Use the parsed information from _raw and transform it to more useful format
 	SdbListIter *sdbiter;
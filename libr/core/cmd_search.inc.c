@@ -1244,107 +1244,103 @@ static bool is_end_gadget(const RAnalOp *aop, const ut8 crop) {
 	return false;
 }
 
-static bool insert_into(void *user, const ut64 k, const ut64 v) {
-	HtUU *ht = (HtUU *)user;
-	ht_uu_insert (ht, k, v);
-	return true;
-}
-
 // TODO: follow unconditional jumps
-static RList *construct_rop_gadget(RCore *core, ut64 addr, ut8 *buf, int buflen, int idx, const char *grep, int regex, RList *rx_list, struct endlist_pair *end_gadget, HtUU *badstart) {
-	int endaddr = end_gadget->instr_offset;
-	int branch_delay = end_gadget->delay_size;
+// walks the instructions from idx up to the end gadget, the result doesn't
+// depend on the search options, so it's stored in the gadget database.
+// returns the index of the gadget or UT32_MAX if there's none there
+static ut32 construct_rop_gadget(RCore *core, RCoreRopDB *db, ut64 addr, ut8 *buf, int buflen, int idx, struct endlist_pair *end_gadget, int max_instr) {
+	const int endaddr = end_gadget->instr_offset;
+	const int start = idx;
 	RAnalOp aop = {0};
-	const char *start = NULL, *end = NULL;
-	char *grep_str = NULL;
-	RCoreAsmHit *hit = NULL;
-	RList *hitlist = r_core_asm_hit_list_new ();
-	ut8 nb_instr = 0;
-	const ut8 max_instr = r_config_get_i (core->config, "rop.len");
+	int nb_instr = 0;
 	bool valid = false;
-	int grep_find;
-	int search_hit;
-	char *rx = NULL;
-	HtUU *localbadstart = ht_uu_new0 ();
-	int count = 0;
-
-	if (grep) {
-		start = grep;
-		end = strchr (grep, ';');
-		if (!end) { // We filter on a single opcode, so no ";"
-			end = start + strlen (grep);
-		}
-		grep_str = calloc (1, end - start + 1);
-		strncpy (grep_str, start, end - start);
-		if (regex) {
-			// get the first regexp.
-			if (r_list_length (rx_list) > 0) {
-				rx = r_list_get_n (rx_list, count++);
-			}
-		}
-	}
-
-	bool found;
-	ht_uu_find (badstart, idx, &found);
-	if (found) {
-		valid = false;
-		goto ret;
+	int *sizes = R_NEWS0 (int, max_instr);
+	char **opstr = R_NEWS0 (char *, max_instr);
+	if (!sizes || !opstr) {
+		free (sizes);
+		free (opstr);
+		return UT32_MAX;
 	}
 	while (nb_instr < max_instr) {
-		ht_uu_insert (localbadstart, idx, 1);
 		int error = r_anal_op (core->anal, &aop, addr, buf + idx, buflen - idx, R_ARCH_OP_MASK_DISASM);
 		if (error < 0 || (nb_instr == 0 && (is_end_gadget (&aop, 0) || aop.type == R_ANAL_OP_TYPE_NOP))) {
-			valid = false;
-			goto ret;
+			break;
 		}
 		const int opsz = aop.size;
-		// opsz = r_strbuf_length (asmop.buf);
 		char *opst = aop.mnemonic;
+		aop.mnemonic = NULL;
 		if (!opst) {
 			R_LOG_ERROR ("Missing mnemonic after disasm");
 			RAnalOp asmop;
 			r_asm_set_pc (core->rasm, addr);
 			if (r_asm_disassemble (core->rasm, &asmop, buf + idx, buflen - idx) < 0) {
-				valid = false;
-				goto ret;
+				break;
 			}
 			opst = strdup (r_str_get (asmop.mnemonic));
 			r_anal_op_fini (&asmop);
 		}
+		sizes[nb_instr] = opsz;
+		opstr[nb_instr++] = opst;
 		if (!r_str_ncasecmp (opst, "invalid", strlen ("invalid")) ||
 			!r_str_ncasecmp (opst, ".byte", strlen (".byte"))) {
-			valid = false;
-			goto ret;
-		}
-
-		hit = r_core_asm_hit_new ();
-		if (hit) {
-			hit->addr = addr;
-			hit->len = opsz;
-			r_list_append (hitlist, hit);
+			break;
 		}
-
 		// Move on to the next instruction
 		idx += opsz;
 		addr += opsz;
+		if (endaddr <= (idx - opsz)) {
+			valid = (endaddr == idx - opsz);
+			break;
+		}
+		r_anal_op_fini (&aop);
+	}
+	r_anal_op_fini (&aop);
+	if (!valid) {
+		int i;
+		for (i = 0; i < nb_instr; i++) {
+			free (opstr[i]);
+		}
+		free (opstr);
+		free (sizes);
+		return UT32_MAX;
+	}
+	return r_core_ropdb_add_gadget (db, buf + start, sizes, opstr, nb_instr);
+}
+
+// the grep is a list of ';' separated strings or regexps that must be found
+// in this order in the mnemonics of the gadget
+static bool rop_gadget_grep(RCoreRopGadget *g, const char *grep, int regex, RList *rx_list) {
+	if (!grep) {
+		return true;
+	}
+	const char *start = grep;
+	const char *end = strchr (grep, ';');
+	if (!end) { // We filter on a single opcode, so no ";"
+		end = start + strlen (grep);
+	}
+	char *grep_str = r_str_ndup (start, end - start);
+	char *rx = NULL;
+	int count = 0;
+	if (regex && r_list_length (rx_list) > 0) {
+		// get the first regexp.
+		rx = r_list_get_n (rx_list, count++);
+	}
+	ut32 i;
+	for (i = 0; i < g->ninstr; i++) {
+		const char *opst = g->opstr[i];
+		bool search_hit;
 		if (rx) {
-			grep_find = !r_regex_match (rx, "e", opst);
-			search_hit = (end && grep && (grep_find < 1));
+			search_hit = end && r_regex_match (rx, "e", opst);
 		} else {
-			search_hit = (end && grep && strstr (opst, grep_str));
+			search_hit = end && grep_str && strstr (opst, grep_str);
 		}
-
-		// Handle (possible) grep
 		if (search_hit) {
 			if (end[0] == ';') { // fields are semicolon-separated
 				start = end + 1; // skip the ;
 				end = strchr (start, ';');
 				end = end? end: start + strlen (start); // latest field?
 				free (grep_str);
-				grep_str = calloc (1, end - start + 1);
-				if (grep_str) {
-					strncpy (grep_str, start, end - start);
-				}
+				grep_str = r_str_ndup (start, end - start);
 			} else {
 				end = NULL;
 			}
@@ -1352,36 +1348,178 @@ static RList *construct_rop_gadget(RCore *core, ut64 addr, ut8 *buf, int buflen,
 				rx = r_list_get_n (rx_list, count++);
 			}
 		}
-		if (endaddr <= (idx - opsz)) {
-			valid = (endaddr == idx - opsz);
-			goto ret;
-		}
-		free (opst);
-		aop.mnemonic = NULL;
-		nb_instr++;
-		r_anal_op_fini (&aop);
 	}
-ret:
-	r_anal_op_fini (&aop);
 	free (grep_str);
-	if (regex && rx) {
-		r_list_free (hitlist);
-		ht_uu_free (localbadstart);
+	return !(regex && rx) && !end;
+}
+
+static RList *rop_gadget_hitlist(RCoreRopGadget *g, ut64 addr) {
+	RList *hitlist = r_core_asm_hit_list_new ();
+	ut32 i;
+	for (i = 0; hitlist && i < g->ninstr; i++) {
+		RCoreAsmHit *hit = r_core_asm_hit_new ();
+		if (hit) {
+			hit->addr = addr;
+			hit->len = g->sizes[i];
+			r_list_append (hitlist, hit);
+		}
+		addr += g->sizes[i];
+	}
+	return hitlist;
+}
+
+// the gadgets depend on the contents and on how they are disassembled
+static char *rop_map_key(RCore *core, const ut8 *buf, int len, ut64 from) {
+	char *hash = r_hash_tostring (NULL, "sha256", buf, len);
+	if (!hash) {
 		return NULL;
 	}
-	if (!valid || (grep && end)) {
-		r_list_free (hitlist);
-		ht_uu_free (localbadstart);
+	char *key = r_str_newf ("%s.%"PFMT64x".%s.%s.%s.%d.%d.%d.%d", hash, from,
+		r_config_get (core->config, "asm.arch"),
+		r_config_get (core->config, "asm.cpu"),
+		r_config_get (core->config, "asm.syntax"),
+		(int)r_config_get_i (core->config, "asm.bits"),
+		(int)r_config_get_b (core->config, "cfg.bigendian"),
+		(int)r_config_get_i (core->config, "rop.len"),
+		(int)r_config_get_b (core->config, "rop.conditional"));
+	free (hash);
+	return key;
+}
+
+static char *rop_cache_path(RCore *core, const char *key) {
+	const char *cd = r_config_get (core->config, "dir.cache");
+	char *hash = r_hash_tostring (NULL, "sha256", (const ut8 *)key, strlen (key));
+	char *res = hash? r_str_newf ("%s%srop.%s.bin", cd, R_SYS_DIR, hash): NULL;
+	free (hash);
+	return res;
+}
+
+/* Sweep a map for all the gadgets like /R without a grep does, but without
+ * printing anything. The visits are recorded in order, so the searches can
+ * replay the walk with their own filters. Returns NULL if interrupted */
+static RCoreRopMap *rop_map_build(RCore *core, RCoreRopDB *db, const char *key, ut64 from, ut8 *buf, int delta, int increment) {
+	const ut8 crop = r_config_get_i (core->config, "rop.conditional");      // decide if cjmp, cret, and ccall should be used too for the gadget-search
+	const int max_instr = r_config_get_i (core->config, "rop.len");
+	RList /*<endlist_pair>*/ *end_list = r_list_newf (free);
+	RCoreRopMap *rm = r_core_ropdb_map_add (db, key, from, delta);
+	int i;
+	if (!end_list || !rm) {
+		r_list_free (end_list);
 		return NULL;
 	}
-	ht_uu_foreach (localbadstart, insert_into, badstart);
-	ht_uu_free (localbadstart);
-	// If our arch has bds then we better be including them
-	if (branch_delay && r_list_length (hitlist) < (1 + branch_delay)) {
-		r_list_free (hitlist);
+	// Find the end gadgets.
+	for (i = 0; i + 32 < delta; i += increment) {
+		RAnalOp end_gadget = {0};
+		// Disassemble one.
+		if (r_anal_op (core->anal, &end_gadget, from + i, buf + i,
+				delta - i, R_ARCH_OP_MASK_BASIC) < 1) {
+			r_anal_op_fini (&end_gadget);
+			continue;
+		}
+		if (is_end_gadget (&end_gadget, crop)) {
+			struct endlist_pair *epair = R_NEW0 (struct endlist_pair);
+			if (epair) {
+				// If this arch has branch delay slots, add the next instr as well
+				if (end_gadget.delay) {
+					epair->instr_offset = i + increment;
+					epair->delay_size = end_gadget.delay;
+				} else {
+					epair->instr_offset = (intptr_t) i;
+					epair->delay_size = end_gadget.delay;
+				}
+				r_list_append (end_list, (void *) (intptr_t) epair);
+			}
+		}
+		r_anal_op_fini (&end_gadget);
+		if (r_cons_is_breaked ()) {
+			break;
+		}
+		// Right now we have a list of all of the end/stop gadgets.
+		// We can just construct gadgets from a little bit before them.
+	}
+	r_list_reverse (end_list);
+	// If we have no end gadgets, just skip all of this search nonsense.
+	if (!r_list_empty (end_list) && !r_cons_is_breaked ()) {
+		int prev, next, ropdepth;
+		ut32 section = 0;
+		const int max_inst_size_x86 = 15;
+		// Get the depth of rop search, should just be max_instr
+		// instructions, x86 and friends are weird length instructions, so
+		// we'll just assume 15 byte instructions.
+		ropdepth = (increment == 1)
+			? max_instr * max_inst_size_x86 /* wow, x86 is long */
+			: max_instr * increment;
+		struct endlist_pair *end_gadget = (struct endlist_pair *) r_list_pop (end_list);
+		next = end_gadget->instr_offset;
+		prev = 0;
+		// Start at just before the first end gadget.
+		for (i = next - ropdepth; i < (delta - max_inst_size_x86); i += increment) {
+			RAnalOp asmop;
+			if (increment == 1) {
+				// give in-boundary instructions a shot
+				if (i < prev - max_inst_size_x86) {
+					i = prev - max_inst_size_x86;
+				}
+			} else {
+				if (i < prev) {
+					i = prev;
+				}
+			}
+			if (i < 0) {
+				i = 0;
+			}
+			if (r_cons_is_breaked ()) {
+				break;
+			}
+			if (i >= next) {
+				// We've exhausted the first end-gadget section,
+				// move to the next one.
+				free (end_gadget);
+				end_gadget = NULL;
+				if (r_list_get_n (end_list, 0)) {
+					prev = i;
+					end_gadget = (struct endlist_pair *) r_list_pop (end_list);
+					next = end_gadget->instr_offset;
+					section++;
+					i = next - ropdepth;
+					if (i < 0) {
+						i = 0;
+					}
+				} else {
+					break;
+				}
+			}
+			if (r_asm_disassemble (core->rasm, &asmop, buf + i, delta - i)) {
+				r_asm_set_pc (core->rasm, from + i);
+				ut32 gadget = construct_rop_gadget (core, db, from + i, buf, delta, i, end_gadget, max_instr);
+				if (gadget != UT32_MAX) {
+					RCoreRopHit hit = {
+						.addr = from + i,
+						.end = from + next,
+						.gadget = gadget,
+						.section = section,
+						.delay = end_gadget->delay_size,
+					};
+					r_vector_push (&rm->hits, &hit);
+				}
+				// fixed size archs also skip to the next end gadget after
+				// printing one, the search replays that with its filters
+				r_anal_op_fini (&asmop);
+				continue;
+			}
+			r_anal_op_fini (&asmop);
+			if (increment != 1) {
+				i = next;
+			}
+		}
+		free (end_gadget);
+	}
+	r_list_free (end_list);
+	if (r_cons_is_breaked ()) {
+		r_core_ropdb_map_del (db, key);
 		return NULL;
 	}
-	return hitlist;
+	return rm;
 }
 
 static void print_rop(RCore *core, RList *hitlist, PJ *pj, int mode) {
@@ -1552,13 +1690,12 @@ static void print_rop(RCore *core, RList *hitlist, PJ *pj, int mode) {
 }
 
 static int r_core_search_rop(RCore *core, RInterval search_itv, int opt, const char *grep, int regexp, struct search_parameters *param) {
-	const ut8 crop = r_config_get_i (core->config, "rop.conditional");      // decide if cjmp, cret, and ccall should be used too for the gadget-search
 	const ut8 subchain = r_config_get_i (core->config, "rop.subchains");
 	const ut8 max_instr = r_config_get_i (core->config, "rop.len");
+	const bool cache = r_config_get_b (core->config, "rop.cache");
 	const char *arch = r_config_get (core->config, "asm.arch");
 	int max_count = r_config_get_i (core->config, "search.maxhits");
-	int i = 0, end = 0, mode = 0, increment = 1, ret, result = true;
-	RList /*<endlist_pair>*/ *end_list = r_list_newf (free);
+	int mode = 0, increment = 1, result = true;
 	RList /*<RRegex>*/ *rx_list = NULL;
 	int align = core->search->align;
 	RListIter *itermap = NULL;
@@ -1566,10 +1703,19 @@ static int r_core_search_rop(RCore *core, RInterval search_itv, int opt, const c
 	char *save_ptr = NULL;
 	char *grep_arg = NULL;
 	char *rx = NULL;
-	int delta = 0;
-	ut8 *buf;
 	RIOMap *map;
 
+	if (max_instr <= 1) {
+		R_LOG_ERROR ("ROP length (rop.len) must be greater than 1");
+		if (max_instr == 1) {
+			R_LOG_ERROR ("For rop.len = 1, use /c to search for single instructions. See /c? for help");
+		}
+		return false;
+	}
+	RCoreRopDB *db = rop_db (core);
+	if (!db) {
+		return false;
+	}
 	Sdb *gadgetSdb = NULL;
 	if (r_config_get_i (core->config, "rop.sdb")) {
 		if (!(gadgetSdb = sdb_ns (core->sdb, "gadget_sdb", false))) {
@@ -1579,14 +1725,6 @@ static int r_core_search_rop(RCore *core, RInterval search_itv, int opt, const c
 	if (max_count == 0) {
 		max_count = -1;
 	}
-	if (max_instr <= 1) {
-		r_list_free (end_list);
-		R_LOG_ERROR ("ROP length (rop.len) must be greater than 1");
-		if (max_instr == 1) {
-			R_LOG_ERROR ("For rop.len = 1, use /c to search for single instructions. See /c? for help");
-		}
-		return false;
-	}
 
 	if (!strcmp (arch, "mips")) { // MIPS has no jump-in-the-middle
 		increment = 4;
@@ -1595,6 +1733,8 @@ static int r_core_search_rop(RCore *core, RInterval search_itv, int opt, const c
 	} else if (!strcmp (arch, "avr")) { // AVR is halfword aligned.
 		increment = 2;
 	}
+	// same as the depth used while building the map
+	const int ropdepth = (increment == 1)? max_instr * 15: max_instr * increment;
 
 	// Options, like JSON, linear, ...
 	grep_arg = strchr (grep, ' ');
@@ -1639,184 +1779,133 @@ static int r_core_search_rop(RCore *core, RInterval search_itv, int opt, const c
 	r_cons_break_push (NULL, NULL);
 
 	r_list_foreach (param->boundaries, itermap, map) {
-		HtUU *badstart = ht_uu_new0 ();
 		if (!r_itv_overlap (search_itv, map->itv)) {
 			continue;
 		}
-		RInterval itv = r_itv_intersect (search_itv, map->itv);
-		ut64 from = itv.addr, to = r_itv_end (itv);
-		if (r_cons_is_breaked ()) {
+		if (!max_count || r_cons_is_breaked ()) {
 			break;
 		}
-		delta = to - from;
-		buf = calloc (1, delta);
+		RInterval itv = r_itv_intersect (search_itv, map->itv);
+		const ut64 from = itv.addr;
+		const int delta = r_itv_end (itv) - from;
+		ut8 *buf = calloc (1, delta);
 		if (!buf) {
 			result = false;
 			goto bad;
 		}
 		(void) r_io_read_at (core->io, from, buf, delta);
-
-		// Find the end gadgets.
-		for (i = 0; i + 32 < delta; i += increment) {
-			RAnalOp end_gadget = {0};
-			// Disassemble one.
-			if (r_anal_op (core->anal, &end_gadget, from + i, buf + i,
-					delta - i, R_ARCH_OP_MASK_BASIC) < 1) {
-				r_anal_op_fini (&end_gadget);
-				continue;
+		// the gadgets of the same contents are only collected once
+		char *key = rop_map_key (core, buf, delta, from);
+		char *file = (key && cache)? rop_cache_path (core, key): NULL;
+		RCoreRopMap *rm = key? r_core_ropdb_map_get (db, key): NULL;
+		if (!rm && file) {
+			rm = r_core_ropdb_load (db, key, file, from, delta);
+		}
+		if (!rm && key) {
+			rm = rop_map_build (core, db, key, from, buf, delta, increment);
+			if (rm && file) {
+				r_sys_mkdirp (r_config_get (core->config, "dir.cache"));
+				if (!r_core_ropdb_save (db, key, file)) {
+					R_LOG_WARN ("Cannot write %s", file);
+				}
 			}
-			if (is_end_gadget (&end_gadget, crop)) {
-#if 0
-				if (search->maxhits && r_list_length (end_list) >= search->maxhits) {
-					// limit number of high level rop gadget results
-					r_anal_op_fini (&end_gadget);
-					break;
+		}
+		free (file);
+		free (key);
+		free (buf);
+		if (!rm) {
+			continue;
+		}
+		HtUU *badstart = ht_uu_new0 ();
+		HtUU *greps = ht_uu_new0 ();
+		// fixed size archs move to the next end gadget after printing one
+		ut32 skip_section = UT32_MAX;
+		ut64 skip_end = 0;
+		RCoreRopHit *rh;
+		r_vector_foreach (&rm->hits, rh) {
+			if (!max_count || r_cons_is_breaked ()) {
+				break;
+			}
+			if (skip_section != UT32_MAX) {
+				if (rh->section == skip_section) {
+					continue;
 				}
-#endif
-				struct endlist_pair *epair = R_NEW0 (struct endlist_pair);
-				if (epair) {
-					// If this arch has branch delay slots, add the next instr as well
-					if (end_gadget.delay) {
-						epair->instr_offset = i + increment;
-						epair->delay_size = end_gadget.delay;
-					} else {
-						epair->instr_offset = (intptr_t) i;
-						epair->delay_size = end_gadget.delay;
-					}
-					r_list_append (end_list, (void *) (intptr_t) epair);
+				// and won't look at that end gadget again unless the
+				// next section starts there
+				const ut64 first = (rh->end - rm->addr > (ut64)ropdepth)? rh->end - ropdepth: rm->addr;
+				if (rh->section == skip_section + 1 && rh->addr == skip_end && rh->addr != first) {
+					continue;
 				}
 			}
-			r_anal_op_fini (&end_gadget);
-			if (r_cons_is_breaked ()) {
-				break;
+			RCoreRopGadget *g = r_core_ropdb_gadget (db, rh->gadget);
+			bool found = false;
+			ht_uu_find (badstart, rh->addr, &found);
+			if (!g || found) {
+				continue;
 			}
-			// Right now we have a list of all of the end/stop gadgets.
-			// We can just construct gadgets from a little bit before them.
-		}
-		r_list_reverse (end_list);
-		// If we have no end gadgets, just skip all of this search nonsense.
-		if (!r_list_empty (end_list)) {
-			int prev, next, ropdepth;
-			const int max_inst_size_x86 = 15;
-			// Get the depth of rop search, should just be max_instr
-			// instructions, x86 and friends are weird length instructions, so
-			// we'll just assume 15 byte instructions.
-			ropdepth = (increment == 1)
-				? max_instr * max_inst_size_x86 /* wow, x86 is long */
-				: max_instr * increment;
-			if (r_cons_is_breaked ()) {
+			ut64 match = ht_uu_find (greps, rh->gadget, &found);
+			if (!found) {
+				match = rop_gadget_grep (g, grep, regexp, rx_list);
+				ht_uu_insert (greps, rh->gadget, match);
+			}
+			if (!match) {
+				continue;
+			}
+			ut64 addr = rh->addr;
+			ut32 k;
+			for (k = 0; k < g->ninstr; k++) {
+				ht_uu_insert (badstart, addr, 1);
+				addr += g->sizes[k];
+			}
+			// If our arch has bds then we better be including them
+			if (rh->delay && g->ninstr < 1 + rh->delay) {
+				continue;
+			}
+			if (align && (0 != (rh->addr % align))) {
+				continue;
+			}
+			RList *hitlist = rop_gadget_hitlist (g, rh->addr);
+			if (!hitlist) {
+				result = false;
 				break;
 			}
-			struct endlist_pair *end_gadget = (struct endlist_pair *) r_list_pop (end_list);
-			next = end_gadget->instr_offset;
-			prev = 0;
-			// Start at just before the first end gadget.
-			for (i = next - ropdepth; i < (delta - max_inst_size_x86) && max_count; i += increment) {
-				RAnalOp asmop;
-				if (increment == 1) {
-					// give in-boundary instructions a shot
-					if (i < prev - max_inst_size_x86) {
-						i = prev - max_inst_size_x86;
-					}
-				} else {
-					if (i < prev) {
-						i = prev;
-					}
-				}
-				if (i < 0) {
-					i = 0;
-				}
-				if (r_cons_is_breaked ()) {
-					break;
-				}
-				if (i >= next) {
-					// We've exhausted the first end-gadget section,
-					// move to the next one.
-					free (end_gadget);
-					if (r_list_get_n (end_list, 0)) {
-						prev = i;
-						end_gadget = (struct endlist_pair *) r_list_pop (end_list);
-						next = end_gadget->instr_offset;
-						i = next - ropdepth;
-						if (i < 0) {
-							i = 0;
-						}
-					} else {
-						break;
-					}
-				}
-				if (i >= end) { // read by chunk of 4k
-					r_io_read_at (core->io, from + i, buf + i,
-						R_MIN ((delta - i), 4096));
-					end = i + 2048;
+			if (gadgetSdb) {
+				RListIter *iter;
+				RCoreAsmHit *hit;
+				char *headAddr = r_str_newf ("%"PFMT64x, rh->addr);
+				r_list_foreach (hitlist, iter, hit) {
+					char *addr = r_str_newf ("%"PFMT64x"(%"PFMT32d")", hit->addr, hit->len);
+					sdb_concat (gadgetSdb, headAddr, addr, 0);
+					free (addr);
 				}
-				ret = r_asm_disassemble (core->rasm, &asmop, buf + i, delta - i);
-				if (ret) {
-					r_asm_set_pc (core->rasm, from + i);
-					RList *hitlist = construct_rop_gadget (core,
-						from + i, buf, delta, i, grep, regexp,
-						rx_list, end_gadget, badstart);
-					if (!hitlist) {
-						r_anal_op_fini (&asmop);
-						continue;
-					}
-					if (align && (0 != ((from + i) % align))) {
-						r_anal_op_fini (&asmop);
-						continue;
-					}
-					if (gadgetSdb) {
-						RListIter *iter;
-
-						RCoreAsmHit *hit = (RCoreAsmHit *) hitlist->head->data;
-						char *headAddr = r_str_newf ("%"PFMT64x, hit->addr);
-						if (!headAddr) {
-							result = false;
-							r_anal_op_fini (&asmop);
-							goto bad;
-						}
-
-						r_list_foreach (hitlist, iter, hit) {
-							char *addr = r_str_newf ("%"PFMT64x"(%"PFMT32d")", hit->addr, hit->len);
-							if (!addr) {
-								free (headAddr);
-								result = false;
-								r_anal_op_fini (&asmop);
-								goto bad;
-							}
-							sdb_concat (gadgetSdb, headAddr, addr, 0);
-							free (addr);
-						}
-						free (headAddr);
-					}
+				free (headAddr);
+			}
 
-					if (param->outmode == R_MODE_JSON) {
-						mode = 'j';
-					}
-					if ((mode == 'q') && subchain) {
-						do {
-							print_rop (core, hitlist, NULL, mode);
-							hitlist->head = hitlist->head->n;
-						} while (hitlist->head->n);
-					} else {
-						print_rop (core, hitlist, param->pj, mode);
-					}
-					r_list_free (hitlist);
-					if (max_count > 0) {
-						max_count--;
-						if (max_count < 1) {
-							r_anal_op_fini (&asmop);
-							break;
-						}
-					}
-				}
-				r_anal_op_fini (&asmop);
-				if (increment != 1) {
-					i = next;
-				}
+			if (param->outmode == R_MODE_JSON) {
+				mode = 'j';
+			}
+			if ((mode == 'q') && subchain) {
+				do {
+					print_rop (core, hitlist, NULL, mode);
+					hitlist->head = hitlist->head->n;
+				} while (hitlist->head->n);
+			} else {
+				print_rop (core, hitlist, param->pj, mode);
+			}
+			r_list_free (hitlist);
+			if (max_count > 0) {
+				max_count--;
+			}
+			if (increment != 1) {
+				skip_section = rh->section;
+				skip_end = rh->end;
 			}
 		}
-		free (buf);
+		ht_uu_free (greps);
 		ht_uu_free (badstart);
+		if (!result) {
+			break;
+		}
 	}
 	if (r_cons_is_breaked ()) {
 		eprintf ("\n");
@@ -1828,7 +1917,6 @@ static int r_core_search_rop(RCore *core, RInterval search_itv, int opt, const c
 	}
 bad:
 	r_list_free (rx_list);
-	r_list_free (end_list);
 	free (grep_arg);
 	free (gregexp);
 	return result;
@@ -4989,7 +5077,6 @@ reread:
 		} else if (input[1] == ' ' || input[1] == '\0' || param.outmode == R_MODE_JSON) {
 			int ret;
 			const char *file = input[param_offset - 1]? input + param_offset: NULL;
-			ut64 addr = search_itv.addr;
 			RListIter *iter;
 			RIOMap *map;
 			RSearchKeyword *kw;
@@ -5010,23 +5097,17 @@ reread:
 					eprintf ("-- %"PFMT64x" %"PFMT64x"\n", r_io_map_begin (map), r_io_map_end (map));
 				}
 				r_cons_break_push (NULL, NULL);
-				for (addr = r_io_map_begin (map); addr < r_io_map_end (map); addr++) {
-					if (r_cons_is_breaked ()) {
-						break;
-					}
-					ret = r_core_magic_at (core, kw, file, addr, 0, false,
-							param.outmode == R_MODE_JSON? param.pj: NULL, &hits);
-					if (ret == -1) {
-						// something went terribly wrong.
-						break;
-					}
-					if (maxHits && hits >= maxHits) {
-						break;
-					}
-					addr += ret - 1;
-				}
+				ret = r_core_magic_scan (core, kw, file, r_io_map_begin (map), r_io_map_end (map),
+						param.outmode == R_MODE_JSON? param.pj: NULL, &hits);
 				r_cons_clear_line (1);
 				r_cons_break_pop ();
+				if (ret == -1) {
+					// something went terribly wrong.
+					break;
+				}
+				if (maxHits && hits >= maxHits) {
+					break;
+				}
 			}
 			if (param.outmode == R_MODE_JSON) {
 				pj_end (param.pj);
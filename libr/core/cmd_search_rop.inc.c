@@ -677,9 +677,52 @@ static int rop_classify_nops(RCore *core, RList *ropList) {
 	return changes;
 }
 
+static RCoreRopDB *rop_db(RCore *core) {
+	if (!core->ropdb) {
+		core->ropdb = r_core_ropdb_new ();
+	}
+	return core->ropdb;
+}
+
+// the emulation only depends on the esil expressions and the register profile
+// of the arch, so the results are kept in the gadget database and the same
+// sequence is never classified twice
+static const RCoreRopClass *rop_classify_cached(RCore *core, RList *ropList) {
+	RCoreRopDB *rdb = rop_db (core);
+	const char *arch = r_config_get (core->config, "asm.arch");
+	const int bits = r_config_get_i (core->config, "asm.bits");
+	const bool romem = r_config_get_b (core->config, "esil.romem");
+	const bool stats = r_config_get_b (core->config, "esil.stats");
+	RStrBuf *sb = r_strbuf_newf ("%s.%d.%d%d\n", r_str_get (arch), bits, romem, stats);
+	RListIter *iter;
+	const char *esil_str;
+	r_list_foreach (ropList, iter, esil_str) {
+		r_strbuf_appendf (sb, "%s\n", esil_str);
+	}
+	char *ckey = r_strbuf_drain (sb);
+	if (!rdb || !ckey) {
+		free (ckey);
+		return NULL;
+	}
+	const RCoreRopClass *res = r_core_ropdb_class_get (rdb, ckey);
+	if (!res) {
+		RCoreRopClass *c = R_NEW0 (RCoreRopClass);
+		if (c) {
+			c->nop = rop_classify_nops (core, ropList);
+			c->mov = rop_classify_mov (core, ropList);
+			c->constant = rop_classify_constant (core, ropList);
+			c->arithm = rop_classify_arithmetic (core, ropList);
+			c->arithm_ct = rop_classify_arithmetic_const (core, ropList);
+			if (r_core_ropdb_class_add (rdb, ckey, c)) {
+				res = c;
+			}
+		}
+	}
+	free (ckey);
+	return res;
+}
+
 static void rop_classify(RCore *core, Sdb *db, RList *ropList, const char *key, unsigned int size) {
-	int nop = 0;  rop_classify_nops (core, ropList);
-	char *mov, *ct, *arithm, *arithm_ct, *str;
 	Sdb *db_nop = sdb_ns (db, "nop", true);
 	Sdb *db_mov = sdb_ns (db, "mov", true);
 	Sdb *db_ct = sdb_ns (db, "const", true);
@@ -690,41 +733,36 @@ static void rop_classify(RCore *core, Sdb *db, RList *ropList, const char *key,
 		R_LOG_ERROR ("Could not create SDB 'rop' sub-namespaces");
 		return;
 	}
-	nop = rop_classify_nops (core, ropList);
-	mov = rop_classify_mov (core, ropList);
-	ct = rop_classify_constant (core, ropList);
-	arithm = rop_classify_arithmetic (core, ropList);
-	arithm_ct = rop_classify_arithmetic_const (core, ropList);
-	str = r_str_newf ("0x%u", size);
+	const RCoreRopClass *c = rop_classify_cached (core, ropList);
+	if (!c) {
+		return;
+	}
+	char *str = r_str_newf ("0x%u", size);
 
-	if (nop == 1) {
+	if (c->nop == 1) {
 		char *str_nop = r_str_newf ("%s NOP", str);
 		sdb_set (db_nop, key, str_nop, 0);
 		free (str_nop);
 	} else {
-		if (mov) {
-			char *str_mov = r_str_newf ("%s MOV { %s }", str, mov);
+		if (c->mov) {
+			char *str_mov = r_str_newf ("%s MOV { %s }", str, c->mov);
 			sdb_set (db_mov, key, str_mov, 0);
 			free (str_mov);
-			free (mov);
 		}
-		if (ct) {
-			char *str_ct = r_str_newf ("%s LOAD_CONST { %s }", str, ct);
+		if (c->constant) {
+			char *str_ct = r_str_newf ("%s LOAD_CONST { %s }", str, c->constant);
 			sdb_set (db_ct, key, str_ct, 0);
 			free (str_ct);
-			free (ct);
 		}
-		if (arithm) {
-			char *str_arithm = r_str_newf ("%s ARITHMETIC { %s }", str, arithm);
+		if (c->arithm) {
+			char *str_arithm = r_str_newf ("%s ARITHMETIC { %s }", str, c->arithm);
 			sdb_set (db_aritm, key, str_arithm, 0);
 			free (str_arithm);
-			free (arithm);
 		}
-		if (arithm_ct) {
-			char *str_arithm_ct = r_str_newf ("%s ARITHMETIC_CONST { %s }", str, arithm_ct);
+		if (c->arithm_ct) {
+			char *str_arithm_ct = r_str_newf ("%s ARITHMETIC_CONST { %s }", str, c->arithm_ct);
 			sdb_set (db_aritm_ct, key, str_arithm_ct, 0);
 			free (str_arithm_ct);
-			free (arithm_ct);
 		}
 	}
 
@@ -869,7 +869,7 @@ static void typesList(RCore *core, int mode) {
 }
 
 static void set_offset_hint(RCore *core, RAnalOp *op, const char *type, ut64 laddr, ut64 at, int offimm) {
-	char *res = r_type_get_struct_memb (core->anal->sdb_types, type, offimm);
+	char *res = r_anal_typedb_member_at (core->anal->typedb, type, offimm);
 	const char *cmt = ((offimm == 0) && res)? res: type;
 	if (offimm > 0) {
 		// set hint only if link is present
@@ -1265,7 +1265,7 @@ static int cmd_type(void *data, const char *input) {
 			break;
 		case 's': // "tss"
 			if (input[2] == ' ') {
-				r_cons_printf ("%" PFMT64u "\n", (r_type_get_bitsize (TDB, input + 3) / 8));
+				r_cons_printf ("%" PFMT64u "\n", (r_anal_typedb_bitsize (core->anal->typedb, input + 3) / 8));
 			} else {
 				r_core_cmd_help (core, help_msg_ts);
 			}
@@ -1533,6 +1533,7 @@ static int cmd_type(void *data, const char *input) {
 					if (out) {
 						// remove previous types and save new edited types
 						sdb_reset (TDB);
+						r_anal_typedb_invalidate (core->anal->typedb);
 						r_anal_save_parsed_type (core->anal, out);
 						free (out);
 					}
@@ -1818,7 +1819,7 @@ static int cmd_type(void *data, const char *input) {
 							}
 						}
 					}
-					int type_size = r_type_get_bitsize (core->anal->sdb_types, type) / 8;
+					int type_size = r_anal_typedb_bitsize (core->anal->typedb, type) / 8;
 					int obs = core->blocksize;
 					if (type_size > obs) {
 						r_core_block_size (core, type_size);
@@ -1850,6 +1851,7 @@ static int cmd_type(void *data, const char *input) {
 				r_core_cmd_help_match (core, help_msg_t, "t-*");
 			} else {
 				sdb_reset (TDB);
+				r_anal_typedb_invalidate (core->anal->typedb);
 			}
 		} else {
 			const char *name = r_str_trim_head_ro (input + 1);
@@ -2412,6 +2412,9 @@ static int win_eprintf(const char *format, ...) {
 static void ev_iowrite_cb(REvent *ev, int type, void *user, void *data) {
 	RCore *core = user;
 	REventIOWrite *iow = data;
+	if (core->fs && core->fs->cache) {
+		r_fs_cache_reset (core->fs->cache);
+	}
 	if (r_config_get_i (core->config, "anal.onchange")) {
 		// works, but loses varnames and such, but at least is not crashing
 		char *cmd = r_str_newf ("af-0x%08"PFMT64x";af 0x%08"PFMT64x, iow->addr, iow->addr);
@@ -2740,6 +2743,7 @@ R_API bool r_core_init(RCore *core) {
 	r_core_bind (core, &core->dbg->coreb);
 	r_core_bind (core, &core->dbg->bp->coreb);
 	r_core_bind (core, &core->io->coreb);
+	r_io_plugin_add (core->io, &r_io_plugin_rfs);
 	core->dbg->egg = core->egg;
 	core->dbg->anal = core->anal; // XXX: dupped instance.. can cause lost pointerz
 	// r_debug_use (core->dbg, "native");
@@ -2827,6 +2831,8 @@ R_API void r_core_fini(RCore *c) {
 	//update_sdb (c);
 	// avoid double free
 	r_list_free (c->ropchain);
+	r_core_ropdb_free (c->ropdb);
+	r_core_asm_index_free (c->asmidx);
 	r_table_free (c->table);
 	r_event_free (c->ev);
 	R_FREE (c->cmdlog);
@@ -2836,6 +2842,7 @@ R_API void r_core_fini(RCore *c) {
 	free (c->stkcmd);
 	r_project_free (c->prj);
 	r_list_free (c->visual.tabs);
+	r_list_free (c->visual.views);
 	free (c->block);
 	r_core_autocomplete_free (c->autocomplete);
 
@@ -2867,6 +2874,8 @@ R_API void r_core_fini(RCore *c) {
 	c->dbg = (r_debug_free (c->dbg), NULL);
 	c->io = (r_io_free (c->io), NULL);
 	c->lang = (r_lang_free (c->lang), NULL);
+	r_config_snap_free (c->ds_snap);
+	c->ds_snap = NULL;
 	r_config_free (c->config);
 	c->config = NULL;
 	/* after r_config_free, the value of I.teefile is trashed */
@@ -327,6 +327,15 @@ typedef struct r_disasm_state_t {
 	ut64 emustack_min;
 	ut64 emustack_max;
 	int skiplines; // for smooth scrolling in visual disasm
+	// raw config values only used while initializing the state
+	bool subrel;
+	bool subreg;
+	bool subvaronly;
+	bool show_lines_wide;
+	int bytespace;
+	const char *highlight;
+	const char *relto;
+	const char *strenc_str;
 } RDisasmState;
 
 static void ds_setup_print_pre(RDisasmState *ds, bool tail, bool middle);
@@ -633,6 +642,148 @@ static void ds_print_esil_anal_fini(RDisasmState *ds) {
 	}
 }
 
+#define DS_CFG(name, type, field) R_CONFIG_SNAP_FIELD (RDisasmState, name, type, field)
+static const RConfigSnapField ds_config[] = {
+	DS_CFG ("asm.anal", BOOL, asm_anal),
+	DS_CFG ("asm.anos", BOOL, show_anos),
+	DS_CFG ("asm.bbmiddle", BOOL, midbb),
+	DS_CFG ("asm.bytes", BOOL, show_bytes),
+	DS_CFG ("asm.bytes.align", BOOL, show_bytes_align),
+	DS_CFG ("asm.bytes.asbits", BOOL, show_bytes_asbits),
+	DS_CFG ("asm.bytes.ascii", BOOL, show_bytes_ascii),
+	DS_CFG ("asm.bytes.opcolor", BOOL, show_bytes_opcolor),
+	DS_CFG ("asm.bytes.right", BOOL, show_bytes_right),
+	DS_CFG ("asm.bytes.space", INT, bytespace),
+	DS_CFG ("asm.capitalize", BOOL, capitalize),
+	DS_CFG ("asm.cmt.calls", BOOL, show_calls),
+	DS_CFG ("asm.cmt.col", INT, cmtcol),
+	DS_CFG ("asm.cmt.esil", BOOL, show_cmt_esil),
+	DS_CFG ("asm.cmt.flgrefs", BOOL, show_cmt_flgrefs),
+	DS_CFG ("asm.cmt.fold", INT, cmtfold),
+	DS_CFG ("asm.cmt.off", STR, show_cmtoff),
+	DS_CFG ("asm.cmt.pseudo", BOOL, show_cmt_pseudo),
+	DS_CFG ("asm.cmt.refs", BOOL, show_cmtrefs),
+	DS_CFG ("asm.cmt.right", INT, show_cmt_right_default),
+	DS_CFG ("asm.cmt.token", STR, cmtoken),
+	DS_CFG ("asm.cmt.user", BOOL, show_cmt_user),
+	DS_CFG ("asm.cmt.wrap", BOOL, cmt_wrap),
+	DS_CFG ("asm.comments", BOOL, show_comments),
+	DS_CFG ("asm.cycles", BOOL, show_cycles),
+	DS_CFG ("asm.cyclespace", INT, cyclespace),
+	DS_CFG ("asm.decode", INT, decode),
+	DS_CFG ("asm.demangle", INT, asm_demangle),
+	DS_CFG ("asm.describe", BOOL, asm_describe),
+	DS_CFG ("asm.dwarf", BOOL, show_dwarf),
+	DS_CFG ("asm.dwarf.abspath", BOOL, dwarfAbspath),
+	DS_CFG ("asm.dwarf.file", BOOL, dwarfFile),
+	DS_CFG ("asm.emu", BOOL, show_emu),
+	DS_CFG ("asm.esil", BOOL, use_esil),
+	DS_CFG ("asm.family", BOOL, show_family),
+	DS_CFG ("asm.fcnsig", BOOL, show_fcnsig),
+	DS_CFG ("asm.flags", BOOL, show_flags),
+	DS_CFG ("asm.flags.inbytes", BOOL, show_flag_in_bytes),
+	DS_CFG ("asm.flags.inline", BOOL, flags_inline),
+	DS_CFG ("asm.flags.inoffset", BOOL, show_flag_in_offset),
+	DS_CFG ("asm.flags.limit", INT, maxflags),
+	DS_CFG ("asm.flags.middle", INT, midflags),
+	DS_CFG ("asm.flags.offset", BOOL, show_flgoff),
+	DS_CFG ("asm.flags.prefix", BOOL, flags_prefix),
+	DS_CFG ("asm.flags.right", BOOL, asm_flags_right),
+	DS_CFG ("asm.functions", BOOL, show_functions),
+	DS_CFG ("asm.highlight", STR, highlight),
+	DS_CFG ("asm.hint.call", BOOL, asm_hint_call),
+	DS_CFG ("asm.hint.call.indirect", BOOL, asm_hint_call_indirect),
+	DS_CFG ("asm.hint.cdiv", BOOL, asm_hint_cdiv),
+	DS_CFG ("asm.hint.emu", BOOL, asm_hint_emu),
+	DS_CFG ("asm.hint.imm", BOOL, asm_hint_imm),
+	DS_CFG ("asm.hint.jmp", BOOL, asm_hint_jmp),
+	DS_CFG ("asm.hint.lea", BOOL, asm_hint_lea),
+	DS_CFG ("asm.hint.pos", INT, asm_hint_pos),
+	DS_CFG ("asm.hints", BOOL, asm_hints),
+	DS_CFG ("asm.imm.str", BOOL, immstr),
+	DS_CFG ("asm.imm.trim", BOOL, immtrim),
+	DS_CFG ("asm.indent", INT, show_indent),
+	DS_CFG ("asm.indentspace", INT, indent_space),
+	DS_CFG ("asm.instr", BOOL, asm_instr),
+	DS_CFG ("asm.lbytes", INT, lbytes),
+	DS_CFG ("asm.lines", BOOL, show_lines),
+	DS_CFG ("asm.lines.bb", BOOL, show_bbline),
+	DS_CFG ("asm.lines.call", BOOL, show_lines_call),
+	DS_CFG ("asm.lines.fcn", BOOL, show_lines_fcn),
+	DS_CFG ("asm.lines.jmp", BOOL, show_lines_bb),
+	DS_CFG ("asm.lines.out", INT, linesout),
+	DS_CFG ("asm.lines.ret", BOOL, show_lines_ret),
+	DS_CFG ("asm.lines.right", BOOL, linesright),
+	DS_CFG ("asm.lines.wide", BOOL, show_lines_wide),
+	DS_CFG ("asm.marks", BOOL, show_marks),
+	DS_CFG ("asm.meta", BOOL, asm_meta),
+	DS_CFG ("asm.midcursor", BOOL, midcursor),
+	DS_CFG ("asm.middle", INT, adistrick),
+	DS_CFG ("asm.nbytes", INT, nbytes),
+	DS_CFG ("asm.nodup", BOOL, show_nodup),
+	DS_CFG ("asm.noisy", BOOL, show_noisy_comments),
+	DS_CFG ("asm.offset", BOOL, show_offset),
+	DS_CFG ("asm.offset.base10", BOOL, show_offdec),
+	DS_CFG ("asm.offset.focus", BOOL, show_offset_focus),
+	DS_CFG ("asm.offset.relto", STR, relto),
+	DS_CFG ("asm.offset.segment", BOOL, show_offseg),
+	DS_CFG ("asm.optype", BOOL, show_optype),
+	DS_CFG ("asm.payloads", BOOL, showpayloads),
+	DS_CFG ("asm.pseudo", BOOL, pseudo),
+	DS_CFG ("asm.refptr", BOOL, show_refptr),
+	DS_CFG ("asm.section", BOOL, show_section),
+	DS_CFG ("asm.section.col", INT, show_section_col),
+	DS_CFG ("asm.section.name", BOOL, show_section_name),
+	DS_CFG ("asm.section.perm", BOOL, show_section_perm),
+	DS_CFG ("asm.size", BOOL, show_size),
+	DS_CFG ("asm.slow", BOOL, show_slow),
+	DS_CFG ("asm.stackptr", BOOL, show_stackptr),
+	DS_CFG ("asm.strip", STR, strip),
+	DS_CFG ("asm.sub.jmp", BOOL, subjmp),
+	DS_CFG ("asm.sub.names", BOOL, subnames),
+	DS_CFG ("asm.sub.reg", BOOL, subreg),
+	DS_CFG ("asm.sub.rel", BOOL, subrel),
+	DS_CFG ("asm.sub.var", BOOL, subvar),
+	DS_CFG ("asm.sub.varmin", UT64, min_ref_addr),
+	DS_CFG ("asm.sub.varonly", BOOL, subvaronly),
+	DS_CFG ("asm.symbol", BOOL, show_symbols),
+	DS_CFG ("asm.symbol.col", INT, show_symbols_col),
+	DS_CFG ("asm.tabs", INT, atabs),
+	DS_CFG ("asm.tabs.off", INT, atabsoff),
+	DS_CFG ("asm.tabs.once", BOOL, atabsonce),
+	DS_CFG ("asm.trace", BOOL, show_trace),
+	DS_CFG ("asm.trace.color", BOOL, show_trace_color),
+	DS_CFG ("asm.trace.space", INT, tracespace),
+	DS_CFG ("asm.trace.stats", BOOL, show_trace_stats),
+	DS_CFG ("asm.types", INT, asm_types),
+	DS_CFG ("asm.ucase", INT, acase),
+	DS_CFG ("asm.var", BOOL, show_vars),
+	DS_CFG ("asm.var.access", BOOL, show_varaccess),
+	DS_CFG ("asm.var.summary", INT, show_varsum),
+	DS_CFG ("asm.xrefs", BOOL, show_xrefs),
+	DS_CFG ("asm.xrefs.code", BOOL, asm_xrefs_code),
+	DS_CFG ("asm.xrefs.fold", INT, foldxrefs),
+	DS_CFG ("asm.xrefs.max", INT, maxrefs),
+	DS_CFG ("bin.relocs", BOOL, showrelocs),
+	DS_CFG ("bin.str.enc", STR, strenc_str),
+	DS_CFG ("emu.bb", BOOL, show_emu_bb),
+	DS_CFG ("emu.pre", BOOL, pre_emu),
+	DS_CFG ("emu.ssa", BOOL, show_emu_ssa),
+	DS_CFG ("emu.stack", BOOL, show_emu_stack),
+	DS_CFG ("emu.str", BOOL, show_emu_str),
+	DS_CFG ("emu.str.flag", BOOL, show_emu_strflag),
+	DS_CFG ("emu.str.inv", BOOL, show_emu_strinv),
+	DS_CFG ("emu.str.lea", BOOL, show_emu_strlea),
+	DS_CFG ("emu.str.off", BOOL, show_emu_stroff),
+	DS_CFG ("emu.write", BOOL, show_emu_write),
+	DS_CFG ("scr.color", BOOL, show_color),
+	DS_CFG ("scr.color.args", BOOL, show_color_args),
+	DS_CFG ("scr.color.bytes", BOOL, show_color_bytes),
+	DS_CFG ("scr.color.ops", BOOL, colorop),
+	DS_CFG ("scr.utf8", INT, show_utf8),
+};
+#undef DS_CFG
+
 static RDisasmState *ds_init(RCore *core) {
 	RDisasmState *ds = R_NEW0 (RDisasmState);
 	if (!ds) {
@@ -641,8 +792,12 @@ static RDisasmState *ds_init(RCore *core) {
 	ds->ssa = sdb_new0 ();
 	ds->core = core;
 	ds->addrbytes = core->io->addrbytes;
-	ds->strip = r_config_get (core->config, "asm.strip");
-	ds->cmtoken = r_config_get (core->config, "asm.cmt.token");
+	if (!core->ds_snap) {
+		core->ds_snap = r_config_snap_new (core->config, ds_config, R_ARRAY_SIZE (ds_config));
+	}
+	if (core->ds_snap) {
+		r_config_snap_load (core->ds_snap, core->config, ds);
+	}
 	ds->pal_hint = core->cons->context->pal.jmp;
 	ds->pal_comment = core->cons->context->pal.comment;
 	#define P(x) (core->cons && core->cons->context->pal.x)? core->cons->context->pal.x
@@ -685,93 +840,16 @@ static RDisasmState *ds_init(RCore *core) {
 	ds->color_var_addr = P(var_addr): Color_CYAN;
 	ds->color_var_name = P(var_name): Color_RED;
 
-	ds->immstr = r_config_get_i (core->config, "asm.imm.str");
-	ds->immtrim = r_config_get_i (core->config, "asm.imm.trim");
-	ds->use_esil = r_config_get_i (core->config, "asm.esil");
-	ds->pre_emu = r_config_get_i (core->config, "emu.pre");
-	ds->show_flgoff = r_config_get_i (core->config, "asm.flags.offset");
-	ds->show_nodup = r_config_get_i (core->config, "asm.nodup");
-	const char *ah = r_config_get (core->config, "asm.highlight");
-	ds->asm_highlight = R_STR_ISNOTEMPTY (ah)? r_num_math (core->num, ah): UT64_MAX;
-	ds->asm_anal = r_config_get_i (core->config, "asm.anal");
-	ds->show_color = r_config_get_i (core->config, "scr.color");
-	ds->show_color_bytes = r_config_get_i (core->config, "scr.color.bytes");
-	ds->show_color_args = r_config_get_i (core->config, "scr.color.args");
-	ds->colorop = r_config_get_b (core->config, "scr.color.ops");
-	ds->show_utf8 = r_config_get_i (core->config, "scr.utf8");
-	ds->acase = r_config_get_b (core->config, "asm.ucase");
-	ds->capitalize = r_config_get_b (core->config, "asm.capitalize");
-	ds->atabs = r_config_get_i (core->config, "asm.tabs");
-	ds->atabsonce = r_config_get_b (core->config, "asm.tabs.once");
-	ds->atabsoff = r_config_get_i (core->config, "asm.tabs.off");
-	ds->midflags = r_config_get_i (core->config, "asm.flags.middle");
-	ds->asm_flags_right = r_config_get_i (core->config, "asm.flags.right");
-	ds->midbb = r_config_get_i (core->config, "asm.bbmiddle");
-	ds->midcursor = r_config_get_i (core->config, "asm.midcursor");
-	ds->decode = r_config_get_i (core->config, "asm.decode");
-	core->rasm->parse->pseudo = ds->pseudo = r_config_get_b (core->config, "asm.pseudo");
+	ds->asm_highlight = R_STR_ISNOTEMPTY (ds->highlight)? r_num_math (core->num, ds->highlight): UT64_MAX;
+	core->rasm->parse->pseudo = ds->pseudo;
 	if (ds->pseudo) {
 		ds->atabs = 0;
 	}
-	ds->subnames = r_config_get_b (core->config, "asm.sub.names");
 	ds->interactive = r_cons_is_interactive ();
-	ds->subjmp = r_config_get_b (core->config, "asm.sub.jmp");
-	ds->subvar = r_config_get_b (core->config, "asm.sub.var");
-	core->rasm->parse->subrel = r_config_get_b (core->config, "asm.sub.rel");
-	core->rasm->parse->subreg = r_config_get_b (core->config, "asm.sub.reg");
-	core->rasm->parse->localvar_only = r_config_get_b (core->config, "asm.sub.varonly");
+	core->rasm->parse->subrel = ds->subrel;
+	core->rasm->parse->subreg = ds->subreg;
+	core->rasm->parse->localvar_only = ds->subvaronly;
 	core->rasm->parse->retleave_asm = NULL;
-	ds->show_fcnsig = r_config_get_b (core->config, "asm.fcnsig");
-	ds->show_vars = r_config_get_b (core->config, "asm.var");
-	ds->cmt_wrap = r_config_get_b (core->config, "asm.cmt.wrap");
-	ds->show_varsum = r_config_get_i (core->config, "asm.var.summary");
-	ds->show_varaccess = r_config_get_i (core->config, "asm.var.access");
-	ds->maxrefs = r_config_get_i (core->config, "asm.xrefs.max");
-	ds->maxflags = r_config_get_i (core->config, "asm.flags.limit");
-	ds->flags_inline = r_config_get_i (core->config, "asm.flags.inline");
-	ds->asm_types = r_config_get_i (core->config, "asm.types");
-	ds->foldxrefs = r_config_get_i (core->config, "asm.xrefs.fold");
-	ds->show_lines = r_config_get_b (core->config, "asm.lines");
-	ds->show_lines_bb = ds->show_lines ? r_config_get_b (core->config, "asm.lines.jmp") : false;
-	ds->linesright = r_config_get_i (core->config, "asm.lines.right");
-	ds->show_indent = r_config_get_i (core->config, "asm.indent");
-	ds->indent_space = r_config_get_i (core->config, "asm.indentspace");
-	ds->tracespace = r_config_get_i (core->config, "asm.trace.space");
-	ds->cyclespace = r_config_get_i (core->config, "asm.cyclespace");
-	ds->show_dwarf = r_config_get_i (core->config, "asm.dwarf");
-	ds->dwarfFile = r_config_get_i (ds->core->config, "asm.dwarf.file");
-	ds->dwarfAbspath = r_config_get_i (ds->core->config, "asm.dwarf.abspath");
-	ds->show_lines_call = ds->show_lines ? r_config_get_i (core->config, "asm.lines.call") : false;
-	ds->show_lines_ret = ds->show_lines ? r_config_get_i (core->config, "asm.lines.ret") : false;
-	ds->show_size = r_config_get_i (core->config, "asm.size");
-	ds->show_trace = r_config_get_b (core->config, "asm.trace");
-	ds->show_trace_stats = r_config_get_b (core->config, "asm.trace.stats");
-	ds->show_trace_color = r_config_get_b (core->config, "asm.trace.color");
-	ds->linesout = r_config_get_i (core->config, "asm.lines.out");
-	ds->adistrick = r_config_get_i (core->config, "asm.middle"); // TODO: find better name
-	ds->asm_demangle = r_config_get_b (core->config, "asm.demangle");
-	ds->asm_describe = r_config_get_b (core->config, "asm.describe");
-	ds->show_offset = r_config_get_b (core->config, "asm.offset");
-	ds->show_offset_focus = r_config_get_b (core->config, "asm.offset.focus");
-	ds->show_offdec = r_config_get_i (core->config, "asm.offset.base10");
-	ds->show_bbline = r_config_get_i (core->config, "asm.lines.bb");
-	ds->show_section = r_config_get_i (core->config, "asm.section");
-	ds->show_section_col = r_config_get_i (core->config, "asm.section.col");
-	ds->show_section_perm = r_config_get_i (core->config, "asm.section.perm");
-	ds->show_section_name = r_config_get_i (core->config, "asm.section.name");
-	ds->show_symbols = r_config_get_i (core->config, "asm.symbol");
-	ds->show_symbols_col = r_config_get_i (core->config, "asm.symbol.col");
-	ds->asm_instr = r_config_get_i (core->config, "asm.instr");
-	ds->show_emu = r_config_get_b (core->config, "asm.emu");
-	ds->show_emu_bb = r_config_get_b (core->config, "emu.bb");
-	ds->show_emu_str = r_config_get_b (core->config, "emu.str");
-	ds->show_emu_stroff = r_config_get_b (core->config, "emu.str.off");
-	ds->show_emu_strinv = r_config_get_b (core->config, "emu.str.inv");
-	ds->show_emu_strflag = r_config_get_b (core->config, "emu.str.flag");
-	ds->show_emu_strlea = r_config_get_b (core->config, "emu.str.lea");
-	ds->show_emu_write = r_config_get_b (core->config, "emu.write");
-	ds->show_emu_ssa = r_config_get_b (core->config, "emu.ssa");
-	ds->show_emu_stack = r_config_get_b (core->config, "emu.stack");
 	ds->stackFd = -1;
 	if (ds->show_emu_stack) {
 		// TODO: initialize fake stack in here
@@ -791,19 +869,8 @@ static RDisasmState *ds_init(RCore *core) {
 		}
 	}
 	ds->stackptr = core->anal->stackptr;
-	ds->show_offseg = r_config_get_b (core->config, "asm.offset.segment");
-	ds->show_flags = r_config_get_b (core->config, "asm.flags");
-	ds->show_bytes = r_config_get_b (core->config, "asm.bytes");
-	ds->show_bytes_ascii = r_config_get_b (core->config, "asm.bytes.ascii");
-	ds->show_bytes_asbits = r_config_get_i (core->config, "asm.bytes.asbits");
-	ds->show_bytes_align = r_config_get_i (core->config, "asm.bytes.align");
-	ds->show_bytes_right = r_config_get_i (core->config, "asm.bytes.right");
-	ds->show_bytes_opcolor = r_config_get_i (core->config, "asm.bytes.opcolor");
-	ds->show_optype = r_config_get_i (core->config, "asm.optype");
-	ds->asm_meta = r_config_get_i (core->config, "asm.meta");
-	ds->asm_xrefs_code = r_config_get_i (core->config, "asm.xrefs.code");
 	{
-		const char *relto = r_config_get (core->config, "asm.offset.relto");
+		const char *relto = ds->relto? ds->relto: "";
 		ds->show_reloff_to = 0;
 		ds->show_reloff_to |= strstr (relto, "fu")? RELOFF_TO_FUNC: 0;
 		ds->show_reloff_to |= strstr (relto, "fl")? RELOFF_TO_FLAG: 0;
@@ -816,40 +883,17 @@ static RDisasmState *ds_init(RCore *core) {
 		ds->show_reloff_to |= strstr (relto, "li")? RELOFF_TO_LIBS: 0;
 	}
 	ds->show_reloff = ds->show_reloff_to != 0; // r_config_get_i (core->config, "asm.offset.rel");
-	ds->show_lines_fcn = ds->show_lines ? r_config_get_i (core->config, "asm.lines.fcn") : false;
-	ds->show_comments = r_config_get_b (core->config, "asm.comments");
-	ds->show_cmt_user = r_config_get_b (core->config, "asm.cmt.user");
-	ds->asm_hint_jmp = r_config_get_i (core->config, "asm.hint.jmp");
-	ds->asm_hint_call = r_config_get_i (core->config, "asm.hint.call");
-	ds->asm_hint_call_indirect = r_config_get_i (core->config, "asm.hint.call.indirect");
-	ds->asm_hint_lea = r_config_get_i (core->config, "asm.hint.lea");
-	ds->asm_hint_imm = r_config_get_i (core->config, "asm.hint.imm");
-	ds->asm_hint_emu = r_config_get_i (core->config, "asm.hint.emu");
-	ds->asm_hint_cdiv = r_config_get_i (core->config, "asm.hint.cdiv");
-	ds->asm_hint_pos = r_config_get_i (core->config, "asm.hint.pos");
-	ds->asm_hints = r_config_get_i (core->config, "asm.hints"); // only for cdiv wtf
-	ds->show_slow = r_config_get_i (core->config, "asm.slow");
-	ds->show_refptr = r_config_get_i (core->config, "asm.refptr");
-	ds->show_calls = r_config_get_i (core->config, "asm.cmt.calls");
-	ds->show_family = r_config_get_i (core->config, "asm.family");
-	ds->cmtcol = r_config_get_i (core->config, "asm.cmt.col");
-	ds->show_cmt_esil = r_config_get_b (core->config, "asm.cmt.esil");
-	ds->show_cmt_pseudo = r_config_get_b (core->config, "asm.cmt.pseudo");
-	ds->show_cmt_flgrefs = r_config_get_b (core->config, "asm.cmt.flgrefs");
-	ds->show_cycles = r_config_get_i (core->config, "asm.cycles");
-	ds->show_stackptr = r_config_get_i (core->config, "asm.stackptr");
-	ds->show_xrefs = r_config_get_b (core->config, "asm.xrefs");
-	ds->show_anos = r_config_get_b (core->config, "asm.anos");
-	ds->show_cmtrefs = r_config_get_i (core->config, "asm.cmt.refs");
-	ds->cmtfold = r_config_get_i (core->config, "asm.cmt.fold");
-	ds->show_cmtoff = r_config_get (core->config, "asm.cmt.off");
+	if (!ds->show_lines) {
+		ds->show_lines_bb = false;
+		ds->show_lines_call = false;
+		ds->show_lines_ret = false;
+		ds->show_lines_fcn = false;
+	}
 	if (!ds->show_cmtoff) {
 		ds->show_cmtoff = "nodup";
 	}
-	ds->show_functions = r_config_get_b (core->config, "asm.functions");
-	ds->nbytes = r_config_get_i (core->config, "asm.nbytes");
 	ds->show_asciidot = !strcmp (core->print->strconv_mode, "asciidot");
-	const char *strenc_str = r_config_get (core->config, "bin.str.enc");
+	const char *strenc_str = ds->strenc_str;
 	if (!strenc_str) {
 		ds->strenc = R_STRING_ENC_GUESS;
 	} else if (!strcmp (strenc_str, "latin1")) {
@@ -867,19 +911,12 @@ static RDisasmState *ds_init(RCore *core) {
 	} else {
 		ds->strenc = R_STRING_ENC_GUESS;
 	}
-	core->print->bytespace = r_config_get_i (core->config, "asm.bytes.space");
+	core->print->bytespace = ds->bytespace;
 	ds->cursor = 0;
 	ds->nb = 0;
 	ds->flagspace_ports = r_flag_space_get (core->flags, "ports");
-	ds->lbytes = r_config_get_i (core->config, "asm.lbytes");
-	ds->show_cmt_right_default = r_config_get_b (core->config, "asm.cmt.right");
 	ds->show_cmt_right = ds->show_cmt_right_default;
-	ds->show_flag_in_bytes = r_config_get_i (core->config, "asm.flags.inbytes");
-	ds->show_flag_in_offset = r_config_get_i (core->config, "asm.flags.inoffset");
-	ds->show_marks = r_config_get_i (core->config, "asm.marks");
-	ds->show_noisy_comments = r_config_get_i (core->config, "asm.noisy");
 	ds->pre = DS_PRE_NONE;
-	ds->flags_prefix = r_config_get_b (ds->core->config, "asm.flags.prefix");
 	ds->ocomment = NULL;
 	ds->linesopts = 0;
 	ds->lastfail = 0;
@@ -892,14 +929,11 @@ static RDisasmState *ds_init(RCore *core) {
 	ds->esil_regstate = NULL;
 	ds->esil_likely = false;
 
-	ds->showpayloads = r_config_get_i (ds->core->config, "asm.payloads");
-	ds->showrelocs = r_config_get_i (core->config, "bin.relocs");
-	ds->min_ref_addr = r_config_get_i (core->config, "asm.sub.varmin");
 
 	if (ds->show_flag_in_bytes) {
 		ds->show_flags = false;
 	}
-	if (r_config_get_i (core->config, "asm.lines.wide")) {
+	if (ds->show_lines_wide) {
 		ds->linesopts |= R_ANAL_REFLINE_TYPE_WIDE;
 	}
 	if (core->cons->vline) {
@@ -934,7 +968,7 @@ static RDisasmState *ds_init(RCore *core) {
 	} else {
 		ds->cursor = -1;
 	}
-	if (r_config_get_i (core->config, "asm.lines.wide")) {
+	if (ds->show_lines_wide) {
 		ds->linesopts |= R_ANAL_REFLINE_TYPE_WIDE;
 	}
 	if (core->cons->vline) {
@@ -6617,7 +6651,7 @@ toro:
 			if (fmt) {
 				r_cons_printf ("(%s)\n", link_type);
 				r_core_cmdf (core, "pf %s @ 0x%08" PFMT64x, fmt, ds->addr + ds->index);
-				const ut32 type_bitsize = r_type_get_bitsize (core->anal->sdb_types, link_type);
+				const ut32 type_bitsize = r_anal_typedb_bitsize (core->anal->typedb, link_type);
 				// always round up when calculating byte_size from bit_size of types
 				// could be struct with a bitfield entry
 				inc = (type_bitsize >> 3) + (!!(type_bitsize & 0x7));
@@ -0,0 +1,409 @@
+/* radare - LGPL - Copyright 2024 - pancake */
+
+#include <r_core.h>
+
+// Gadget database used by /R. Every map is swept once for the gadgets that
+// disassemble correctly, without applying the grep, so the later searches
+// only filter the stored results. The instruction sequences are shared by
+// all the maps, a gadget that appears in several places is kept only once.
+// The maps can be saved to disk, keyed by a hash of their contents.
+
+#define ROPDB_MAGIC "R2RG"
+#define ROPDB_VERSION 1
+#define ROPDB_HITSIZE 28
+// the classes are cheap to compute again, don't let them grow forever
+#define ROPDB_MAXCLASSES 0x10000
+
+static void gadget_free(RCoreRopGadget *g) {
+	if (g) {
+		ut32 i;
+		for (i = 0; i < g->ninstr; i++) {
+			free (g->opstr[i]);
+		}
+		free (g->opstr);
+		free (g->sizes);
+		free (g->bytes);
+		free (g);
+	}
+}
+
+static void map_free(RCoreRopMap *m) {
+	if (m) {
+		r_vector_fini (&m->hits);
+		free (m);
+	}
+}
+
+static void maps_kv_free(HtPPKv *kv) {
+	if (kv) {
+		free (kv->key);
+		map_free (kv->value);
+	}
+}
+
+static void class_free(RCoreRopClass *c) {
+	if (c) {
+		free (c->mov);
+		free (c->constant);
+		free (c->arithm);
+		free (c->arithm_ct);
+		free (c);
+	}
+}
+
+static void classes_kv_free(HtPPKv *kv) {
+	if (kv) {
+		free (kv->key);
+		class_free (kv->value);
+	}
+}
+
+R_API RCoreRopDB *r_core_ropdb_new(void) {
+	RCoreRopDB *db = R_NEW0 (RCoreRopDB);
+	if (!db) {
+		return NULL;
+	}
+	r_pvector_init (&db->gadgets, (RPVectorFree)gadget_free);
+	db->dedup = ht_pu_new0 ();
+	db->maps = ht_pp_new (NULL, maps_kv_free, NULL);
+	db->classes = ht_pp_new (NULL, classes_kv_free, NULL);
+	if (!db->dedup || !db->maps || !db->classes) {
+		r_core_ropdb_free (db);
+		return NULL;
+	}
+	return db;
+}
+
+R_API void r_core_ropdb_free(RCoreRopDB *db) {
+	if (db) {
+		ht_pp_free (db->classes);
+		ht_pp_free (db->maps);
+		ht_pu_free (db->dedup);
+		r_pvector_fini (&db->gadgets);
+		free (db);
+	}
+}
+
+// the same bytes can disassemble differently at another address (relative
+// branches), so the mnemonics are part of the identity of the gadget too
+static char *gadget_key(const ut8 *bytes, const int *sizes, char **opstr, ut32 ninstr) {
+	RStrBuf *sb = r_strbuf_new ("");
+	ut32 i;
+	int j, off = 0;
+	for (i = 0; i < ninstr; i++) {
+		for (j = 0; j < sizes[i]; j++) {
+			r_strbuf_appendf (sb, "%02x", bytes[off + j]);
+		}
+		off += sizes[i];
+		r_strbuf_appendf (sb, " %s\n", opstr[i]);
+	}
+	return r_strbuf_drain (sb);
+}
+
+static void strings_free(char **opstr, ut32 n) {
+	ut32 i;
+	for (i = 0; opstr && i < n; i++) {
+		free (opstr[i]);
+	}
+	free (opstr);
+}
+
+/* Returns the index of the gadget with these instructions, adding it when it's
+ * new. The sizes, the opstr array and its strings are taken in both cases */
+R_API ut32 r_core_ropdb_add_gadget(RCoreRopDB *db, const ut8 *bytes, int *sizes, char **opstr, ut32 ninstr) {
+	R_RETURN_VAL_IF_FAIL (db && bytes && sizes && opstr && ninstr > 0, UT32_MAX);
+	char *key = gadget_key (bytes, sizes, opstr, ninstr);
+	bool found = false;
+	ut64 idx = key? ht_pu_find (db->dedup, key, &found): 0;
+	if (found) {
+		free (key);
+		strings_free (opstr, ninstr);
+		free (sizes);
+		return (ut32)idx;
+	}
+	RCoreRopGadget *g = R_NEW0 (RCoreRopGadget);
+	if (!key || !g) {
+		free (key);
+		free (g);
+		strings_free (opstr, ninstr);
+		free (sizes);
+		return UT32_MAX;
+	}
+	g->ninstr = ninstr;
+	g->sizes = sizes;
+	g->opstr = opstr;
+	ut32 i;
+	for (i = 0; i < ninstr; i++) {
+		g->size += sizes[i];
+	}
+	g->bytes = r_mem_dup (bytes, g->size);
+	idx = r_pvector_length (&db->gadgets);
+	if (!g->bytes || !r_pvector_push (&db->gadgets, g)) {
+		gadget_free (g);
+		free (key);
+		return UT32_MAX;
+	}
+	ht_pu_insert (db->dedup, key, idx);
+	free (key);
+	return (ut32)idx;
+}
+
+R_API RCoreRopGadget *r_core_ropdb_gadget(RCoreRopDB *db, ut32 idx) {
+	R_RETURN_VAL_IF_FAIL (db, NULL);
+	if (idx >= r_pvector_length (&db->gadgets)) {
+		return NULL;
+	}
+	return r_pvector_at (&db->gadgets, idx);
+}
+
+R_API RCoreRopMap *r_core_ropdb_map_get(RCoreRopDB *db, const char *key) {
+	R_RETURN_VAL_IF_FAIL (db && key, NULL);
+	return ht_pp_find (db->maps, key, NULL);
+}
+
+// replaces the map stored with the same key, if any
+R_API RCoreRopMap *r_core_ropdb_map_add(RCoreRopDB *db, const char *key, ut64 addr, ut64 size) {
+	R_RETURN_VAL_IF_FAIL (db && key, NULL);
+	RCoreRopMap *m = R_NEW0 (RCoreRopMap);
+	if (!m) {
+		return NULL;
+	}
+	m->addr = addr;
+	m->size = size;
+	r_vector_init (&m->hits, sizeof (RCoreRopHit), NULL, NULL);
+	char *k = strdup (key);
+	if (!k) {
+		map_free (m);
+		return NULL;
+	}
+	ht_pp_delete (db->maps, key);
+	if (!ht_pp_insert (db->maps, k, m)) {
+		free (k);
+		map_free (m);
+		return NULL;
+	}
+	return m;
+}
+
+R_API void r_core_ropdb_map_del(RCoreRopDB *db, const char *key) {
+	R_RETURN_IF_FAIL (db && key);
+	ht_pp_delete (db->maps, key);
+}
+
+R_API const RCoreRopClass *r_core_ropdb_class_get(RCoreRopDB *db, const char *key) {
+	R_RETURN_VAL_IF_FAIL (db && key, NULL);
+	return ht_pp_find (db->classes, key, NULL);
+}
+
+// the class and its strings are owned by the database after this call
+R_API bool r_core_ropdb_class_add(RCoreRopDB *db, const char *key, RCoreRopClass *c) {
+	R_RETURN_VAL_IF_FAIL (db && key && c, false);
+	if (db->nclasses >= ROPDB_MAXCLASSES) {
+		HtPP *classes = ht_pp_new (NULL, classes_kv_free, NULL);
+		if (classes) {
+			ht_pp_free (db->classes);
+			db->classes = classes;
+			db->nclasses = 0;
+		}
+	}
+	char *k = strdup (key);
+	if (!k || !ht_pp_insert (db->classes, k, c)) {
+		free (k);
+		class_free (c);
+		return false;
+	}
+	db->nclasses++;
+	return true;
+}
+
+/* File layout, all little endian:
+ *   magic[4] version:32 keylen:32 key ngadgets:32 nhits:32
+ *   gadget: ninstr:32 size:32 bytes { size:16 len:16 mnemonic }...
+ *   hit: addr:64 end:64 gadget:32 section:32 delay:32
+ * Gadget indexes are local to the file */
+R_API bool r_core_ropdb_save(RCoreRopDB *db, const char *key, const char *file) {
+	R_RETURN_VAL_IF_FAIL (db && key && file, false);
+	RCoreRopMap *m = r_core_ropdb_map_get (db, key);
+	if (!m) {
+		return false;
+	}
+	HtUU *local = ht_uu_new0 ();
+	RVector order;
+	r_vector_init (&order, sizeof (ut32), NULL, NULL);
+	RCoreRopHit *hit;
+	r_vector_foreach (&m->hits, hit) {
+		bool found = false;
+		ht_uu_find (local, hit->gadget, &found);
+		if (!found) {
+			ht_uu_insert (local, hit->gadget, r_vector_length (&order));
+			r_vector_push (&order, &hit->gadget);
+		}
+	}
+	RBuffer *b = r_buf_new ();
+	ut8 tmp[8];
+	const ut32 keylen = strlen (key);
+	r_buf_append_bytes (b, (const ut8 *)ROPDB_MAGIC, 4);
+	r_write_le32 (tmp, ROPDB_VERSION);
+	r_buf_append_bytes (b, tmp, 4);
+	r_write_le32 (tmp, keylen);
+	r_buf_append_bytes (b, tmp, 4);
+	r_buf_append_bytes (b, (const ut8 *)key, keylen);
+	r_write_le32 (tmp, r_vector_length (&order));
+	r_buf_append_bytes (b, tmp, 4);
+	r_write_le32 (tmp, r_vector_length (&m->hits));
+	r_buf_append_bytes (b, tmp, 4);
+	ut32 *gi;
+	r_vector_foreach (&order, gi) {
+		RCoreRopGadget *g = r_pvector_at (&db->gadgets, *gi);
+		r_write_le32 (tmp, g->ninstr);
+		r_write_le32 (tmp + 4, g->size);
+		r_buf_append_bytes (b, tmp, 8);
+		r_buf_append_bytes (b, g->bytes, g->size);
+		ut32 i;
+		for (i = 0; i < g->ninstr; i++) {
+			const ut16 len = R_MIN (strlen (g->opstr[i]), UT16_MAX);
+			r_write_le16 (tmp, g->sizes[i]);
+			r_write_le16 (tmp + 2, len);
+			r_buf_append_bytes (b, tmp, 4);
+			r_buf_append_bytes (b, (const ut8 *)g->opstr[i], len);
+		}
+	}
+	r_vector_foreach (&m->hits, hit) {
+		r_write_le64 (tmp, hit->addr);
+		r_buf_append_bytes (b, tmp, 8);
+		r_write_le64 (tmp, hit->end);
+		r_buf_append_bytes (b, tmp, 8);
+		r_write_le32 (tmp, ht_uu_find (local, hit->gadget, NULL));
+		r_write_le32 (tmp + 4, hit->section);
+		r_buf_append_bytes (b, tmp, 8);
+		r_write_le32 (tmp, hit->delay);
+		r_buf_append_bytes (b, tmp, 4);
+	}
+	ut64 size = 0;
+	const ut8 *data = r_buf_data (b, &size);
+	bool res = size < ST32_MAX && r_file_dump (file, data, (int)size, false);
+	r_buf_free (b);
+	r_vector_fini (&order);
+	ht_uu_free (local);
+	return res;
+}
+
+typedef struct {
+	const ut8 *data;
+	size_t size;
+	size_t off;
+} RopReader;
+
+static bool rd(RopReader *r, size_t n) {
+	return r->off + n <= r->size && r->off + n >= r->off;
+}
+
+static ut32 rd32(RopReader *r) {
+	ut32 v = r_read_le32 (r->data + r->off);
+	r->off += 4;
+	return v;
+}
+
+static bool load_gadgets(RCoreRopDB *db, RopReader *r, ut32 *ids, ut32 ngadgets) {
+	ut32 n;
+	for (n = 0; n < ngadgets; n++) {
+		if (!rd (r, 8)) {
+			return false;
+		}
+		const ut32 ninstr = rd32 (r);
+		const ut32 size = rd32 (r);
+		// each instruction takes at least 4 bytes in the file
+		if (!ninstr || !rd (r, size) || ninstr > (r->size - r->off - size) / 4) {
+			return false;
+		}
+		const ut8 *bytes = r->data + r->off;
+		r->off += size;
+		int total = 0;
+		int *sizes = R_NEWS0 (int, ninstr);
+		char **opstr = R_NEWS0 (char *, ninstr);
+		ut32 i;
+		bool ok = sizes && opstr;
+		for (i = 0; ok && i < ninstr; i++) {
+			ok = false;
+			if (rd (r, 4)) {
+				sizes[i] = r_read_le16 (r->data + r->off);
+				total += sizes[i];
+				const ut16 len = r_read_le16 (r->data + r->off + 2);
+				r->off += 4;
+				if (rd (r, len)) {
+					opstr[i] = r_str_ndup ((const char *)r->data + r->off, len);
+					r->off += len;
+					ok = opstr[i] != NULL;
+				}
+			}
+		}
+		if (!ok || (ut32)total != size) {
+			strings_free (opstr, ninstr);
+			free (sizes);
+			return false;
+		}
+		ids[n] = r_core_ropdb_add_gadget (db, bytes, sizes, opstr, ninstr);
+		if (ids[n] == UT32_MAX) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Load the map saved with this key. Returns NULL when the file doesn't exist
+ * or it was written for something else */
+R_API RCoreRopMap *r_core_ropdb_load(RCoreRopDB *db, const char *key, const char *file, ut64 addr, ut64 size) {
+	R_RETURN_VAL_IF_FAIL (db && key && file, NULL);
+	size_t fsize = 0;
+	ut8 *data = (ut8 *)r_file_slurp (file, &fsize);
+	if (!data) {
+		return NULL;
+	}
+	RopReader r = { data, fsize, 0 };
+	const ut32 keylen = strlen (key);
+	if (!rd (&r, 12) || memcmp (data, ROPDB_MAGIC, 4)
+			|| r_read_le32 (data + 4) != ROPDB_VERSION
+			|| r_read_le32 (data + 8) != keylen) {
+		free (data);
+		return NULL;
+	}
+	r.off = 12;
+	if (!rd (&r, keylen + 8) || memcmp (data + r.off, key, keylen)) {
+		free (data);
+		return NULL;
+	}
+	r.off += keylen;
+	const ut32 ngadgets = rd32 (&r);
+	const ut32 nhits = rd32 (&r);
+	// every gadget takes at least 8 bytes in the file
+	ut32 *ids = (ngadgets <= (fsize - r.off) / 8)? R_NEWS0 (ut32, R_MAX (ngadgets, 1)): NULL;
+	RCoreRopMap *m = NULL;
+	if (ids && load_gadgets (db, &r, ids, ngadgets) && nhits <= (fsize - r.off) / ROPDB_HITSIZE) {
+		m = r_core_ropdb_map_add (db, key, addr, size);
+	}
+	if (m) {
+		r_vector_reserve (&m->hits, nhits);
+		ut32 i;
+		for (i = 0; i < nhits; i++) {
+			const ut8 *p = data + r.off + (i * ROPDB_HITSIZE);
+			const ut32 local = r_read_le32 (p + 16);
+			if (local >= ngadgets) {
+				R_LOG_WARN ("Corrupted rop cache %s", file);
+				r_core_ropdb_map_del (db, key);
+				m = NULL;
+				break;
+			}
+			RCoreRopHit hit = {
+				.addr = r_read_le64 (p),
+				.end = r_read_le64 (p + 8),
+				.gadget = ids[local],
+				.section = r_read_le32 (p + 20),
+				.delay = r_read_le32 (p + 24),
+			};
+			r_vector_push (&m->hits, &hit);
+		}
+	}
+	free (ids);
+	free (data);
+	return m;
+}
@@ -479,7 +479,12 @@ static RThreadFunctionRet task_run_thread(RThread *th) {
 		return 0;
 	}
 	RCoreTask *task = (RCoreTask *)th->user;
-	return task_run (task);
+	RCore *core = task->core;
+	RThreadFunctionRet ret = task_run (task);
+	// the decoder contexts of this thread would stay in the sessions forever
+	r_arch_session_decoder_release (R_UNWRAP4 (core, anal, arch, session));
+	r_arch_session_decoder_release (R_UNWRAP4 (core, rasm, arch, session));
+	return ret;
 }
 
 R_API void r_core_task_enqueue(RCoreTaskScheduler *scheduler, RCoreTask *task) {
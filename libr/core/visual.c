@@ -208,6 +208,12 @@ static const char *stackPrintCommand(RCore *core) {
 	return printHexFormats[core->visual.current0format % PRINT_HEX_FORMATS];
 }
 
+// the current tab runs a user defined command
+static bool visual_tab_command(RCore *core) {
+	RCoreVisualTab *tab = core->visual.tabs? r_list_get_n (core->visual.tabs, core->visual.tab): NULL;
+	return tab && tab->name[0] == ':';
+}
+
 static const char *__core_visual_print_command(RCore *core) {
 	if (core->visual.tabs) {
 		RCoreVisualTab *tab = r_list_get_n (core->visual.tabs, core->visual.tab);
@@ -2838,6 +2844,113 @@ static void handle_space_key(RCore *core, int force) {
 	}
 }
 
+// Output of the print command for a view, with the state it leaves behind
+typedef struct {
+	char *key;
+	char *out;
+	ut64 value; // $? is used as the visual blocksize
+	ut64 screen_bounds;
+	int cur;
+	ut64 *asmqjmps;
+	int asmqjmps_count;
+} VisualView;
+
+static void visual_view_free(VisualView *v) {
+	if (v) {
+		free (v->key);
+		free (v->out);
+		free (v->asmqjmps);
+		free (v);
+	}
+}
+
+static void visual_views_reset(RCore *core) {
+	if (core->visual.views) {
+		r_list_purge (core->visual.views);
+	}
+}
+
+// bumped by any change in the config, analysis, flags, writes or maps
+static ut64 visual_views_gen(RCore *core) {
+	return (ut64)core->config->gen + R_DIRTY_GEN (core->anal) + R_DIRTY_GEN (core->flags)
+		+ R_DIRTY_GEN (core->io) + core->io->mts;
+}
+
+static void visual_view_restore(RCore *core, VisualView *v) {
+	core->num->value = v->value;
+	core->print->screen_bounds = v->screen_bounds;
+	core->print->cur = v->cur;
+	if (core->asmqjmps && v->asmqjmps && v->asmqjmps_count < core->asmqjmps_size) {
+		memcpy (core->asmqjmps, v->asmqjmps, (v->asmqjmps_count + 1) * sizeof (ut64));
+		core->asmqjmps_count = v->asmqjmps_count;
+	}
+}
+
+static void visual_view_save(RCore *core, VisualView *v) {
+	v->value = core->num->value;
+	v->screen_bounds = core->print->screen_bounds;
+	v->cur = core->print->cur;
+	if (core->asmqjmps && core->asmqjmps_count < core->asmqjmps_size) {
+		v->asmqjmps_count = core->asmqjmps_count;
+		v->asmqjmps = r_mem_dup (core->asmqjmps, (v->asmqjmps_count + 1) * sizeof (ut64));
+	}
+}
+
+/* Runs the print command of the view, or reuses its output when the same
+ * view was rendered recently. Views are keyed by the command, the seek, the
+ * cursor and the screen size, and they're all dropped when something else
+ * changes or a key other than the movement ones is pressed */
+static char *visual_view(RCore *core, const char *cmd, bool cacheable) {
+	const int max = r_config_get_i (core->config, "scr.vcache");
+	if (!cacheable || max < 1) {
+		visual_views_reset (core);
+		return r_core_cmd_str (core, cmd);
+	}
+	if (!core->visual.views) {
+		core->visual.views = r_list_newf ((RListFree)visual_view_free);
+		if (!core->visual.views) {
+			return r_core_cmd_str (core, cmd);
+		}
+	}
+	RList *views = core->visual.views;
+	if (visual_views_gen (core) != core->visual.viewgen) {
+		r_list_purge (views);
+	}
+	RPrint *p = core->print;
+	int rows, cols = r_cons_get_size (&rows);
+	char *key = r_str_newf ("%s;0x%"PFMT64x";%d;%d;%d;%d;%d;%d", cmd, core->offset,
+		p->cur_enabled, p->cur, p->ocur, core->blocksize, cols, rows);
+	RListIter *iter;
+	VisualView *v;
+	r_list_foreach (views, iter, v) {
+		if (!strcmp (v->key, key)) {
+			free (key);
+			r_list_split_iter (views, iter);
+			free (iter);
+			r_list_prepend (views, v);
+			visual_view_restore (core, v);
+			return strdup (v->out);
+		}
+	}
+	char *out = r_core_cmd_str (core, cmd);
+	v = R_NEW0 (VisualView);
+	if (v && out) {
+		v->key = key;
+		v->out = strdup (out);
+		visual_view_save (core, v);
+		r_list_prepend (views, v);
+		while (r_list_length (views) > max) {
+			visual_view_free (r_list_pop (views));
+		}
+	} else {
+		free (key);
+		free (v);
+	}
+	// the print command may change and restore some vars
+	core->visual.viewgen = visual_views_gen (core);
+	return out;
+}
+
 R_API int r_core_visual_cmd(RCore *core, const char *arg) {
 	ut8 och = arg[0];
 	ut64 offset = core->offset;
@@ -2859,6 +2972,11 @@ R_API int r_core_visual_cmd(RCore *core, const char *arg) {
 			return 1;
 		}
 	}
+	if (ch < 1 || !strchr ("hjklHJKL", ch)) {
+		// the key may prompt, print or change what's shown
+		visual_views_reset (core);
+		r_cons_visual_invalidate ();
+	}
 	if (core->visual.imes) {
 		// TODO: support arrow keys to move around without losing insert mode
 		// TODO: implement append mode
@@ -4298,37 +4416,28 @@ static void visual_title(RCore *core, int color) {
 	}
 }
 
+// only set the vars that change, every set invalidates the cached views
+static void responsive_set(RCore *core, const char *name, int v) {
+	if (r_config_get_i (core->config, name) != v) {
+		r_config_set_i (core->config, name, v);
+	}
+}
+
 static int visual_responsive(RCore *core) {
 	int h, w = r_cons_get_size (&h);
 	if (r_config_get_i (core->config, "scr.responsive")) {
-		if (w < 110) {
-			r_config_set_i (core->config, "asm.cmt.right", 0);
-		} else {
-			r_config_set_i (core->config, "asm.cmt.right", 1);
-		}
-		if (w < 68) {
-			r_config_set_i (core->config, "hex.cols", (int)(w / 5.2));
-		} else {
-			r_config_set_i (core->config, "hex.cols", 16);
-		}
-		if (w < 25) {
-			r_config_set_i (core->config, "asm.offset", 0);
-		} else {
-			r_config_set_i (core->config, "asm.offset", 1);
-		}
+		responsive_set (core, "asm.cmt.right", w >= 110);
+		responsive_set (core, "hex.cols", (w < 68)? (int)(w / 5.2): 16);
+		responsive_set (core, "asm.offset", w >= 25);
 		if (w > 80) {
-			r_config_set_i (core->config, "asm.lines.width", 14);
-			r_config_set_i (core->config, "asm.lines.width", w - (int)(w / 1.2));
-			r_config_set_i (core->config, "asm.cmt.col", w - (int)(w / 2.5));
-		} else {
-			r_config_set_i (core->config, "asm.lines.width", 7);
+			responsive_set (core, "asm.cmt.col", w - (int)(w / 2.5));
 		}
 		if (w < 70) {
-			r_config_set_i (core->config, "asm.lines.width", 1);
-			r_config_set_i (core->config, "asm.bytes", 0);
+			responsive_set (core, "asm.lines.width", 1);
 		} else {
-			r_config_set_i (core->config, "asm.bytes", 1);
+			responsive_set (core, "asm.lines.width", (w > 80)? w - (int)(w / 1.2): 7);
 		}
+		responsive_set (core, "asm.bytes", w >= 70);
 	}
 	return w;
 }
@@ -4487,12 +4596,15 @@ R_IPI void visual_refresh(RCore *core) {
 	core->cons->blankline = true;
 	int notch = r_config_get_i (core->config, "scr.notch");
 	int w = visual_responsive (core);
-	if (core->visual.autoblocksize) {
-		r_cons_gotoxy (0, 0);
-	} else {
-		r_cons_clear ();
+	const bool damage = r_config_get_b (core->config, "scr.damage");
+	if (!damage) {
+		if (core->visual.autoblocksize) {
+			r_cons_gotoxy (0, 0);
+		} else {
+			r_cons_clear ();
+		}
+		r_cons_flush ();
 	}
-	r_cons_flush ();
 	r_cons_print_clear ();
 	r_cons_print (core->cons->context->pal.bgprompt);
 	core->cons->context->noflush = true;
@@ -4575,7 +4687,11 @@ R_IPI void visual_refresh(RCore *core) {
 		}
 	}
 	if (R_STR_ISNOTEMPTY (cmd_str)) {
-		char *res = r_core_cmd_str (core, cmd_str);
+		// user defined commands and the debugger may show something else every time
+		const bool cacheable = !vsplit && R_STR_ISEMPTY (vcmd) && !core->visual.splitView
+			&& !core->visual.zoom && !r_config_get_b (core->config, "cfg.debug")
+			&& !visual_tab_command (core);
+		char *res = visual_view (core, cmd_str, cacheable);
 		if (vsplit) {
 			res = r_str_ansi_crop (res, 0, 0, split_w, -1);
 		}
@@ -4599,7 +4715,9 @@ R_IPI void visual_refresh(RCore *core) {
 
 	/* this is why there's flickering */
 	if (core->print->vflush) {
+		core->cons->damage = damage;
 		r_cons_visual_flush ();
+		core->cons->damage = false;
 	} else {
 		r_cons_reset ();
 	}
@@ -5010,6 +5128,8 @@ dodo:
 	r_cons_singleton ()->teefile = teefile;
 	r_cons_set_cup (false);
 	r_cons_clear00 ();
+	visual_views_reset (core);
+	r_cons_visual_invalidate ();
 	core->vmode = false;
 	core->cons->event_resize = NULL;
 	core->cons->event_data = NULL;
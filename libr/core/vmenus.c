@@ -2678,12 +2678,11 @@ static void config_visual_hit(RCore *core, const char *name, int editor) {
 	if (r_config_node_is_bool (node)) {
 		r_config_set_i (core->config, name, node->i_value? 0:1);
 	} else {
-// XXX: must use config_set () to run callbacks!
 		if (editor) {
 			char *buf = r_core_editor (core, NULL, node->value);
 			if (buf) {
-				free (node->value);
-				node->value = buf;
+				r_config_set (core->config, name, buf);
+				free (buf);
 			}
 		} else {
 			// FGETS AND SO
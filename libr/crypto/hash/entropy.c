@@ -7,17 +7,51 @@
 
 #include <stdlib.h>
 #include <math.h>
-#include "r_types.h"
+#include <r_hash.h>
+#include <r_util.h>
 
-R_API double r_hash_entropy(const ut8 *data, ut64 size) {
-	if (!data || !size) {
-		return 0;
+// bytes counted in the 32bit tables before folding them into the result
+#define HIST_CHUNK (1ULL << 30)
+
+static void histogram_chunk(const ut8 *data, ut64 size, ut64 *count) {
+	// four tables, so runs of the same byte don't keep incrementing the same
+	// counter and stall waiting for the previous store to complete
+	ut32 c[4][256] = {{0}};
+	ut64 i = 0;
+	for (; i + 8 <= size; i += 8) {
+		ut64 w;
+		memcpy (&w, data + i, sizeof (w));
+		c[0][w & 0xff]++;
+		c[1][(w >> 8) & 0xff]++;
+		c[2][(w >> 16) & 0xff]++;
+		c[3][(w >> 24) & 0xff]++;
+		c[0][(w >> 32) & 0xff]++;
+		c[1][(w >> 40) & 0xff]++;
+		c[2][(w >> 48) & 0xff]++;
+		c[3][w >> 56]++;
 	}
-	ut64 i, count[256] = {0};
-	double h = 0;
-	for (i = 0; i < size; i++) {
-		count[data[i]]++;
+	for (; i < size; i++) {
+		c[0][data[i]]++;
+	}
+	for (i = 0; i < 256; i++) {
+		count[i] += (ut64)c[0][i] + c[1][i] + c[2][i] + c[3][i];
+	}
+}
+
+R_API void r_hash_histogram(const ut8 *data, ut64 size, ut64 count[256]) {
+	memset (count, 0, 256 * sizeof (ut64));
+	if (!data) {
+		return;
+	}
+	ut64 off;
+	for (off = 0; off < size; off += HIST_CHUNK) {
+		histogram_chunk (data + off, R_MIN (HIST_CHUNK, size - off), count);
 	}
+}
+
+static double entropy_from_count(const ut64 *count, ut64 size) {
+	double h = 0;
+	int i;
 	for (i = 0; i < 256; i++) {
 		if (count[i]) {
 			double p = (double) count[i] / size;
@@ -26,7 +60,33 @@ R_API double r_hash_entropy(const ut8 *data, ut64 size) {
 	}
 	return h;
 }
+
+R_API double r_hash_entropy(const ut8 *data, ut64 size) {
+	if (!data || !size) {
+		return 0;
+	}
+	ut64 count[256];
+	r_hash_histogram (data, size, count);
+	return entropy_from_count (count, size);
+}
+
 R_API double r_hash_entropy_fraction(const ut8 *data, ut64 size) {
 	return size ? r_hash_entropy (data, size) / \
 		log2 ((double) R_MIN (size, 256)) : 0;
 }
+
+// all the byte statistics of a block in a single pass over the data
+R_API void r_hash_stats(const ut8 *data, ut64 size, RHashStats *st) {
+	R_RETURN_IF_FAIL (st);
+	r_hash_histogram (data, size, st->count);
+	st->size = data? size: 0;
+	st->zeros = st->count[0];
+	st->ffs = st->count[0xff];
+	st->printable = 0;
+	int i;
+	for (i = ' '; i <= '~'; i++) {
+		st->printable += st->count[i];
+	}
+	st->entropy = st->size? entropy_from_count (st->count, st->size): 0;
+	st->fraction = st->size? st->entropy / log2 ((double) R_MIN (st->size, 256)): 0;
+}
@@ -1,6 +1,7 @@
 /* radare2 - LGPL - Copyright 2009-2024 pancake */
 
 #include <r_hash.h>
+#include <r_util.h>
 
 #define HANDLE_CRC_PRESET(rbits, aname) \
 	do { \
@@ -232,3 +233,74 @@ R_API int r_hash_calculate(RHash *ctx, ut64 algobit, const ut8 *buf, int len) {
 
 	return 0;
 }
+
+typedef struct {
+	ut64 algobit;
+	const ut8 *input;
+	RHashBlock *blocks;
+	int count;
+	int first;
+	int step;
+} HashBlocksWorker;
+
+static void hash_blocks(HashBlocksWorker *w) {
+	RHash *ctx = r_hash_new (true, w->algobit);
+	if (!ctx) {
+		return;
+	}
+	int i;
+	for (i = w->first; i < w->count; i += w->step) {
+		RHashBlock *b = &w->blocks[i];
+		b->dlen = r_hash_calculate (ctx, w->algobit, w->input + b->off, b->len);
+		b->entropy = ctx->entropy;
+		memcpy (b->digest, ctx->digest, sizeof (b->digest));
+	}
+	r_hash_free (ctx);
+}
+
+static RThreadFunctionRet hash_blocks_thread(RThread *th) {
+	hash_blocks ((HashBlocksWorker *)th->user);
+	return R_TH_STOP;
+}
+
+// hash every block of the input on its own, spread across threads. the
+// results are the same as calling r_hash_calculate on each block in order
+R_API bool r_hash_calculate_blocks(ut64 algobit, const ut8 *input, RHashBlock *blocks, int count, int nthreads) {
+	R_RETURN_VAL_IF_FAIL (input && blocks, false);
+	if (count < 1) {
+		return true;
+	}
+	nthreads = R_MAX (R_MIN (nthreads, count), 1);
+	HashBlocksWorker *workers = R_NEWS0 (HashBlocksWorker, nthreads);
+	RThread **threads = R_NEWS0 (RThread *, nthreads);
+	if (!workers || !threads) {
+		free (workers);
+		free (threads);
+		return false;
+	}
+	int i;
+	for (i = 0; i < nthreads; i++) {
+		workers[i] = (HashBlocksWorker){ algobit, input, blocks, count, i, nthreads };
+		if (i > 0) {
+			threads[i] = r_th_new (hash_blocks_thread, &workers[i], 0);
+			if (threads[i]) {
+				r_th_start (threads[i]);
+			}
+		}
+	}
+	// the calling thread takes its share and any share a thread could not take
+	for (i = 0; i < nthreads; i++) {
+		if (!threads[i]) {
+			hash_blocks (&workers[i]);
+		}
+	}
+	for (i = 1; i < nthreads; i++) {
+		if (threads[i]) {
+			r_th_wait (threads[i]);
+			r_th_free (threads[i]);
+		}
+	}
+	free (workers);
+	free (threads);
+	return true;
+}
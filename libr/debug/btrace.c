@@ -0,0 +1,329 @@
+/* radare - LGPL - Copyright 2024 - pancake */
+
+#include <r_debug.h>
+
+// Block tracing: instead of single stepping every instruction, run until the
+// next control flow change of the current basic block using a temporary
+// breakpoint and only step the instruction that leaves it. Instructions
+// outside the analyzed code are single stepped. Each run of instructions is
+// stored as an (addr, size, ninstr) record that can be expanded back to an
+// instruction level trace later, even without the process.
+
+#define BTRACE_HDRSIZE 16
+#define BTRACE_ENTRYSIZE 16
+#define BTRACE_FLUSH 4096
+
+typedef struct {
+	ut64 addr;
+	int ninstr;
+	ut64 *ops;
+	ut8 *sizes;
+	bool *stops;
+} BTraceBlock;
+
+typedef struct {
+	RDebug *dbg;
+	const char *file;
+	HtUP *blocks;
+	ut8 *buf;
+	int nbuf;
+	int count;
+} BTrace;
+
+static void btrace_block_free(HtUPKv *kv) {
+	BTraceBlock *b = kv->value;
+	if (b) {
+		free (b->ops);
+		free (b->sizes);
+		free (b->stops);
+		free (b);
+	}
+}
+
+static bool is_stop(RAnalOp *op) {
+	// conditional and register/indirect variants fold into the base types
+	switch (op->type & ~R_ANAL_OP_TYPE_COND & R_ANAL_OP_TYPE_MASK) {
+	case R_ANAL_OP_TYPE_CALL:
+	case R_ANAL_OP_TYPE_UCALL:
+	case R_ANAL_OP_TYPE_JMP:
+	case R_ANAL_OP_TYPE_UJMP:
+	case R_ANAL_OP_TYPE_RET:
+	case R_ANAL_OP_TYPE_TRAP:
+	case R_ANAL_OP_TYPE_SWI:
+	case R_ANAL_OP_TYPE_ILL:
+		return true;
+	}
+	return false;
+}
+
+// calls don't end basic blocks, so every branching instruction inside it
+// must be a stop as well to not lose the trace of the callee
+static BTraceBlock *btrace_block_new(BTrace *bt, RAnalBlock *bb) {
+	RDebug *dbg = bt->dbg;
+	BTraceBlock *b = R_NEW0 (BTraceBlock);
+	if (!b || bb->ninstr < 1) {
+		free (b);
+		return NULL;
+	}
+	b->addr = bb->addr;
+	b->ninstr = bb->ninstr;
+	b->ops = R_NEWS (ut64, bb->ninstr);
+	b->sizes = R_NEWS (ut8, bb->ninstr);
+	b->stops = R_NEWS0 (bool, bb->ninstr);
+	if (!b->ops || !b->sizes || !b->stops) {
+		free (b->ops);
+		free (b->sizes);
+		free (b->stops);
+		free (b);
+		return NULL;
+	}
+	int i;
+	for (i = 0; i < bb->ninstr; i++) {
+		ut8 buf[32];
+		RAnalOp op;
+		b->ops[i] = r_anal_bb_opaddr_i (bb, i);
+		b->sizes[i] = (ut8)r_anal_bb_size_i (bb, i);
+		if (i + 1 == bb->ninstr) {
+			b->stops[i] = true;
+			break;
+		}
+		dbg->iob.read_at (dbg->iob.io, b->ops[i], buf, sizeof (buf));
+		r_anal_op_init (&op);
+		if (r_anal_op (dbg->anal, &op, b->ops[i], buf, sizeof (buf), R_ARCH_OP_MASK_BASIC) < 1 || is_stop (&op)) {
+			b->stops[i] = true;
+		}
+		r_anal_op_fini (&op);
+	}
+	return b;
+}
+
+static BTraceBlock *btrace_block_at(BTrace *bt, ut64 pc) {
+	RAnalBlock *bb = r_anal_bb_from_offset (bt->dbg->anal, pc);
+	if (!bb || !r_anal_block_op_starts_at (bb, pc)) {
+		return NULL;
+	}
+	bool found = false;
+	BTraceBlock *b = ht_up_find (bt->blocks, bb->addr, &found);
+	if (!found) {
+		b = btrace_block_new (bt, bb);
+		ht_up_insert (bt->blocks, bb->addr, b);
+	}
+	return b;
+}
+
+static bool btrace_flush(BTrace *bt) {
+	bool res = true;
+	if (bt->nbuf > 0) {
+		res = r_file_dump (bt->file, bt->buf, bt->nbuf * BTRACE_ENTRYSIZE, true);
+		bt->nbuf = 0;
+	}
+	return res;
+}
+
+static bool btrace_record(BTrace *bt, ut64 addr, ut32 size, ut32 ninstr) {
+	ut8 *e = bt->buf + (bt->nbuf * BTRACE_ENTRYSIZE);
+	r_write_le64 (e, addr);
+	r_write_le32 (e + 8, size);
+	r_write_le32 (e + 12, ninstr);
+	bt->count++;
+	if (++bt->nbuf >= BTRACE_FLUSH) {
+		return btrace_flush (bt);
+	}
+	return true;
+}
+
+static ut64 btrace_pc(RDebug *dbg) {
+	r_debug_reg_sync (dbg, R_REG_TYPE_GPR, false);
+	return r_debug_reg_get (dbg, "PC");
+}
+
+// fallback for code without basic blocks, returns false if the step failed
+static bool btrace_step(BTrace *bt, ut64 pc) {
+	RDebug *dbg = bt->dbg;
+	ut8 buf[32];
+	RAnalOp op;
+	dbg->iob.read_at (dbg->iob.io, pc, buf, sizeof (buf));
+	r_anal_op_init (&op);
+	int size = r_anal_op (dbg->anal, &op, pc, buf, sizeof (buf), R_ARCH_OP_MASK_BASIC);
+	r_anal_op_fini (&op);
+	if (r_debug_step (dbg, 1) != 1) {
+		return false;
+	}
+	return btrace_record (bt, pc, R_MAX (size, 1), 1);
+}
+
+/* Trace the execution at block level until reaching the `until` address, a
+ * user breakpoint, the end of the process or ^C. Returns the amount of records
+ * written to `file` or -1 on error */
+R_API int r_debug_btrace(RDebug *dbg, const char *file, ut64 until) {
+	R_RETURN_VAL_IF_FAIL (dbg && file, -1);
+	if (r_debug_is_dead (dbg)) {
+		return -1;
+	}
+	ut8 hdr[BTRACE_HDRSIZE] = {0};
+	memcpy (hdr, R_DEBUG_BTRACE_MAGIC, 4);
+	r_write_le32 (hdr + 4, R_DEBUG_BTRACE_VERSION);
+	r_write_le32 (hdr + 8, dbg->bits);
+	if (!r_file_dump (file, hdr, sizeof (hdr), false)) {
+		R_LOG_ERROR ("Cannot write %s", file);
+		return -1;
+	}
+	BTrace bt = {
+		.dbg = dbg,
+		.file = file,
+		.blocks = ht_up_new (NULL, btrace_block_free, NULL),
+		.buf = malloc (BTRACE_FLUSH * BTRACE_ENTRYSIZE),
+	};
+	if (!bt.blocks || !bt.buf) {
+		ht_up_free (bt.blocks);
+		free (bt.buf);
+		return -1;
+	}
+	r_cons_break_push (NULL, NULL);
+	ut64 pc = btrace_pc (dbg);
+	while (!r_cons_is_breaked () && !r_debug_is_dead (dbg) && pc != until) {
+		BTraceBlock *b = btrace_block_at (&bt, pc);
+		if (!b) {
+			if (!btrace_step (&bt, pc)) {
+				break;
+			}
+			pc = btrace_pc (dbg);
+			continue;
+		}
+		int i = 0, j;
+		while (i < b->ninstr && b->ops[i] != pc) {
+			i++;
+		}
+		for (j = i; j < b->ninstr - 1 && !b->stops[j]; j++) {
+			// until can be in the middle of the block
+			if (b->ops[j] == until) {
+				break;
+			}
+		}
+		const ut64 stop = b->ops[j];
+		if (stop != pc) {
+			bool has_bp = r_bp_get_at (dbg->bp, stop);
+			if (!has_bp) {
+				r_bp_add_sw (dbg->bp, stop, dbg->bpsize, R_BP_PROT_EXEC);
+			}
+			r_debug_continue (dbg);
+			if (!has_bp) {
+				r_bp_del (dbg->bp, stop);
+			}
+			if (r_debug_is_dead (dbg)) {
+				break;
+			}
+			const ut64 npc = btrace_pc (dbg);
+			if (npc != stop || has_bp || stop == until) {
+				// stopped before leaving the block, keep what was executed
+				int k = i;
+				while (k <= j && b->ops[k] != npc) {
+					k++;
+				}
+				if (k > j) {
+					R_LOG_WARN ("Block trace interrupted at 0x%08"PFMT64x, npc);
+				} else if (k > i) {
+					btrace_record (&bt, pc, npc - pc, k - i);
+				}
+				break;
+			}
+		}
+		if (r_debug_step (dbg, 1) != 1) {
+			break;
+		}
+		if (!btrace_record (&bt, pc, stop + b->sizes[j] - pc, j - i + 1)) {
+			R_LOG_ERROR ("Cannot write %s", file);
+			break;
+		}
+		pc = btrace_pc (dbg);
+		if (r_bp_get_at (dbg->bp, pc)) {
+			break;
+		}
+	}
+	r_cons_break_pop ();
+	if (!btrace_flush (&bt)) {
+		R_LOG_ERROR ("Cannot write %s", file);
+	}
+	ht_up_free (bt.blocks);
+	free (bt.buf);
+	return bt.count;
+}
+
+static ut8 *btrace_load(const char *file, int *count) {
+	size_t size = 0;
+	ut8 *data = (ut8 *)r_file_slurp (file, &size);
+	if (!data) {
+		R_LOG_ERROR ("Cannot open %s", file);
+		return NULL;
+	}
+	if (size < BTRACE_HDRSIZE || memcmp (data, R_DEBUG_BTRACE_MAGIC, 4)
+			|| r_read_le32 (data + 4) != R_DEBUG_BTRACE_VERSION) {
+		R_LOG_ERROR ("Invalid block trace file %s", file);
+		free (data);
+		return NULL;
+	}
+	*count = (size - BTRACE_HDRSIZE) / BTRACE_ENTRYSIZE;
+	return data;
+}
+
+static void btrace_entry(const ut8 *data, int n, RDebugBTraceEntry *e) {
+	const ut8 *p = data + BTRACE_HDRSIZE + (n * BTRACE_ENTRYSIZE);
+	e->addr = r_read_le64 (p);
+	e->size = r_read_le32 (p + 8);
+	e->ninstr = r_read_le32 (p + 12);
+}
+
+R_API bool r_debug_btrace_list(RDebug *dbg, const char *file, int mode) {
+	R_RETURN_VAL_IF_FAIL (dbg && file, false);
+	int i, count = 0;
+	ut8 *data = btrace_load (file, &count);
+	if (!data) {
+		return false;
+	}
+	for (i = 0; i < count; i++) {
+		RDebugBTraceEntry e;
+		btrace_entry (data, i, &e);
+		if (mode == 'q') {
+			dbg->cb_printf ("0x%08"PFMT64x"\n", e.addr);
+		} else {
+			dbg->cb_printf ("0x%08"PFMT64x" size=%d ninstr=%d\n", e.addr, e.size, e.ninstr);
+		}
+	}
+	free (data);
+	return true;
+}
+
+/* Expand a block trace into instructions and append them to the debug trace,
+ * the code is read through the io, so it works without a running process as
+ * long as the same binary is loaded. Returns the amount of instructions */
+R_API int r_debug_btrace_load(RDebug *dbg, const char *file) {
+	R_RETURN_VAL_IF_FAIL (dbg && dbg->trace && file, -1);
+	int i, count = 0, total = 0;
+	ut8 *data = btrace_load (file, &count);
+	if (!data) {
+		return -1;
+	}
+	for (i = 0; i < count; i++) {
+		RDebugBTraceEntry e;
+		btrace_entry (data, i, &e);
+		ut64 addr = e.addr;
+		ut32 n;
+		for (n = 0; n < e.ninstr; n++) {
+			ut8 buf[32];
+			RAnalOp op;
+			dbg->iob.read_at (dbg->iob.io, addr, buf, sizeof (buf));
+			r_anal_op_init (&op);
+			int size = r_anal_op (dbg->anal, &op, addr, buf, sizeof (buf), R_ARCH_OP_MASK_BASIC);
+			r_anal_op_fini (&op);
+			if (size < 1 || addr + size > e.addr + e.size) {
+				R_LOG_WARN ("Cannot decode the traced instruction at 0x%08"PFMT64x, addr);
+				break;
+			}
+			r_debug_trace_add (dbg, addr, size);
+			addr += size;
+			total++;
+		}
+	}
+	free (data);
+	return total;
+}
@@ -12,6 +12,8 @@ R_API void r_debug_session_free(RDebugSession *session) {
 		r_vector_free (session->checkpoints);
 		ht_up_free (session->registers);
 		ht_up_free (session->memory);
+		ht_up_free (session->pagehash);
+		r_pvector_fini (&session->pages);
 		free (session);
 	}
 }
@@ -22,9 +24,8 @@ static void r_debug_checkpoint_fini(void *element, void *user) {
 	for (i = 0; i < R_REG_TYPE_LAST; i++) {
 		r_reg_arena_free (checkpoint->arena[i]);
 	}
-	// causes double free in RDebug.free with this reproducer:
-	// lldb -- r2 -NAdq -c 'db main;dts+;db;dc;pd-- 2' /bin/ls
-	// r_list_free (checkpoint->snaps);
+	// the checkpoint snapshots are not in dbg->snaps, they belong to it
+	r_list_free (checkpoint->snaps);
 	checkpoint->snaps = NULL;
 }
 
@@ -53,10 +54,173 @@ R_API RDebugSession *r_debug_session_new(void) {
 		r_debug_session_free (session);
 		return NULL;
 	}
+	r_pvector_init (&session->pages, free);
+	session->pagehash = ht_up_new0 ();
+	if (!session->pagehash) {
+		r_debug_session_free (session);
+		return NULL;
+	}
 
 	return session;
 }
 
+#if __linux__
+// bit 55 of the pagemap entries tells if the page was written since the
+// last time the soft-dirty bits were cleared, unmapped pages count as dirty
+static bool softdirty_read(RDebug *dbg, RDebugMap *map, ut8 *dirty, ut32 npages) {
+	r_strf_var (path, 64, "/proc/%d/pagemap", dbg->pid);
+	int fd = r_sandbox_open (path, O_RDONLY, 0);
+	if (fd == -1) {
+		return false;
+	}
+	bool res = false;
+	ut64 *entries = R_NEWS (ut64, npages);
+	const off_t off = (off_t)(map->addr / SNAP_PAGE_SIZE) * sizeof (ut64);
+	if (entries && lseek (fd, off, SEEK_SET) == off) {
+		const ssize_t size = (ssize_t)npages * sizeof (ut64);
+		if (read (fd, entries, size) == size) {
+			ut32 i;
+			for (i = 0; i < npages; i++) {
+				const bool present = entries[i] & (3ULL << 62);
+				dirty[i] = !present || (entries[i] & (1ULL << 55));
+			}
+			res = true;
+		}
+	}
+	free (entries);
+	close (fd);
+	return res;
+}
+
+static bool softdirty_clear(RDebug *dbg) {
+	r_strf_var (path, 64, "/proc/%d/clear_refs", dbg->pid);
+	return r_file_dump (path, (const ut8 *)"4", 1, false);
+}
+#endif
+
+static bool debug_is_native(RDebug *dbg) {
+	return dbg->current && dbg->current->plugin && !strcmp (dbg->current->plugin->meta.name, "native");
+}
+
+static RDebugSnap *prev_checkpoint_snap(RDebugSession *session, RDebugMap *map) {
+	const size_t count = r_vector_length (session->checkpoints);
+	if (count < 1) {
+		return NULL;
+	}
+	RDebugCheckpoint *prev = r_vector_index_ptr (session->checkpoints, count - 1);
+	RListIter *iter;
+	RDebugSnap *snap;
+	r_list_foreach (prev->snaps, iter, snap) {
+		if (snap->pages && snap->addr == map->addr && snap->size == map->size) {
+			return snap;
+		}
+	}
+	return NULL;
+}
+
+// returns a session owned copy of the page, identical pages are stored once
+static ut8 *session_page(RDebugSession *session, const ut8 *buf, ut32 len) {
+	const ut64 hash = r_hash_xxhash (buf, len);
+	if (len == SNAP_PAGE_SIZE) {
+		ut8 *page = ht_up_find (session->pagehash, hash, NULL);
+		if (page && !memcmp (page, buf, len)) {
+			return page;
+		}
+	}
+	ut8 *page = malloc (SNAP_PAGE_SIZE);
+	if (!page) {
+		return NULL;
+	}
+	memcpy (page, buf, len);
+	r_pvector_push (&session->pages, page);
+	if (len == SNAP_PAGE_SIZE) {
+		ht_up_insert (session->pagehash, hash, page);
+	}
+	return page;
+}
+
+// snapshots a map for the next checkpoint, only the pages that changed since
+// the previous checkpoint are copied, the rest are shared with it. the pages
+// not marked in dirty (NULL means all of them) are not even read
+R_API RDebugSnap *r_debug_session_snap(RDebugSession *session, RDebugMap *map, const ut8 *dirty, RDebugSnapRead read, void *user) {
+	R_RETURN_VAL_IF_FAIL (session && map && read, NULL);
+	if (map->size < 1) {
+		return NULL;
+	}
+	RDebugSnap *snap = R_NEW0 (RDebugSnap);
+	if (!snap) {
+		return NULL;
+	}
+	const ut32 npages = (map->size + SNAP_PAGE_SIZE - 1) / SNAP_PAGE_SIZE;
+	snap->name = strdup (r_str_get (map->name));
+	snap->addr = map->addr;
+	snap->addr_end = map->addr_end;
+	snap->size = map->size;
+	snap->perm = map->perm;
+	snap->user = map->user;
+	snap->shared = map->shared;
+	snap->pages = R_NEWS0 (ut8 *, npages);
+	ut8 *buf = malloc (SNAP_PAGE_SIZE);
+	if (!snap->pages || !buf) {
+		goto fail;
+	}
+	RDebugSnap *prev = prev_checkpoint_snap (session, map);
+	ut32 i;
+	for (i = 0; i < npages; i++) {
+		if (prev && dirty && !dirty[i]) {
+			snap->pages[i] = prev->pages[i];
+			continue;
+		}
+		const ut32 off = i * SNAP_PAGE_SIZE;
+		const ut32 len = R_MIN (SNAP_PAGE_SIZE, snap->size - off);
+		read (user, snap->addr + off, buf, len);
+		if (prev && !memcmp (prev->pages[i], buf, len)) {
+			snap->pages[i] = prev->pages[i];
+			continue;
+		}
+		snap->pages[i] = session_page (session, buf, len);
+		if (!snap->pages[i]) {
+			goto fail;
+		}
+	}
+	free (buf);
+	return snap;
+fail:
+	free (buf);
+	r_debug_snap_free (snap);
+	return NULL;
+}
+
+static bool debug_read(void *user, ut64 addr, ut8 *buf, int len) {
+	RDebug *dbg = user;
+	return dbg->iob.read_at (dbg->iob.io, addr, buf, len);
+}
+
+static bool debug_write(void *user, ut64 addr, const ut8 *buf, int len) {
+	RDebug *dbg = user;
+	return dbg->iob.write_at (dbg->iob.io, addr, buf, len);
+}
+
+static RDebugSnap *checkpoint_snap_map(RDebug *dbg, RDebugMap *map, bool softdirty) {
+	if (map->size > dbg->maxsnapsize) {
+		R_LOG_WARN ("Not snapping map %s (bigger than dbg.maxsnapsize)", r_str_get (map->name));
+		return NULL;
+	}
+	ut8 *dirty = NULL;
+#if __linux__
+	if (softdirty && map->size > 0) {
+		const ut32 npages = (map->size + SNAP_PAGE_SIZE - 1) / SNAP_PAGE_SIZE;
+		dirty = malloc (npages);
+		if (dirty && !softdirty_read (dbg, map, dirty, npages)) {
+			R_FREE (dirty);
+		}
+	}
+#endif
+	RDebugSnap *snap = r_debug_session_snap (dbg->session, map, dirty, debug_read, dbg);
+	free (dirty);
+	return snap;
+}
+
 R_API bool r_debug_add_checkpoint(RDebug *dbg) {
 	R_RETURN_VAL_IF_FAIL (dbg->session, false);
 	size_t i;
@@ -78,17 +242,23 @@ R_API bool r_debug_add_checkpoint(RDebug *dbg) {
 	if (!checkpoint.snaps) {
 		return false;
 	}
+	const bool native = debug_is_native (dbg);
+	const bool softdirty = native && dbg->session->softdirty_pid == dbg->pid;
 	RListIter *iter;
 	RDebugMap *map;
 	r_debug_map_sync (dbg);
 	r_list_foreach (dbg->maps, iter, map) {
 		if ((map->perm & R_PERM_RW) == R_PERM_RW) {
-			RDebugSnap *snap = r_debug_snap_map (dbg, map);
+			RDebugSnap *snap = checkpoint_snap_map (dbg, map, softdirty);
 			if (snap) {
 				r_list_append (checkpoint.snaps, snap);
 			}
 		}
 	}
+#if __linux__
+	// the next checkpoint will only read the pages written after this point
+	dbg->session->softdirty_pid = (native && softdirty_clear (dbg))? dbg->pid: 0;
+#endif
 
 	checkpoint.cnum = dbg->session->cnum;
 	r_vector_push (dbg->session->checkpoints, &checkpoint);
@@ -142,7 +312,7 @@ static void _set_initial_memory(RDebug *dbg) {
 	RListIter *iter;
 	RDebugSnap *snap;
 	r_list_foreach (dbg->session->cur_chkpt->snaps, iter, snap) {
-		dbg->iob.write_at (dbg->iob.io, snap->addr, snap->data, snap->size);
+		r_debug_snap_restore (snap, debug_write, dbg);
 	}
 }
 
@@ -344,7 +514,7 @@ static void serialize_checkpoints(Sdb *db, RVector *checkpoints) {
 			pj_kn (j, "addr", snap->addr);
 			pj_kn (j, "addr_end", snap->addr_end);
 			pj_kn (j, "size", snap->size);
-			char *edata = sdb_encode ((const void *)snap->data, snap->size);
+			char *edata = sdb_encode (r_debug_snap_data (snap), snap->size);
 			if (!edata) {
 				pj_free (j);
 				return;
@@ -7,10 +7,41 @@ R_API void r_debug_snap_free(RDebugSnap *snap) {
 	if (snap) {
 		free (snap->name);
 		free (snap->data);
+		free (snap->pages); // the page contents belong to the session
 		free (snap);
 	}
 }
 
+// contents of the snapshot, checkpoint snapshots are made contiguous on demand
+R_API const ut8 *r_debug_snap_data(RDebugSnap *snap) {
+	R_RETURN_VAL_IF_FAIL (snap, NULL);
+	if (!snap->data && snap->pages) {
+		snap->data = malloc (snap->size);
+		if (snap->data) {
+			ut32 off;
+			for (off = 0; off < snap->size; off += SNAP_PAGE_SIZE) {
+				const ut32 len = R_MIN (SNAP_PAGE_SIZE, snap->size - off);
+				memcpy (snap->data + off, snap->pages[off / SNAP_PAGE_SIZE], len);
+			}
+		}
+	}
+	return snap->data;
+}
+
+// writes the snapshot back, page by page for the checkpoint snapshots
+R_API void r_debug_snap_restore(RDebugSnap *snap, RDebugSnapWrite write, void *user) {
+	R_RETURN_IF_FAIL (snap && write);
+	if (snap->data) {
+		write (user, snap->addr, snap->data, snap->size);
+		return;
+	}
+	ut32 off;
+	for (off = 0; snap->pages && off < snap->size; off += SNAP_PAGE_SIZE) {
+		const ut32 len = R_MIN (SNAP_PAGE_SIZE, snap->size - off);
+		write (user, snap->addr + off, snap->pages[off / SNAP_PAGE_SIZE], len);
+	}
+}
+
 R_API RDebugSnap *r_debug_snap_map(RDebug *dbg, RDebugMap *map) {
 	R_RETURN_VAL_IF_FAIL (dbg && map, NULL);
 	if (map->size < 1) {
@@ -63,7 +94,7 @@ R_API ut8 *r_debug_snap_get_hash(RDebugSnap *snap) {
 	}
 
 	r_hash_do_begin (ctx, algobit);
-	r_hash_calculate (ctx, algobit, snap->data, snap->size);
+	r_hash_calculate (ctx, algobit, r_debug_snap_data (snap), snap->size);
 	r_hash_do_end (ctx, algobit);
 
 	ut8 *ret = malloc (R_HASH_SIZE_SHA256);
@@ -86,7 +117,7 @@ R_API bool r_debug_snap_is_equal(RDebugSnap *a, RDebugSnap *b) {
 	}
 
 	r_hash_do_begin (ctx, algobit);
-	r_hash_calculate (ctx, algobit, a->data, a->size);
+	r_hash_calculate (ctx, algobit, r_debug_snap_data (a), a->size);
 	r_hash_do_end (ctx, algobit);
 
 	ut8 *temp = malloc (R_HASH_SIZE_SHA256);
@@ -97,7 +128,7 @@ R_API bool r_debug_snap_is_equal(RDebugSnap *a, RDebugSnap *b) {
 	memcpy (temp, ctx->digest, R_HASH_SIZE_SHA256);
 
 	r_hash_do_begin (ctx, algobit);
-	r_hash_calculate (ctx, algobit, b->data, b->size);
+	r_hash_calculate (ctx, algobit, r_debug_snap_data (b), b->size);
 	r_hash_do_end (ctx, algobit);
 
 	ret = memcmp (temp, ctx->digest, R_HASH_SIZE_SHA256) == 0;
@@ -1,17 +1,19 @@
-/* radare - LGPL - Copyright 2015-2023 - pancake, rkx1209 */
+/* radare - LGPL - Copyright 2015-2024 - pancake, rkx1209 */
 
 #include <r_esil.h>
 #include <r_anal.h>
 #include <r_arch.h>
 
-#define CMP_REG_CHANGE(x, y) ((x) - ((REsilRegChange *)y)->idx)
-#define CMP_MEM_CHANGE(x, y) ((x) - ((REsilMemChange *)y)->idx)
-
 #define D if (false)
 
-static void htup_vector_free(HtUPKv *kv) {
+// granularity of the memory snapshots
+#define TRACE_PAGE 0x400
+// a snapshot is taken every this many ops
+#define TRACE_SNAP_OPS 0x400
+
+static void page_kv_free(HtUPKv *kv) {
 	if (kv) {
-		r_vector_free (kv->value);
+		free (kv->value);
 	}
 }
 
@@ -19,6 +21,23 @@ static void trace_db_init(REsilTraceDB *db) {
 	RVecTraceOp_init (&db->ops);
 	RVecAccess_init (&db->accesses);
 	db->loop_counts = ht_uu_new0 ();
+	r_str_constpool_init (&db->regnames);
+}
+
+static bool trace_snap_init(REsilTraceSnap *snap, REsilTrace *trace, RReg *reg) {
+	size_t i;
+	memset (snap, 0, sizeof (REsilTraceSnap));
+	snap->idx = trace->idx;
+	snap->change = trace->changes_count;
+	snap->pages = ht_up_new (NULL, page_kv_free, NULL);
+	if (!snap->pages) {
+		return false;
+	}
+	for (i = 0; i < R_REG_TYPE_LAST; i++) {
+		RRegArena *a = reg->regset[i].arena;
+		snap->arena[i] = a? r_reg_arena_clone (a): NULL;
+	}
+	return true;
 }
 
 R_API REsilTrace *r_esil_trace_new(REsil *esil) {
@@ -27,45 +46,23 @@ R_API REsilTrace *r_esil_trace_new(REsil *esil) {
 		// R_LOG_ERROR ("Run `aeim` to initialize a stack for the ESIL vm");
 		return NULL;
 	}
-	size_t i;
 	REsilTrace *trace = R_NEW0 (REsilTrace);
 	if (!trace) {
 		return NULL;
 	}
 	trace_db_init (&trace->db);
-	trace->registers = ht_up_new (NULL, htup_vector_free, NULL);
-	if (!trace->registers) {
-		goto error;
-	}
-	trace->memory = ht_up_new (NULL, htup_vector_free, NULL);
-	if (!trace->memory) {
+	RVecTraceSnap_init (&trace->snaps);
+	trace->dirty = ht_uu_new0 ();
+	if (!trace->dirty) {
 		goto error;
 	}
-	// Save initial ESIL stack memory
 	trace->stack_addr = esil->stack_addr;
 	trace->stack_size = esil->stack_size;
-	trace->stack_data = malloc (esil->stack_size);
-	if (!trace->stack_data) {
-		goto error;
-	}
-	int res = esil->anal->iob.read_at (esil->anal->iob.io, trace->stack_addr, trace->stack_data, trace->stack_size);
-	if (res < 1) {
+	// the initial state, memory pages are saved the first time they are written
+	REsilTraceSnap *snap = RVecTraceSnap_emplace_back (&trace->snaps);
+	if (!snap || !trace_snap_init (snap, trace, esil->anal->reg)) {
 		goto error;
 	}
-
-	// AFAIK this is not used
-	// Save initial registers arenas
-	for (i = 0; i < R_REG_TYPE_LAST; i++) {
-		RRegArena *a = esil->anal->reg->regset[i].arena;
-		RRegArena *b = r_reg_arena_new (a->size);
-		if (!b) {
-			goto error;
-		}
-		if (b->bytes && a->bytes && b->size > 0) {
-			memcpy (b->bytes, a->bytes, b->size);
-		}
-		trace->arena[i] = b;
-	}
 	return trace;
 error:
 	R_LOG_ERROR ("trace initialization failed");
@@ -73,11 +70,56 @@ error:
 	return NULL;
 }
 
+static inline REsilTraceOp *trace_db_op(REsilTraceDB *db, int idx) {
+	return (idx >= db->ops_first)? RVecTraceOp_at (&db->ops, idx - db->ops_first): NULL;
+}
+
+static inline size_t access_datasize(REsilTraceAccess *a) {
+	return (a->is_reg || !a->mem.data)? 0: strlen (a->mem.data) + 1;
+}
+
+// forgets the ops traced before idx and their accesses
+static void trace_db_drop(REsilTraceDB *db, int idx) {
+	const ut64 nops = RVecTraceOp_length (&db->ops);
+	if (idx <= db->ops_first || !nops) {
+		return;
+	}
+	const ut64 n = R_MIN ((ut64)(idx - db->ops_first), nops);
+	const ut32 nxs = (n < nops)
+		? RVecTraceOp_at (&db->ops, n)->start
+		: RVecAccess_length (&db->accesses);
+	REsilTraceAccess *xs = R_VEC_START_ITER (&db->accesses);
+	REsilTraceAccess *a;
+	for (a = xs; a < xs + nxs; a++) {
+		db->datasize -= access_datasize (a);
+		fini_access (a);
+	}
+	memmove (xs, xs + nxs, (R_VEC_END_ITER (&db->accesses) - (xs + nxs)) * sizeof (REsilTraceAccess));
+	R_VEC_END_ITER (&db->accesses) -= nxs;
+	REsilTraceOp *ops = R_VEC_START_ITER (&db->ops);
+	memmove (ops, ops + n, (nops - n) * sizeof (REsilTraceOp));
+	R_VEC_END_ITER (&db->ops) -= n;
+	// the access indexes of the ops left are relative to the new start
+	REsilTraceOp *op;
+	R_VEC_FOREACH (&db->ops, op) {
+		op->start -= nxs;
+		op->end -= nxs;
+		if (op->first_reg_write != UT32_MAX) {
+			op->first_reg_write -= nxs;
+		}
+		if (op->first_mem_write != UT32_MAX) {
+			op->first_mem_write -= nxs;
+		}
+	}
+	db->ops_first += n;
+}
+
 static void trace_db_fini(REsilTraceDB *db) {
 	if (db) {
 		RVecAccess_fini (&db->accesses);
 		RVecTraceOp_fini (&db->ops);
 		ht_uu_free (db->loop_counts);
+		r_str_constpool_fini (&db->regnames);
 	}
 }
 
@@ -93,48 +135,274 @@ R_API void r_esil_trace_loopcount_increment(REsilTrace *etrace, ut64 addr) {
 }
 
 R_API void r_esil_trace_free(REsilTrace *trace) {
-	size_t i;
 	if (trace) {
-		ht_up_free (trace->registers);
-		ht_up_free (trace->memory);
-		for (i = 0; i < R_REG_TYPE_LAST; i++) {
-			r_reg_arena_free (trace->arena[i]);
-		}
-		free (trace->stack_data);
+		free (trace->changes);
+		RVecTraceSnap_fini (&trace->snaps);
+		ht_uu_free (trace->dirty);
 		trace_db_fini (&trace->db);
 		R_FREE (trace);
 	}
 }
 
-static void add_reg_change(REsilTrace *trace, RRegItem *ri, ut64 data) {
-	R_RETURN_IF_FAIL (trace && ri);
-	ut64 addr = ri->offset | (ri->arena << 16);
-	RVector *vreg = ht_up_find (trace->registers, addr, NULL);
-	if (!vreg) {
-		vreg = r_vector_new (sizeof (REsilRegChange), NULL, NULL);
-		if (!vreg) {
-			R_LOG_ERROR ("creating a register vector");
-			return;
+static inline REsilTraceChange *trace_change_at(REsilTrace *trace, ut64 seq) {
+	const ut64 pos = trace->changes_head + (seq - trace->changes_first);
+	return &trace->changes[pos % trace->changes_size];
+}
+
+// appends a change to the ring, it only grows when it's full, esil.trace.maxmem
+// bounds the live changes by dropping the oldest snapshots between ops
+static REsilTraceChange *trace_change_new(REsilTrace *trace, REsilTraceChangeType type) {
+	const ut64 used = trace->changes_count - trace->changes_first;
+	if (used == trace->changes_size) {
+		const ut32 size = trace->changes_size? trace->changes_size * 2: 0x1000;
+		REsilTraceChange *changes = R_NEWS (REsilTraceChange, size);
+		if (!changes) {
+			return NULL;
+		}
+		ut64 seq;
+		for (seq = trace->changes_first; seq < trace->changes_count; seq++) {
+			changes[seq - trace->changes_first] = *trace_change_at (trace, seq);
 		}
-		ht_up_insert (trace->registers, addr, vreg);
+		free (trace->changes);
+		trace->changes = changes;
+		trace->changes_size = size;
+		trace->changes_head = 0;
+	}
+	REsilTraceChange *c = trace_change_at (trace, trace->changes_count);
+	trace->changes_count++;
+	memset (c, 0, sizeof (REsilTraceChange));
+	c->idx = trace->idx;
+	c->type = type;
+	return c;
+}
+
+static void add_reg_change(REsilTrace *trace, const char *name, ut64 data) {
+	REsilTraceChange *c = trace_change_new (trace, R_ESIL_TRACE_CHANGE_REG);
+	if (c) {
+		c->reg = name;
+		c->value = data;
 	}
-	REsilRegChange reg = { trace->cur_idx, data }; // imho cur_idx is not necessary, we keep track of this in the other vector
-	r_vector_push (vreg, &reg);
 }
 
-static void add_mem_change(REsilTrace *trace, ut64 addr, ut8 data) {
-	R_RETURN_IF_FAIL (trace);
-	RVector *vmem = ht_up_find (trace->memory, addr, NULL);
-	if (!vmem) {
-		vmem = r_vector_new (sizeof (REsilMemChange), NULL, NULL);
-		if (!vmem) {
-			R_LOG_ERROR ("creating a memory vector");
+static void add_mem_change(REsilTrace *trace, ut64 addr, const ut8 *buf, int len) {
+	while (len > 0) {
+		REsilTraceChange *c = trace_change_new (trace, R_ESIL_TRACE_CHANGE_MEM);
+		if (!c) {
 			return;
 		}
-		ht_up_insert (trace->memory, addr, vmem);
+		c->addr = addr;
+		c->size = R_MIN (len, sizeof (c->bytes));
+		memcpy (c->bytes, buf, c->size);
+		addr += c->size;
+		buf += c->size;
+		len -= c->size;
+	}
+}
+
+// saves the contents of the pages before they are written for the first time
+static void trace_touch(REsil *esil, ut64 addr, int len) {
+	REsilTrace *trace = esil->trace;
+	REsilTraceSnap *base = RVecTraceSnap_at (&trace->snaps, 0);
+	if (!base || len < 1) {
+		return;
+	}
+	const ut64 last = (addr + len - 1) & ~(ut64)(TRACE_PAGE - 1);
+	ut64 page = addr & ~(ut64)(TRACE_PAGE - 1);
+	for (;;) {
+		bool found = false;
+		ht_up_find (base->pages, page, &found);
+		if (!found) {
+			ut8 *data = malloc (TRACE_PAGE);
+			if (data) {
+				esil->anal->iob.read_at (esil->anal->iob.io, page, data, TRACE_PAGE);
+				ht_up_insert (base->pages, page, data);
+			}
+		}
+		ht_uu_update (trace->dirty, page, 1);
+		if (page == last) {
+			break;
+		}
+		page += TRACE_PAGE;
+	}
+}
+
+typedef struct {
+	REsil *esil;
+	REsilTraceSnap *snap;
+} TraceSnapCtx;
+
+static bool snap_page_cb(void *user, const ut64 page, const ut64 v) {
+	TraceSnapCtx *ctx = user;
+	ut8 *data = malloc (TRACE_PAGE);
+	if (data) {
+		ctx->esil->anal->iob.read_at (ctx->esil->anal->iob.io, page, data, TRACE_PAGE);
+		ht_up_insert (ctx->snap->pages, page, data);
+	}
+	return true;
+}
+
+// saves the registers and the pages written since the previous snapshot
+static void trace_snapshot(REsil *esil) {
+	REsilTrace *trace = esil->trace;
+	REsilTraceSnap *snap = RVecTraceSnap_emplace_back (&trace->snaps);
+	if (!snap) {
+		return;
+	}
+	if (!trace_snap_init (snap, trace, esil->anal->reg)) {
+		RVecTraceSnap_pop_back (&trace->snaps);
+		return;
+	}
+	TraceSnapCtx ctx = { esil, snap };
+	ht_uu_foreach (trace->dirty, snap_page_cb, &ctx);
+	ht_uu_free (trace->dirty);
+	trace->dirty = ht_uu_new0 ();
+}
+
+static bool merge_page_cb(void *user, const ut64 page, const void *data) {
+	HtUP *pages = user;
+	// the first snapshot has every page that was ever written
+	ut8 *dst = ht_up_find (pages, page, NULL);
+	if (dst) {
+		memcpy (dst, data, TRACE_PAGE);
+	}
+	return true;
+}
+
+// forgets everything before the second snapshot, which becomes the oldest state
+static void trace_drop_oldest(REsilTrace *trace) {
+	REsilTraceSnap *base = RVecTraceSnap_at (&trace->snaps, 0);
+	REsilTraceSnap *next = RVecTraceSnap_at (&trace->snaps, 1);
+	size_t i;
+	ht_up_foreach (next->pages, merge_page_cb, base->pages);
+	for (i = 0; i < R_REG_TYPE_LAST; i++) {
+		r_reg_arena_free (base->arena[i]);
+		base->arena[i] = next->arena[i];
+		next->arena[i] = NULL;
+	}
+	base->idx = next->idx;
+	base->change = next->change;
+	trace_db_drop (&trace->db, base->idx);
+	if (trace->changes_size > 0) {
+		const ut64 drop = next->change - trace->changes_first;
+		trace->changes_head = (trace->changes_head + drop) % trace->changes_size;
+	}
+	trace->changes_first = next->change;
+	RVecTraceSnap_remove (&trace->snaps, 1);
+}
+
+// bytes taken by the ops and accesses traced since the op at idx
+static ut64 trace_db_memsize(REsilTraceDB *db, int idx) {
+	REsilTraceOp *op = trace_db_op (db, idx);
+	const ut64 nops = RVecTraceOp_length (&db->ops);
+	const ut64 nxs = RVecAccess_length (&db->accesses);
+	if (!op) {
+		return (idx > db->ops_first)? 0: nops * sizeof (REsilTraceOp) + nxs * sizeof (REsilTraceAccess);
+	}
+	return (nops - (idx - db->ops_first)) * sizeof (REsilTraceOp) + (nxs - op->start) * sizeof (REsilTraceAccess);
+}
+
+static ut64 trace_memsize(REsilTrace *trace) {
+	// only the live changes, the ring keeps the capacity it grew to
+	ut64 size = (trace->changes_count - trace->changes_first) * sizeof (REsilTraceChange);
+	size += trace_db_memsize (&trace->db, trace->db.ops_first) + trace->db.datasize;
+	REsilTraceSnap *snap;
+	R_VEC_FOREACH (&trace->snaps, snap) {
+		size_t i;
+		for (i = 0; i < R_REG_TYPE_LAST; i++) {
+			size += snap->arena[i]? snap->arena[i]->size: 0;
+		}
+		size += (ut64)snap->pages->count * TRACE_PAGE;
+	}
+	return size;
+}
+
+static void trace_trim(REsil *esil) {
+	REsilTrace *trace = esil->trace;
+	// snapshot before the recent changes take a quarter of the budget, so
+	// dropping the oldest state still leaves the last steps to go back
+	REsilTraceSnap *last = RVecTraceSnap_last (&trace->snaps);
+	const ut64 recent = (trace->changes_count - last->change) * sizeof (REsilTraceChange)
+		+ trace_db_memsize (&trace->db, last->idx);
+	if (last->idx != trace->idx && recent > esil->trace_maxmem / 4) {
+		trace_snapshot (esil);
+	}
+	while (trace_memsize (trace) > esil->trace_maxmem) {
+		if (RVecTraceSnap_length (&trace->snaps) < 2) {
+			REsilTraceSnap *base = RVecTraceSnap_at (&trace->snaps, 0);
+			if (base->idx == trace->idx) {
+				break;
+			}
+			trace_snapshot (esil);
+			if (RVecTraceSnap_length (&trace->snaps) < 2) {
+				break;
+			}
+		}
+		trace_drop_oldest (trace);
+	}
+}
+
+static bool dirty_page_cb(void *user, const ut64 page, const void *data) {
+	ht_uu_update ((HtUU *)user, page, 1);
+	return true;
+}
+
+// the vm is going to run a different path from a restored state,
+// forget the ops that were traced after it
+static void trace_truncate(REsilTrace *trace, int idx) {
+	REsilTraceOp *op = trace_db_op (&trace->db, idx);
+	if (op) {
+		REsilTraceAccess *from = R_VEC_START_ITER (&trace->db.accesses) + op->start;
+		REsilTraceAccess *a;
+		for (a = from; a < R_VEC_END_ITER (&trace->db.accesses); a++) {
+			trace->db.datasize -= access_datasize (a);
+		}
+		RVecAccess_erase_back (&trace->db.accesses, from);
+		RVecTraceOp_erase_back (&trace->db.ops, op);
+	}
+	while (trace->changes_count > trace->changes_first) {
+		REsilTraceChange *c = trace_change_at (trace, trace->changes_count - 1);
+		if (c->idx < idx) {
+			break;
+		}
+		trace->changes_count--;
+	}
+	while (RVecTraceSnap_length (&trace->snaps) > 1) {
+		REsilTraceSnap *snap = RVecTraceSnap_last (&trace->snaps);
+		if (snap->idx <= idx) {
+			break;
+		}
+		// its pages are dirty again for the next snapshot
+		ht_up_foreach (snap->pages, dirty_page_cb, trace->dirty);
+		RVecTraceSnap_pop_back (&trace->snaps);
+	}
+	trace->end_idx = idx;
+}
+
+// keeps the summary of the last traced op in sync with its accesses
+static void trace_op_account(REsilTrace *trace, REsilTraceAccess *access) {
+	ut32 length = RVecTraceOp_length (&trace->db.ops);
+	REsilTraceOp *last = length > 0? RVecTraceOp_at (&trace->db.ops, length - 1): NULL;
+	if (!last) {
+		return;
+	}
+	const ut32 idx = RVecAccess_length (&trace->db.accesses) - 1;
+	if (access->is_reg) {
+		const ut64 bit = r_esil_trace_regbit (access->reg.name);
+		if (access->is_write) {
+			last->reg_write |= bit;
+			if (last->first_reg_write == UT32_MAX) {
+				last->first_reg_write = idx;
+			}
+		} else {
+			last->reg_read |= bit;
+		}
+	} else if (access->is_write) {
+		if (last->first_mem_write == UT32_MAX) {
+			last->first_mem_write = idx;
+		}
+	} else {
+		last->mem_read = true;
 	}
-	REsilMemChange mem = { trace->cur_idx, data };
-	r_vector_push (vmem, &mem);
 }
 
 // TODO find a better name
@@ -180,10 +448,11 @@ static bool trace_hook_reg_read(REsil *esil, const char *name, ut64 *res, int *s
 		access->is_reg = true;
 		D eprintf ("emplaced a new access\n");
 		// eprintf ("[ESIL] REG READ %s 0x%08"PFMT64x"\n", name, val);
-		access->reg.name = strdup (name); // XXX leaks. and regnames should be constant not heap allocated
+		access->reg.name = r_str_constpool_get (&esil->trace->db.regnames, name);
 		access->reg.value = *res;
 		// TODO size
 		access->is_write = false;
+		trace_op_account (esil->trace, access);
 		// eprintf ("select it %p%c", DB, 10);
 	} else  {
 		R_LOG_ERROR ("cannot read");
@@ -204,12 +473,13 @@ static bool trace_hook_reg_write(REsil *esil, const char *name, ut64 *val) {
 			return false;
 		}
 		access->is_reg = true;
-		access->reg.name = strdup (name); // TODO: LEAK reg.name instead of .reg!
+		access->reg.name = r_str_constpool_get (&esil->trace->db.regnames, name);
 		access->reg.value = *val;
 		access->is_write = true;
 		// TODO size
+		trace_op_account (esil->trace, access);
 
-		add_reg_change (esil->trace, ri, *val);
+		add_reg_change (esil->trace, access->reg.name, *val);
 		if (esil->ocb.hook_reg_write) {
 			REsilCallbacks cbs = esil->cb;
 			esil->cb = esil->ocb;
@@ -247,6 +517,8 @@ static bool trace_hook_mem_read(REsil *esil, ut64 addr, ut8 *buf, int len) {
 	access->mem.data = hexbuf;
 	access->mem.addr = addr;
 	access->is_write = false;
+	esil->trace->db.datasize += access_datasize (access);
+	trace_op_account (esil->trace, access);
 
 	if (esil->ocb.hook_mem_read) {
 		REsilCallbacks cbs = esil->cb;
@@ -259,7 +531,6 @@ static bool trace_hook_mem_read(REsil *esil, ut64 addr, ut8 *buf, int len) {
 }
 
 static bool trace_hook_mem_write(REsil *esil, ut64 addr, const ut8 *buf, int len) {
-	size_t i;
 	int ret = 0;
 	D eprintf ("%d MW 0x%"PFMT64x" %d\n", esil->trace->cur_idx, addr, len);
 	char *hexbuf = r_hex_bin2strdup (buf, len);
@@ -277,10 +548,11 @@ static bool trace_hook_mem_write(REsil *esil, ut64 addr, const ut8 *buf, int len
 	access->mem.data = hexbuf;
 	access->mem.addr = addr;
 	access->is_write = true;
+	esil->trace->db.datasize += access_datasize (access);
+	trace_op_account (esil->trace, access);
 
-	for (i = 0; i < len; i++) {
-		add_mem_change (esil->trace, addr + i, buf[i]);
-	}
+	trace_touch (esil, addr, len);
+	add_mem_change (esil->trace, addr, buf, len);
 
 	if (esil->ocb.hook_mem_write) {
 		REsilCallbacks cbs = esil->cb;
@@ -323,6 +595,14 @@ R_API void r_esil_trace_op(REsil *esil, struct r_anal_op_t *op) {
 	esil->ocb = esil->cb;
 	esil->ocb_set = true;
 
+	REsilTrace *trace = esil->trace;
+	if (trace->idx < trace->end_idx) {
+		trace_truncate (trace, trace->idx);
+	}
+	REsilTraceSnap *snap = RVecTraceSnap_last (&trace->snaps);
+	if (snap && trace->idx - snap->idx >= TRACE_SNAP_OPS) {
+		trace_snapshot (esil);
+	}
 	REsilTraceOp *to = RVecTraceOp_emplace_back (&esil->trace->db.ops);
 	if (to) {
 		ut32 vec_idx = RVecAccess_length (&esil->trace->db.accesses);
@@ -330,11 +610,16 @@ R_API void r_esil_trace_op(REsil *esil, struct r_anal_op_t *op) {
 		to->start = vec_idx;
 		to->end = vec_idx;
 		to->addr = op->addr;
+		to->reg_read = 0;
+		to->reg_write = 0;
+		to->first_reg_write = UT32_MAX;
+		to->first_mem_write = UT32_MAX;
+		to->mem_read = false;
 	}
 
-	RRegItem *pc_ri = r_reg_get (esil->anal->reg, "PC", -1);
-	if (pc_ri) {
-		add_reg_change (esil->trace, pc_ri, op->addr);
+	REsilTraceChange *pc = trace_change_new (trace, R_ESIL_TRACE_CHANGE_PC);
+	if (pc) {
+		pc->value = op->addr;
 	}
 	/* set hooks */
 	esil->cb.hook_reg_read = trace_hook_reg_read;
@@ -352,39 +637,21 @@ R_API void r_esil_trace_op(REsil *esil, struct r_anal_op_t *op) {
 	esil->ocb_set = false;
 	// update_last_trace_op (esil);
 	/* increment idx */
-	esil->trace->idx++;
-	esil->trace->end_idx++; // should be vector length
-}
-
-static bool restore_memory_cb(void *user, const ut64 key, const void *value) {
-	size_t index;
-	REsil *esil = user;
-	RVector *vmem = (RVector *)value;
-
-	r_vector_upper_bound (vmem, esil->trace->idx, index, CMP_MEM_CHANGE);
-	if (index > 0 && index <= vmem->len) {
-		REsilMemChange *c = r_vector_index_ptr (vmem, index - 1);
-		esil->anal->iob.write_at (esil->anal->iob.io, key, &c->data, 1);
+	trace->idx++;
+	trace->end_idx++; // should be vector length
+	if (esil->trace_maxmem) {
+		trace_trim (esil);
 	}
-	return true;
 }
 
-static bool restore_register(REsil *esil, RRegItem *ri, int idx) {
-	size_t index;
-	RVector *vreg = ht_up_find (esil->trace->registers, ri->offset | (ri->arena << 16), NULL);
-	if (vreg) {
-		r_vector_upper_bound (vreg, idx, index, CMP_REG_CHANGE);
-		if (index > 0 && index <= vreg->len) {
-			REsilRegChange *c = r_vector_index_ptr (vreg, index - 2);
-			if (c) {
-				// printf ("set value %s 0x%"PFMT64x"\n", ri->name, c->data);
-				r_reg_set_value (esil->anal->reg, ri, c->data);
-			}
-		}
-	}
+static bool restore_page_cb(void *user, const ut64 page, const void *data) {
+	REsil *esil = user;
+	esil->anal->iob.write_at (esil->anal->iob.io, page, data, TRACE_PAGE);
 	return true;
 }
 
+// restores the state of the vm right before the op at idx was executed,
+// starting from the closest snapshot and replaying the changes after it
 R_API void r_esil_trace_restore(REsil *esil, int idx) {
 	size_t i;
 	D printf ("RESTORE 2\n");
@@ -392,29 +659,55 @@ R_API void r_esil_trace_restore(REsil *esil, int idx) {
 	if (!trace) {
 		return;
 	}
-	// Restore initial state when going backward
-	if (idx < esil->trace->idx) {
-		// Restore initial registers value
-		for (i = 0; i < R_REG_TYPE_LAST; i++) {
-			RRegArena *a = esil->anal->reg->regset[i].arena;
-			RRegArena *b = trace->arena[i];
-			if (a && b) {
-				memcpy (a->bytes, b->bytes, a->size);
-			}
+	REsilTraceSnap *base = RVecTraceSnap_at (&trace->snaps, 0);
+	if (idx < base->idx) {
+		R_LOG_WARN ("The trace only goes back to %d, see esil.trace.maxmem", base->idx);
+		idx = base->idx;
+	}
+	if (idx > trace->end_idx) {
+		idx = trace->end_idx;
+	}
+	REsilTraceSnap *snap = NULL;
+	R_VEC_FOREACH_PREV (&trace->snaps, snap) {
+		if (snap->idx <= idx) {
+			break;
 		}
-		// Restore initial stack memory
-		esil->anal->iob.write_at (esil->anal->iob.io, trace->stack_addr,
-			trace->stack_data, trace->stack_size);
 	}
-	// Apply latest changes to registers and memory
-	esil->trace->idx = idx;
-	esil->trace->cur_idx = idx;
-	RListIter *iter;
-	RRegItem *ri;
-	r_list_foreach (esil->anal->reg->allregs, iter, ri) {
-		restore_register (esil, ri, idx);
+	// revert every written page and roll the snapshots forward until the closest one
+	REsilTraceSnap *s;
+	R_VEC_FOREACH (&trace->snaps, s) {
+		ht_up_foreach (s->pages, restore_page_cb, esil);
+		if (s == snap) {
+			break;
+		}
 	}
-	ht_up_foreach (trace->memory, restore_memory_cb, esil);
+	for (i = 0; i < R_REG_TYPE_LAST; i++) {
+		RRegArena *a = esil->anal->reg->regset[i].arena;
+		RRegArena *b = snap->arena[i];
+		if (a && b && a->bytes && b->bytes) {
+			memcpy (a->bytes, b->bytes, R_MIN (a->size, b->size));
+		}
+	}
+	ut64 seq;
+	for (seq = snap->change; seq < trace->changes_count; seq++) {
+		REsilTraceChange *c = trace_change_at (trace, seq);
+		if (c->idx > idx || (c->idx == idx && c->type != R_ESIL_TRACE_CHANGE_PC)) {
+			break;
+		}
+		switch (c->type) {
+		case R_ESIL_TRACE_CHANGE_PC:
+			r_reg_setv (esil->anal->reg, "PC", c->value);
+			break;
+		case R_ESIL_TRACE_CHANGE_REG:
+			r_reg_setv (esil->anal->reg, c->reg, c->value);
+			break;
+		case R_ESIL_TRACE_CHANGE_MEM:
+			esil->anal->iob.write_at (esil->anal->iob.io, c->addr, c->bytes, c->size);
+			break;
+		}
+	}
+	trace->idx = idx;
+	trace->cur_idx = idx;
 }
 
 static void print_access(PrintfCallback p, int idx, REsilTraceAccess *a, int format) {
@@ -449,7 +742,7 @@ R_API void r_esil_trace_list(REsil *esil, int format) {
 	}
 	if (esil->trace) {
 		// PrintfCallback p = esil->anal->cb_printf;
-		int idx = 0;
+		int idx = esil->trace->db.ops_first;
 		REsilTraceOp *op;
 		R_VEC_FOREACH (&esil->trace->db.ops, op) {
 			D eprintf ("---> %d | 0x%08"PFMT64x" | %d %d\n", idx, op->addr, op->start, op->end);
@@ -462,7 +755,7 @@ R_API void r_esil_trace_list(REsil *esil, int format) {
 }
 
 static inline ut64 lookup_pc(REsilTraceDB *db, int idx) {
-	REsilTraceOp *to = RVecTraceOp_at (&db->ops, idx);
+	REsilTraceOp *to = trace_db_op (db, idx);
 	return to ? to->addr : UT64_MAX;
 }
 
@@ -477,7 +770,7 @@ R_API void r_esil_trace_show(REsil *esil, int idx, int format) {
 		return;
 	}
 
-	REsilTraceOp *op = RVecTraceOp_at (&esil->trace->db.ops, idx);
+	REsilTraceOp *op = trace_db_op (&esil->trace->db, idx);
 	switch (format) {
 	case '*': // radare
 		p ("ar PC=0x%"PFMT64x"\n", pc);
@@ -498,3 +791,73 @@ R_API void r_esil_trace_show(REsil *esil, int idx, int format) {
 		break;
 	}
 }
+
+static inline REsilTraceOp *trace_op_at(REsilTrace *etrace, ut32 idx) {
+	REsilTraceOp *op = trace_db_op (&etrace->db, idx);
+	return (op && op->start != op->end)? op: NULL;
+}
+
+// name of the first register written by the op at idx
+R_API const char *r_esil_trace_regwrite(REsilTrace *etrace, ut32 idx) {
+	R_RETURN_VAL_IF_FAIL (etrace, NULL);
+	REsilTraceOp *op = trace_op_at (etrace, idx);
+	if (op && op->first_reg_write != UT32_MAX) {
+		REsilTraceAccess *a = RVecAccess_at (&etrace->db.accesses, op->first_reg_write);
+		return a? a->reg.name: NULL;
+	}
+	return NULL;
+}
+
+static REsilTraceAccess *trace_find_reg(REsilTrace *etrace, REsilTraceOp *op, const char *rname, bool is_write) {
+	const ut64 mask = is_write? op->reg_write: op->reg_read;
+	if (!(mask & r_esil_trace_regbit (rname))) {
+		return NULL;
+	}
+	// names are interned, most hits are resolved by the pointer comparison
+	const char *name = r_str_constpool_get (&etrace->db.regnames, rname);
+	ut32 i;
+	for (i = op->start; i < op->end; i++) {
+		REsilTraceAccess *a = RVecAccess_at (&etrace->db.accesses, i);
+		if (a && a->is_reg && a->is_write == is_write && a->reg.name == name) {
+			return a;
+		}
+	}
+	return NULL;
+}
+
+R_API bool r_esil_trace_regwrite_contains(REsilTrace *etrace, ut32 idx, const char *rname) {
+	R_RETURN_VAL_IF_FAIL (etrace && rname, false);
+	REsilTraceOp *op = trace_op_at (etrace, idx);
+	return op && trace_find_reg (etrace, op, rname, true);
+}
+
+// value of the register read by the op at idx, false if it was not read
+R_API bool r_esil_trace_regread_value(REsilTrace *etrace, ut32 idx, const char *rname, ut64 *value) {
+	R_RETURN_VAL_IF_FAIL (etrace && rname && value, false);
+	REsilTraceOp *op = trace_op_at (etrace, idx);
+	REsilTraceAccess *a = op? trace_find_reg (etrace, op, rname, false): NULL;
+	if (a) {
+		*value = a->reg.value;
+		return true;
+	}
+	return false;
+}
+
+R_API bool r_esil_trace_memwrite_addr(REsilTrace *etrace, ut32 idx, ut64 *addr) {
+	R_RETURN_VAL_IF_FAIL (etrace && addr, false);
+	REsilTraceOp *op = trace_op_at (etrace, idx);
+	if (op && op->first_mem_write != UT32_MAX) {
+		REsilTraceAccess *a = RVecAccess_at (&etrace->db.accesses, op->first_mem_write);
+		if (a) {
+			*addr = a->mem.addr;
+			return true;
+		}
+	}
+	return false;
+}
+
+R_API bool r_esil_trace_have_memread(REsilTrace *etrace, ut32 idx) {
+	R_RETURN_VAL_IF_FAIL (etrace, false);
+	REsilTraceOp *op = trace_op_at (etrace, idx);
+	return op && op->mem_read;
+}
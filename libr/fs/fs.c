@@ -18,6 +18,12 @@
 
 R_LIB_VERSION (r_fs);
 
+// bytes read at once when streaming files
+#define FS_READ_CHUNK (1024 * 1024)
+#define FS_DUMP_THREADS 4
+// bytes read ahead of the threads writing the files of a dump
+#define FS_DUMP_MAXQUEUE (64 * 1024 * 1024)
+
 static const RFSPlugin* fs_static_plugins[] = {
 	R_FS_STATIC_PLUGINS
 };
@@ -51,12 +57,19 @@ R_API R_MUSTUSE RFS* r_fs_new(void) {
 			return NULL;
 		}
 		fs->roots->free = (RListFree) r_fs_root_free;
+		fs->files = r_list_new ();
+		if (!fs->files) {
+			r_fs_free (fs);
+			return NULL;
+		}
 		fs->plugins = r_list_new ();
 		if (!fs->plugins) {
 			r_fs_free (fs);
 			return NULL;
 		}
 		fs->plugins->free = free;
+		fs->cache = r_fs_cache_new (&fs->iob);
+		fs->threads = FS_DUMP_THREADS;
 		// XXX fs->roots->free = r_fs_plugin_free;
 		size_t i;
 		for (i = 0; fs_static_plugins[i]; i++) {
@@ -87,12 +100,41 @@ R_API RFSPlugin* r_fs_plugin_get(RFS* fs, const char* name) {
 	return NULL;
 }
 
+// closes the kept files of the root before it's freed, they can't be read
+// anymore and r_fs_close won't call the plugin on them
+static void fs_detach(RFS *fs, RFSRoot *root) {
+	RListIter *iter, *iter2;
+	RFSFile *file;
+	r_list_foreach_safe (fs->files, iter, iter2, file) {
+		if (file->root != root) {
+			continue;
+		}
+		R_FREE (file->data);
+		if (file->p && file->p->close) {
+			file->p->close (file);
+		}
+		file->p = NULL;
+		file->root = NULL;
+		r_list_delete (fs->files, iter);
+	}
+}
+
 R_API void r_fs_free(RFS* fs) {
 	if (fs) {
 		//r_io_free (fs->iob.io);
 		//root makes use of plugin so revert to avoid UaF
+		RListIter *iter;
+		RFSRoot *root;
+		r_list_foreach (fs->roots, iter, root) {
+			fs_detach (fs, root);
+		}
+		r_list_free (fs->files);
 		r_list_free (fs->roots);
 		r_list_free (fs->plugins);
+#if WITH_GPL && USE_GRUB
+		grubfs_bind_cache (NULL);
+#endif
+		r_fs_cache_free (fs->cache);
 		free (fs);
 	}
 }
@@ -121,6 +163,12 @@ R_API void r_fs_del(RFS* fs, RFSPlugin* p) {
 	// TODO: implement r_fs_del
 }
 
+static inline void fs_pin(RFS *fs, bool enable) {
+	if (fs->cache) {
+		r_fs_cache_pin (fs->cache, enable);
+	}
+}
+
 /* mountpoint */
 R_API RFSRoot* r_fs_mount(RFS* fs, R_NULLABLE const char* fstype, const char* path, ut64 delta) {
 	R_RETURN_VAL_IF_FAIL (fs && path, NULL);
@@ -196,7 +244,15 @@ R_API RFSRoot* r_fs_mount(RFS* fs, R_NULLABLE const char* fstype, const char* pa
 	root->p = p;
 	root->iob = fs->iob;
 	root->cob = fs->cob;
-	if (p->mount && !p->mount (root)) {
+	root->cache = fs->cache;
+	if (fs->cache) {
+		// the io could have changed since the last mount
+		r_fs_cache_reset (fs->cache);
+	}
+	fs_pin (fs, true);
+	const bool mounted = !p->mount || p->mount (root);
+	fs_pin (fs, false);
+	if (!mounted) {
 		free (str);
 		free (heapFsType);
 		r_fs_root_free (root);
@@ -225,7 +281,11 @@ R_API bool r_fs_umount(RFS* fs, const char* path) {
 		}
 	}
 	if (riter) {
+		fs_detach (fs, r_list_iter_get_data (riter));
 		r_list_delete (fs->roots, riter);
+		if (fs->cache) {
+			r_fs_cache_reset (fs->cache);
+		}
 		return true;
 	}
 	return false;
@@ -282,7 +342,9 @@ R_API RFSFile* r_fs_open(RFS* fs, const char* p, bool create) {
 				} else {
 					dir = path + strlen (root->path);
 				}
+				fs_pin (fs, true);
 				f = root->p->open (root, dir, false);
+				fs_pin (fs, false);
 				if (f) {
 					break;
 				}
@@ -298,16 +360,28 @@ R_API RFSFile* r_fs_open(RFS* fs, const char* p, bool create) {
 R_API void r_fs_close(RFS* fs, RFSFile* file) {
 	R_RETURN_IF_FAIL (fs && file);
 	R_FREE (file->data);
+	r_list_delete_data (fs->files, file);
+	// r_fs_umount clears the plugin of the files it detached
 	if (file->p && file->p->close) {
 		file->p->close (file);
 	}
 }
 
+// the file outlives the command that opened it, so it must be closed and
+// detached from its root when it's unmounted. r_fs_close stops tracking it
+R_API bool r_fs_keep(RFS* fs, RFSFile* file) {
+	R_RETURN_VAL_IF_FAIL (fs && file, false);
+	return r_list_append (fs->files, file) != NULL;
+}
+
 R_API int r_fs_write(RFS* fs, RFSFile* file, ut64 addr, const ut8 *data, int len) {
 	R_RETURN_VAL_IF_FAIL (fs && file && data && len >= 0, -1);
 	if (fs && file) {
 		// TODO: fill file->data ? looks like dupe of rbuffer
 		if (file->p && file->p->write) {
+			if (fs->cache) {
+				r_fs_cache_reset (fs->cache);
+			}
 			return file->p->write (file, addr, data, len);
 		}
 		R_LOG_ERROR ("null file->p->write");
@@ -318,16 +392,67 @@ R_API int r_fs_write(RFS* fs, RFSFile* file, ut64 addr, const ut8 *data, int len
 R_API int r_fs_read(RFS* fs, RFSFile* file, ut64 addr, int len) {
 	R_RETURN_VAL_IF_FAIL (fs && file && len > 0, -1);
 	if (file->p && file->p->read) {
-		if (!file->data) {
-			free (file->data);
-			file->data = calloc (1, len + 1);
+		// the buffer of a previous read may be smaller
+		ut8 *data = realloc (file->data, len + 1);
+		if (!data) {
+			return -1;
 		}
+		memset (data, 0, len + 1);
+		file->data = data;
 		return file->p->read (file, addr, len);
 	}
 	R_LOG_ERROR ("null file->p->read");
 	return -1;
 }
 
+/* Read len bytes of the file from addr in chunks of FS_READ_CHUNK bytes,
+ * passing each one to the callback, so the whole file is never in memory.
+ * Stops when the callback returns false */
+R_API bool r_fs_read_cb(RFS* fs, RFSFile* file, ut64 addr, ut64 len, RFSReadCallback cb, void *user) {
+	R_RETURN_VAL_IF_FAIL (fs && file && cb, false);
+	if (addr >= file->size) {
+		return !len;
+	}
+	len = R_MIN (len, file->size - addr);
+	bool ret = true;
+	while (len > 0) {
+		const int n = (int)R_MIN (len, FS_READ_CHUNK);
+		const int res = r_fs_read (fs, file, addr, n);
+		if (res < 1 || !file->data) {
+			ret = false;
+			break;
+		}
+		const int got = R_MIN (res, n);
+		if (!cb (user, addr, file->data, got)) {
+			ret = false;
+			break;
+		}
+		addr += got;
+		len -= got;
+	}
+	R_FREE (file->data);
+	return ret;
+}
+
+static bool read_fd_cb(void *user, ut64 addr, const ut8 *buf, int len) {
+	const int fd = *(int *)user;
+	while (len > 0) {
+		const int n = r_sandbox_write (fd, buf, len);
+		if (n < 1) {
+			return false;
+		}
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+
+// same as r_fs_read_cb writing the chunks to fd
+R_API bool r_fs_read_fd(RFS* fs, RFSFile* file, ut64 addr, ut64 len, int fd) {
+	R_RETURN_VAL_IF_FAIL (fs && file && fd >= 0, false);
+	return r_fs_read_cb (fs, file, addr, len, read_fd_cb, &fd);
+}
+
 R_API RList* r_fs_dir(RFS* fs, const char* p) {
 	R_RETURN_VAL_IF_FAIL (fs && p, NULL);
 	RList *ret = NULL;
@@ -343,7 +468,9 @@ R_API RList* r_fs_dir(RFS* fs, const char* p) {
 			if (!*dir) {
 				dir = "/";
 			}
+			fs_pin (fs, true);
 			ret = root->p->dir (root, dir, fs->view);
+			fs_pin (fs, false);
 			if (ret) {
 				break;
 			}
@@ -354,10 +481,91 @@ R_API RList* r_fs_dir(RFS* fs, const char* p) {
 	return ret;
 }
 
-R_API bool r_fs_dir_dump(RFS* fs, const char* path, const char* name) {
-	R_RETURN_VAL_IF_FAIL (fs && path && name, false);
+// files extracted by r_fs_dir_dump waiting to be written
+typedef struct {
+	char *path;
+	ut8 *data;
+	ut32 size;
+} FSDumpJob;
+
+typedef struct {
+	RThreadLock *lock;
+	RThreadCond *cond; // signaled when a job is queued or written
+	RList *jobs;
+	ut64 queued; // bytes in the queue
+	bool done;
+	bool failed;
+} FSDump;
+
+static void dump_job_free(FSDumpJob *job) {
+	if (job) {
+		free (job->path);
+		free (job->data);
+		free (job);
+	}
+}
+
+static RThreadFunctionRet dump_thread(RThread *th) {
+	FSDump *d = th->user;
+	for (;;) {
+		r_th_lock_enter (d->lock);
+		while (r_list_empty (d->jobs) && !d->done) {
+			r_th_cond_wait (d->cond, d->lock);
+		}
+		FSDumpJob *job = r_list_pop_head (d->jobs);
+		r_th_lock_leave (d->lock);
+		if (!job) {
+			break;
+		}
+		const bool ok = r_file_dump (job->path, job->data, job->size, false);
+		if (!ok) {
+			R_LOG_ERROR ("Cannot write \"%s\"", job->path);
+		}
+		r_th_lock_enter (d->lock);
+		d->queued -= job->size;
+		d->failed |= !ok;
+		r_th_cond_signal_all (d->cond);
+		r_th_lock_leave (d->lock);
+		dump_job_free (job);
+	}
+	return R_TH_STOP;
+}
+
+// the filesystem plugins are not thread safe, so files are read here and
+// only written by the dump threads
+static bool dump_file(FSDump *d, RFSFile *item, const char *str) {
+	if (!d) {
+		return r_file_dump (str, item->data, item->size, 0);
+	}
+	FSDumpJob *job = R_NEW0 (FSDumpJob);
+	if (!job || !(job->path = strdup (str))) {
+		free (job);
+		return false;
+	}
+	job->data = item->data;
+	job->size = item->size;
+	item->data = NULL;
+	r_th_lock_enter (d->lock);
+	while (d->queued > FS_DUMP_MAXQUEUE && !d->failed) {
+		r_th_cond_wait (d->cond, d->lock);
+	}
+	const bool ok = !d->failed;
+	if (ok) {
+		r_list_append (d->jobs, job);
+		d->queued += job->size;
+		r_th_cond_signal_all (d->cond);
+	}
+	r_th_lock_leave (d->lock);
+	if (!ok) {
+		dump_job_free (job);
+	}
+	return ok;
+}
+
+static bool dir_dump(RFS* fs, const char* path, const char* name, FSDump *d) {
 	RListIter* iter;
 	RFSFile *file, *item;
+	bool ret = true;
 
 	RList *list = r_fs_dir (fs, path);
 	if (!list) {
@@ -366,6 +574,7 @@ R_API bool r_fs_dir_dump(RFS* fs, const char* path, const char* name) {
 	if (!r_sys_mkdir (name)) {
 		if (r_sys_mkdir_failed ()) {
 			R_LOG_ERROR ("Cannot create \"%s\"", name);
+			r_list_free (list);
 			return false;
 		}
 	}
@@ -379,29 +588,74 @@ R_API bool r_fs_dir_dump(RFS* fs, const char* path, const char* name) {
 		switch (file->type) {
 		// DON'T FOLLOW MOUNTPOINTS
 		case R_FS_FILE_TYPE_DIRECTORY:
-			if (!r_fs_dir_dump (fs, npath, str)) {
-				free (npath);
-				free (str);
-				return false;
-			}
+			ret = dir_dump (fs, npath, str, d);
 			break;
 		case R_FS_FILE_TYPE_REGULAR:
 			item = r_fs_open (fs, npath, false);
 			if (item) {
 				r_fs_read (fs, item, 0, item->size);
-				if (!r_file_dump (str, item->data, item->size, 0)) {
-					free (npath);
-					free (str);
-					return false;
-				}
+				ret = dump_file (d, item, str);
 				r_fs_close (fs, item);
 			}
 			break;
 		}
 		free (npath);
 		free (str);
+		if (!ret) {
+			break;
+		}
 	}
-	return true;
+	r_list_free (list);
+	return ret;
+}
+
+/* Extract the files under path into the name directory of the host, the
+ * files are written by fs->threads threads while the next ones are read */
+R_API bool r_fs_dir_dump(RFS* fs, const char* path, const char* name) {
+	R_RETURN_VAL_IF_FAIL (fs && path && name, false);
+	const int nthreads = R_MIN (fs->threads, r_th_ncpus ());
+	if (nthreads < 2) {
+		return dir_dump (fs, path, name, NULL);
+	}
+	FSDump d = {
+		.lock = r_th_lock_new (false),
+		.cond = r_th_cond_new (),
+		.jobs = r_list_newf ((RListFree)dump_job_free),
+	};
+	RThread **threads = R_NEWS0 (RThread *, nthreads);
+	int i, started = 0;
+	if (d.lock && d.cond && d.jobs && threads) {
+		for (i = 0; i < nthreads; i++) {
+			threads[i] = r_th_new (dump_thread, &d, 0);
+			if (threads[i] && r_th_start (threads[i])) {
+				started++;
+			}
+		}
+	}
+	bool ret = false;
+	if (started > 0) {
+		ret = dir_dump (fs, path, name, &d);
+		r_th_lock_enter (d.lock);
+		d.done = true;
+		r_th_cond_signal_all (d.cond);
+		r_th_lock_leave (d.lock);
+	}
+	for (i = 0; threads && i < nthreads; i++) {
+		if (threads[i]) {
+			r_th_wait (threads[i]);
+			r_th_free (threads[i]);
+		}
+	}
+	if (started > 0) {
+		ret &= !d.failed;
+	} else {
+		ret = dir_dump (fs, path, name, NULL);
+	}
+	free (threads);
+	r_list_free (d.jobs);
+	r_th_cond_free (d.cond);
+	r_th_lock_free (d.lock);
+	return ret;
 }
 
 static void r_fs_find_off_aux(RFS* fs, const char* name, ut64 offset, RList* list) {
@@ -501,9 +755,11 @@ R_API RFSFile* r_fs_slurp(RFS* fs, const char* path) {
 			continue;
 		}
 		if (root->p->open && root->p->read && root->p->close) {
+			fs_pin (fs, true);
 			file = root->p->open (root, path, false);
+			fs_pin (fs, false);
 			if (file) {
-				root->p->read (file, 0, file->size); //file->data
+				r_fs_read (fs, file, 0, file->size);
 			} else {
 				R_LOG_ERROR ("cannot open file");
 			}
@@ -587,6 +843,7 @@ R_API RList* r_fs_partitions(RFS* fs, const char* ptype, ut64 delta) {
 		if (partitions[i].iterate == grub_parhook) {
 			struct grub_partition_map* gpt = partitions[i].ptr;
 			grubfs_bind_io (NULL, 0);
+			grubfs_bind_cache (fs->cache);
 			disk = (void*) grubfs_disk (&fs->iob);
 			if (gpt) {
 				gpt->iterate (disk,
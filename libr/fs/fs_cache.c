@@ -0,0 +1,218 @@
+/* radare - LGPL - Copyright 2024 - pancake */
+
+#include <r_fs.h>
+
+// Block cache for the filesystem plugins that read the disk through the io
+// in sector sized chunks. Reads are served from fixed size blocks kept in
+// LRU order, and consecutive misses grow a read-ahead window so sequential
+// file reads end up as a few large io reads. Blocks used while mounting,
+// listing directories or opening files are pinned up to half of the cache,
+// so the superblock, inode tables, FAT or MFT survive reading big files.
+
+#define FS_CACHE_BSIZE 4096
+#define FS_CACHE_SIZE (8 * 1024 * 1024)
+#define FS_CACHE_MAXRA 64
+
+typedef struct r_fs_cache_block_t {
+	ut64 idx;
+	bool ok; // the io read succeeded
+	bool pinned;
+	struct r_fs_cache_block_t *prev;
+	struct r_fs_cache_block_t *next;
+	ut8 data[];
+} RFSCacheBlock;
+
+static void lru_unlink(RFSCache *c, RFSCacheBlock *b) {
+	if (b->prev) {
+		b->prev->next = b->next;
+	} else {
+		c->head = b->next;
+	}
+	if (b->next) {
+		b->next->prev = b->prev;
+	} else {
+		c->tail = b->prev;
+	}
+	b->prev = b->next = NULL;
+}
+
+static void lru_push(RFSCache *c, RFSCacheBlock *b) {
+	b->prev = NULL;
+	b->next = c->head;
+	if (c->head) {
+		c->head->prev = b;
+	} else {
+		c->tail = b;
+	}
+	c->head = b;
+}
+
+static void block_pin(RFSCache *c, RFSCacheBlock *b) {
+	if (c->pinning > 0 && !b->pinned && c->npinned < c->maxblocks / 2) {
+		b->pinned = true;
+		c->npinned++;
+	}
+}
+
+static void block_evict(RFSCache *c) {
+	RFSCacheBlock *b = c->tail;
+	while (b && b->pinned) {
+		b = b->prev;
+	}
+	if (b) {
+		lru_unlink (c, b);
+		ht_up_delete (c->blocks, b->idx);
+		c->nblocks--;
+		free (b);
+	}
+}
+
+static RFSCacheBlock *block_add(RFSCache *c, ut64 idx, const ut8 *data, bool ok) {
+	RFSCacheBlock *b = malloc (sizeof (RFSCacheBlock) + c->bsize);
+	if (!b) {
+		return NULL;
+	}
+	b->idx = idx;
+	b->ok = ok;
+	b->pinned = false;
+	memcpy (b->data, data, c->bsize);
+	if (c->nblocks >= c->maxblocks) {
+		block_evict (c);
+	}
+	ht_up_insert (c->blocks, idx, b);
+	lru_push (c, b);
+	c->nblocks++;
+	return b;
+}
+
+// load the block and the ones after it when the reads are sequential
+static RFSCacheBlock *block_load(RFSCache *c, ut64 idx) {
+	c->ra = (idx == c->next)? R_MIN (c->ra * 2, c->maxra): 1;
+	ut32 i, n = R_MAX (c->ra, 1);
+	for (i = 1; i < n; i++) {
+		if (ht_up_find (c->blocks, idx + i, NULL)) {
+			break;
+		}
+	}
+	n = i;
+	ut8 *buf = malloc ((size_t)n * c->bsize);
+	if (!buf) {
+		return NULL;
+	}
+	RIOBind *iob = c->iob;
+	bool ok = iob->read_at (iob->io, idx * c->bsize, buf, n * c->bsize);
+	if (!ok && n > 1) {
+		// the read-ahead may go past the end of the mapped data
+		n = 1;
+		ok = iob->read_at (iob->io, idx * c->bsize, buf, c->bsize);
+	}
+	RFSCacheBlock *first = NULL;
+	// insert the read-ahead first so the requested block is the most recent
+	for (i = n; i > 0; i--) {
+		RFSCacheBlock *b = block_add (c, idx + i - 1, buf + (size_t)(i - 1) * c->bsize, ok);
+		if (i == 1) {
+			first = b;
+		}
+	}
+	free (buf);
+	c->next = idx + n;
+	return first;
+}
+
+static RFSCacheBlock *block_get(RFSCache *c, ut64 idx) {
+	RFSCacheBlock *b = ht_up_find (c->blocks, idx, NULL);
+	if (b) {
+		c->hits++;
+		lru_unlink (c, b);
+		lru_push (c, b);
+	} else {
+		c->misses++;
+		b = block_load (c, idx);
+	}
+	if (b) {
+		block_pin (c, b);
+	}
+	return b;
+}
+
+R_API RFSCache *r_fs_cache_new(RIOBind *iob) {
+	R_RETURN_VAL_IF_FAIL (iob, NULL);
+	RFSCache *c = R_NEW0 (RFSCache);
+	if (!c) {
+		return NULL;
+	}
+	c->iob = iob;
+	c->blocks = ht_up_new0 ();
+	if (!c->blocks) {
+		free (c);
+		return NULL;
+	}
+	r_fs_cache_setup (c, FS_CACHE_BSIZE, FS_CACHE_SIZE);
+	return c;
+}
+
+R_API void r_fs_cache_reset(RFSCache *c) {
+	R_RETURN_IF_FAIL (c);
+	RFSCacheBlock *b = c->head;
+	while (b) {
+		RFSCacheBlock *next = b->next;
+		free (b);
+		b = next;
+	}
+	c->head = c->tail = NULL;
+	ht_up_free (c->blocks);
+	c->blocks = ht_up_new0 ();
+	c->nblocks = c->npinned = 0;
+	c->next = UT64_MAX;
+	c->ra = 0;
+}
+
+R_API void r_fs_cache_free(RFSCache *c) {
+	if (c) {
+		r_fs_cache_reset (c);
+		ht_up_free (c->blocks);
+		free (c);
+	}
+}
+
+/* Set the block size and the total size in bytes of the cache, a size of 0
+ * disables it and reads go straight to the io. Drops everything cached */
+R_API void r_fs_cache_setup(RFSCache *c, ut32 bsize, ut64 size) {
+	R_RETURN_IF_FAIL (c);
+	r_fs_cache_reset (c);
+	c->bsize = R_MAX (bsize, 512);
+	c->maxblocks = (ut32)R_MIN (size / c->bsize, UT32_MAX);
+	// the read-ahead must not evict what it just read
+	c->maxra = R_MIN (FS_CACHE_MAXRA, c->maxblocks / 4);
+}
+
+// the blocks used between enable and disable calls are filesystem metadata
+R_API void r_fs_cache_pin(RFSCache *c, bool enable) {
+	R_RETURN_IF_FAIL (c);
+	c->pinning += enable? 1: -1;
+}
+
+// same as the io read_at through the cache
+R_API bool r_fs_cache_read(RFSCache *c, ut64 addr, ut8 *buf, int len) {
+	R_RETURN_VAL_IF_FAIL (c && buf && len >= 0, false);
+	if (!c->maxblocks || !c->blocks) {
+		return c->iob->read_at (c->iob->io, addr, buf, len);
+	}
+	bool ok = true;
+	while (len > 0) {
+		const ut64 idx = addr / c->bsize;
+		const ut32 delta = addr % c->bsize;
+		const int n = R_MIN (len, (int)(c->bsize - delta));
+		RFSCacheBlock *b = block_get (c, idx);
+		if (b) {
+			memcpy (buf, b->data + delta, n);
+			ok &= b->ok;
+		} else {
+			ok &= c->iob->read_at (c->iob->io, addr, buf, n);
+		}
+		addr += n;
+		buf += n;
+		len -= n;
+	}
+	return ok;
+}
@@ -216,8 +216,13 @@ static bool r_fs_shell_command(RFSShell *shell, RFS *fs, const char *buf) {
 		}
 		file = r_fs_open (fs, abspath, false);
 		if (file) {
-			r_fs_read (fs, file, 0, file->size);
-			r_file_dump (fname, file->data, file->size, 0);
+			int fd = r_sandbox_open (fname, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+			if (fd == -1 || !r_fs_read_fd (fs, file, 0, file->size, fd)) {
+				R_LOG_ERROR ("Cannot dump %s", fname);
+			}
+			if (fd != -1) {
+				r_sandbox_close (fd);
+			}
 			r_fs_close (fs, file);
 		} else {
 			char *f = r_str_newf ("./%s", fname);
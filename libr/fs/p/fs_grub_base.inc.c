@@ -11,6 +11,7 @@ static RFSFile* FSP(_open)(RFSRoot *root, const char *path, bool create) {
 	file->ptr = gfs;
 	file->p = root->p;
 	grubfs_bind_io (NULL, file->root->delta);
+	grubfs_bind_cache (root->cache);
 	if (gfs->file->fs->open (gfs->file, path)) {
 		r_fs_file_free (file);
 		grubfs_free (gfs);
@@ -24,7 +25,15 @@ static RFSFile* FSP(_open)(RFSRoot *root, const char *path, bool create) {
 
 static int FSP(_read)(RFSFile *file, ut64 addr, int len) {
 	GrubFS *gfs = file->ptr;
+	if (addr >= gfs->file->size) {
+		return 0;
+	}
+	len = (int)R_MIN ((ut64)len, gfs->file->size - addr);
 	grubfs_bind_io (NULL, file->root->delta);
+	grubfs_bind_cache (file->root->cache);
+	// the filesystems read from the offset of the file, which is only
+	// advanced by grub_file_read(), seek there to read any range
+	gfs->file->offset = addr;
 	int rc = gfs->file->fs->read (gfs->file, (char*)file->data, len);
 	file->off = grub_hack_lastoff; //gfs->file->offset;
 	return rc;
@@ -56,6 +65,7 @@ static RList *FSP(_dir)(RFSRoot *root, const char *path, int view) {
 	list = r_list_new ();
 	//gfs->file->device->data = &root->iob;
 	grubfs_bind_io (&root->iob, root->delta);
+	grubfs_bind_cache (root->cache);
 	gfs->file->fs->dir (gfs->file->device, path, dirhook, 0);
 	grubfs_bind_io (NULL, root->delta);
 	return list;
@@ -67,6 +77,7 @@ static bool FSP(_mount)(RFSRoot *root) {
 	GrubFS *gfs = grubfs_new (&FSIPTR, &root->iob);
 	root->ptr = gfs;
 	grubfs_bind_io (&root->iob, root->delta);
+	grubfs_bind_cache (root->cache);
 	// XXX: null hook seems to be problematic on some filesystems
 	//return gfs->file->fs->dir (gfs->file->device, "/", NULL, 0)? false:true;
 	bool ret = gfs->file->fs->dir (gfs->file->device, "/", do_nothing, 0) == 0;
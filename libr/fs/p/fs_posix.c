@@ -32,9 +32,10 @@ static int fs_posix_read(RFSFile *file, ut64 addr, int len) {
 	R_FREE (file->data);
 	char *abspath = r_str_newf ("%s/%s", file->path, file->name);
 	if (abspath) {
-		file->data = (void*)r_file_slurp_range (abspath, 0, len, NULL);
+		int size = 0;
+		file->data = (void*)r_file_slurp_range (abspath, addr, len, &size);
 		free (abspath);
-		return len;
+		return file->data? size: 0;
 	}
 	return 0;
 }
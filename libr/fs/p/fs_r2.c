@@ -144,6 +144,7 @@ static int __flags_cat(RFSRoot *root, RFSFile *file, const char *path) {
 	}
 	char *res = root->cob.cmdStrF (root->cob.core, "?v %s", last);
 	file->ptr = NULL;
+	free (file->data);
 	file->data = (ut8*)res;
 	file->p = root->p;
 	file->size = strlen (res);
@@ -162,6 +163,7 @@ static int __bsize_cat(RFSRoot *root, RFSFile *file, const char *path) {
 	R_RETURN_VAL_IF_FAIL (root && file, -1);
 	char *res = root->cob.cmdStrF (root->cob.core, "b");
 	file->ptr = NULL;
+	free (file->data);
 	file->data = (ut8*)res;
 	file->p = root->p;
 	file->size = strlen (res);
@@ -180,6 +182,7 @@ static int __seek_cat(RFSRoot *root, RFSFile *file, const char *path) {
 	R_RETURN_VAL_IF_FAIL (root && file, -1);
 	char *res = root->cob.cmdStrF (root->cob.core, "s");
 	file->ptr = NULL;
+	free (file->data);
 	file->data = (ut8*)res;
 	file->p = root->p;
 	file->size = strlen (res);
@@ -206,6 +209,7 @@ static int __cfg_cat(RFSRoot *root, RFSFile *file, const char *path) {
 	r_str_replace_char (a, '/', '.');
 	char *res = root->cob.cmdStrF (root->cob.core, "e %s", a);
 	file->ptr = NULL;
+	free (file->data);
 	file->data = (ut8*)res;
 	file->p = root->p;
 	file->size = strlen (res);
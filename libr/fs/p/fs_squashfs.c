@@ -52,7 +52,9 @@ static int fs_sqsh_mapper_map(
 		R_LOG_ERROR ("cannot allocate %d bytes", size);
 		return -1;
 	}
-	int res = root->iob.read_at (root->iob.io, offset, buf, size);
+	int res = root->cache
+		? r_fs_cache_read (root->cache, offset, buf, size)
+		: root->iob.read_at (root->iob.io, offset, buf, size);
 	if (res < 1) {
 		R_LOG_ERROR ("cannot allocate %d bytes", size);
 		free (buf);
@@ -20,6 +20,7 @@
 #include <r_bin.h>
 #include <r_codemeta.h>
 #include <sdb/set.h>
+#include <sdb/ht_pu.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -417,6 +418,32 @@ typedef struct {
 
 typedef struct r_ref_manager_t RefManager;
 
+typedef struct r_anal_type_member_t {
+	const char *name;
+	const char *type; // first field of the record, without the offset and array size
+	int offset; // as stored, 0 means right after the previous member
+	int elements; // array size, 0 for scalars
+	int fields; // amount of comma separated fields in the record
+} RAnalTypeMember;
+
+typedef struct r_anal_type_info_t {
+	const char *name;
+	RTypeKind kind;
+	ut64 bitsize; // atomic types only
+	RVector members; // RAnalTypeMember, structs and unions only
+} RAnalTypeInfo;
+
+// native index of the sdb type records, rebuilt lazily after they change
+typedef struct r_anal_typedb_t {
+	Sdb *sdb;
+	bool dirty;
+	RStrConstPool names;
+	HtPP *types; // name => RAnalTypeInfo, NULL for unknown names
+	HtPU *sizes; // type expression => bitsize
+	RPVector structs; // RAnalTypeInfo of every struct, for the lookups by offset
+	bool structs_loaded;
+} RAnalTypeDB;
+
 typedef struct r_anal_t {
 	RArchConfig *config;
 	int lineswidth; // asm.lines.width
@@ -450,6 +477,7 @@ typedef struct r_anal_t {
 	RAnalRange *limit; // anal.from, anal.to
 	RList *plugins; // anal plugins
 	Sdb *sdb_types;
+	RAnalTypeDB *typedb; // parsed view of sdb_types
 	Sdb *sdb_fmts;
 	Sdb *sdb_zigns;
 	RefManager *rm;
@@ -1143,6 +1171,15 @@ R_API RList *r_anal_get_fcns(RAnal *anal);
 R_API void r_anal_remove_parsed_type(RAnal *anal, const char *name);
 R_API void r_anal_save_parsed_type(RAnal *anal, const char *parsed);
 
+/* typedb */
+R_API RAnalTypeDB *r_anal_typedb_new(Sdb *sdb);
+R_API void r_anal_typedb_free(RAnalTypeDB *db);
+R_API void r_anal_typedb_invalidate(RAnalTypeDB *db);
+R_API const RAnalTypeInfo *r_anal_typedb_get(RAnalTypeDB *db, const char *name);
+R_API ut64 r_anal_typedb_bitsize(RAnalTypeDB *db, const char *type);
+R_API char *r_anal_typedb_member_at(RAnalTypeDB *db, const char *type, int offset);
+R_API RList *r_anal_typedb_by_offset(RAnalTypeDB *db, ut64 offset);
+
 /* var.c */
 R_API R_OWN char *r_anal_function_autoname_var(RAnalFunction *fcn, char kind, const char *pfx, int ptr);
 R_API R_BORROW RAnalVar *r_anal_function_set_var(RAnalFunction *fcn, int delta, char kind, R_NULLABLE const char *type, int size, bool isarg, R_NONNULL const char *name);
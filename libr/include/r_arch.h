@@ -127,6 +127,28 @@ typedef struct r_arch_t {
 	char *platform;
 } RArch;
 
+typedef void *(*RArchDecoderNew)(struct r_arch_session_t *s);
+typedef void (*RArchDecoderFree)(void *ctx);
+
+// decoder context created by the plugin for a config in a thread
+typedef struct r_arch_decoder_t {
+	ut64 tid;
+	int bits;
+	int syntax;
+	bool bigendian;
+	char *cpu;
+	void *ctx;
+	struct r_arch_decoder_t *next;
+} RArchDecoder;
+
+typedef struct r_arch_decoders_t {
+	ut32 id;
+	HtUP *ht; // hash of the config and thread => RArchDecoder list
+	RThreadLock *lock; // only taken to look up or add decoders
+	RArchDecoderNew dnew;
+	RArchDecoderFree dfree;
+} RArchDecoders;
+
 typedef struct r_arch_session_t {
 	char *name; // used by .use to chk if it was set already
 	// TODO: name it "peer" instead of encoder. so the encoder can back reference the decoder
@@ -136,6 +158,7 @@ typedef struct r_arch_session_t {
 	RArchConfig *config; // TODO remove arch->config and keep archsession->config
 	void *data; // store plugin-specific data
 	void *user; // holds user pointer provided by user
+	RArchDecoders *decoders; // pool of decoder contexts used by the plugin
 	R_REF_TYPE;
 } RArchSession;
 
@@ -209,6 +232,10 @@ R_API bool r_arch_session_encode(RArchSession *as, RAnalOp *op, RArchEncodeMask
 R_API bool r_arch_session_patch(RArchSession *as, RAnalOp *op, RArchModifyMask mask);
 R_API int r_arch_session_info(RArchSession *as, int q);
 R_API RList *r_arch_session_preludes(RArchSession *as);
+R_API bool r_arch_session_decoders_init(RArchSession *as, RArchDecoderNew dnew, RArchDecoderFree dfree);
+R_API void r_arch_session_decoders_fini(RArchSession *as);
+R_API void *r_arch_session_decoder(RArchSession *as);
+R_API void r_arch_session_decoder_release(RArchSession *as);
 
 // arch.c
 R_API RArch *r_arch_new(void);
@@ -35,6 +35,28 @@ typedef struct r_asm_code_t {
 	int code_align;
 } RAsmCode;
 
+// instruction decoded by r_asm_batch_disassemble()
+typedef struct r_asm_insn_t {
+	ut64 addr;
+	ut32 text; // offset of the text in the arena of the batch
+	ut32 mnem; // interned mnemonic, see r_asm_batch_mnemonic()
+	ut16 size;
+	ut16 textlen;
+	ut16 ops; // offset of the operands in the text
+	ut16 opslen;
+} RAsmInsn;
+
+typedef struct r_asm_batch_t {
+	struct r_asm_t *a;
+	RVector insns; // RAsmInsn
+	char *arena; // nul terminated texts of the instructions
+	ut32 arenalen;
+	ut32 arenasize;
+	RPVector mnems;
+	HtPU *mnemids; // mnemonic => id
+	RAnalOp op; // reused to decode every instruction
+} RAsmBatch;
+
 typedef RList* (*RAnalVarList)(RAnalFunction *fcn, int kind);
 
 typedef struct r_parse_t {
@@ -136,6 +158,14 @@ R_API int r_asm_syntax_from_string(const char *name);
 R_API int r_asm_set_pc(RAsm *a, ut64 pc);
 R_API int r_asm_disassemble(RAsm *a, RAnalOp *op, const ut8 *buf, int len);
 R_API RAsmCode* r_asm_mdisassemble(RAsm *a, const ut8 *buf, int len);
+R_API RAsmBatch *r_asm_batch_new(RAsm *a);
+R_API void r_asm_batch_free(RAsmBatch *b);
+R_API void r_asm_batch_reset(RAsmBatch *b);
+R_API int r_asm_batch_disassemble(RAsmBatch *b, ut64 addr, const ut8 *buf, int len, int count);
+R_API bool r_asm_batch_set_text(RAsmBatch *b, RAsmInsn *insn, const char *text);
+R_API const char *r_asm_batch_text(RAsmBatch *b, const RAsmInsn *insn);
+R_API const char *r_asm_batch_mnemonic(RAsmBatch *b, ut32 id);
+R_API void r_asm_batch_filter(RAsmBatch *b, RFlag *f);
 R_API RAsmCode* r_asm_mdisassemble_hexstr(RAsm *a, RParse *p, const char *hexstr);
 R_API RAsmCode* r_asm_massemble(RAsm *a, const char *buf);
 R_API RAsmCode* r_asm_rasm_assemble(RAsm *a, const char *buf, bool use_spp);
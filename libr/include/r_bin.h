@@ -8,6 +8,7 @@
 #include <r_io.h>
 #include <r_cons.h>
 #include <r_list.h>
+#include <sdb/ht_uu.h>
 
 typedef struct r_bin_t RBin;
 
@@ -476,6 +477,7 @@ struct r_bin_t {
 	bool demangle_usecmd;
 	bool demangle_trylib;
 	bool verbose;
+	bool use_mmap; // map regular files read-only instead of reading them through io
 	bool use_xtr; // use extract plugins when loading a file?
 	bool use_ldr; // use loader plugins when loading a file?
 	RStrConstPool constpool;
@@ -650,6 +652,22 @@ typedef struct r_bin_reloc_t {
 	bool is_ifunc;
 } RBinReloc;
 
+// a pending write of a relocated value
+typedef struct r_bin_patch_t {
+	ut64 addr;
+	ut32 seq; // insertion order
+	ut32 prev; // previous patch at the same address or UT32_MAX
+	ut8 size;
+	ut8 data[8];
+} RBinPatch;
+
+// queues reloc patches to write them to the io overlay in batches
+typedef struct r_bin_patch_batch_t {
+	RIOBind *iob;
+	RVector patches; // RBinPatch
+	HtUU *last; // addr -> seq of the last patch queued there
+} RBinPatchBatch;
+
 typedef struct r_bin_string_t {
 	char *string; // TODO: rename to text or so
 	ut64 vaddr;
@@ -801,6 +819,11 @@ R_API const RList *r_bin_get_imports(RBin *bin);
 R_API RList *r_bin_get_libs(RBin *bin);
 R_API RRBTree *r_bin_patch_relocs(RBinFile *bin);
 R_API RRBTree *r_bin_get_relocs(RBin *bin);
+R_API void r_bin_patch_batch_init(RBinPatchBatch *pb, RIOBind *iob);
+R_API void r_bin_patch_batch_fini(RBinPatchBatch *pb);
+R_API bool r_bin_patch_batch_add(RBinPatchBatch *pb, ut64 addr, const ut8 *data, int size);
+R_API bool r_bin_patch_batch_read(RBinPatchBatch *pb, ut64 addr, ut8 *buf, int len);
+R_API int r_bin_patch_batch_flush(RBinPatchBatch *pb);
 R_API RList *r_bin_get_sections(RBin *bin);
 R_API RList *r_bin_get_classes(RBin *bin);
 R_API RList *r_bin_get_strings(RBin *bin);
@@ -891,6 +914,7 @@ R_API RBinSection *r_bin_get_section_at(RBinObject *o, ut64 off, int va);
 R_API bool r_bin_addr2line(RBin *bin, ut64 addr, char *file, int len, int *line, int *column);
 R_API char *r_bin_addr2text(RBin *bin, ut64 addr, int origin);
 R_API char *r_bin_addr2fileline(RBin *bin, ut64 addr);
+R_API void r_bin_addrinfo_load(RBin *bin);
 /* bin_write.c */
 R_API bool r_bin_wr_addlib(RBin *bin, const char *lib);
 R_API ut64 r_bin_wr_scn_resize(RBin *bin, const char *name, ut64 size);
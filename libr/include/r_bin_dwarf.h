@@ -856,6 +856,35 @@ typedef struct r_bin_dwarf_loc_list_t {
 	ut64 offset;
 } RBinDwarfLocList;
 
+// compact address to line entry of the lazy line index
+typedef struct r_bin_dwarf_line_addr_t {
+	ut64 addr;
+	const char *file; // interned in RBinDwarfLineIndex.files
+	ut32 line;
+	ut32 column;
+} RBinDwarfLineAddr;
+
+typedef struct r_bin_dwarf_cu_range_t {
+	ut64 offset; // of the unit in .debug_info
+	ut64 stmt_list; // offset of the line program in .debug_line
+	ut64 lo;
+	ut64 hi;
+	ut64 hi_max; // highest hi of this and the previous known ranges
+	bool parsed;
+} RBinDwarfCURange;
+
+typedef struct r_bin_dwarf_line_index_t {
+	RBinDwarfCURange *cus;
+	size_t cus_count;
+	size_t cus_known; // units with a known range, sorted by lo, the others follow
+	size_t cus_pending; // units whose line program was not parsed yet
+	bool filled; // all the rows were copied into the addrinfo sdb
+	RBinDwarfLineAddr *rows; // sorted by address
+	size_t rows_count;
+	size_t rows_capacity;
+	RStrConstPool files;
+} RBinDwarfLineIndex;
+
 #define r_bin_dwarf_line_new(o,a,f,l) o->address=a, o->file = strdup (r_str_get (f)), o->line = l, o->column =0,o
 
 R_API void r_bin_dwarf_parse_aranges(RBin *a, int mode);
@@ -867,6 +896,10 @@ R_API void r_bin_dwarf_print_loc(HtUP /*<offset, RBinDwarfLocList*>*/  *loc_tabl
 R_API void r_bin_dwarf_free_loc(HtUP /*<offset, RBinDwarfLocList*>*/  *loc_table);
 R_API void r_bin_dwarf_free_debug_info(RBinDwarfDebugInfo *inf);
 R_API void r_bin_dwarf_free_debug_abbrev(RBinDwarfDebugAbbrev *da);
+R_API RBinDwarfLineIndex *r_bin_dwarf_index_lines(RBin *bin);
+R_API const RBinDwarfLineAddr *r_bin_dwarf_line_index_at(RBin *bin, RBinDwarfLineIndex *li, ut64 addr);
+R_API void r_bin_dwarf_line_index_fill(RBin *bin, RBinDwarfLineIndex *li);
+R_API void r_bin_dwarf_line_index_free(RBinDwarfLineIndex *li);
 
 #ifdef __cplusplus
 }
@@ -50,10 +50,43 @@ typedef struct r_config_t {
 	RList *nodes;
 	HtPP *ht;
 	bool lock;
+	ut32 gen; // bumped on every change, used to invalidate the snapshots
 	/*was the struct modified after the last project save*/
 	R_DIRTY_VAR;
 } RConfig;
 
+typedef enum {
+	R_CONFIG_SNAP_BOOL, // bool
+	R_CONFIG_SNAP_INT, // int
+	R_CONFIG_SNAP_UT64, // ut64
+	R_CONFIG_SNAP_STR, // const char *
+} RConfigSnapType;
+
+typedef struct r_config_snap_field_t {
+	const char *name;
+	RConfigSnapType type;
+	size_t offset;
+} RConfigSnapField;
+
+#define R_CONFIG_SNAP_FIELD(st, name, type, field) { name, R_CONFIG_SNAP_##type, r_offsetof (st, field) }
+
+typedef struct r_config_snap_value_t {
+	RConfigNode *node;
+	bool dynamic; // the node has a getter, so it is read every time
+	ut64 i;
+	const char *s;
+} RConfigSnapValue;
+
+// pre-resolved typed values of a set of config vars, only looked up again after the config changes
+typedef struct r_config_snap_t {
+	RConfig *cfg;
+	ut32 gen;
+	const RConfigSnapField *fields;
+	size_t count;
+	RConfigSnapValue *values;
+	size_t dynamic;
+} RConfigSnap;
+
 typedef struct r_config_hold_t {
 	RConfig *cfg;
 	RList *list;
@@ -96,6 +129,11 @@ R_API bool r_config_readonly(RConfig *cfg, const char *key);
 R_API bool r_config_set_setter(RConfig *cfg, const char *key, RConfigCallback cb);
 R_API bool r_config_set_getter(RConfig *cfg, const char *key, RConfigCallback cb);
 
+R_API RConfigSnap *r_config_snap_new(RConfig *cfg, const RConfigSnapField *fields, size_t count);
+R_API void r_config_snap_free(RConfigSnap *snap);
+R_API bool r_config_snap_refresh(RConfigSnap *snap, RConfig *cfg);
+R_API void r_config_snap_load(RConfigSnap *snap, RConfig *cfg, void *dst);
+
 R_API void r_config_serialize(R_NONNULL RConfig *config, R_NONNULL Sdb *db);
 R_API bool r_config_unserialize(R_NONNULL RConfig *config, R_NONNULL Sdb *db, R_NULLABLE char **err);
 
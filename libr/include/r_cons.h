@@ -480,6 +480,16 @@ typedef struct input_state_t {
 	bool bufactive;
 } InputState;
 
+// what was written in each row of the terminal by the last visual flush
+typedef struct r_cons_screen_t {
+	ut64 *rows; // hash of the contents of each row
+	int nrows;
+	int ncols;
+	bool valid;
+	int drawn; // rows written by the last frame
+	ut64 input; // time of the last key read, to measure the latency
+} RConsScreen;
+
 typedef struct r_cons_t {
 	RConsContext *context;
 	InputState input_state;
@@ -488,6 +498,8 @@ typedef struct r_cons_t {
 	int rows;
 	int echo; // dump to stdout in realtime
 	int fps;
+	bool damage; // visual flushes only write the rows that changed
+	RConsScreen screen;
 	int columns;
 	int force_rows;
 	int force_columns;
@@ -947,6 +959,7 @@ R_API void r_cons_2048(bool color);
 R_API void r_cons_memset(char ch, int len);
 R_API void r_cons_visual_flush(void);
 R_API void r_cons_visual_write(char *buffer);
+R_API void r_cons_visual_invalidate(void);
 R_API bool r_cons_is_utf8(void);
 R_API bool r_cons_is_windows(void);
 R_API void r_cons_cmd_help(const char * const help[], bool use_color);
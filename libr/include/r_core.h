@@ -254,6 +254,8 @@ typedef struct r_core_visual_t {
 	int mousemode;
 	bool graphCursor;
 	bool coming_from_vmark;
+	RList *views; // rendered print commands, see scr.vcache
+	ut64 viewgen;
 } RCoreVisual;
 
 typedef struct {
@@ -266,6 +268,57 @@ typedef struct {
 
 R_API void r_core_gadget_free(RCoreGadget *g);
 
+typedef struct r_core_rop_gadget_t {
+	ut32 ninstr;
+	ut32 size;
+	ut8 *bytes;
+	int *sizes; // size of each instruction
+	char **opstr; // mnemonic of each instruction
+} RCoreRopGadget;
+
+typedef struct r_core_rop_hit_t {
+	ut64 addr;
+	ut64 end; // address of the end instruction
+	ut32 gadget; // index in the database
+	ut32 section; // index of the end instruction in the map
+	ut32 delay; // branch delay slots of the end instruction
+} RCoreRopHit;
+
+typedef struct r_core_rop_map_t {
+	ut64 addr;
+	ut64 size;
+	RVector hits; // RCoreRopHit, in the order /R visits them
+} RCoreRopMap;
+
+// what rop_classify() found for a sequence of esil expressions
+typedef struct r_core_rop_class_t {
+	int nop;
+	char *mov;
+	char *constant;
+	char *arithm;
+	char *arithm_ct;
+} RCoreRopClass;
+
+typedef struct r_core_rop_db_t {
+	RPVector gadgets; // RCoreRopGadget, unique bytes and mnemonics
+	HtPU *dedup; // gadget bytes and mnemonics => index
+	HtPP *maps; // contents hash and search options => RCoreRopMap
+	HtPP *classes; // arch, bits and esil expressions => RCoreRopClass
+	ut32 nclasses; // dropped all at once when reaching ROPDB_MAXCLASSES
+} RCoreRopDB;
+
+R_API RCoreRopDB *r_core_ropdb_new(void);
+R_API void r_core_ropdb_free(RCoreRopDB *db);
+R_API ut32 r_core_ropdb_add_gadget(RCoreRopDB *db, const ut8 *bytes, int *sizes, char **opstr, ut32 ninstr);
+R_API RCoreRopGadget *r_core_ropdb_gadget(RCoreRopDB *db, ut32 idx);
+R_API RCoreRopMap *r_core_ropdb_map_get(RCoreRopDB *db, const char *key);
+R_API RCoreRopMap *r_core_ropdb_map_add(RCoreRopDB *db, const char *key, ut64 addr, ut64 size);
+R_API void r_core_ropdb_map_del(RCoreRopDB *db, const char *key);
+R_API const RCoreRopClass *r_core_ropdb_class_get(RCoreRopDB *db, const char *key);
+R_API bool r_core_ropdb_class_add(RCoreRopDB *db, const char *key, RCoreRopClass *c);
+R_API bool r_core_ropdb_save(RCoreRopDB *db, const char *key, const char *file);
+R_API RCoreRopMap *r_core_ropdb_load(RCoreRopDB *db, const char *key, const char *file, ut64 addr, ut64 size);
+
 typedef struct r_core_tasks_t {
 	int task_id_next;
 	RList *tasks;
@@ -332,6 +385,7 @@ typedef struct RCorePriv RCorePriv;
 struct r_core_t {
 	RBin *bin;
 	RConfig *config;
+	RConfigSnap *ds_snap; // disasm config vars, refreshed when the config changes
 	RProject *prj;
 	ut64 offset; // current seek
 	ut64 prompt_offset; // temporarily set to offset to have $$ in expressions always stay the same during temp seeks
@@ -422,6 +476,8 @@ struct r_core_t {
 	bool scr_gadgets;
 	bool log_events; // core.c:cb_event_handler : log actions from events if cfg.log.events is set
 	RList *ropchain;
+	RCoreRopDB *ropdb; // gadgets found by /R, created on first use
+	struct r_core_asm_index_t *asmidx; // decoded instructions of the searched ranges, see search.index
 	char *theme;
 	char *themepath;
 	bool allbins;
@@ -641,6 +697,9 @@ R_API int r_core_set_file_by_name(RBin * bin, const char *name);
 
 R_API void r_core_debug_rr(RCore *core, RReg *reg, int mode);
 
+/* cfs.c */
+extern RIOPlugin r_io_plugin_rfs;
+
 /* fortune */
 R_IPI void cmd_aei(RCore *core);
 R_IPI RList *r_core_fortune_types(void);
@@ -746,6 +805,44 @@ typedef struct r_core_asm_hit {
 	ut8 valid;
 } RCoreAsmHit;
 
+// what r_anal_op() returned for an instruction with the basic mask
+typedef struct r_core_asm_index_op_t {
+	int ret;
+	int size;
+	ut32 type;
+	int direction;
+	ut64 jump;
+	ut64 ptr;
+	ut64 val;
+	ut64 disp;
+} RCoreAsmIndexOp;
+
+typedef struct r_core_asm_index_seg_t {
+	ut64 addr;
+	ut64 size;
+	ut8 *state; // R_CORE_ASM_INDEX_* bits of each offset
+	ut8 *len; // r_asm_disassemble() length
+	ut32 *mnem; // mnemonic id
+	ut32 *op; // index in ops
+} RCoreAsmIndexSeg;
+
+#define R_CORE_ASM_INDEX_DISASM 1
+#define R_CORE_ASM_INDEX_ANAL 2
+#define R_CORE_ASM_INDEX_WINDOW 0x1000
+
+typedef struct r_core_asm_index_t {
+	RCore *core;
+	char *key; // config the instructions were decoded with
+	ut64 mts; // io->mts when the index was filled
+	ut32 iogen; // io write generation, see R_DIRTY_GEN
+	RPVector segs; // RCoreAsmIndexSeg
+	RPVector mnems; // interned mnemonics, by id
+	HtPU *mnemids; // mnemonic => id
+	RVector ops; // RCoreAsmIndexOp
+	ut64 bufaddr;
+	ut8 buf[R_CORE_ASM_INDEX_WINDOW + 32];
+} RCoreAsmIndex;
+
 R_API RBuffer *r_core_syscall(RCore *core, const char *name, const char *args);
 R_API RBuffer *r_core_syscallf(RCore *core, const char *name, const char *fmt, ...) R_PRINTF_CHECK(3, 4);
 R_API RCoreAsmHit *r_core_asm_hit_new(void);
@@ -758,6 +855,13 @@ R_API RList *r_core_asm_bwdisassemble(RCore *core, ut64 addr, int n, int len);
 R_API RList *r_core_asm_back_disassemble_instr(RCore *core, ut64 addr, int len, ut32 hit_count, ut32 extra_padding);
 R_API RList *r_core_asm_back_disassemble_byte(RCore *core, ut64 addr, int len, ut32 hit_count, ut32 extra_padding);
 R_API ut32 r_core_asm_bwdis_len(RCore* core, int* len, ut64* start_addr, ut32 l);
+R_API RCoreAsmIndex *r_core_asm_index_new(RCore *core);
+R_API void r_core_asm_index_free(RCoreAsmIndex *ai);
+R_API void r_core_asm_index_reset(RCoreAsmIndex *ai);
+R_API RCoreAsmIndex *r_core_asm_index(RCore *core, ut64 from, ut64 to);
+R_API int r_core_asm_index_disasm(RCoreAsmIndex *ai, ut64 addr, ut32 *mnem);
+R_API const char *r_core_asm_index_mnemonic(RCoreAsmIndex *ai, ut32 mnem);
+R_API const RCoreAsmIndexOp *r_core_asm_index_op(RCoreAsmIndex *ai, ut64 addr);
 
 
 enum r_pdu_condition_t {
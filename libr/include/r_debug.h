@@ -172,6 +172,9 @@ typedef struct r_debug_snap_t {
 	ut64 addr_end;
 	ut32 size;
 	ut8 *data;
+	// checkpoint snapshots keep SNAP_PAGE_SIZE chunks shared with other
+	// checkpoints instead of the data, see r_debug_snap_data()
+	ut8 **pages;
 	int perm;
 	int user;
 	bool shared;
@@ -179,6 +182,10 @@ typedef struct r_debug_snap_t {
 	char *comment;
 } RDebugSnap;
 
+// memory accessors used to take and restore the checkpoint snapshots
+typedef bool (*RDebugSnapRead)(void *user, ut64 addr, ut8 *buf, int len);
+typedef bool (*RDebugSnapWrite)(void *user, ut64 addr, const ut8 *buf, int len);
+
 typedef struct {
 	int cnum;
 	ut64 data;
@@ -204,6 +211,9 @@ typedef struct r_debug_session_t {
 	HtUP *registers; /* RVector<RDebugChangeReg> */
 	int reasontype /*RDebugReasonType*/;
 	RBreakpointItem *bp;
+	RPVector pages; // owns the memory pages of all the checkpoints
+	HtUP *pagehash; // hash of the contents => page, to share identical pages
+	int softdirty_pid; // the soft-dirty bits of this pid were cleared at the last checkpoint
 } RDebugSession;
 
 /* Session file format */
@@ -237,6 +247,16 @@ typedef struct r_debug_trace_t {
 	HtPP *ht; // use rbtree like the iocache?
 } RDebugTrace;
 
+#define R_DEBUG_BTRACE_MAGIC "r2bt"
+#define R_DEBUG_BTRACE_VERSION 1
+
+// run of instructions executed without branching, stored by r_debug_btrace
+typedef struct r_debug_btrace_entry_t {
+	ut64 addr;
+	ut32 size;
+	ut32 ninstr;
+} RDebugBTraceEntry;
+
 // R2_590 rename to traceitem for consistency?
 #define r_debug_tracepoint_free(x) free((x))
 typedef struct r_debug_tracepoint_t {
@@ -594,6 +614,9 @@ R_API RDebugTracepoint *r_debug_trace_add(RDebug *dbg, ut64 addr, int size);
 R_API RDebugTrace *r_debug_trace_new(void);
 R_API void r_debug_trace_free(RDebugTrace *dbg);
 R_API int r_debug_trace_tag(RDebug *dbg, int tag);
+R_API int r_debug_btrace(RDebug *dbg, const char *file, ut64 until);
+R_API bool r_debug_btrace_list(RDebug *dbg, const char *file, int mode);
+R_API int r_debug_btrace_load(RDebug *dbg, const char *file);
 R_API int r_debug_child_fork(RDebug *dbg);
 R_API int r_debug_child_clone(RDebug *dbg);
 
@@ -628,12 +651,15 @@ R_API bool r_debug_trace_ins_after(RDebug *dbg);
 
 R_API RDebugSession *r_debug_session_new(void);
 R_API void r_debug_session_free(RDebugSession *session);
+R_API RDebugSnap *r_debug_session_snap(RDebugSession *session, RDebugMap *map, const ut8 *dirty, RDebugSnapRead read, void *user);
 
 R_API RDebugSnap *r_debug_snap_map(RDebug *dbg, RDebugMap *map);
 R_API bool r_debug_snap_contains(RDebugSnap *snap, ut64 addr);
 R_API ut8 *r_debug_snap_get_hash(RDebugSnap *snap);
 R_API bool r_debug_snap_is_equal(RDebugSnap *a, RDebugSnap *b);
 R_API void r_debug_snap_free(RDebugSnap *snap);
+R_API const ut8 *r_debug_snap_data(RDebugSnap *snap);
+R_API void r_debug_snap_restore(RDebugSnap *snap, RDebugSnapWrite write, void *user);
 
 /* snap */
 R_API int r_debug_snap_delete(RDebug *dbg, int idx);
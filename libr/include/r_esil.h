@@ -50,15 +50,44 @@ typedef struct r_esil_handler_t {
 	void *user;
 } REsilHandler;
 
-typedef struct r_esil_change_reg_t {
+typedef enum {
+	R_ESIL_TRACE_CHANGE_REG,
+	R_ESIL_TRACE_CHANGE_MEM,
+	R_ESIL_TRACE_CHANGE_PC, // program counter when the op starts
+} REsilTraceChangeType;
+
+// one register or up to 8 bytes of memory changed by the op at idx
+typedef struct r_esil_trace_change_t {
 	int idx;
-	ut64 data;
-} REsilRegChange;
+	ut8 type; // REsilTraceChangeType
+	ut8 size; // bytes of memory
+	union {
+		const char *reg; // interned in the trace db
+		ut64 addr;
+	};
+	union {
+		ut64 value;
+		ut8 bytes[8];
+	};
+} REsilTraceChange;
 
-typedef struct r_esil_change_mem_t {
+// state of the vm right before the op at idx was executed
+typedef struct r_esil_trace_snap_t {
 	int idx;
-	ut8 data;
-} REsilMemChange;
+	ut64 change; // sequence number of the first change recorded after it
+	RRegArena *arena[R_REG_TYPE_LAST];
+	// contents of the pages dirtied since the previous snapshot, the
+	// first snapshot holds the original contents of every dirtied page
+	HtUP *pages;
+} REsilTraceSnap;
+
+static inline void r_esil_trace_snap_fini(REsilTraceSnap *snap) {
+	int i;
+	for (i = 0; i < R_REG_TYPE_LAST; i++) {
+		r_reg_arena_free (snap->arena[i]);
+	}
+	ht_up_free (snap->pages);
+}
 
 typedef struct {
 	const char *name;
@@ -85,8 +114,20 @@ typedef struct {
 	ut64 addr;
 	ut32 start;
 	ut32 end; // 1 past the end of the op for this index
+	// summary of the accesses, so the common queries don't walk them
+	ut64 reg_read; // r_esil_trace_regbit() of every register read
+	ut64 reg_write; // r_esil_trace_regbit() of every register written
+	ut32 first_reg_write; // index in the accesses, UT32_MAX if none
+	ut32 first_mem_write; // index in the accesses, UT32_MAX if none
+	bool mem_read;
 } REsilTraceOp;
 
+// registers are hashed into a 64 bit signature, a clear bit means the
+// register is not there, a set one must be confirmed with the accesses
+static inline ut64 r_esil_trace_regbit(const char *name) {
+	return 1ULL << (r_str_hash (name) & 63);
+}
+
 static inline void fini_access(REsilTraceAccess *access) {
 	if (access->is_reg) {
 		return;
@@ -96,11 +137,15 @@ static inline void fini_access(REsilTraceAccess *access) {
 
 R_VEC_TYPE(RVecTraceOp, REsilTraceOp);
 R_VEC_TYPE_WITH_FINI(RVecAccess, REsilTraceAccess, fini_access);
+R_VEC_TYPE_WITH_FINI(RVecTraceSnap, REsilTraceSnap, r_esil_trace_snap_fini);
 
 typedef struct {
-	RVecTraceOp ops;
-	RVecAccess accesses;
+	RVecTraceOp ops; // ops[0] is the op at index ops_first
+	RVecAccess accesses; // the start, end and first_* of the ops index this
+	int ops_first; // the ops before the oldest snapshot are dropped with it
+	ut64 datasize; // bytes of the mem.data strings of the accesses
 	HtUU *loop_counts;
+	RStrConstPool regnames; // owns the reg.name of the accesses
 } REsilTraceDB;
 
 typedef struct r_esil_trace_t {
@@ -108,12 +153,16 @@ typedef struct r_esil_trace_t {
 	int idx;
 	int end_idx;
 	int cur_idx;
-	HtUP *registers;
-	HtUP *memory;
-	RRegArena *arena[R_REG_TYPE_LAST];
+	// ring buffer with the changes needed to step back
+	REsilTraceChange *changes;
+	ut32 changes_size;
+	ut32 changes_head; // slot of the oldest change
+	ut64 changes_first; // sequence number of the oldest change
+	ut64 changes_count; // sequence number of the next change
+	RVecTraceSnap snaps; // never empty, the first one is the oldest restorable state
+	HtUU *dirty; // pages written since the last snapshot
 	ut64 stack_addr;
 	ut64 stack_size;
-	ut8 *stack_data;
 } REsilTrace;
 
 typedef bool (*REsilHookRegWriteCB)(ESIL *esil, const char *name, ut64 *val);
@@ -248,6 +297,7 @@ typedef struct r_esil_t {
 	/* deep esil parsing fills this */
 	Sdb *stats;
 	REsilTrace *trace;
+	ut64 trace_maxmem; // esil.trace.maxmem, memory budget of the trace in bytes, 0 for unlimited
 	REsilRegInterface reg_if;
 	REsilMemInterface mem_if;
 	RIDStorage voyeur[R_ESIL_VOYEUR_LAST];
@@ -422,6 +472,11 @@ R_API void r_esil_trace_show(REsil *esil, int idx, int format);
 R_API void r_esil_trace_restore(REsil *esil, int idx);
 R_API ut64 r_esil_trace_loopcount(REsilTrace *etrace, ut64 addr);
 R_API void r_esil_trace_loopcount_increment(REsilTrace *etrace, ut64 addr);
+R_API const char *r_esil_trace_regwrite(REsilTrace *etrace, ut32 idx);
+R_API bool r_esil_trace_regwrite_contains(REsilTrace *etrace, ut32 idx, const char *rname);
+R_API bool r_esil_trace_regread_value(REsilTrace *etrace, ut32 idx, const char *rname, ut64 *value);
+R_API bool r_esil_trace_memwrite_addr(REsilTrace *etrace, ut32 idx, ut64 *addr);
+R_API bool r_esil_trace_have_memread(REsilTrace *etrace, ut32 idx);
 
 R_API bool r_esil_reg_write_silent(REsil *esil, const char *name, ut64 num);
 R_API bool r_esil_reg_read_nocallback(REsil *esil, const char *regname, ut64 *num, int *size);
@@ -17,6 +17,25 @@ R_LIB_VERSION_HEADER (r_fs);
 struct r_fs_plugin_t;
 struct r_fs_root_t;
 struct r_fs_t;
+struct r_fs_cache_block_t;
+
+// block cache shared by the mounted filesystems, see fs_cache.c
+typedef struct r_fs_cache_t {
+	RIOBind *iob;
+	ut32 bsize;
+	ut32 maxblocks; // 0 disables the cache
+	ut32 maxra; // read-ahead limit in blocks
+	HtUP *blocks; // block index => block
+	struct r_fs_cache_block_t *head; // most recently used
+	struct r_fs_cache_block_t *tail;
+	ut32 nblocks;
+	ut32 npinned;
+	int pinning; // blocks used while > 0 are pinned as metadata
+	ut64 next; // block where a sequential read would continue
+	ut32 ra; // current read-ahead window in blocks
+	ut64 hits;
+	ut64 misses;
+} RFSCache;
 
 typedef struct r_fs_t {
 	RIOBind iob;
@@ -24,8 +43,11 @@ typedef struct r_fs_t {
 	RConsBind csb;
 	RList /*<RFSPlugin>*/ *plugins;
 	RList /*<RFSRoot>*/ *roots;
+	RList /*<RFSFile>*/ *files; // kept open across commands, see r_fs_keep
 	int view;
 	void *ptr;
+	RFSCache *cache;
+	int threads; // used to write the files in r_fs_dir_dump
 } RFS;
 
 typedef struct r_fs_partition_plugin_t {
@@ -54,6 +76,7 @@ typedef struct r_fs_root_t {
 	ut64 delta;
 	struct r_fs_plugin_t *p;
 	void *ptr;
+	RFSCache *cache; // borrowed from the RFS
 	// TODO: deprecate
 	RIOBind iob;
 	RCoreBind cob;
@@ -143,6 +166,9 @@ enum {
 	R_FS_VIEW_ALL = 0xff,
 };
 
+// returns false to stop reading
+typedef bool (*RFSReadCallback)(void *user, ut64 addr, const ut8 *buf, int len);
+
 #ifdef R_API
 R_API RFS *r_fs_new(void);
 R_API void r_fs_free(RFS* fs);
@@ -157,7 +183,10 @@ R_API bool r_fs_umount(RFS* fs, const char *path);
 
 R_API RFSFile *r_fs_open(RFS* fs, const char *path, bool create);
 R_API void r_fs_close(RFS* fs, RFSFile *file);
+R_API bool r_fs_keep(RFS* fs, RFSFile *file);
 R_API int r_fs_read(RFS* fs, RFSFile *file, ut64 addr, int len);
+R_API bool r_fs_read_cb(RFS* fs, RFSFile *file, ut64 addr, ut64 len, RFSReadCallback cb, void *user);
+R_API bool r_fs_read_fd(RFS* fs, RFSFile *file, ut64 addr, ut64 len, int fd);
 R_API int r_fs_write(RFS* fs, RFSFile* file, ut64 addr, const ut8 *data, int len);
 R_API RFSFile *r_fs_slurp(RFS* fs, const char *path);
 R_API RList *r_fs_dir(RFS* fs, const char *path);
@@ -173,6 +202,14 @@ R_API char *r_fs_name(RFS *fs, ut64 offset);
 R_API bool r_fs_check(RFS *fs, const char *p);
 R_API bool r_fs_shell(RFSShell *shell, RFS *fs, const char *root);
 
+/* cache */
+R_API RFSCache *r_fs_cache_new(RIOBind *iob);
+R_API void r_fs_cache_free(RFSCache *c);
+R_API void r_fs_cache_setup(RFSCache *c, ut32 bsize, ut64 size);
+R_API void r_fs_cache_reset(RFSCache *c);
+R_API void r_fs_cache_pin(RFSCache *c, bool enable);
+R_API bool r_fs_cache_read(RFSCache *c, ut64 addr, ut8 *buf, int len);
+
 /* file.c */
 R_API RFSFile *r_fs_file_new(RFSRoot *root, const char *path);
 R_API void r_fs_file_free(RFSFile *file);
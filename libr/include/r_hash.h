@@ -204,6 +204,37 @@ struct r_hash_t {
 	ut8 R_ALIGNED(8) digest[128];
 };
 
+// byte statistics of a block, see r_hash_stats
+typedef struct r_hash_stats_t {
+	ut64 count[256];
+	ut64 size;
+	ut64 zeros;
+	ut64 ffs;
+	ut64 printable;
+	double entropy;
+	double fraction; // same as r_hash_entropy_fraction
+} RHashStats;
+
+// one independent block for r_hash_calculate_blocks
+typedef struct r_hash_block_t {
+	ut64 off; // offset in the input buffer
+	int len;
+	int dlen;
+	double entropy;
+	ut8 R_ALIGNED(8) digest[128];
+} RHashBlock;
+
+// bytes and blocks given at once to r_hash_calculate_blocks
+#define R_HASH_BATCH (64 * 1024 * 1024)
+#define R_HASH_BATCH_BLOCKS 0x10000
+
+// number of blocks of bsize bytes to hash at once when nblocks are left
+static inline size_t r_hash_batch_count(ut64 bsize, ut64 nblocks) {
+	ut64 n = R_HASH_BATCH / R_MAX (bsize, 1);
+	n = R_MIN (R_MIN (n, R_HASH_BATCH_BLOCKS), nblocks);
+	return (size_t)R_MAX (n, 1);
+}
+
 typedef struct r_hash_seed_t {
 	int prefix;
 	ut8 *buf;
@@ -534,6 +565,7 @@ R_API const char *r_hash_name(ut64 bit);
 R_API ut64 r_hash_name_to_bits(const char *name);
 R_API int r_hash_size(ut64 bit);
 R_API int r_hash_calculate(RHash *ctx, ut64 algobit, const ut8 *input, int len);
+R_API bool r_hash_calculate_blocks(ut64 algobit, const ut8 *input, RHashBlock *blocks, int count, int nthreads);
 
 /* checksums */
 /* XXX : crc16 should use 0 as arg0 by default */
@@ -554,6 +586,8 @@ R_API ut64 r_hash_sip(const ut8* buf, ut64 len);
 R_API ut8  r_hash_hamdist(const ut8 *buf, int len);
 R_API double r_hash_entropy(const ut8 *data, ut64 len);
 R_API double r_hash_entropy_fraction(const ut8 *data, ut64 len);
+R_API void r_hash_histogram(const ut8 *data, ut64 len, ut64 count[256]);
+R_API void r_hash_stats(const ut8 *data, ut64 len, RHashStats *st);
 R_API int r_hash_pcprint(const ut8 *buffer, ut64 len);
 
 /* lifecycle */
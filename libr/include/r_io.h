@@ -142,6 +142,7 @@ typedef struct r_io_t {
 	bool overlay;
 	// moved into cache.mode // ut32 cached; // uses R_PERM_RWX // wtf cache for exec?
 	bool cachemode; // write in cache all the read operations (EXPERIMENTAL)
+	R_DIRTY_VAR; // bumped on every write and map layout change
 	ut32 p_cache; // uses 1, 2, 4.. probably R_PERM_RWX :D
 	ut64 mts; // map "timestamps", this sucks somehow
 	RIDStorage files; // RIODescs accessible by their fd
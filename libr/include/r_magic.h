@@ -261,6 +261,9 @@ struct r_magic_set {
 	int magic_file_formats[FILE_NAMES_SIZE];
 	const char *magic_file_names[FILE_NAMES_SIZE];
 	ut32 last_cont_level;
+	/* set while scanning, top level tests with a non zero value here are
+	 * skipped together with that amount of entries */
+	const ut32 *cand;
 };
 
 #if USE_LIB_MAGIC
@@ -269,6 +272,8 @@ struct r_magic_set {
 typedef struct r_magic_set RMagic;
 #endif
 
+typedef struct r_magic_scan_t RMagicScan;
+
 #ifdef R_API
 R_API RMagic* r_magic_new(int flags);
 R_API void r_magic_free(RMagic*);
@@ -286,6 +291,10 @@ R_API bool r_magic_load_buffer(RMagic*, const ut8 *, size_t);
 R_API bool r_magic_compile(RMagic*, const char *);
 R_API bool r_magic_check(RMagic*, const char *);
 R_API int r_magic_errno(RMagic*);
+
+R_API RMagicScan *r_magic_scan_new(RMagic *ms);
+R_API void r_magic_scan_free(RMagicScan *sc);
+R_API const char *r_magic_scan_buffer(RMagicScan *sc, const void *buf, size_t nb);
 #endif
 
 
@@ -8,6 +8,7 @@ extern "C" {
 #include "r_types.h"
 #include "r_bind.h"
 #include "r_list.h"
+#include "r_util/r_strbuf.h"
 
 R_LIB_VERSION_HEADER (r_socket);
 
@@ -48,6 +49,11 @@ R_LIB_VERSION_HEADER (r_socket);
 #define R_INVALID_SOCKET -1
 #endif
 
+/* framed requests sent before reading their replies, the requests in flight
+ * must fit in the pipe or both ends block writing, see r2pipe_send */
+#define R2PIPE_WINDOW 64
+#define R2PIPE_WINDOW_SIZE 4096
+
 typedef struct {
 #if R2__WINDOWS__
 	HANDLE pipe;
@@ -58,8 +64,19 @@ typedef struct {
 	int output[2];
 #endif
 	RCoreBind coreb;
+	bool framed; // length-prefixed frames with request ids
+	ut32 seq; // next request id to use in framed mode
+	ut32 inflight; // requests whose reply was not read yet
+	ut32 inflight_size; // bytes of those requests
+	ut32 inflight_sizes[R2PIPE_WINDOW]; // ring with the size of each one, by id
+	RList *replies; // read by r2pipe_send to make room, returned first by r2pipe_recv
 } R2Pipe;
 
+/* framed r2pipe protocol: [magic:1][id:le32][len:le32][payload:len] */
+#define R2PIPE_FRAME_MAGIC 0x01
+#define R2PIPE_FRAME_HDRSZ 9
+#define R2PIPE_FRAME_MAXSZ (ST32_MAX - R2PIPE_FRAME_HDRSZ)
+
 typedef struct r_socket_t {
 #ifdef _MSC_VER
 	SOCKET fd;
@@ -291,6 +308,13 @@ R_API R2Pipe *r2pipe_open(const char *cmd);
 R_API R2Pipe *r2pipe_open_dl(const char *file);
 R_API char *r2pipe_cmd(R2Pipe *r2pipe, const char *str);
 R_API char *r2pipe_cmdf(R2Pipe *r2pipe, const char *fmt, ...) R_PRINTF_CHECK(2, 3);
+// framed requests (see R2PIPE_FRAME_MAGIC) are only understood by the #!pipe
+// lang host, the `r2 -q0` loop still speaks the NUL terminated protocol
+R_API void r2pipe_set_framed(R2Pipe *r2pipe, bool framed);
+R_API st64 r2pipe_send(R2Pipe *r2pipe, const char *str);
+R_API char *r2pipe_recv(R2Pipe *r2pipe, ut32 *id);
+R_API bool r2pipe_frame_append(RStrBuf *sb, ut32 id, const char *data, size_t len);
+R_API int r2pipe_frame_parse(const ut8 *buf, size_t len, ut32 *id, ut32 *plen);
 #endif
 
 #ifdef __cplusplus
@@ -264,9 +264,11 @@ typedef struct _utX {
 		return m? *m = n, m: m; \
 	}
 
-#define R_DIRTY(x) (x)->is_dirty = true
+#define R_DIRTY(x) do { (x)->is_dirty = true; (x)->dirty_gen++; } while (0)
 #define R_IS_DIRTY(x) (x)->is_dirty
-#define R_DIRTY_VAR bool is_dirty
+// bumped on every change, unlike is_dirty it's never cleared
+#define R_DIRTY_GEN(x) (x)->dirty_gen
+#define R_DIRTY_VAR bool is_dirty; ut32 dirty_gen
 
 #define R_TAG(x) (void*)((size_t)(x)|1)
 #define R_UNTAG(x) (void*)((((size_t)(x))&(size_t)-2))
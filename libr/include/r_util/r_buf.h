@@ -121,6 +121,13 @@ struct r_buf_t {
 	RBufferType type;
 };
 
+// contiguous bytes of a buffer range, see r_buf_span()
+typedef struct r_buf_span_t {
+	const ut8 *data;
+	ut64 len;
+	ut8 *copy; // owned when the buffer is not backed by memory
+} RBufferSpan;
+
 /* constructors */
 R_API RBuffer *r_buf_new(void);
 R_API RBuffer *r_buf_new_with_io(void *iob, int fd);
@@ -171,6 +178,9 @@ R_API st64 r_buf_fwrite_at(RBuffer *b, ut64 addr, const ut8 *buf, const char *fm
 // entire buffer in memory. Consider using the r_buf_read* APIs instead and read
 // only the chunks you need.
 R_DEPRECATE R_API const ut8 *r_buf_data(RBuffer *b, ut64 *size);
+R_API const ut8 *r_buf_view(RBuffer *b, ut64 addr, ut64 len);
+R_API bool r_buf_span(RBuffer *b, ut64 addr, ut64 len, RBufferSpan *span);
+R_API void r_buf_span_fini(RBufferSpan *span);
 R_API ut64 r_buf_size(RBuffer *b);
 R_API bool r_buf_resize(RBuffer *b, ut64 newsize);
 R_API RBuffer *r_buf_ref(RBuffer *b);
@@ -106,6 +106,7 @@ R_API ut32 r_io_bank_first(RIO *io) {
 
 R_API bool r_io_bank_use(RIO *io, ut32 bankid) {
 	R_RETURN_VAL_IF_FAIL (io, false);
+	R_DIRTY (io);
 	RIOBank *bank = r_io_bank_get (io, bankid);
 	if (bank) {
 		io->bank = bankid;
@@ -180,6 +181,7 @@ static RRBNode *_find_entry_submap_node(RIOBank *bank, RIOSubMap *sm) {
 
 R_API bool r_io_bank_map_add_top(RIO *io, const ut32 bankid, const ut32 mapid) {
 	R_RETURN_VAL_IF_FAIL (io, false);
+	R_DIRTY (io);
 	RIOBank *bank = r_io_bank_get (io, bankid);
 	if (!bank) {
 		return false;
@@ -274,6 +276,7 @@ R_API bool r_io_bank_map_add_top(RIO *io, const ut32 bankid, const ut32 mapid) {
 
 R_API bool r_io_bank_map_add_bottom(RIO *io, const ut32 bankid, const ut32 mapid) {
 	R_RETURN_VAL_IF_FAIL (io, false);
+	R_DIRTY (io);
 	RIOBank *bank = r_io_bank_get (io, bankid);
 	if (!bank) {
 		return false;
@@ -324,6 +327,7 @@ R_API bool r_io_bank_map_add_bottom(RIO *io, const ut32 bankid, const ut32 mapid
 
 R_API bool r_io_bank_map_priorize(RIO *io, const ut32 bankid, const ut32 mapid) {
 	R_RETURN_VAL_IF_FAIL (io, false);
+	R_DIRTY (io);
 	RIOBank *bank = r_io_bank_get (io, bankid);
 	if (!bank) {
 		return false;
@@ -499,6 +503,7 @@ static void _delete_submaps_from_bank_tree(RIO *io, RIOBank *bank, RListIter *pr
 
 R_API bool r_io_bank_map_depriorize(RIO *io, const ut32 bankid, const ut32 mapid) {
 	R_RETURN_VAL_IF_FAIL (io, false);
+	R_DIRTY (io);
 	RIOBank *bank = r_io_bank_get (io, bankid);
 	if (!bank) {
 		return false;
@@ -552,6 +557,7 @@ static int _mapref_priority_cmp(RIOBank *bank, RIOMapRef *mr0, RIOMapRef *mr1) {
 
 R_API bool r_io_bank_update_map_boundaries(RIO *io, const ut32 bankid, const ut32 mapid, ut64 ofrom, ut64 oto) {
 	R_RETURN_VAL_IF_FAIL (io, false);
+	R_DIRTY (io);
 	RIOBank *bank = r_io_bank_get (io, bankid);
 	if (!bank) {
 		return false;
@@ -891,6 +897,7 @@ R_API bool r_io_bank_write_at(RIO *io, const ut32 bankid, ut64 addr, const ut8 *
 
 R_API bool r_io_bank_write_to_overlay_at(RIO *io, const ut32 bankid, ut64 addr, const ut8 *buf, int len) {
 	R_RETURN_VAL_IF_FAIL (io, false);
+	R_DIRTY (io);
 	RIOBank *bank = r_io_bank_get (io, bankid);
 	if (!bank) {
 		R_LOG_WARN ("Tfw no bank(id: %u) in io", bankid);
@@ -1128,6 +1135,7 @@ R_API RIOMap *r_io_bank_get_map_at(RIO *io, const ut32 bankid, ut64 addr) {
 // deletes map with mapid from bank with bankid
 R_API void r_io_bank_del_map(RIO *io, const ut32 bankid, const ut32 mapid) {
 	R_RETURN_IF_FAIL (io);
+	R_DIRTY (io);
 	// no need to check for mapref here, since this is "just" deleting
 	RIOBank *bank = r_io_bank_get (io, bankid);
 	RIOMap *map = r_io_map_get (io, mapid);	//is this needed?
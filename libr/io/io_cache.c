@@ -82,6 +82,7 @@ R_API bool r_io_cache_empty(RIO *io) {
 
 R_API void r_io_cache_reset(RIO *io) {
 	R_RETURN_IF_FAIL (io);
+	R_DIRTY (io);
 	ut32 mode = io->cache.mode;
 	r_io_cache_fini (io);
 	r_io_cache_init (io);
@@ -116,6 +117,7 @@ static RRBNode *_find_entry_ci_node(RRBTree *cache_tree, RInterval *itv) {
 // write happens only in the last layer
 R_API bool r_io_cache_write_at(RIO *io, ut64 addr, const ut8 *buf, int len) {
 	R_RETURN_VAL_IF_FAIL (io && buf && (len > 0), false);
+	R_DIRTY (io);
 	if (r_list_empty (io->cache.layers)) {
 		return false;
 	}
@@ -252,6 +254,7 @@ R_API bool r_io_cache_at(RIO *io, ut64 addr) {
 // this uses closed boundary input
 R_API int r_io_cache_invalidate(RIO *io, ut64 from, ut64 to, bool many) {
 	R_RETURN_VAL_IF_FAIL (io && from <= to, 0);
+	R_DIRTY (io);
 	RInterval itv = (RInterval){from, (to + 1) - from};
 	void **iter;
 	ut32 invalidated_cache_bytes = 0;
@@ -547,6 +550,7 @@ R_API bool r_io_cache_pop(RIO *io) {
 	if (!r_list_empty (io->cache.layers)) {
 		RIOCacheLayer *cl = r_list_pop (io->cache.layers);
 		iocache_layer_free (cl);
+		R_DIRTY (io);
 		return true;
 	}
 	return false;
@@ -554,6 +558,7 @@ R_API bool r_io_cache_pop(RIO *io) {
 
 R_API bool r_io_cache_undo(RIO *io) { // "wcu"
 	R_RETURN_VAL_IF_FAIL (io, false);
+	R_DIRTY (io);
 	if (r_list_empty (io->cache.layers)) {
 		return false;
 	}
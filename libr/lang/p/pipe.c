@@ -125,6 +125,69 @@ static void env(const char *s, int f) {
 }
 #endif
 
+#if R2__UNIX__
+// run every complete frame queued in the pending buffer and send all the replies in one write
+static bool lang_pipe_frames(RLangSession *s, RCore *core, RStrBuf *pending, int fd) {
+	int len = 0;
+	ut8 *data = r_strbuf_getbin (pending, &len);
+	RStrBuf *out = r_strbuf_new (NULL);
+	int off = 0;
+	bool ok = true;
+	while (off < len) {
+		ut32 id = 0, plen = 0;
+		int fsz = r2pipe_frame_parse (data + off, len - off, &id, &plen);
+		if (fsz < 0) {
+			R_LOG_ERROR ("r_lang_pipe: invalid frame");
+			ok = false;
+			break;
+		}
+		if (fsz == 0) {
+			break;
+		}
+		char *cmd = r_str_ndup ((const char *)data + off + R2PIPE_FRAME_HDRSZ, plen);
+		char *res = cmd? s->lang->cmd_str (core, cmd): NULL;
+		bool sent = r2pipe_frame_append (out, id, res? res: "", res? strlen (res): 0);
+		free (res);
+		free (cmd);
+		if (!sent) {
+			// the client expects a reply for every request, send an error instead
+			const char *err = "ERROR: cannot send the reply\n";
+			R_LOG_ERROR ("r_lang_pipe: cannot send the reply of request %u", id);
+			if (!r2pipe_frame_append (out, id, err, strlen (err))) {
+				ok = false;
+				break;
+			}
+		}
+		off += fsz;
+	}
+	if (ok) {
+		// keep the partial frame (if any) for the next read
+		if (off < len) {
+			ut8 *rest = r_mem_dup (data + off, len - off);
+			if (rest) {
+				r_strbuf_setbin (pending, rest, len - off);
+				free (rest);
+			}
+		} else {
+			r_strbuf_set (pending, "");
+		}
+		int olen = 0;
+		ut8 *odata = r_strbuf_getbin (out, &olen);
+		while (olen > 0) {
+			int n = write (fd, odata, olen);
+			if (n < 1) {
+				ok = false;
+				break;
+			}
+			odata += n;
+			olen -= n;
+		}
+	}
+	r_strbuf_free (out);
+	return ok;
+}
+#endif
+
 static bool lang_pipe_run(RLangSession *s, const char *code, int len) {
 #if R2__UNIX__
 	int safe_in = dup (0);
@@ -172,7 +235,8 @@ static bool lang_pipe_run(RLangSession *s, const char *code, int len) {
 	} else {
 		RCore *core = R_UNWRAP3 (s, lang, user);
 		/* parent */
-		char *res, buf[8192]; // TODO: use the heap?
+		char buf[8192]; // TODO: use the heap?
+		RStrBuf *pending = r_strbuf_new (NULL);
 		/* Close pipe ends not required in the parent */
 		close (output[1]);
 		close (input[0]);
@@ -188,15 +252,23 @@ static bool lang_pipe_run(RLangSession *s, const char *code, int len) {
 			if (ret < 1) {
 				break;
 			}
+			if (buf[0] == R2PIPE_FRAME_MAGIC || r_strbuf_length (pending) > 0) {
+				r_strbuf_append_n (pending, buf, ret);
+				if (!lang_pipe_frames (s, core, pending, input[1])) {
+					break;
+				}
+				continue;
+			}
 			if (!buf[0]) {
 				continue;
 			}
 			buf[sizeof (buf) - 1] = 0;
-			res = s->lang->cmd_str (core, buf);
+			char *res = s->lang->cmd_str (core, buf);
 			if (res) {
 				// r_cons_print (res);
 				size_t res_len = strlen (res) + 1;
 				if (write (input[1], res, res_len) != res_len) {
+					free (res);
 					break;
 				}
 				free (res);
@@ -207,6 +279,7 @@ static bool lang_pipe_run(RLangSession *s, const char *code, int len) {
 				}
 			}
 		}
+		r_strbuf_free (pending);
 		r_cons_break_pop ();
 		/* workaround to avoid stdin closed */
 		if (safe_in != -1) {
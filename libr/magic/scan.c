@@ -0,0 +1,333 @@
+/* radare - LGPL - Copyright 2024 - pancake */
+
+#include <r_userconf.h>
+#include <r_magic.h>
+#include <r_util.h>
+
+#if USE_LIB_MAGIC
+
+R_API RMagicScan *r_magic_scan_new(RMagic *ms) {
+	return NULL;
+}
+
+R_API void r_magic_scan_free(RMagicScan *sc) {
+}
+
+R_API const char *r_magic_scan_buffer(RMagicScan *sc, const void *buf, size_t nb) {
+	return NULL;
+}
+
+#else
+
+#include <ctype.h>
+#include "file.h"
+#include "tar.h"
+
+// Prefilter for scanning the same magic database at every offset of a range.
+// Most top level tests compare a constant at a fixed offset, those literal
+// bytes are used as anchors, bucketed by offset and first byte, so checking a
+// position only costs a table lookup per distinct offset. The full binary
+// tests are only evaluated for the anchors found there, the rest are skipped
+// in match(). Text tests are not filtered, ascmagic runs them as usual.
+// Tests that can't be anchored (indirect offsets, regex, masks other than and)
+// are always evaluated, so the output is the same as r_magic_buffer().
+
+#define ANCHOR_MAX 8
+
+typedef struct {
+	ut32 entry; // global index of the top level test
+	ut32 skip; // entries until the next top level test
+	ut32 offset;
+	ut32 end; // the test fails when the buffer is smaller than this
+	int len;
+	ut8 bytes[ANCHOR_MAX];
+	ut8 mask[ANCHOR_MAX];
+} MagicAnchor;
+
+typedef struct {
+	ut32 offset;
+	ut32 start[257]; // anchors starting with each byte value in list
+} MagicAnchorOffset;
+
+struct r_magic_scan_t {
+	RMagic *ms;
+	ut32 *cand; // one per magic entry, what match() looks at
+	ut32 nentries;
+	MagicAnchor *anchors;
+	ut32 nanchors;
+	MagicAnchorOffset *offsets;
+	ut32 noffsets;
+	ut32 *list;
+	ut32 *hits; // anchors enabled in the last position
+	ut32 nhits;
+	bool always; // some tests must run everywhere
+};
+
+static bool anchor_number(struct r_magic *m, MagicAnchor *a) {
+	bool be;
+	int size;
+	switch (m->type) {
+	case FILE_BYTE: size = 1; be = false; break;
+	case FILE_SHORT: size = 2; be = R_SYS_ENDIAN; break;
+	case FILE_BESHORT: size = 2; be = true; break;
+	case FILE_LESHORT: size = 2; be = false; break;
+	case FILE_LONG: size = 4; be = R_SYS_ENDIAN; break;
+	case FILE_BELONG: size = 4; be = true; break;
+	case FILE_LELONG: size = 4; be = false; break;
+	case FILE_QUAD: size = 8; be = R_SYS_ENDIAN; break;
+	case FILE_BEQUAD: size = 8; be = true; break;
+	case FILE_LEQUAD: size = 8; be = false; break;
+	default:
+		return false;
+	}
+	ut64 mask = UT64_MAX;
+	if (m->num_mask) {
+		// only the and masks keep the compared bits in place
+		if ((m->mask_op & FILE_OPS_MASK) != FILE_OPAND) {
+			return false;
+		}
+		mask = m->num_mask;
+	}
+	if (m->mask_op & FILE_OPINVERSE) {
+		return false;
+	}
+	r_write_ble (a->bytes, m->value.q & mask, be, size * 8);
+	r_write_ble (a->mask, mask, be, size * 8);
+	a->len = size;
+	a->end = 0;
+	return true;
+}
+
+static bool anchor_string(struct r_magic *m, MagicAnchor *a) {
+	int i, len = R_MIN (m->vallen, ANCHOR_MAX);
+	if (m->str_flags) {
+		return false;
+	}
+	if (m->type == FILE_STRING) {
+		// the data is nul terminated and loses its trailing newline before
+		// the comparison, so only the bytes before the first nul are exact
+		i = 0;
+		while (i < len && m->value.s[i]) {
+			i++;
+		}
+		len = i;
+		a->end = 0;
+	} else if (m->type == FILE_SEARCH && m->str_range == 1) {
+		// searches compare the raw buffer, but the whole string must fit
+		a->end = m->offset + R_MIN (m->vallen, sizeof (m->value.s));
+	} else {
+		return false;
+	}
+	if (len < 1) {
+		return false;
+	}
+	memcpy (a->bytes, m->value.s, len);
+	memset (a->mask, 0xff, len);
+	a->len = len;
+	return true;
+}
+
+static bool anchor_from_magic(struct r_magic *m, MagicAnchor *a) {
+	if ((m->flag & INDIR) || m->reln != '=') {
+		return false;
+	}
+	a->offset = m->offset;
+	return MAGIC_IS_STRING (m->type)? anchor_string (m, a): anchor_number (m, a);
+}
+
+// like mcopy(), the bytes past the end of the buffer read as zeros
+static inline ut8 scan_byte(const ut8 *buf, size_t nb, ut64 off) {
+	return (off < nb)? buf[off]: 0;
+}
+
+static inline bool anchor_match(const MagicAnchor *a, const ut8 *buf, size_t nb) {
+	if (a->end > nb) {
+		return false;
+	}
+	int i;
+	for (i = 0; i < a->len; i++) {
+		if ((scan_byte (buf, nb, (ut64)a->offset + i) & a->mask[i]) != a->bytes[i]) {
+			return false;
+		}
+	}
+	return true;
+}
+
+static int anchor_cmp(const void *_a, const void *_b) {
+	const MagicAnchor *a = _a, *b = _b;
+	return (a->offset > b->offset) - (a->offset < b->offset);
+}
+
+// masked first bytes go in every bucket they can match, counts the entries
+// of the list when it's NULL
+static ut32 scan_buckets(RMagicScan *sc, MagicAnchorOffset *o, ut32 first, ut32 last, ut32 k) {
+	ut32 b, i;
+	for (b = 0; b < 256; b++) {
+		o->start[b] = k;
+		for (i = first; i < last; i++) {
+			const MagicAnchor *a = &sc->anchors[i];
+			if ((b & a->mask[0]) == a->bytes[0]) {
+				if (sc->list) {
+					sc->list[k] = i;
+				}
+				k++;
+			}
+		}
+	}
+	o->start[256] = k;
+	return k;
+}
+
+static bool scan_build(RMagicScan *sc) {
+	RMagic *ms = sc->ms;
+	struct mlist *ml;
+	ut32 i;
+	for (ml = ms->mlist->next; ml != ms->mlist; ml = ml->next) {
+		sc->nentries += ml->nmagic;
+	}
+	const ut32 n = R_MAX (sc->nentries, 1);
+	sc->cand = R_NEWS0 (ut32, n);
+	sc->anchors = R_NEWS0 (MagicAnchor, n);
+	sc->hits = R_NEWS (ut32, n);
+	if (!sc->cand || !sc->anchors || !sc->hits) {
+		return false;
+	}
+	ut32 base = 0;
+	for (ml = ms->mlist->next; ml != ms->mlist; ml = ml->next) {
+		for (i = 0; i < ml->nmagic; i++) {
+			struct r_magic *m = &ml->magic[i];
+			if (m->cont_level) {
+				continue;
+			}
+			ut32 skip = 1;
+			while (i + skip < ml->nmagic && ml->magic[i + skip].cont_level) {
+				skip++;
+			}
+			// the text tests run later on the converted buffer, never skip them
+			if (!(m->flag & BINTEST)) {
+				continue;
+			}
+			MagicAnchor *a = &sc->anchors[sc->nanchors];
+			if (anchor_from_magic (m, a)) {
+				a->entry = base + i;
+				a->skip = skip;
+				sc->cand[a->entry] = skip;
+				sc->nanchors++;
+			} else {
+				sc->always = true;
+			}
+		}
+		base += ml->nmagic;
+	}
+	qsort (sc->anchors, sc->nanchors, sizeof (MagicAnchor), anchor_cmp);
+	for (i = 0; i < sc->nanchors; i++) {
+		if (!i || sc->anchors[i].offset != sc->anchors[i - 1].offset) {
+			sc->noffsets++;
+		}
+	}
+	sc->offsets = R_NEWS0 (MagicAnchorOffset, R_MAX (sc->noffsets, 1));
+	if (!sc->offsets) {
+		return false;
+	}
+	int pass;
+	for (pass = 0; pass < 2; pass++) {
+		ut32 first = 0, k = 0, o = 0;
+		while (first < sc->nanchors) {
+			ut32 last = first + 1;
+			while (last < sc->nanchors && sc->anchors[last].offset == sc->anchors[first].offset) {
+				last++;
+			}
+			sc->offsets[o].offset = sc->anchors[first].offset;
+			k = scan_buckets (sc, &sc->offsets[o++], first, last, k);
+			first = last;
+		}
+		if (!pass) {
+			sc->list = R_NEWS (ut32, R_MAX (k, 1));
+			if (!sc->list) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+R_API void r_magic_scan_free(RMagicScan *sc) {
+	if (sc) {
+		free (sc->cand);
+		free (sc->anchors);
+		free (sc->offsets);
+		free (sc->list);
+		free (sc->hits);
+		free (sc);
+	}
+}
+
+// the magic must be loaded already and stay the same while scanning
+R_API RMagicScan *r_magic_scan_new(RMagic *ms) {
+	R_RETURN_VAL_IF_FAIL (ms, NULL);
+	if (!ms->mlist) {
+		return NULL;
+	}
+	RMagicScan *sc = R_NEW0 (RMagicScan);
+	if (!sc) {
+		return NULL;
+	}
+	sc->ms = ms;
+	if (!scan_build (sc)) {
+		r_magic_scan_free (sc);
+		return NULL;
+	}
+	return sc;
+}
+
+// cheap necessary condition for is_tar(): the checksum field must be octal
+static bool maybe_tar(const ut8 *buf, size_t nb) {
+	if (nb < sizeof (union record)) {
+		return false;
+	}
+	const ut8 c = buf[offsetof (union record, header.chksum)];
+	return isspace ((int)c) || (c >= '0' && c <= '7');
+}
+
+/* Same as r_magic_buffer() but only running the anchored tests whose literal
+ * bytes are found in buf. Returns NULL when nothing matches, without calling
+ * into the magic at all when no test can match */
+R_API const char *r_magic_scan_buffer(RMagicScan *sc, const void *buf, size_t nb) {
+	R_RETURN_VAL_IF_FAIL (sc && buf, NULL);
+	RMagic *ms = sc->ms;
+	const ut8 *data = buf;
+	ut32 i, j;
+	sc->nhits = 0;
+	for (i = 0; i < sc->noffsets; i++) {
+		const MagicAnchorOffset *o = &sc->offsets[i];
+		const ut8 b = scan_byte (data, nb, o->offset);
+		for (j = o->start[b]; j < o->start[b + 1]; j++) {
+			const MagicAnchor *a = &sc->anchors[sc->list[j]];
+			if (sc->cand[a->entry] && anchor_match (a, data, nb)) {
+				sc->cand[a->entry] = 0;
+				sc->hits[sc->nhits++] = sc->list[j];
+			}
+		}
+	}
+	const char *res = NULL;
+	const bool tar = !(ms->flags & R_MAGIC_NO_CHECK_TAR) && maybe_tar (data, nb);
+	if (sc->nhits || sc->always || tar || nb < 2) {
+		ms->cand = sc->cand;
+		if (__magic_file_reset (ms) != -1 && __magic_file_buffer (ms, -1, NULL, buf, nb) != -1 && ms->o.buf) {
+			res = __magic_file_getbuffer (ms);
+		}
+		ms->cand = NULL;
+	} else if (!(ms->flags & R_MAGIC_NO_CHECK_ASCII)) {
+		// no binary test can match, but the buffer may still be text
+		if (__magic_file_reset (ms) != -1 && __magic_file_ascmagic (ms, buf, nb) > 0 && ms->o.buf) {
+			res = __magic_file_getbuffer (ms);
+		}
+	}
+	for (i = 0; i < sc->nhits; i++) {
+		const MagicAnchor *a = &sc->anchors[sc->hits[i]];
+		sc->cand[a->entry] = a->skip;
+	}
+	return res;
+}
+
+#endif
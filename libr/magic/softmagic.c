@@ -41,7 +41,7 @@
 #include <stdlib.h>
 #include "r_util/r_time.h"
 
-static int match(RMagic *, struct r_magic *, ut32, const ut8 *, size_t, int);
+static int match(RMagic *, struct r_magic *, ut32, ut32, const ut8 *, size_t, int);
 static int mget(RMagic *, const ut8 *, struct r_magic *, size_t, unsigned int);
 static int magiccheck(RMagic *, struct r_magic *);
 static st32 mprint(RMagic *, struct r_magic *);
@@ -67,11 +67,13 @@ static void cvt_64(union VALUETYPE *, const struct r_magic *);
 /*ARGSUSED1*/		/* nbytes passed for regularity, maybe need later */
 int __magic_file_softmagic(RMagic *ms, const ut8 *buf, size_t nbytes, int mode) {
 	struct mlist *ml;
+	ut32 base = 0;
 	int rv;
 	for (ml = ms->mlist->next; ml != ms->mlist; ml = ml->next) {
-		if ((rv = match(ms, ml->magic, ml->nmagic, buf, nbytes, mode)) != 0) {
+		if ((rv = match(ms, ml->magic, ml->nmagic, base, buf, nbytes, mode)) != 0) {
 			return rv;
 		}
+		base += ml->nmagic;
 	}
 	return 0;
 }
@@ -103,7 +105,7 @@ int __magic_file_softmagic(RMagic *ms, const ut8 *buf, size_t nbytes, int mode)
  *	If a continuation matches, we bump the current continuation level
  *	so that higher-level continuations are processed.
  */
-static int match(RMagic *ms, struct r_magic *magic, ut32 nmagic, const ut8 *s, size_t nbytes, int mode) {
+static int match(RMagic *ms, struct r_magic *magic, ut32 nmagic, ut32 base, const ut8 *s, size_t nbytes, int mode) {
 	ut32 magindex = 0;
 	unsigned int cont_level = 0;
 	int need_separator = 0;
@@ -118,6 +120,11 @@ static int match(RMagic *ms, struct r_magic *magic, ut32 nmagic, const ut8 *s, s
 		int flush;
 		struct r_magic *m = &magic[magindex];
 
+		if (ms->cand && ms->cand[base + magindex]) {
+			/* the scan prefilter knows it can't match */
+			magindex += ms->cand[base + magindex] - 1;
+			continue;
+		}
 		if ((m->flag & BINTEST) != mode) {
 			/* Skip sub-tests */
 			while (magic[magindex + 1].cont_level != 0 && ++magindex < nmagic - 1) {
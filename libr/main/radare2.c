@@ -543,6 +543,8 @@ static RThreadFunctionRet th_analysis(RThread *th) {
 	r_cons_thready ();
 	r_cons_new ();
 	perform_analysis (td->core, td->do_analysis);
+	r_arch_session_decoder_release (R_UNWRAP4 (td->core, anal, arch, session));
+	r_arch_session_decoder_release (R_UNWRAP4 (td->core, rasm, arch, session));
 	R_FREE (th->user);
 	R_LOG_INFO ("bin.load done");
 	return false;
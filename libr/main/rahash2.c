@@ -7,6 +7,7 @@
 #include <r_util/r_print.h>
 #include <r_crypto.h>
 
+#define HASH_THREADS 64
 
 typedef struct {
 	int quiet;
@@ -181,6 +182,114 @@ static int do_hash_internal(RHash *ctx, RahashOptions *ro, ut64 hash, const ut8
 	return 1;
 }
 
+typedef struct {
+	RahashOptions *ro;
+	RHash *ctx;
+	ut64 algo;
+	const ut8 *buf;
+	int len;
+} HashJob;
+
+typedef struct hash_pool_t HashPool;
+
+typedef struct {
+	HashPool *pool;
+	int first;
+	RThread *th;
+	RThreadSemaphore *start;
+} HashWorker;
+
+// the workers are started once per file and woken up for every chunk
+struct hash_pool_t {
+	HashJob *jobs;
+	int count;
+	int nthreads;
+	bool quit;
+	RThreadSemaphore *done;
+	HashWorker workers[HASH_THREADS];
+};
+
+static void hash_worker(HashWorker *w) {
+	HashPool *pool = w->pool;
+	int i;
+	for (i = w->first; i < pool->count; i += pool->nthreads) {
+		HashJob *job = &pool->jobs[i];
+		do_hash_internal (job->ctx, job->ro, job->algo, job->buf, job->len, NULL, 0, 0);
+	}
+}
+
+static RThreadFunctionRet hash_worker_thread(RThread *th) {
+	HashWorker *w = (HashWorker *)th->user;
+	for (;;) {
+		r_th_sem_wait (w->start);
+		if (w->pool->quit) {
+			break;
+		}
+		hash_worker (w);
+		r_th_sem_post (w->pool->done);
+	}
+	return R_TH_STOP;
+}
+
+static void hash_pool_init(HashPool *pool, HashJob *jobs, int count, int nthreads) {
+	int i;
+	memset (pool, 0, sizeof (HashPool));
+	pool->jobs = jobs;
+	pool->count = count;
+	pool->nthreads = R_MAX (R_MIN (R_MIN (nthreads, count), HASH_THREADS), 1);
+	if (pool->nthreads > 1) {
+		pool->done = r_th_sem_new (0);
+	}
+	for (i = 0; i < pool->nthreads; i++) {
+		HashWorker *w = &pool->workers[i];
+		w->pool = pool;
+		w->first = i;
+		if (i > 0 && pool->done) {
+			// a worker that fails to start is run by the caller instead
+			w->start = r_th_sem_new (0);
+			w->th = w->start? r_th_new (hash_worker_thread, w, 0): NULL;
+			if (w->th && !r_th_start (w->th)) {
+				r_th_free (w->th);
+				w->th = NULL;
+			}
+		}
+	}
+}
+
+// hash the current chunk of every job, the buffers must not change until it returns
+static void hash_pool_run(HashPool *pool) {
+	int i, running = 0;
+	for (i = 1; i < pool->nthreads; i++) {
+		if (pool->workers[i].th) {
+			r_th_sem_post (pool->workers[i].start);
+			running++;
+		}
+	}
+	for (i = 0; i < pool->nthreads; i++) {
+		if (!pool->workers[i].th) {
+			hash_worker (&pool->workers[i]);
+		}
+	}
+	while (running-- > 0) {
+		r_th_sem_wait (pool->done);
+	}
+}
+
+static void hash_pool_fini(HashPool *pool) {
+	int i;
+	pool->quit = true;
+	for (i = 1; i < pool->nthreads; i++) {
+		HashWorker *w = &pool->workers[i];
+		if (w->th) {
+			r_th_sem_post (w->start);
+			r_th_wait (w->th);
+			r_th_free (w->th);
+		}
+		r_th_sem_free (w->start);
+	}
+	r_th_sem_free (pool->done);
+}
+
 static int do_hash(RahashOptions *ro, const char *file, const char *algo, RIO *io, int bsize, int rad, int ule, const ut8 *compare) {
 	ut64 j, algobit = r_hash_name_to_bits (algo);
 	ut8 *buf;
@@ -230,41 +339,71 @@ static int do_hash(RahashOptions *ro, const char *file, const char *algo, RIO *i
 		}
 	}
 	RHash *ctx = r_hash_new (true, algobit);
+	const int nthreads = r_th_ncpus ();
 	if (ro->incremental) {
+		// every algorithm gets its own context, so each chunk is read once
+		// and all the algorithms consume it in parallel
+		int k, njobs = 0;
+		HashJob *jobs = R_NEWS0 (HashJob, R_HASH_NUM_INDICES);
+		if (!jobs) {
+			r_hash_free (ctx);
+			free (buf);
+			pj_free (pj);
+			return 1;
+		}
 		for (i = 1; i < R_HASH_ALL; i <<= 1) {
 			if (algobit & i) {
-				ut64 hashbit = i & algobit;
-				int dlen = r_hash_size (hashbit);
-				r_hash_do_begin (ctx, i);
+				HashJob *job = &jobs[njobs++];
+				job->ro = ro;
+				job->algo = i;
+				job->ctx = r_hash_new (true, i);
+				r_hash_do_begin (job->ctx, i);
 				if (ro->s.buf && ro->s.prefix) {
-					do_hash_internal (ctx, ro, hashbit, ro->s.buf, ro->s.len, pj, rad, 0);
-				}
-				for (j = ro->from; j < ro->to; j += bsize) {
-					int len = ((j + bsize) > ro->to)? (ro->to - j): bsize;
-					r_io_pread_at (io, j, buf, len);
-					do_hash_internal (ctx, ro, hashbit, buf, len, pj, rad, 0);
-				}
-				if (ro->s.buf && !ro->s.prefix) {
-					do_hash_internal (ctx, ro, hashbit, ro->s.buf, ro->s.len, pj, rad, 0);
-				}
-				r_hash_do_end (ctx, i);
-				if (ro->iterations > 0) {
-					r_hash_do_spice (ctx, i, ro->iterations, ro->_s);
-				}
-				if (!*r_hash_name (i)) {
-					continue;
-				}
-				if (!ro->quiet && rad != 'j') {
-					printf ("%s: ", file);
-				}
-				do_hash_print (ctx, ro, i, dlen, pj, ro->quiet? 'n': rad);
-				if (ro->quiet == 1) {
-					printf (" %s\n", file);
-				} else if (ro->quiet > 0 && ro->quiet < 3 && !rad) {
-					printf ("\n");
+					do_hash_internal (job->ctx, ro, i, ro->s.buf, ro->s.len, pj, rad, 0);
 				}
 			}
 		}
+		HashPool pool;
+		hash_pool_init (&pool, jobs, njobs, nthreads);
+		for (j = ro->from; j < ro->to; j += bsize) {
+			int len = ((j + bsize) > ro->to)? (ro->to - j): bsize;
+			r_io_pread_at (io, j, buf, len);
+			for (k = 0; k < njobs; k++) {
+				jobs[k].buf = buf;
+				jobs[k].len = len;
+			}
+			hash_pool_run (&pool);
+		}
+		hash_pool_fini (&pool);
+		for (k = 0; k < njobs; k++) {
+			HashJob *job = &jobs[k];
+			i = job->algo;
+			int dlen = r_hash_size (i);
+			if (ro->s.buf && !ro->s.prefix) {
+				do_hash_internal (job->ctx, ro, i, ro->s.buf, ro->s.len, pj, rad, 0);
+			}
+			r_hash_do_end (job->ctx, i);
+			if (ro->iterations > 0) {
+				r_hash_do_spice (job->ctx, i, ro->iterations, ro->_s);
+			}
+			// the last digest is the one compared with -c
+			ctx->entropy = job->ctx->entropy;
+			memcpy (ctx->digest, job->ctx->digest, sizeof (ctx->digest));
+			r_hash_free (job->ctx);
+			if (!*r_hash_name (i)) {
+				continue;
+			}
+			if (!ro->quiet && rad != 'j') {
+				printf ("%s: ", file);
+			}
+			do_hash_print (ctx, ro, i, dlen, pj, ro->quiet? 'n': rad);
+			if (ro->quiet == 1) {
+				printf (" %s\n", file);
+			} else if (ro->quiet > 0 && ro->quiet < 3 && !rad) {
+				printf ("\n");
+			}
+		}
+		free (jobs);
 		if (ro->_s) {
 			R_FREE (ro->_s->buf);
 		}
@@ -273,6 +412,22 @@ static int do_hash(RahashOptions *ro, const char *file, const char *algo, RIO *i
 		if (ro->s.buf) {
 			R_LOG_WARN ("Seed ignored on per-block hashing");
 		}
+		// blocks are independent, hash a batch of them in parallel and
+		// print the results in order
+		const ut64 nblocks = (ro->to > ro->from)? (ro->to - ro->from + bsize - 1) / bsize: 1;
+		int k, nbatch = (int)r_hash_batch_count (bsize, nblocks);
+		ut8 *bbuf = NULL;
+		RHashBlock *blocks = R_NEWS0 (RHashBlock, nbatch);
+		if (blocks) {
+			bbuf = malloc ((size_t)nbatch * bsize);
+		}
+		if (!bbuf) {
+			free (blocks);
+			r_hash_free (ctx);
+			free (buf);
+			pj_free (pj);
+			return 1;
+		}
 		for (i = 1; i < R_HASH_ALL; i <<= 1) {
 			ut64 f, t, ofrom, oto;
 			if (algobit & i) {
@@ -281,15 +436,28 @@ static int do_hash(RahashOptions *ro, const char *file, const char *algo, RIO *i
 				oto = ro->to;
 				f = ro->from;
 				t = ro->to;
-				for (j = f; j < t; j += bsize) {
-					int nsize = (j + bsize < fsize)? bsize: (fsize - j);
-					r_io_pread_at (io, j, buf, bsize);
-					ro->from = j;
-					ro->to = j + bsize;
-					if (ro->to > fsize) {
-						ro->to = fsize;
+				for (j = f; j < t; j += (ut64)nbatch * bsize) {
+					for (k = 0; k < nbatch && j + (ut64)k * bsize < t; k++) {
+						ut64 at = j + (ut64)k * bsize;
+						blocks[k].off = (ut64)k * bsize;
+						blocks[k].len = (at + bsize < fsize)? bsize: (fsize - at);
+					}
+					r_io_pread_at (io, j, bbuf, k * bsize);
+					r_hash_calculate_blocks (hashbit, bbuf, blocks, k, nthreads);
+					int n;
+					for (n = 0; n < k; n++) {
+						ro->from = j + blocks[n].off;
+						ro->to = ro->from + bsize;
+						if (ro->to > fsize) {
+							ro->to = fsize;
+						}
+						ctx->entropy = blocks[n].entropy;
+						memcpy (ctx->digest, blocks[n].digest, sizeof (ctx->digest));
+						if (ro->iterations > 0) {
+							r_hash_do_spice (ctx, hashbit, ro->iterations, ro->_s);
+						}
+						do_hash_print (ctx, ro, hashbit, blocks[n].dlen, pj, rad);
 					}
-					do_hash_internal (ctx, ro, hashbit, buf, nsize, pj, rad, 1);
 				}
 				// Commented out to fix issue #23371
 				// do_hash_internal (ctx, ro, hashbit, NULL, 0, pj, rad, 1);
@@ -297,6 +465,8 @@ static int do_hash(RahashOptions *ro, const char *file, const char *algo, RIO *i
 				ro->to = oto;
 			}
 		}
+		free (blocks);
+		free (bbuf);
 	}
 	if (rad == 'j') {
 		pj_end (pj);
@@ -1,4 +1,4 @@
-/* radare - LGPL - Copyright 2015-2024 - pancake */
+/* radare - LGPL - Copyright 2015-2026 - pancake */
 /*
 Usage Example:
 
@@ -122,6 +122,212 @@ R_API char *r2pipe_read(R2Pipe *r2pipe) {
 	return buf;
 }
 
+/* framed protocol */
+
+R_API bool r2pipe_frame_append(RStrBuf *sb, ut32 id, const char *data, size_t len) {
+	R_RETURN_VAL_IF_FAIL (sb && (data || !len), false);
+	const size_t cur = r_strbuf_length (sb);
+	if (len > R2PIPE_FRAME_MAXSZ || cur + R2PIPE_FRAME_HDRSZ + len > ST32_MAX) {
+		return false;
+	}
+	// a failed append must not leave a header without its payload
+	if (!r_strbuf_reserve (sb, cur + R2PIPE_FRAME_HDRSZ + len)) {
+		return false;
+	}
+	ut8 hdr[R2PIPE_FRAME_HDRSZ];
+	hdr[0] = R2PIPE_FRAME_MAGIC;
+	r_write_le32 (hdr + 1, id);
+	r_write_le32 (hdr + 5, (ut32)len);
+	if (!r_strbuf_append_n (sb, (const char *)hdr, sizeof (hdr))) {
+		return false;
+	}
+	return len? r_strbuf_append_n (sb, data, len): true;
+}
+
+// returns the size of the complete frame at buf, 0 if more data is needed or -1 if invalid
+R_API int r2pipe_frame_parse(const ut8 *buf, size_t len, ut32 *id, ut32 *plen) {
+	R_RETURN_VAL_IF_FAIL (buf, -1);
+	if (len < R2PIPE_FRAME_HDRSZ) {
+		return (len > 0 && buf[0] != R2PIPE_FRAME_MAGIC)? -1: 0;
+	}
+	if (buf[0] != R2PIPE_FRAME_MAGIC) {
+		return -1;
+	}
+	ut32 n = r_read_le32 (buf + 5);
+	if (n > R2PIPE_FRAME_MAXSZ) {
+		return -1;
+	}
+	if (id) {
+		*id = r_read_le32 (buf + 1);
+	}
+	if (plen) {
+		*plen = n;
+	}
+	if (len - R2PIPE_FRAME_HDRSZ < n) {
+		return 0;
+	}
+	return (int)(n + R2PIPE_FRAME_HDRSZ);
+}
+
+#if HAVE_R2PIPE
+static bool r2pipe_write_all(R2Pipe *r2pipe, const ut8 *buf, size_t len) {
+	while (len > 0) {
+#if R2__WINDOWS__
+		DWORD dwWritten = 0;
+		if (!WriteFile (r2pipe->pipe, buf, len, &dwWritten, NULL) || !dwWritten) {
+			return false;
+		}
+		int n = dwWritten;
+#else
+		int n = write (r2pipe->input[1], buf, len);
+		if (n < 1) {
+			return false;
+		}
+#endif
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+
+static bool r2pipe_read_all(R2Pipe *r2pipe, ut8 *buf, size_t len) {
+	while (len > 0) {
+#if R2__WINDOWS__
+		DWORD dwRead = 0;
+		if (!ReadFile (r2pipe->pipe, buf, len, &dwRead, NULL) || !dwRead) {
+			return false;
+		}
+		int n = dwRead;
+#else
+		int n = read (r2pipe->output[0], buf, len);
+		if (n < 1) {
+			return false;
+		}
+#endif
+		buf += n;
+		len -= n;
+	}
+	return true;
+}
+#endif
+
+R_API void r2pipe_set_framed(R2Pipe *r2pipe, bool framed) {
+	R_RETURN_IF_FAIL (r2pipe);
+	r2pipe->framed = framed;
+}
+
+#if HAVE_R2PIPE
+typedef struct {
+	ut32 id;
+	char *data;
+} R2PipeReply;
+
+static void r2pipe_reply_free(R2PipeReply *reply) {
+	if (reply) {
+		free (reply->data);
+		free (reply);
+	}
+}
+
+static char *r2pipe_read_reply(R2Pipe *r2pipe, ut32 *id) {
+	ut8 hdr[R2PIPE_FRAME_HDRSZ];
+	ut32 len = 0;
+	if (!r2pipe_read_all (r2pipe, hdr, sizeof (hdr))) {
+		return NULL;
+	}
+	if (r2pipe_frame_parse (hdr, sizeof (hdr), id, &len) < 0) {
+		R_LOG_ERROR ("Invalid r2pipe frame");
+		return NULL;
+	}
+	char *buf = malloc ((size_t)len + 1);
+	if (!buf) {
+		return NULL;
+	}
+	if (!r2pipe_read_all (r2pipe, (ut8 *)buf, len)) {
+		free (buf);
+		return NULL;
+	}
+	buf[len] = 0;
+	if (r2pipe->inflight > 0) {
+		const ut32 first = r2pipe->seq - r2pipe->inflight;
+		r2pipe->inflight_size -= r2pipe->inflight_sizes[first % R2PIPE_WINDOW];
+		r2pipe->inflight--;
+	}
+	return buf;
+}
+
+// the server writes the replies before reading more requests, so the ones
+// in flight are bounded and the oldest replies are read to make room
+static bool r2pipe_make_room(R2Pipe *r2pipe, ut32 size) {
+	while (r2pipe->inflight >= R2PIPE_WINDOW
+		|| (r2pipe->inflight > 0 && r2pipe->inflight_size + size > R2PIPE_WINDOW_SIZE)) {
+		if (!r2pipe->replies) {
+			r2pipe->replies = r_list_newf ((RListFree)r2pipe_reply_free);
+			if (!r2pipe->replies) {
+				return false;
+			}
+		}
+		R2PipeReply *reply = R_NEW0 (R2PipeReply);
+		if (!reply) {
+			return false;
+		}
+		reply->data = r2pipe_read_reply (r2pipe, &reply->id);
+		if (!reply->data) {
+			free (reply);
+			return false;
+		}
+		r_list_append (r2pipe->replies, reply);
+	}
+	return true;
+}
+#endif
+
+// queue a command without waiting for its reply, returns the request id or -1.
+// It reads pending replies when too many requests are in flight, see R2PIPE_WINDOW
+R_API st64 r2pipe_send(R2Pipe *r2pipe, const char *str) {
+#if HAVE_R2PIPE
+	R_RETURN_VAL_IF_FAIL (r2pipe && str, -1);
+	RStrBuf sb;
+	r_strbuf_init (&sb);
+	ut32 id = r2pipe->seq;
+	st64 ret = -1;
+	if (r2pipe_frame_append (&sb, id, str, strlen (str))) {
+		int len = 0;
+		ut8 *data = r_strbuf_getbin (&sb, &len);
+		if (data && r2pipe_make_room (r2pipe, len) && r2pipe_write_all (r2pipe, data, len)) {
+			r2pipe->inflight_sizes[id % R2PIPE_WINDOW] = len;
+			r2pipe->inflight_size += len;
+			r2pipe->inflight++;
+			r2pipe->seq++;
+			ret = id;
+		}
+	}
+	r_strbuf_fini (&sb);
+	return ret;
+#else
+	return -1;
+#endif
+}
+
+// read the next reply frame, replies arrive in the same order as the requests
+R_API char *r2pipe_recv(R2Pipe *r2pipe, ut32 *id) {
+#if HAVE_R2PIPE
+	R_RETURN_VAL_IF_FAIL (r2pipe, NULL);
+	R2PipeReply *reply = r2pipe->replies? r_list_pop_head (r2pipe->replies): NULL;
+	if (reply) {
+		char *data = reply->data;
+		if (id) {
+			*id = reply->id;
+		}
+		free (reply);
+		return data;
+	}
+	return r2pipe_read_reply (r2pipe, id);
+#else
+	return NULL;
+#endif
+}
+
 R_API int r2pipe_close(R2Pipe *r2pipe) {
 #if HAVE_R2PIPE
 	if (!r2pipe) {
@@ -163,6 +369,7 @@ R_API int r2pipe_close(R2Pipe *r2pipe) {
 		r2pipe->child = NO_CHILD;
 	}
 #endif
+	r_list_free (r2pipe->replies);
 #endif
 	free (r2pipe);
 	return 0;
@@ -345,6 +552,19 @@ R_API R2Pipe *r2pipe_open(const char *cmd) {
 R_API char *r2pipe_cmd(R2Pipe *r2p, const char *str) {
 #if HAVE_R2PIPE
 	R_RETURN_VAL_IF_FAIL (r2p && str, NULL);
+	if (r2p->framed) {
+		ut32 id = 0;
+		st64 req = r2pipe_send (r2p, str);
+		if (req < 0) {
+			r_sys_perror ("r2pipe_send");
+			return NULL;
+		}
+		char *res = r2pipe_recv (r2p, &id);
+		if (res && id != (ut32)req) {
+			R_LOG_WARN ("r2pipe reply id %u does not match request %u", id, (ut32)req);
+		}
+		return res;
+	}
 	if (!*str || !r2pipe_write (r2p, str)) {
 		r_sys_perror ("r2pipe_write");
 		return NULL;
@@ -207,6 +207,75 @@ R_DEPRECATE R_API const ut8 *r_buf_data(RBuffer *b, ut64 *size) {
 	return b->whole_buf;
 }
 
+// borrow a pointer to the [addr, addr + len) range without copying, only
+// possible when the data lives in memory (bytes, mmap and slices of those)
+R_API const ut8 *r_buf_view(RBuffer *b, ut64 addr, ut64 len) {
+	R_RETURN_VAL_IF_FAIL (b, NULL);
+	switch (b->type) {
+	case R_BUFFER_BYTES:
+	case R_BUFFER_MMAP:
+		// the mmap user data starts with a RBufferBytes
+		if (!b->rb_bytes->buf || addr > b->rb_bytes->length || len > b->rb_bytes->length - addr) {
+			return NULL;
+		}
+		return b->rb_bytes->buf + addr;
+	case R_BUFFER_REF:
+		if (addr > b->rb_ref->size || len > b->rb_ref->size - addr) {
+			return NULL;
+		}
+		return r_buf_view (b->rb_ref->parent, b->rb_ref->base + addr, len);
+	default:
+		return NULL;
+	}
+}
+
+/* Get the bytes of [addr, addr + len) to walk a table without going through
+ * the buffer methods for every field. The data is borrowed when the buffer is
+ * backed by memory, otherwise it's read into a copy owned by the span, which
+ * can be shorter than requested. Returns false when nothing can be read, the
+ * span must be released with r_buf_span_fini() otherwise */
+R_API bool r_buf_span(RBuffer *b, ut64 addr, ut64 len, RBufferSpan *span) {
+	R_RETURN_VAL_IF_FAIL (b && span, false);
+	memset (span, 0, sizeof (RBufferSpan));
+	if (!len) {
+		return true;
+	}
+	const ut8 *data = r_buf_view (b, addr, len);
+	if (data) {
+		span->data = data;
+		span->len = len;
+		return true;
+	}
+	const ut64 size = buf_get_size (b);
+	if (addr >= size) {
+		return false;
+	}
+	len = R_MIN (len, size - addr);
+	if (len > SIZE_MAX) {
+		return false;
+	}
+	ut8 *copy = malloc (len);
+	if (!copy) {
+		return false;
+	}
+	st64 r = r_buf_read_at (b, addr, copy, len);
+	if (r < 1) {
+		free (copy);
+		return false;
+	}
+	span->data = span->copy = copy;
+	span->len = r;
+	return true;
+}
+
+R_API void r_buf_span_fini(RBufferSpan *span) {
+	if (span) {
+		R_FREE (span->copy);
+		span->data = NULL;
+		span->len = 0;
+	}
+}
+
 R_API ut64 r_buf_size(RBuffer *b) {
 	R_RETURN_VAL_IF_FAIL (b, 0);
 	return buf_get_size (b);
@@ -45,6 +45,14 @@ static bool buf_mmap_resize(RBuffer *b, ut64 newsize) {
 	return true;
 }
 
+static ut8 *buf_mmap_get_whole_buf(RBuffer *b, ut64 *sz) {
+	r_warn_if_fail (b->rb_mmap);
+	if (sz) {
+		*sz = b->rb_mmap->bytes.length;
+	}
+	return b->rb_mmap->bytes.buf;
+}
+
 static const RBufferMethods buffer_mmap_methods = {
 	.init = buf_mmap_init,
 	.fini = buf_mmap_fini,
@@ -53,4 +61,5 @@ static const RBufferMethods buffer_mmap_methods = {
 	.get_size = buf_bytes_get_size,
 	.resize = buf_mmap_resize,
 	.seek = buf_bytes_seek,
+	.get_whole_buf = buf_mmap_get_whole_buf
 };
@@ -107,17 +107,18 @@ static void __table_adjust(RTable *t) {
 	}
 	r_list_foreach (t->rows, iter, row) {
 		const char *item;
-		int ncol = 0;
+		RListIter *citer = t->cols->head;
 		r_list_foreach (row->items, iter2, item) {
+			if (!citer) {
+				break;
+			}
+			RTableColumn *c = citer->data;
 			int itemLength = r_str_len_utf8_ansi (item) + 1;
-			RTableColumn *c = r_list_get_n (t->cols, ncol);
-			if (c) {
-				c->width = R_MAX (c->width, itemLength);
-				if (t->maxColumnWidth > 0) {
-					c->width = R_MIN (t->maxColumnWidth, c->width);
-				}
+			c->width = R_MAX (c->width, itemLength);
+			if (t->maxColumnWidth > 0) {
+				c->width = R_MIN (t->maxColumnWidth, c->width);
 			}
-			ncol ++;
+			citer = citer->n;
 		}
 	}
 }
@@ -810,9 +811,11 @@ R_API void r_table_filter(RTable *t, int nth, int op, const char *un) {
 		}
 	}
 	size_t nrow = 0;
+	// only the numeric operations need to evaluate the cells
+	const bool numeric = op == '+' || op == '>' || op == '<' || op == '=' || op == '!';
 	r_list_foreach_safe (t->rows, iter, iter2, row) {
 		const char *nn = r_list_get_n (row->items, nth);
-		ut64 nv = r_num_math (NULL, nn);
+		ut64 nv = numeric? r_num_math (NULL, nn): 0;
 		bool match = true;
 		switch (op) {
 		case 'p':
@@ -901,9 +904,111 @@ static int cmp(const void *_a, const void *_b) {
 	return res;
 }
 
+enum {
+	KEY_CUSTOM,
+	KEY_NUMBER,
+	KEY_FLOAT,
+	KEY_STRING,
+};
+
+typedef struct {
+	RTableRow *row;
+	size_t idx;
+	union {
+		ut64 n;
+		double f;
+		const char *s;
+	} key;
+} TableSortItem;
+
+static int column_key_kind(RTableColumn *col) {
+	RTableColumnType *type = col->type;
+	if (type == &r_table_type_number || type == &r_table_type_bool) {
+		return KEY_NUMBER;
+	}
+	if (type == &r_table_type_float) {
+		return KEY_FLOAT;
+	}
+	if (type == &r_table_type_string) {
+		return KEY_STRING;
+	}
+	return KEY_CUSTOM;
+}
+
+// ties are resolved by the original position to keep the sort stable like r_list_sort
+static int sort_item_number(const void *a, const void *b) {
+	const TableSortItem *ia = a, *ib = b;
+	if (ia->key.n != ib->key.n) {
+		return (ia->key.n > ib->key.n)? 1: -1;
+	}
+	return (ia->idx > ib->idx) - (ia->idx < ib->idx);
+}
+
+static int sort_item_float(const void *a, const void *b) {
+	const TableSortItem *ia = a, *ib = b;
+	if (ia->key.f != ib->key.f) {
+		return (ia->key.f > ib->key.f)? 1: -1;
+	}
+	return (ia->idx > ib->idx) - (ia->idx < ib->idx);
+}
+
+static int sort_item_string(const void *a, const void *b) {
+	const TableSortItem *ia = a, *ib = b;
+	int res = strcmp (ia->key.s, ib->key.s);
+	if (res) {
+		return res;
+	}
+	return (ia->idx > ib->idx) - (ia->idx < ib->idx);
+}
+
+// decode the sort column once per row and sort the typed keys instead of the strings
+static bool table_sort_typed(RTable *t, int nth, int kind, bool dec) {
+	const size_t count = r_list_length (t->rows);
+	TableSortItem *items = R_NEWS (TableSortItem, count);
+	if (!items) {
+		return false;
+	}
+	RListIter *iter;
+	RTableRow *row;
+	size_t i = 0;
+	r_list_foreach (t->rows, iter, row) {
+		const char *cell = r_list_get_n (row->items, nth);
+		TableSortItem *item = &items[i];
+		item->row = row;
+		item->idx = i;
+		switch (kind) {
+		case KEY_NUMBER:
+			item->key.n = cell? r_num_get (NULL, cell): 0;
+			break;
+		case KEY_FLOAT:
+			item->key.f = cell? strtod (cell, NULL): 0;
+			break;
+		default:
+			item->key.s = cell? cell: "";
+			break;
+		}
+		i++;
+	}
+	qsort (items, count, sizeof (TableSortItem), (kind == KEY_NUMBER)
+		? sort_item_number
+		: (kind == KEY_FLOAT)? sort_item_float: sort_item_string);
+	// reverse the sorted order like r_list_reverse does for the decreasing sort
+	i = 0;
+	r_list_foreach (t->rows, iter, row) {
+		iter->data = items[dec? count - 1 - i: i].row;
+		i++;
+	}
+	free (items);
+	return true;
+}
+
 R_API void r_table_sort(RTable *t, int nth, bool dec) {
 	RTableColumn *col = r_list_get_n (t->cols, nth);
 	if (col) {
+		const int kind = column_key_kind (col);
+		if (kind != KEY_CUSTOM && table_sort_typed (t, nth, kind, dec)) {
+			return;
+		}
 		Gnth = nth;
 		if (col->type && col->type->cmp) {
 			Gcmp = col->type->cmp;
@@ -985,7 +1090,93 @@ R_API void r_table_uniq(RTable *t) {
 	r_table_group (t, -1, NULL);
 }
 
+static bool group_key_append(RStrBuf *sb, RTableColumn *col, const char *cell) {
+	switch (column_key_kind (col)) {
+	case KEY_NUMBER:
+		r_strbuf_appendf (sb, "%"PFMT64x, cell? r_num_get (NULL, cell): 0);
+		break;
+	case KEY_FLOAT:
+		// sortFloat considers equal the values closer than 0.01
+		r_strbuf_appendf (sb, "%"PFMT64d, (st64)((cell? strtod (cell, NULL): 0) * 100));
+		break;
+	case KEY_STRING:
+		r_strbuf_append (sb, r_str_get (cell));
+		break;
+	default:
+		return false;
+	}
+	r_strbuf_append_n (sb, "\x01", 1);
+	return true;
+}
+
+// build the key that identifies the group of a row, or NULL if a column can't be keyed
+static char *group_key(RTable *t, RTableRow *row, int nth) {
+	RStrBuf *sb = r_strbuf_new (NULL);
+	RListIter *iter, *citer = t->cols->head;
+	const char *cell;
+	int i = 0;
+	r_strbuf_appendf (sb, "%d\x01", r_list_length (row->items));
+	r_list_foreach (row->items, iter, cell) {
+		if (!citer) {
+			break;
+		}
+		if (nth == -1 || i == nth) {
+			if (!group_key_append (sb, citer->data, cell)) {
+				r_strbuf_free (sb);
+				return NULL;
+			}
+		}
+		citer = citer->n;
+		i++;
+	}
+	return r_strbuf_drain (sb);
+}
+
+// rows are grouped in a single pass with a hashtable keyed by their decoded cells
+static bool table_group_hashed(RTable *t, int nth, RTableSelector fcn) {
+	RListIter *iter, *tmp;
+	RTableRow *row;
+	if (nth != -1) {
+		RTableColumn *col = r_list_get_n (t->cols, nth);
+		if (!col || column_key_kind (col) == KEY_CUSTOM) {
+			return false;
+		}
+	} else {
+		RTableColumn *col;
+		r_list_foreach (t->cols, iter, col) {
+			if (column_key_kind (col) == KEY_CUSTOM) {
+				return false;
+			}
+		}
+	}
+	HtPP *ht = ht_pp_new0 ();
+	if (!ht) {
+		return false;
+	}
+	r_list_foreach_safe (t->rows, iter, tmp, row) {
+		char *key = group_key (t, row, nth);
+		if (!key) {
+			break;
+		}
+		RTableRow *uniq_row = ht_pp_find (ht, key, NULL);
+		if (uniq_row) {
+			if (fcn) {
+				fcn (uniq_row, row, nth);
+			}
+			r_list_delete (t->rows, iter);
+		} else {
+			ht_pp_insert (ht, key, row);
+		}
+		free (key);
+	}
+	ht_pp_free (ht);
+	return true;
+}
+
 R_API void r_table_group(RTable *t, int nth, RTableSelector fcn) {
+	if (table_group_hashed (t, nth, fcn)) {
+		return;
+	}
 	RListIter *iter;
 	RListIter *tmp;
 	RTableRow *row;
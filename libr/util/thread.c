@@ -108,6 +108,22 @@ R_API R_TH_TID r_th_self(void) {
 #endif
 }
 
+// amount of online cpus, used to size worker pools
+R_API int r_th_ncpus(void) {
+#if !WANT_THREADS || defined(__wasi__)
+	return 1;
+#elif R2__WINDOWS__
+	SYSTEM_INFO si;
+	GetSystemInfo (&si);
+	return R_MAX ((int)si.dwNumberOfProcessors, 1);
+#elif defined(_SC_NPROCESSORS_ONLN)
+	long n = sysconf (_SC_NPROCESSORS_ONLN);
+	return (n > 0)? (int)n: 1;
+#else
+	return 1;
+#endif
+}
+
 R_API bool r_th_setname(RThread *th, const char *name) {
 #if defined(HAVE_PTHREAD_NP) && HAVE_PTHREAD_NP
 #if __linux__ || __sun
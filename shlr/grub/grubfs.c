@@ -8,6 +8,7 @@
 
 
 static RIOBind *bio = NULL;
+static RFSCache *bcache = NULL;
 static ut64 delta = 0;
 
 static void* empty (int sz) {
@@ -27,6 +28,9 @@ static grub_err_t read_foo (struct grub_disk *disk, grub_disk_addr_t sector, gru
 		iob = bio;
 	}
 	//printf ("io %p\n", file->root->iob.io);
+	if (bcache) {
+		return !r_fs_cache_read (bcache, delta+(blocksize*sector), (ut8*)buf, size*blocksize);
+	}
 	return !iob->read_at (iob->io, delta+(blocksize*sector), (ut8*)buf, size*blocksize);
 }
 
@@ -68,3 +72,8 @@ void grubfs_bind_io (RIOBind *iob, ut64 _delta) {
 	bio = iob;
 	delta = _delta;
 }
+
+// disk reads go through the cache when it's not null
+void grubfs_bind_cache (RFSCache *cache) {
+	bcache = cache;
+}
@@ -3,6 +3,7 @@
 extern unsigned long long grub_hack_lastoff;
 
 #include <r_io.h>
+#include <r_fs.h>
 #include <grub/file.h>
 #include <grub/disk.h>
 #include <grub/partition.h>
@@ -14,6 +15,7 @@ typedef struct grubfs {
 GrubFS *grubfs_new (struct grub_fs *myfs, void *data);
 void grubfs_free (GrubFS *gf);
 void grubfs_bind_io (RIOBind *iob, ut64 _delta);
+void grubfs_bind_cache (RFSCache *cache);
 grub_disk_t grubfs_disk (void *data);
 void grubfs_disk_free (struct grub_disk *gd);
 
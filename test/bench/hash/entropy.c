@@ -0,0 +1,58 @@
+/* radare - LGPL - Copyright 2026 - pancake */
+// compare the plain byte loop with the r_hash_histogram based entropy
+// usage: ./entropy [megabytes]
+
+#include <r_util.h>
+#include <r_hash.h>
+
+static double loop_entropy(const ut8 *data, ut64 size) {
+	ut64 i, count[256] = {0};
+	double h = 0;
+	for (i = 0; i < size; i++) {
+		count[data[i]]++;
+	}
+	for (i = 0; i < 256; i++) {
+		if (count[i]) {
+			double p = (double) count[i] / size;
+			h -= p * log2 (p);
+		}
+	}
+	return h;
+}
+
+static void report(const char *name, ut64 size, ut64 t0, double e) {
+	ut64 dt = r_time_now_mono () - t0;
+	double secs = dt / 1000000.0;
+	double mb = size / (1024.0 * 1024.0);
+	printf ("%s: %.0fMB in %.3fs (%.0f MB/s) entropy=%f\n", name, mb, secs, secs > 0? mb / secs: 0.0, e);
+}
+
+int main(int argc, char **argv) {
+	const ut64 size = ((argc > 1)? atoi (argv[1]): 256) * 1024ULL * 1024;
+	ut8 *buf = malloc (size);
+	if (!buf) {
+		return 1;
+	}
+	// half random, half a single repeated byte, the worst case for the loop
+	r_num_irand ();
+	ut64 i;
+	for (i = 0; i < size / 2; i++) {
+		buf[i] = r_num_rand (256);
+	}
+	memset (buf + size / 2, 0x90, size - size / 2);
+
+	ut64 t0 = r_time_now_mono ();
+	double e = loop_entropy (buf, size);
+	report ("loop", size, t0, e);
+
+	t0 = r_time_now_mono ();
+	e = r_hash_entropy (buf, size);
+	report ("r_hash_entropy", size, t0, e);
+
+	RHashStats st;
+	t0 = r_time_now_mono ();
+	r_hash_stats (buf, size, &st);
+	report ("r_hash_stats", size, t0, st.entropy);
+	free (buf);
+	return 0;
+}
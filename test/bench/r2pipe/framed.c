@@ -0,0 +1,49 @@
+/* radare - LGPL - Copyright 2026 - pancake */
+// compare commands/sec of the classic and the framed r2pipe protocols
+// usage: r2 -qc '#!pipe ./framed 100000' /bin/ls
+
+#include <r_util.h>
+#include <r_socket.h>
+
+static void report(const char *name, int n, ut64 t0) {
+	ut64 dt = r_time_now_mono () - t0;
+	double secs = dt / 1000000.0;
+	printf ("%s: %d cmds in %.3fs (%.0f cmds/s)\n", name, n, secs, secs > 0? n / secs: 0.0);
+}
+
+int main(int argc, char **argv) {
+	int i, n = (argc > 1)? atoi (argv[1]): 10000;
+	R2Pipe *r2p = r2pipe_open (NULL);
+	if (!r2p) {
+		return 1;
+	}
+	ut64 t0 = r_time_now_mono ();
+	for (i = 0; i < n; i++) {
+		free (r2pipe_cmdf (r2p, "?v %d", i));
+	}
+	report ("classic", n, t0);
+
+	r2pipe_set_framed (r2p, true);
+	t0 = r_time_now_mono ();
+	int sent = 0, recv = 0;
+	while (recv < n) {
+		while (sent < n && sent - recv < R2PIPE_WINDOW) {
+			char cmd[32];
+			snprintf (cmd, sizeof (cmd), "?v %d", sent);
+			if (r2pipe_send (r2p, cmd) < 0) {
+				r2pipe_close (r2p);
+				return 1;
+			}
+			sent++;
+		}
+		char *res = r2pipe_recv (r2p, NULL);
+		if (!res) {
+			break;
+		}
+		free (res);
+		recv++;
+	}
+	report ("framed", recv, t0);
+	r2pipe_close (r2p);
+	return 0;
+}
@@ -338,6 +338,50 @@ static bool test_anal_get_base_type_not_found(void) {
 	mu_end;
 }
 
+static bool test_anal_typedb(void) {
+	RAnal *anal = r_anal_new ();
+	mu_assert_notnull (anal->typedb, "Couldn't create new RAnal.typedb");
+	Sdb *TDB = anal->sdb_types;
+	sdb_set (TDB, "int32_t", "type", 0);
+	sdb_set (TDB, "type.int32_t.size", "32", 0);
+	setup_sdb_for_struct (TDB);
+	sdb_set (TDB, "outer", "struct", 0);
+	sdb_set (TDB, "struct.outer", "head,k", 0);
+	sdb_set (TDB, "struct.outer.head", "int32_t,0,0", 0);
+	sdb_set (TDB, "struct.outer.k", "struct kappa,4,0", 0);
+
+	RAnalTypeDB *db = anal->typedb;
+	mu_assert_eq (r_anal_typedb_bitsize (db, "int32_t"), 32, "atomic bitsize");
+	mu_assert_eq (r_anal_typedb_bitsize (db, "struct kappa"), 64, "struct bitsize");
+	mu_assert_eq (r_anal_typedb_bitsize (db, "outer"), 96, "nested struct bitsize");
+	mu_assert_eq (r_anal_typedb_bitsize (db, "kappa *"), 32, "pointer bitsize");
+	mu_assert_eq (r_anal_typedb_bitsize (db, "non_existant"), 0, "unknown bitsize");
+
+	char *m = r_anal_typedb_member_at (db, "kappa", 4);
+	mu_assert_streq (m, "kappa.cow", "member at offset");
+	free (m);
+	m = r_anal_typedb_member_at (db, "outer", 8);
+	mu_assert_streq (m, "outer.k.cow", "nested member at offset");
+	free (m);
+	mu_assert_null (r_anal_typedb_member_at (db, "kappa", 8), "member past the end");
+
+	RList *l = r_anal_typedb_by_offset (db, 4);
+	mu_assert_eq (r_list_length (l), 2, "structs with a member at offset 4");
+	mu_assert_streq (r_list_get_n (l, 0), "kappa.cow", "first by offset");
+	mu_assert_streq (r_list_get_n (l, 1), "outer.k", "second by offset");
+	r_list_free (l);
+
+	// writes to the sdb must be visible in the next lookup
+	sdb_set (TDB, "type.int32_t.size", "16", 0);
+	mu_assert_eq (r_anal_typedb_bitsize (db, "struct kappa"), 32, "struct bitsize after update");
+	sdb_reset (TDB);
+	r_anal_typedb_invalidate (db);
+	mu_assert_eq (r_anal_typedb_bitsize (db, "struct kappa"), 0, "struct bitsize after reset");
+
+	r_anal_free (anal);
+	mu_end;
+}
+
 int all_tests(void) {
 	mu_run_test (test_anal_get_base_type_struct);
 	mu_run_test (test_anal_save_base_type_struct);
@@ -350,6 +394,7 @@ int all_tests(void) {
 	mu_run_test (test_anal_get_base_type_atomic);
 	mu_run_test (test_anal_save_base_type_atomic);
 	mu_run_test (test_anal_get_base_type_not_found);
+	mu_run_test (test_anal_typedb);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,81 @@
+#include <r_arch.h>
+#include "minunit.h"
+
+static int created = 0;
+static int freed = 0;
+
+static void *decoder_new(RArchSession *as) {
+	created++;
+	return r_str_newf ("%d", as->config->bits);
+}
+
+static void decoder_free(void *ctx) {
+	freed++;
+	free (ctx);
+}
+
+typedef struct {
+	RArchSession *as;
+	void *decoder;
+	bool release;
+} DecoderJob;
+
+static RThreadFunctionRet decoder_thread(RThread *th) {
+	DecoderJob *job = th->user;
+	job->decoder = r_arch_session_decoder (job->as);
+	if (job->release) {
+		r_arch_session_decoder_release (job->as);
+	}
+	return R_TH_STOP;
+}
+
+bool test_r_arch_session_decoders(void) {
+	created = freed = 0;
+	RArchSession *as = R_NEW0 (RArchSession);
+	as->config = r_arch_config_new ();
+	r_arch_config_set_bits (as->config, 32);
+	mu_assert_true (r_arch_session_decoders_init (as, decoder_new, decoder_free), "init");
+	char *d32 = r_arch_session_decoder (as);
+	mu_assert_streq (d32, "32", "decoder for 32 bits");
+	r_arch_config_set_bits (as->config, 16);
+	char *d16 = r_arch_session_decoder (as);
+	mu_assert_streq (d16, "16", "decoder for 16 bits");
+	r_arch_config_set_bits (as->config, 32);
+	mu_assert_ptreq (r_arch_session_decoder (as), d32, "switching back is a lookup");
+	mu_assert_eq (created, 2, "one decoder per mode");
+
+	DecoderJob job = { as, NULL, false };
+	RThread *th = r_th_new (decoder_thread, &job, 0);
+	r_th_start (th);
+	r_th_wait (th);
+	r_th_free (th);
+	void *other = job.decoder;
+	mu_assert_notnull (other, "decoder for another thread");
+	mu_assert_ptrneq (other, d32, "threads don't share decoders");
+	mu_assert_eq (created, 3, "one decoder per thread");
+
+	DecoderJob worker = { as, NULL, true };
+	th = r_th_new (decoder_thread, &worker, 0);
+	r_th_start (th);
+	r_th_wait (th);
+	r_th_free (th);
+	mu_assert_notnull (worker.decoder, "decoder for the worker");
+	mu_assert_eq (freed, 1, "the worker released its decoder");
+	mu_assert_ptreq (r_arch_session_decoder (as), d32, "the other decoders are kept");
+
+	r_arch_session_decoders_fini (as);
+	mu_assert_eq (freed, created, "all decoders freed");
+	mu_assert_null (as->decoders, "no decoders left");
+	r_arch_config_free (as->config);
+	free (as);
+	mu_end;
+}
+
+int all_tests(void) {
+	mu_run_test (test_r_arch_session_decoders);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
@@ -22,9 +22,41 @@ bool test_r_bin(void) {
 	mu_end;
 }
 
+bool test_r_bin_patch_batch(void) {
+	RIO *io = r_io_new ();
+	RIOBind iob;
+	r_io_bind (io, &iob);
+	RIODesc *desc = r_io_open_at (io, "malloc://64", R_PERM_RW, 0644, 0x1000);
+	mu_assert_notnull (desc, "cannot open malloc://64");
+	r_io_write_at (io, 0x1000, (const ut8 *)"AAAAAAAABBBBBBBB", 16);
+
+	RBinPatchBatch pb;
+	r_bin_patch_batch_init (&pb, &iob);
+	mu_assert_true (r_bin_patch_batch_add (&pb, 0x1000, (const ut8 *)"xxxx", 4), "add");
+	mu_assert_true (r_bin_patch_batch_add (&pb, 0x1002, (const ut8 *)"yy", 2), "add overlapping");
+	mu_assert_true (r_bin_patch_batch_add (&pb, 0x1008, (const ut8 *)"BBBB", 4), "add unchanged");
+	mu_assert_false (r_bin_patch_batch_add (&pb, 0x1010, (const ut8 *)"123456789", 9), "patches are 8 bytes max");
+
+	ut8 buf[16] = {0};
+	r_io_read_at (io, 0x1000, buf, 8);
+	mu_assert_memeq (buf, (const ut8 *)"AAAAAAAA", 8, "nothing is written before flushing");
+	r_bin_patch_batch_read (&pb, 0x1001, buf, 4);
+	mu_assert_memeq (buf, (const ut8 *)"xyyA", 4, "pending patches are visible in order");
+
+	int writes = r_bin_patch_batch_flush (&pb);
+	mu_assert_eq (writes, 1, "nearby patches are written at once");
+	r_io_read_at (io, 0x1000, buf, 16);
+	mu_assert_memeq (buf, (const ut8 *)"xxyyAAAABBBBBBBB", 16, "patched contents");
+	mu_assert_eq (r_bin_patch_batch_flush (&pb), 0, "flushing an empty batch does nothing");
+
+	r_bin_patch_batch_fini (&pb);
+	r_io_free (io);
+	mu_end;
+}
 
 bool all_tests(void) {
 	mu_run_test(test_r_bin);
+	mu_run_test(test_r_bin_patch_batch);
 	return tests_passed != tests_run;
 }
 
@@ -422,6 +422,56 @@ bool test_r_buf_slice_too_big(void) {
 	mu_end;
 }
 
+bool test_r_buf_view(void) {
+	const char *content = "AAAAAAAAAASomething To\nSay Here..BBBBBBBBBB";
+	const int length = strlen (content);
+	RBuffer *buf = r_buf_new_with_bytes ((ut8 *)content, length);
+	const ut8 *v = r_buf_view (buf, 10, 9);
+	mu_assert_notnull (v, "bytes buffers can be viewed");
+	mu_assert_memeq (v, (ut8 *)"Something", 9, "view points to the right offset");
+	mu_assert_null (r_buf_view (buf, 40, 10), "out of bounds views are not allowed");
+
+	RBuffer *b = r_buf_new_slice (buf, 10, 23);
+	v = r_buf_view (b, 13, 3);
+	mu_assert_notnull (v, "slices of bytes buffers can be viewed");
+	mu_assert_memeq (v, (ut8 *)"Say", 3, "base should be considered");
+	mu_assert_null (r_buf_view (b, 20, 4), "views cannot go past the slice");
+
+	RBuffer *sparse = r_buf_new_sparse (0xff);
+	mu_assert_null (r_buf_view (sparse, 0, 1), "sparse buffers have no contiguous data");
+
+	r_buf_free (sparse);
+	r_buf_free (b);
+	r_buf_free (buf);
+	mu_end;
+}
+
+bool test_r_buf_span(void) {
+	const char *content = "AAAAAAAAAASomething To\nSay Here..BBBBBBBBBB";
+	const int length = strlen (content);
+	RBuffer *buf = r_buf_new_with_bytes ((ut8 *)content, length);
+	RBufferSpan span;
+	mu_assert_true (r_buf_span (buf, 10, 9, &span), "bytes buffers have spans");
+	mu_assert_eq (span.len, 9, "whole range");
+	mu_assert_null (span.copy, "bytes buffers are borrowed");
+	mu_assert_ptreq (span.data, r_buf_view (buf, 10, 9), "same as the view");
+	r_buf_span_fini (&span);
+
+	RBuffer *sparse = r_buf_new_sparse (0xff);
+	mu_assert_false (r_buf_span (sparse, 0, 4, &span), "nothing to read");
+	r_buf_write_at (sparse, 0, (ut8 *)"Something", 9);
+	mu_assert_true (r_buf_span (sparse, 4, 16, &span), "sparse buffers are copied");
+	mu_assert_notnull (span.copy, "the copy is owned by the span");
+	mu_assert_eq (span.len, 5, "copies stop at the end of the buffer");
+	mu_assert_memeq (span.data, (ut8 *)"thing", 5, "copied data");
+	r_buf_span_fini (&span);
+	mu_assert_null (span.data, "released");
+
+	r_buf_free (sparse);
+	r_buf_free (buf);
+	mu_end;
+}
+
 int all_tests(void) {
 	mu_run_test (test_r_buf_cache);
 	mu_run_test (test_r_buf_file);
@@ -437,6 +487,8 @@ int all_tests(void) {
 	mu_run_test (test_r_buf_get_string);
 	mu_run_test (test_r_buf_get_string_nothing);
 	mu_run_test (test_r_buf_slice_too_big);
+	mu_run_test (test_r_buf_view);
+	mu_run_test (test_r_buf_span);
 	return tests_passed != tests_run;
 }
 
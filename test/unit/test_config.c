@@ -0,0 +1,97 @@
+#include <r_config.h>
+#include "minunit.h"
+
+typedef struct {
+	bool flag;
+	int count;
+	ut64 addr;
+	const char *name;
+	int missing;
+} TestSnap;
+
+static const RConfigSnapField test_fields[] = {
+	R_CONFIG_SNAP_FIELD (TestSnap, "test.flag", BOOL, flag),
+	R_CONFIG_SNAP_FIELD (TestSnap, "test.count", INT, count),
+	R_CONFIG_SNAP_FIELD (TestSnap, "test.addr", UT64, addr),
+	R_CONFIG_SNAP_FIELD (TestSnap, "test.name", STR, name),
+	R_CONFIG_SNAP_FIELD (TestSnap, "test.missing", INT, missing),
+};
+
+static int getter_calls = 0;
+
+static bool count_getter(void *user, void *data) {
+	RConfigNode *node = data;
+	getter_calls++;
+	node->i_value = 100 + getter_calls;
+	return true;
+}
+
+bool test_r_config_gen(void) {
+	RConfig *cfg = r_config_new (NULL);
+	r_config_set_i (cfg, "test.count", 1);
+	ut32 gen = cfg->gen;
+	r_config_get_i (cfg, "test.count");
+	mu_assert_eq (cfg->gen, gen, "reading does not change the generation");
+	r_config_set_i (cfg, "test.count", 2);
+	mu_assert ("set_i bumps the generation", cfg->gen != gen);
+	gen = cfg->gen;
+	r_config_set_b (cfg, "test.flag", true);
+	mu_assert ("set_b bumps the generation", cfg->gen != gen);
+	gen = cfg->gen;
+	r_config_set (cfg, "test.name", "hello");
+	mu_assert ("set bumps the generation", cfg->gen != gen);
+	gen = cfg->gen;
+	r_config_rm (cfg, "test.name");
+	mu_assert ("rm bumps the generation", cfg->gen != gen);
+	r_config_free (cfg);
+	mu_end;
+}
+
+bool test_r_config_snap(void) {
+	RConfig *cfg = r_config_new (NULL);
+	r_config_set_b (cfg, "test.flag", true);
+	r_config_set_i (cfg, "test.count", 3);
+	r_config_set_i (cfg, "test.addr", 0x8048000);
+	r_config_set (cfg, "test.name", "hello");
+	RConfigSnap *snap = r_config_snap_new (cfg, test_fields, R_ARRAY_SIZE (test_fields));
+	mu_assert_notnull (snap, "snapshot created");
+	TestSnap ts = { .missing = 42 };
+	r_config_snap_load (snap, cfg, &ts);
+	mu_assert_true (ts.flag, "bool field");
+	mu_assert_eq (ts.count, 3, "int field");
+	mu_assert_eq (ts.addr, 0x8048000, "ut64 field");
+	mu_assert_streq (ts.name, "hello", "str field");
+	mu_assert_eq (ts.missing, 0, "missing vars are zeroed");
+	mu_assert_false (r_config_snap_refresh (snap, cfg), "nothing changed");
+
+	r_config_set_i (cfg, "test.count", 7);
+	r_config_set (cfg, "test.name", "world");
+	r_config_snap_load (snap, cfg, &ts);
+	mu_assert_eq (ts.count, 7, "int field after set");
+	mu_assert_streq (ts.name, "world", "str field after set");
+
+	r_config_set_i (cfg, "test.missing", 5);
+	r_config_snap_load (snap, cfg, &ts);
+	mu_assert_eq (ts.missing, 5, "new vars are resolved");
+
+	// values computed by a getter are never cached
+	r_config_set_getter (cfg, "test.count", count_getter);
+	r_config_snap_load (snap, cfg, &ts);
+	int first = ts.count;
+	r_config_snap_load (snap, cfg, &ts);
+	mu_assert_eq (ts.count, first + 1, "getter runs on every load");
+
+	r_config_snap_free (snap);
+	r_config_free (cfg);
+	mu_end;
+}
+
+int all_tests(void) {
+	mu_run_test (test_r_config_gen);
+	mu_run_test (test_r_config_snap);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
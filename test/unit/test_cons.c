@@ -164,9 +164,69 @@ bool test_cons_to_html(void) {
 	mu_end;
 }
 
+#if R2__UNIX__
+static void damage_write(const char *frame) {
+	char *buf = strdup (frame);
+	r_cons_visual_write (buf);
+	free (buf);
+}
+
+static char *damage_read(int fd) {
+	char out[1024] = {0};
+	int n = read (fd, out, sizeof (out) - 1);
+	return strdup (n > 0? out: "");
+}
+
+bool test_cons_damage(void) {
+	RCons *cons = r_cons_new ();
+	int fds[2];
+	mu_assert_eq (pipe (fds), 0, "pipe");
+	const int fdout = cons->fdout;
+	cons->fdout = fds[1];
+	cons->columns = 10;
+	cons->rows = 4;
+	cons->blankline = false;
+	cons->damage = true;
+	r_cons_visual_invalidate ();
+
+	damage_write ("\x1b[0;0H\x1b[31mtitle\nabc\x1b[0m\nxyz\n");
+	mu_assert_eq (cons->screen.drawn, 4, "first frame draws every row");
+	free (damage_read (fds[0]));
+
+	damage_write ("\x1b[0;0H\x1b[31mtitle\nabd\x1b[0m\nxyz\n");
+	mu_assert_eq (cons->screen.drawn, 1, "only the changed row");
+	mu_assert_streq_free (damage_read (fds[0]), "\x1b[2;1H\x1b[0m\x1b[31mabd\x1b[0m\x1b[K",
+		"the row starts with the attributes of the previous one");
+
+	damage_write ("\x1b[0;0H\x1b[31mtitle\nabd\x1b[0m\nxyz\n");
+	mu_assert_eq (cons->screen.drawn, 0, "nothing changed");
+
+	damage_write ("\x1b[0;0H\x1b[31mtitle\nabd\x1b[0m\nxyz_too_long_for_the_screen\n");
+	mu_assert_streq_free (damage_read (fds[0]), "\x1b[3;1H\x1b[0mxyz_too_lo\x1b[0m", "truncated row");
+
+	r_cons_visual_invalidate ();
+	damage_write ("\x1b[0;0H\x1b[31mtitle\nabd\x1b[0m\nxyz_too_long_for_the_screen\n");
+	mu_assert_eq (cons->screen.drawn, 4, "invalidated frames are drawn again");
+	free (damage_read (fds[0]));
+
+	damage_write ("a\n\x1b[3;3Hb\n");
+	mu_assert_false (cons->screen.valid, "frames moving the cursor are written entirely");
+	free (damage_read (fds[0]));
+
+	cons->damage = false;
+	cons->fdout = fdout;
+	close (fds[0]);
+	close (fds[1]);
+	mu_end;
+}
+#endif
+
 bool all_tests(void) {
 	mu_run_test (test_r_cons);
 	mu_run_test (test_cons_to_html);
+#if R2__UNIX__
+	mu_run_test (test_cons_damage);
+#endif
 	return tests_passed != tests_run;
 }
 
@@ -198,9 +198,130 @@ static bool test_session_load(void) {
 	mu_end;
 }
 
+static bool test_snap_pages(void) {
+	ut8 *page0 = malloc (SNAP_PAGE_SIZE);
+	ut8 *page1 = malloc (SNAP_PAGE_SIZE);
+	memset (page0, 0xaa, SNAP_PAGE_SIZE);
+	memset (page1, 0xbb, SNAP_PAGE_SIZE);
+	RDebugSnap *paged = R_NEW0 (RDebugSnap);
+	paged->size = SNAP_PAGE_SIZE + 0x10;
+	paged->pages = R_NEWS0 (ut8 *, 2);
+	paged->pages[0] = page0;
+	paged->pages[1] = page1;
+	RDebugSnap *flat = R_NEW0 (RDebugSnap);
+	flat->size = paged->size;
+	flat->data = malloc (flat->size);
+	memset (flat->data, 0xaa, SNAP_PAGE_SIZE);
+	memset (flat->data + SNAP_PAGE_SIZE, 0xbb, 0x10);
+
+	const ut8 *data = r_debug_snap_data (paged);
+	mu_assert_notnull (data, "paged snap data");
+	mu_assert_memeq (data, flat->data, flat->size, "paged snap contents");
+	mu_assert ("paged snap equals flat snap", r_debug_snap_is_equal (paged, flat));
+
+	r_debug_snap_free (paged);
+	r_debug_snap_free (flat);
+	free (page0);
+	free (page1);
+	mu_end;
+}
+
+#define MEM_ADDR 0x10000
+#define MEM_SIZE (3 * SNAP_PAGE_SIZE)
+
+typedef struct {
+	ut8 bytes[MEM_SIZE];
+	int reads;
+} TestMem;
+
+static bool mem_read(void *user, ut64 addr, ut8 *buf, int len) {
+	TestMem *mem = user;
+	mem->reads++;
+	memcpy (buf, mem->bytes + (addr - MEM_ADDR), len);
+	return true;
+}
+
+static bool mem_write(void *user, ut64 addr, const ut8 *buf, int len) {
+	TestMem *mem = user;
+	memcpy (mem->bytes + (addr - MEM_ADDR), buf, len);
+	return true;
+}
+
+static void push_checkpoint(RDebugSession *s, RDebugSnap *snap) {
+	RDebugCheckpoint checkpoint = {0};
+	checkpoint.snaps = r_list_newf ((RListFree)r_debug_snap_free);
+	r_list_append (checkpoint.snaps, snap);
+	r_vector_push (s->checkpoints, &checkpoint);
+}
+
+static bool test_session_snap(void) {
+	RDebugSession *s = r_debug_session_new ();
+	RDebugMap map = {0};
+	map.name = "[heap]";
+	map.addr = MEM_ADDR;
+	map.addr_end = MEM_ADDR + MEM_SIZE;
+	map.size = MEM_SIZE;
+	map.perm = R_PERM_RW;
+	TestMem *mem = R_NEW0 (TestMem);
+	memset (mem->bytes, 0x11, 2 * SNAP_PAGE_SIZE);
+	memset (mem->bytes + 2 * SNAP_PAGE_SIZE, 0x22, SNAP_PAGE_SIZE);
+	ut8 *orig = r_mem_dup (mem->bytes, MEM_SIZE);
+
+	// identical pages are stored once
+	RDebugSnap *first = r_debug_session_snap (s, &map, NULL, mem_read, mem);
+	mu_assert_notnull (first, "first snap");
+	mu_assert_eq (mem->reads, 3, "all the pages are read");
+	mu_assert_ptreq (first->pages[0], first->pages[1], "identical pages are shared");
+	mu_assert_ptrneq (first->pages[1], first->pages[2], "different pages are not");
+	mu_assert_eq (r_pvector_length (&s->pages), 2, "two distinct pages stored");
+	push_checkpoint (s, first);
+
+	// only the changed pages are copied for the next checkpoint
+	mem->bytes[2 * SNAP_PAGE_SIZE + 7] = 0x33;
+	mem->reads = 0;
+	RDebugSnap *second = r_debug_session_snap (s, &map, NULL, mem_read, mem);
+	mu_assert_notnull (second, "second snap");
+	mu_assert_eq (mem->reads, 3, "without dirty bits all the pages are read");
+	mu_assert_ptreq (second->pages[0], first->pages[0], "unchanged page 0 is shared");
+	mu_assert_ptreq (second->pages[1], first->pages[1], "unchanged page 1 is shared");
+	mu_assert_ptrneq (second->pages[2], first->pages[2], "changed page is copied");
+	mu_assert_eq (r_pvector_length (&s->pages), 3, "one new page stored");
+	mu_assert_memeq (r_debug_snap_data (second), mem->bytes, MEM_SIZE, "second snap contents");
+	push_checkpoint (s, second);
+
+	// the clean pages are not even read
+	mem->bytes[SNAP_PAGE_SIZE] = 0x44;
+	const ut8 dirty[3] = { 0, 1, 0 };
+	mem->reads = 0;
+	RDebugSnap *third = r_debug_session_snap (s, &map, dirty, mem_read, mem);
+	mu_assert_notnull (third, "third snap");
+	mu_assert_eq (mem->reads, 1, "only the dirty page is read");
+	mu_assert_ptreq (third->pages[0], second->pages[0], "clean page 0 is shared");
+	mu_assert_ptreq (third->pages[2], second->pages[2], "clean page 2 is shared");
+	mu_assert_ptrneq (third->pages[1], second->pages[1], "dirty page is copied");
+	mu_assert_eq (third->pages[1][0], 0x44, "dirty page contents");
+	push_checkpoint (s, third);
+
+	// restoring writes the checkpoint bytes back
+	memset (mem->bytes, 0, MEM_SIZE);
+	r_debug_snap_restore (first, mem_write, mem);
+	mu_assert_memeq (mem->bytes, orig, MEM_SIZE, "first checkpoint restored");
+	r_debug_snap_restore (third, mem_write, mem);
+	mu_assert_eq (mem->bytes[SNAP_PAGE_SIZE], 0x44, "third checkpoint page 1 restored");
+	mu_assert_eq (mem->bytes[2 * SNAP_PAGE_SIZE + 7], 0x33, "third checkpoint page 2 restored");
+	mu_assert_eq (mem->bytes[0], 0x11, "third checkpoint page 0 restored");
+
+	free (orig);
+	free (mem);
+	r_debug_session_free (s);
+	mu_end;
+}
+
 int all_tests(void) {
 	mu_run_test (test_session_save);
 	mu_run_test (test_session_load);
+	mu_run_test (test_snap_pages);
+	mu_run_test (test_session_snap);
 	return tests_passed != tests_run;
 }
 
@@ -0,0 +1,98 @@
+#include <r_fs.h>
+#include "minunit.h"
+
+static RIO *io_pattern(RIOBind *iob, int size) {
+	RIO *io = r_io_new ();
+	char *uri = r_str_newf ("malloc://%d", size);
+	r_io_open (io, uri, R_PERM_RW, 0);
+	free (uri);
+	int i;
+	for (i = 0; i < size; i++) {
+		ut8 b = i * 7;
+		r_io_write_at (io, i, &b, 1);
+	}
+	r_io_bind (io, iob);
+	return io;
+}
+
+bool test_r_fs_cache_read(void) {
+	RIOBind iob;
+	RIO *io = io_pattern (&iob, 0x4000);
+	RFSCache *c = r_fs_cache_new (&iob);
+	r_fs_cache_setup (c, 512, 8 * 512);
+	ut8 buf[1024], exp[1024];
+	r_io_read_at (io, 500, exp, sizeof (exp));
+	mu_assert_true (r_fs_cache_read (c, 500, buf, sizeof (buf)), "read across blocks");
+	mu_assert_memeq (buf, exp, sizeof (buf), "same data as the io");
+	mu_assert_eq (c->misses, 2, "the third block was read ahead");
+	mu_assert_eq (c->hits, 1, "read ahead block used");
+	memset (buf, 0, sizeof (buf));
+	mu_assert_true (r_fs_cache_read (c, 600, buf, 100), "cached read");
+	mu_assert_memeq (buf, exp + 100, 100, "cached data");
+	mu_assert_eq (c->hits, 2, "served from the cache");
+
+	// disabled caches read from the io
+	r_fs_cache_setup (c, 512, 0);
+	mu_assert_true (r_fs_cache_read (c, 500, buf, sizeof (buf)), "read without cache");
+	mu_assert_memeq (buf, exp, sizeof (buf), "same data without cache");
+	mu_assert_eq (c->nblocks, 0, "nothing cached");
+	r_fs_cache_free (c);
+	r_io_free (io);
+	mu_end;
+}
+
+bool test_r_fs_cache_readahead(void) {
+	RIOBind iob;
+	RIO *io = io_pattern (&iob, 0x4000);
+	RFSCache *c = r_fs_cache_new (&iob);
+	r_fs_cache_setup (c, 512, 16 * 512);
+	ut8 buf[512], exp[512];
+	int i;
+	for (i = 0; i < 8; i++) {
+		r_io_read_at (io, i * 512, exp, sizeof (exp));
+		r_fs_cache_read (c, i * 512, buf, sizeof (buf));
+		mu_assert_memeq (buf, exp, sizeof (buf), "sequential reads");
+	}
+	// windows of 1, 2, 4 and 4 blocks, the limit is a quarter of the cache
+	mu_assert_eq (c->misses, 4, "sequential misses read ahead");
+	mu_assert_eq (c->hits, 4, "read ahead blocks are hits");
+	r_fs_cache_free (c);
+	r_io_free (io);
+	mu_end;
+}
+
+bool test_r_fs_cache_pin(void) {
+	RIOBind iob;
+	RIO *io = io_pattern (&iob, 0x4000);
+	RFSCache *c = r_fs_cache_new (&iob);
+	r_fs_cache_setup (c, 512, 8 * 512);
+	ut8 buf[16];
+	r_fs_cache_pin (c, true);
+	r_fs_cache_read (c, 0, buf, sizeof (buf));
+	r_fs_cache_pin (c, false);
+	mu_assert_eq (c->npinned, 1, "metadata block pinned");
+	int i;
+	for (i = 10; i < 32; i += 2) {
+		r_fs_cache_read (c, i * 512, buf, sizeof (buf));
+	}
+	mu_assert_eq (c->nblocks, 8, "cache is full");
+	const ut64 hits = c->hits;
+	r_fs_cache_read (c, 0, buf, sizeof (buf));
+	mu_assert_eq (c->hits, hits + 1, "pinned blocks are not evicted");
+	r_fs_cache_read (c, 10 * 512, buf, sizeof (buf));
+	mu_assert_eq (c->hits, hits + 1, "least recently used block evicted");
+	r_fs_cache_free (c);
+	r_io_free (io);
+	mu_end;
+}
+
+int all_tests(void) {
+	mu_run_test (test_r_fs_cache_read);
+	mu_run_test (test_r_fs_cache_readahead);
+	mu_run_test (test_r_fs_cache_pin);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests();
+}
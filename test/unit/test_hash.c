@@ -0,0 +1,57 @@
+#include <r_hash.h>
+#include <r_util.h>
+#include "minunit.h"
+
+bool test_r_hash_stats(void) {
+	const ut8 buf[] = { 0, 0, 0xff, 'A', 'B', ' ', '~', 0x7f, 0x1f, 0 };
+	RHashStats st;
+	r_hash_stats (buf, sizeof (buf), &st);
+	mu_assert_eq (st.size, sizeof (buf), "size");
+	mu_assert_eq (st.zeros, 3, "zero bytes");
+	mu_assert_eq (st.ffs, 1, "0xff bytes");
+	mu_assert_eq (st.printable, 4, "printable bytes");
+	mu_assert_eq (st.count[0], 3, "histogram of 0x00");
+	mu_assert_eq (st.count['A'], 1, "histogram of A");
+	mu_assert_eq (st.count[0x80], 0, "histogram of a missing byte");
+	mu_assert ("same entropy as r_hash_entropy", st.entropy == r_hash_entropy (buf, sizeof (buf)));
+	mu_assert ("same fraction as r_hash_entropy_fraction", st.fraction == r_hash_entropy_fraction (buf, sizeof (buf)));
+	mu_end;
+}
+
+bool test_r_hash_stats_uniform(void) {
+	ut8 buf[512];
+	int i;
+	for (i = 0; i < sizeof (buf); i++) {
+		buf[i] = i & 0xff;
+	}
+	RHashStats st;
+	r_hash_stats (buf, sizeof (buf), &st);
+	mu_assert_eq (st.zeros, 2, "zero bytes");
+	mu_assert_eq (st.ffs, 2, "0xff bytes");
+	mu_assert_eq (st.printable, 2 * 95, "printable bytes");
+	mu_assert ("8 bits of entropy", st.entropy == 8.0);
+	mu_assert ("full entropy fraction", st.fraction == 1.0);
+	mu_end;
+}
+
+bool test_r_hash_stats_empty(void) {
+	RHashStats st;
+	r_hash_stats (NULL, 16, &st);
+	mu_assert_eq (st.size, 0, "no data");
+	mu_assert_eq (st.zeros, 0, "no zero bytes");
+	mu_assert_eq (st.printable, 0, "no printable bytes");
+	mu_assert ("no entropy", st.entropy == 0);
+	mu_assert ("no entropy fraction", st.fraction == 0);
+	mu_end;
+}
+
+int all_tests(void) {
+	mu_run_test (test_r_hash_stats);
+	mu_run_test (test_r_hash_stats_uniform);
+	mu_run_test (test_r_hash_stats_empty);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
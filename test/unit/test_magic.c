@@ -0,0 +1,52 @@
+#include <r_magic.h>
+#include "minunit.h"
+
+static const char magic_db[] =
+	"# test magic\n"
+	"0\tstring\t\\x7fELF\tELF\n"
+	"0\tbelong\t0xcafebabe\tcompiled Java class data\n"
+	"0\tsearch/1\t#!/bin/sh\tPOSIX shell script text\n";
+
+static bool same_result(RMagic *ms, RMagicScan *sc, const char *buf, size_t len) {
+	const char *r = r_magic_buffer (ms, buf, len);
+	char *exp = strdup (r? r: "");
+	const char *s = r_magic_scan_buffer (sc, buf, len);
+	bool same = !strcmp (exp, s? s: "");
+	free (exp);
+	return same;
+}
+
+bool test_r_magic_scan(void) {
+	RMagic *ms = r_magic_new (0);
+	mu_assert_true (r_magic_load_buffer (ms, (const ut8 *)magic_db, strlen (magic_db)), "load magic");
+	RMagicScan *sc = r_magic_scan_new (ms);
+	mu_assert_notnull (sc, "scan");
+#define BUF(x) { x, sizeof (x) - 1 }
+	const struct {
+		const char *data;
+		size_t len;
+	} bufs[] = {
+		BUF ("#!/bin/sh\necho hello world\n"),
+		BUF ("just some plain ascii text\nin two lines\n"),
+		BUF ("\x7f" "ELF\x01\x01\x01\x00\x00\x00\x00\x00"),
+		BUF ("\xca\xfe\xba\xbe\x00\x00\x00\x32"),
+		BUF ("\x00\x01\x02\x03 random binary data"),
+	};
+#undef BUF
+	int i;
+	for (i = 0; i < R_ARRAY_SIZE (bufs); i++) {
+		mu_assert_true (same_result (ms, sc, bufs[i].data, bufs[i].len), "same result as r_magic_buffer");
+	}
+	r_magic_scan_free (sc);
+	r_magic_free (ms);
+	mu_end;
+}
+
+int all_tests(void) {
+	mu_run_test (test_r_magic_scan);
+	return tests_passed != tests_run;
+}
+
+int main(int argc, char **argv) {
+	return all_tests ();
+}
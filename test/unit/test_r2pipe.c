@@ -21,10 +21,36 @@ static bool test_r2pipe_404(void) {
 	mu_end;
 }
 
+static bool test_r2pipe_frames(void) {
+	RStrBuf *sb = r_strbuf_new (NULL);
+	mu_assert ("frame append", r2pipe_frame_append (sb, 7, "?e hi", 5));
+	mu_assert ("empty frame append", r2pipe_frame_append (sb, 8, "", 0));
+	mu_assert_false (r2pipe_frame_append (sb, 9, "x", (size_t)R2PIPE_FRAME_MAXSZ + 1), "oversized frame append");
+	int len = 0;
+	ut8 *data = r_strbuf_getbin (sb, &len);
+	mu_assert_eq (len, 2 * R2PIPE_FRAME_HDRSZ + 5, "frames size");
+	ut32 id = 0, plen = 0;
+	mu_assert_eq (r2pipe_frame_parse (data, 4, &id, &plen), 0, "partial header");
+	mu_assert_eq (r2pipe_frame_parse (data, R2PIPE_FRAME_HDRSZ + 2, &id, &plen), 0, "partial payload");
+	int fsz = r2pipe_frame_parse (data, len, &id, &plen);
+	mu_assert_eq (fsz, R2PIPE_FRAME_HDRSZ + 5, "first frame size");
+	mu_assert_eq (id, 7, "first frame id");
+	mu_assert_eq (plen, 5, "first frame payload");
+	mu_assert_memeq (data + R2PIPE_FRAME_HDRSZ, (const ut8 *)"?e hi", 5, "first frame data");
+	fsz = r2pipe_frame_parse (data + fsz, len - fsz, &id, &plen);
+	mu_assert_eq (fsz, R2PIPE_FRAME_HDRSZ, "second frame size");
+	mu_assert_eq (id, 8, "second frame id");
+	mu_assert_eq (plen, 0, "second frame payload");
+	mu_assert_eq (r2pipe_frame_parse ((const ut8 *)"pd 1", 4, &id, &plen), -1, "not a frame");
+	r_strbuf_free (sb);
+	mu_end;
+}
+
 static int all_tests(void) {
 	r_sys_setenv ("R2_NOPLUGINS", "1");
 	mu_run_test (test_r2pipe);
 	mu_run_test (test_r2pipe_404);
+	mu_run_test (test_r2pipe_frames);
 	return tests_passed != tests_run;
 }
 
@@ -107,6 +107,39 @@ bool test_r_table_sort1(void) {
 	mu_end;
 }
 
+bool test_r_table_sort_large(void) {
+	RTable *t = r_table_new ("t");
+	RTableColumnType *typeString = r_table_type ("string");
+	RTableColumnType *typeNumber = r_table_type ("number");
+	r_table_add_column (t, typeString, "name", 0);
+	r_table_add_column (t, typeNumber, "addr", 0);
+	r_table_add_row (t, "hi", "0x100000010", NULL);
+	r_table_add_row (t, "lo", "0x10", NULL);
+	r_table_add_row (t, "mid", "0x80000000", NULL);
+	r_table_add_row (t, "same", "0x10", NULL);
+
+	r_table_sort (t, 1, false);
+	char *s = r_table_tocsv (t);
+	mu_assert_streq (s,
+		"name,addr\n"
+		"lo,0x10\n"
+		"same,0x10\n"
+		"mid,0x80000000\n"
+		"hi,0x100000010\n", "numbers wider than 32 bits are sorted and ties keep their order");
+	free (s);
+
+	r_table_group (t, 1, NULL);
+	s = r_table_tocsv (t);
+	mu_assert_streq (s,
+		"name,addr\n"
+		"lo,0x10\n"
+		"mid,0x80000000\n"
+		"hi,0x100000010\n", "group by number");
+	free (s);
+	r_table_free (t);
+	mu_end;
+}
+
 bool test_r_table_uniq(void) {
 	RTable *t = __table_test_data1 ();
 
@@ -315,6 +348,7 @@ bool all_tests(void) {
 	mu_run_test(test_r_table_column_type);
 	mu_run_test(test_r_table_tostring);
 	mu_run_test(test_r_table_sort1);
+	mu_run_test(test_r_table_sort_large);
 	mu_run_test(test_r_table_uniq);
 	mu_run_test(test_r_table_group);
 	mu_run_test (test_r_table_columns);